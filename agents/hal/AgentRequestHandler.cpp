@@ -21,12 +21,14 @@
 #include <dirent.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <utils/RefBase.h>
 
@@ -37,6 +39,7 @@
 #include <vector>
 
 #include "BinderClientToDriver.h"
+#include "DriverLauncher.h"
 #include "SocketClientToDriver.h"
 #include "SocketServerForDriver.h"
 #include "test/vts/proto/AndroidSystemControlMessage.pb.h"
@@ -48,6 +51,13 @@ using namespace google::protobuf;
 namespace android {
 namespace vts {
 
+AgentRequestHandler::~AgentRequestHandler() {
+  if (driver_client_) {
+    driver_client_->Close();
+    delete driver_client_;
+  }
+}
+
 bool AgentRequestHandler::ListHals(const RepeatedPtrField<string>& base_paths) {
   cout << "[runner->agent] command " << __FUNCTION__ << endl;
   AndroidSystemControlResponseMessage response_msg;
@@ -102,6 +112,10 @@ bool AgentRequestHandler::CheckDriverService(const string& service_name,
     response_msg.set_reason("found the service");
     cout << "set service_name " << service_name << endl;
     service_name_ = service_name;
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+    // see LaunchDriverService.
+    response_msg.set_payload_format(PAYLOAD_FORMAT_BINARY);
+#endif
   } else {
     if (live) *live = false;
     response_msg.set_response_code(FAIL);
@@ -110,9 +124,6 @@ bool AgentRequestHandler::CheckDriverService(const string& service_name,
   return VtsSocketSendMessage(response_msg);
 }
 
-static const char kUnixSocketNamePrefixForCallbackServer[] =
-    "/data/local/tmp/vts_agent_callback";
-
 bool AgentRequestHandler::LaunchDriverService(
     const AndroidSystemControlCommandMessage& command_msg) {
   int driver_type = command_msg.driver_type();
@@ -129,12 +140,14 @@ bool AgentRequestHandler::LaunchDriverService(
 
   cout << "[runner->agent] command " << __FUNCTION__ << " (file_path="
        << file_path << ")" << endl;
-  ResponseCode result = FAIL;
 
   // TODO: shall check whether there's a service with the same name and return
   // success immediately if exists.
   AndroidSystemControlResponseMessage response_msg;
 
+  // a session in its own process has nothing else which reaps its drivers.
+  ReapExitedDrivers();
+
   // deletes the service file if exists before starting to launch a driver.
   string socket_port_flie_path = GetSocketPortFilePath(service_name);
   struct stat file_stat;
@@ -143,157 +156,109 @@ bool AgentRequestHandler::LaunchDriverService(
     cerr << __func__ << " " << socket_port_flie_path << " delete error" << endl;
     response_msg.set_reason("service file already exists.");
   } else {
-    pid_t pid = fork();
-    if (pid == 0) {  // child
-      Close();
-
-      string driver_binary_path;
-      char* cmd = NULL;
-      if (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
-          driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
-          driver_type == VTS_DRIVER_TYPE_HAL_HIDL) {
-        // TODO: check whether the port is available and handle if fails.
-        static int port = 0;
-        string callback_socket_name(kUnixSocketNamePrefixForCallbackServer);
-        callback_socket_name += std::to_string(port++);
-        cout << "callback_socket_name: " << callback_socket_name << endl;
-        StartSocketServerForDriver(callback_socket_name, -1);
-
-        if (bits == 32) {
-          driver_binary_path = driver_hal_binary32_;
-        } else {
-          driver_binary_path = driver_hal_binary64_;
-        }
-        size_t offset = driver_binary_path.find_last_of("/");
-        string ld_dir_path = driver_binary_path.substr(0, offset);
-
-        if (driver_hal_spec_dir_path_.length() < 1) {
+    bool launched = false;
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-          asprintf(&cmd,
-                   "LD_LIBRARY_PATH=%s:$LD_LIBRARY_PATH %s --server "
-                   "--server_socket_path=%s "
-                   "--callback_socket_name=%s",
-                   ld_dir_path.c_str(), driver_binary_path.c_str(),
-                   socket_port_flie_path.c_str(), callback_socket_name.c_str());
-#else  // binder
-          asprintf(&cmd,
-                   "LD_LIBRARY_PATH=%s:$LD_LIBRARY_PATH %s --server "
-                   "--service_name=%s "
-                   "--callback_socket_name=%s",
-                   ld_dir_path.c_str(), driver_binary_path.c_str(),
-                   service_name.c_str(), callback_socket_name.c_str());
-#endif
-        } else {
-#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-          asprintf(&cmd,
-                   "LD_LIBRARY_PATH=%s:$LD_LIBRARY_PATH %s --server "
-                   "--server_socket_path=%s "
-                   "--spec_dir=%s --callback_socket_name=%s",
-                   ld_dir_path.c_str(), driver_binary_path.c_str(),
-                   socket_port_flie_path.c_str(),
-                   driver_hal_spec_dir_path_.c_str(),
-                   callback_socket_name.c_str());
-#else  // binder
-          asprintf(&cmd,
-                   "LD_LIBRARY_PATH=%s:$LD_LIBRARY_PATH %s --server "
-                   "--service_name=%s "
-                   "--spec_dir=%s --callback_socket_name=%s",
-                   ld_dir_path.c_str(), driver_binary_path.c_str(),
-                   service_name.c_str(), driver_hal_spec_dir_path_.c_str(),
-                   callback_socket_name.c_str());
+    if (driver_pool_ &&
+        driver_pool_->Claim(driver_type, bits, socket_port_flie_path)) {
+      cout << __func__ << " claimed an idle driver" << endl;
+      launched = true;
+    } else if (driver_zygote_ &&
+               (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
+                driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
+                driver_type == VTS_DRIVER_TYPE_HAL_HIDL) &&
+               driver_zygote_->ForkDriver(bits, socket_port_flie_path)) {
+      launched = true;
+    }
 #endif
+    if (!launched) {
+      DriverBinaryPaths paths;
+      paths.spec_dir_path = driver_hal_spec_dir_path_;
+      paths.hal_binary32 = driver_hal_binary32_;
+      paths.hal_binary64 = driver_hal_binary64_;
+      paths.shell_binary32 = driver_shell_binary32_;
+      paths.shell_binary64 = driver_shell_binary64_;
+      int ready_fd;
+      pid_t pid = LaunchDriver(paths, driver_type, bits, socket_port_flie_path,
+                               service_name, &ready_fd);
+      if (pid > 0) {
+        // WaitForDriverReady closes ready_fd either way.
+        launched = WaitForDriverReady(ready_fd, kDriverReadyTimeoutMsec);
+        if (!launched) {
+          // a driver which isn't ready in time is dropped along with the
+          // socket it may have bound, so that a retry can use the path.
+          cerr << __func__ << " kills the driver " << pid << endl;
+          KillDriver(pid);
+          unlink(socket_port_flie_path.c_str());
         }
-      } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
-        if (bits == 32) {
-          driver_binary_path = driver_shell_binary32_;
-        } else {
-          driver_binary_path = driver_shell_binary64_;
-        }
-        size_t offset = driver_binary_path.find_last_of("/");
-        string ld_dir_path = driver_binary_path.substr(0, offset);
-
+      }
+    }
+    if (launched) {
+// TODO: use an attribute (client) of a newly defined class.
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-        asprintf(
-            &cmd,
-            "LD_LIBRARY_PATH=%s:$LD_LIBRARY_PATH %s --server_socket_path=%s",
-            ld_dir_path.c_str(), driver_binary_path.c_str(),
-            socket_port_flie_path.c_str());
+      VtsDriverSocketClient* client =
+          android::vts::GetDriverSocketClient(service_name);
+      if (!client) {
 #else  // binder
-        cerr << __func__ << " no binder implementation available." << endl;
-        exit(-1);
+      android::sp<android::vts::IVtsFuzzer> client =
+          android::vts::GetBinderClient(service_name);
+      if (!client.get()) {
 #endif
-      } else {
-        cerr << __func__ << " unsupported driver type." << endl;
-      }
-
-      if (cmd) {
-        cout << __func__ << "launch a driver - " << cmd << endl;
-        system(cmd);
-        cout << __func__ << "driver exits" << endl;
-        free(cmd);
-      }
-      exit(0);
-    } else if (pid > 0) {
-      for (int attempt = 0; attempt < 10; attempt++) {
-        sleep(1);
-        if (IsDriverRunning(service_name, 10)) {
-          result = SUCCESS;
-          break;
-        }
+        response_msg.set_response_code(FAIL);
+        response_msg.set_reason("Failed to start a driver.");
+        // TODO: kill the driver?
+        return VtsSocketSendMessage(response_msg);
       }
-      if (result) {
-// TODO: use an attribute (client) of a newly defined class.
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-        VtsDriverSocketClient* client =
-            android::vts::GetDriverSocketClient(service_name);
-        if (!client) {
-#else  // binder
-        android::sp<android::vts::IVtsFuzzer> client =
-            android::vts::GetBinderClient(service_name);
-        if (!client.get()) {
+      if (command_msg.driver_transport() == DRIVER_TRANSPORT_SHARED_MEMORY &&
+          !client->StartSharedMemoryTransport()) {
+        cerr << __func__ << " can't use the shared memory transport; "
+             << "using the socket" << endl;
+      }
 #endif
-          response_msg.set_response_code(FAIL);
-          response_msg.set_reason("Failed to start a driver.");
-          // TODO: kill the driver?
-          return VtsSocketSendMessage(response_msg);
-        }
-        int32_t result;
-        if (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
-            driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
-            driver_type == VTS_DRIVER_TYPE_HAL_HIDL) {
-          cout << "[agent->driver]: LoadHal " << module_name << endl;
-          result = client->LoadHal(file_path, target_class, target_type,
-                                   target_version, target_package,
-                                   target_component_name,
-                                   hw_binder_service_name, module_name);
-          cout << "[driver->agent]: LoadHal returns " << result << endl;
-          if (result == VTS_DRIVER_RESPONSE_SUCCESS) {
-            response_msg.set_response_code(SUCCESS);
-            response_msg.set_reason("Loaded the selected HAL.");
-            cout << "set service_name " << service_name << endl;
-            service_name_ = service_name;
-          } else {
-            response_msg.set_response_code(FAIL);
-            response_msg.set_reason("Failed to load the selected HAL.");
-          }
-        } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
+      int32_t result;
+      if (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
+          driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
+          driver_type == VTS_DRIVER_TYPE_HAL_HIDL) {
+        cout << "[agent->driver]: LoadHal " << module_name << endl;
+        result = client->LoadHal(file_path, target_class, target_type,
+                                 target_version, target_package,
+                                 target_component_name,
+                                 hw_binder_service_name, module_name);
+        cout << "[driver->agent]: LoadHal returns " << result << endl;
+        if (result >= 0) {
           response_msg.set_response_code(SUCCESS);
-          response_msg.set_reason("Loaded the shell driver.");
+          response_msg.set_reason("Loaded the selected HAL.");
           cout << "set service_name " << service_name << endl;
           service_name_ = service_name;
+        } else {
+          response_msg.set_response_code(FAIL);
+          response_msg.set_reason("Failed to load the selected HAL.");
         }
+      } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
+        response_msg.set_response_code(SUCCESS);
+        response_msg.set_reason("Loaded the shell driver.");
+        cout << "set service_name " << service_name << endl;
+        service_name_ = service_name;
+      }
 
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-        driver_client_ = client;
-#endif
-        return VtsSocketSendMessage(response_msg);
+      if (driver_client_) {
+        driver_client_->Close();
+        delete driver_client_;
       }
+      driver_client_ = client;
+      // a runner sends text payloads until the agent advertises that it and
+      // its driver take the wire format.
+      if (response_msg.response_code() == SUCCESS) {
+        response_msg.set_payload_format(PAYLOAD_FORMAT_BINARY);
+      }
+#endif
+      return VtsSocketSendMessage(response_msg);
     }
-    response_msg.set_reason(
-        "Failed to fork a child process to start a driver.");
+    response_msg.set_reason("Failed to launch a driver.");
   }
   response_msg.set_response_code(FAIL);
-  cerr << "can't fork a child process to run the vts_hal_driver." << endl;
+  cerr << "can't launch the driver." << endl;
   return VtsSocketSendMessage(response_msg);
 }
 
@@ -369,71 +334,205 @@ bool AgentRequestHandler::ListApis() {
   return succ;
 }
 
-bool AgentRequestHandler::CallApi(const string& call_payload,
-                                  const string& uid) {
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+// Returns the driver-side payload format requested by a runner command.
+static VtsDriverPayloadFormat GetDriverPayloadFormat(
+    const AndroidSystemControlCommandMessage& command_msg) {
+  return command_msg.payload_format() == PAYLOAD_FORMAT_BINARY
+             ? VTS_DRIVER_PAYLOAD_FORMAT_BINARY
+             : VTS_DRIVER_PAYLOAD_FORMAT_TEXT;
+}
+#endif
+
+bool AgentRequestHandler::CallApi(
+    const AndroidSystemControlCommandMessage& command_msg) {
   cout << "[runner->agent] command " << __FUNCTION__ << endl;
+  string result;
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
   VtsDriverSocketClient* client = driver_client_;
   if (!client) {
+    return false;
+  }
+
+  bool success = client->Call(command_msg.arg(),
+                              command_msg.driver_caller_uid(),
+                              GetDriverPayloadFormat(command_msg), &result);
 #else  // binder
   // TODO: use an attribute (client) of a newly defined class.
   android::sp<android::vts::IVtsFuzzer> client =
       android::vts::GetBinderClient(service_name_);
   if (!client.get()) {
-#endif
     return false;
   }
 
-  const char* result = client->Call(call_payload, uid);
+  // the binder driver only takes text payloads.
+  bool success = false;
+  if (command_msg.payload_format() == PAYLOAD_FORMAT_TEXT) {
+    const char* binder_result = client->Call(command_msg.arg());
+    if (binder_result != NULL) {
+      result = binder_result;
+      success = true;
+    }
+  }
+#endif
 
   AndroidSystemControlResponseMessage response_msg;
-  if (result != NULL && strlen(result) > 0) {
+  if (success && result.size() > 0) {
     cout << "[agent] Call: success" << endl;
     response_msg.set_response_code(SUCCESS);
     response_msg.set_result(result);
+    response_msg.set_payload_format(command_msg.payload_format());
   } else {
     cout << "[agent] Call: fail" << endl;
     response_msg.set_response_code(FAIL);
     response_msg.set_reason("Failed to call the api.");
   }
-  bool succ = VtsSocketSendMessage(response_msg);
+  return VtsSocketSendMessage(response_msg);
+}
+
+bool AgentRequestHandler::CallApiBatch(
+    const AndroidSystemControlCommandMessage& command_msg) {
+  cout << "[runner->agent] command " << __FUNCTION__ << " ("
+       << command_msg.batch_arg_size() << " calls)" << endl;
+  AndroidSystemControlResponseMessage response_msg;
+  bool success = true;
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-  free((void*)result);
+  VtsDriverSocketClient* client = driver_client_;
+  if (!client) {
+    return false;
+  }
+
+  // the whole batch goes to the driver in one request.
+  VtsDriverControlResponseMessage driver_response_msg;
+  if (!client->CallBatch(command_msg.batch_arg(),
+                         command_msg.driver_caller_uid(),
+                         command_msg.continue_on_error(),
+                         GetDriverPayloadFormat(command_msg),
+                         &driver_response_msg)) {
+    success = false;
+  } else {
+    for (int i = 0; i < driver_response_msg.batch_return_message_size(); i++) {
+      response_msg.add_batch_result(driver_response_msg.batch_return_message(i));
+      response_msg.add_batch_response_code(
+          driver_response_msg.batch_response_code(i) ==
+                  VTS_DRIVER_RESPONSE_SUCCESS
+              ? SUCCESS
+              : FAIL);
+    }
+    success = driver_response_msg.response_code() ==
+              VTS_DRIVER_RESPONSE_SUCCESS;
+  }
+#else  // binder
+  // TODO: use an attribute (client) of a newly defined class.
+  android::sp<android::vts::IVtsFuzzer> client =
+      android::vts::GetBinderClient(service_name_);
+  if (!client.get()) {
+    return false;
+  }
+
+  // the binder driver only takes text payloads.
+  if (command_msg.payload_format() != PAYLOAD_FORMAT_TEXT) {
+    success = false;
+  }
+  for (int i = 0; success && i < command_msg.batch_arg_size(); i++) {
+    const string& arg = command_msg.batch_arg(i);
+    const char* result = client->Call(arg);
+    bool call_success = result != NULL && strlen(result) > 0 &&
+                        strcmp(result, "error");
+    response_msg.add_batch_result(result != NULL ? result : "");
+    response_msg.add_batch_response_code(call_success ? SUCCESS : FAIL);
+    if (!call_success) {
+      success = false;
+      if (!command_msg.continue_on_error()) break;
+    }
+  }
 #endif
-  return succ;
+
+  response_msg.set_payload_format(command_msg.payload_format());
+  if (success) {
+    cout << "[agent] CallBatch: success" << endl;
+    response_msg.set_response_code(SUCCESS);
+  } else {
+    cout << "[agent] CallBatch: fail" << endl;
+    response_msg.set_response_code(FAIL);
+    response_msg.set_reason("Failed to call the api batch.");
+  }
+  return VtsSocketSendMessage(response_msg);
 }
 
-bool AgentRequestHandler::GetAttribute(const string& payload) {
+bool AgentRequestHandler::GetAttribute(
+    const AndroidSystemControlCommandMessage& command_msg) {
   cout << "[runner->agent] command " << __FUNCTION__ << endl;
+  string result;
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
   VtsDriverSocketClient* client = driver_client_;
   if (!client) {
+    return false;
+  }
+
+  bool success = client->GetAttribute(
+      command_msg.arg(), GetDriverPayloadFormat(command_msg), &result);
 #else  // binder
   // TODO: use an attribute (client) of a newly defined class.
   android::sp<android::vts::IVtsFuzzer> client =
       android::vts::GetBinderClient(service_name_);
   if (!client.get()) {
-#endif
     return false;
   }
 
-  const char* result = client->GetAttribute(payload);
+  // the binder driver only takes text payloads.
+  bool success = false;
+  if (command_msg.payload_format() == PAYLOAD_FORMAT_TEXT) {
+    const char* binder_result = client->GetAttribute(command_msg.arg());
+    if (binder_result != NULL) {
+      result = binder_result;
+      success = true;
+    }
+  }
+#endif
 
   AndroidSystemControlResponseMessage response_msg;
-  if (result != NULL && strlen(result) > 0) {
+  if (success && result.size() > 0) {
     cout << "[agent] Call: success" << endl;
     response_msg.set_response_code(SUCCESS);
     response_msg.set_result(result);
+    response_msg.set_payload_format(command_msg.payload_format());
   } else {
     cout << "[agent] Call: fail" << endl;
     response_msg.set_response_code(FAIL);
     response_msg.set_reason("Failed to call the api.");
   }
-  bool succ = VtsSocketSendMessage(response_msg);
+  return VtsSocketSendMessage(response_msg);
+}
+
+bool AgentRequestHandler::GetStatus(
+    const AndroidSystemControlCommandMessage& command_msg) {
+  cout << "[runner->agent] command " << __FUNCTION__ << endl;
+  AndroidSystemControlResponseMessage response_msg;
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-  free((void*)result);
+  VtsDriverSocketClient* client = driver_client_;
+  int32_t value = 0;
+  string details;
+  if (client && client->Status(command_msg.status_type(), &value, &details)) {
+    response_msg.set_response_code(SUCCESS);
+    response_msg.set_status_value(value);
+    if (!details.empty()) response_msg.set_result(details);
+  } else {
+    response_msg.set_response_code(FAIL);
+    response_msg.set_reason("Failed to get the status.");
+  }
+#else  // binder
+  android::sp<android::vts::IVtsFuzzer> client =
+      android::vts::GetBinderClient(service_name_);
+  if (client.get()) {
+    response_msg.set_response_code(SUCCESS);
+    response_msg.set_status_value(client->Status(command_msg.status_type()));
+  } else {
+    response_msg.set_response_code(FAIL);
+    response_msg.set_reason("Failed to get the status.");
+  }
 #endif
-  return succ;
+  return VtsSocketSendMessage(response_msg);
 }
 
 bool AgentRequestHandler::DefaultResponse() {
@@ -510,7 +609,11 @@ void AgentRequestHandler::CreateSystemControlResponseFromDriverControlResponse(
 bool AgentRequestHandler::ProcessOneCommand() {
   AndroidSystemControlCommandMessage command_msg;
   if (!VtsSocketRecvMessage(&command_msg)) return false;
+  return ProcessCommand(command_msg);
+}
 
+bool AgentRequestHandler::ProcessCommand(
+    const AndroidSystemControlCommandMessage& command_msg) {
   cout << getpid() << " " << __func__
        << " command_type = " << command_msg.command_type() << endl;
   switch (command_msg.command_type()) {
@@ -527,9 +630,13 @@ bool AgentRequestHandler::ProcessOneCommand() {
     case LIST_APIS:
       return ListApis();
     case CALL_API:
-      return CallApi(command_msg.arg(), command_msg.driver_caller_uid());
+      return CallApi(command_msg);
+    case CALL_API_BATCH:
+      return CallApiBatch(command_msg);
     case VTS_AGENT_COMMAND_GET_ATTRIBUTE:
-      return GetAttribute(command_msg.arg());
+      return GetAttribute(command_msg);
+    case VTS_AGENT_COMMAND_GET_STATUS:
+      return GetStatus(command_msg);
     // for shell driver
     case VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND:
       ExecuteShellCommand(command_msg);
@@ -22,6 +22,7 @@
 
 #include <VtsDriverCommUtil.h>
 
+#include "DriverLauncher.h"
 #include "SocketClientToDriver.h"
 #include "test/vts/proto/AndroidSystemControlMessage.pb.h"
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
@@ -35,22 +36,36 @@ namespace vts {
 // Class which contains actual methods to handle the runner requests.
 class AgentRequestHandler : public VtsDriverCommUtil {
  public:
+  // LAUNCH_DRIVER_SERVICE claims an idle driver from driver_pool, if given,
+  // or forks a HAL driver from driver_zygote, if given, before it launches a
+  // new one.
   AgentRequestHandler(const char* spec_dir_path, const char* hal_path32,
                       const char* hal_path64, const char* shell_path32,
-                      const char* shell_path64)
+                      const char* shell_path64,
+                      DriverPool* driver_pool = NULL,
+                      DriverZygote* driver_zygote = NULL)
       : VtsDriverCommUtil(),
         service_name_(),
         driver_client_(NULL),
+        driver_pool_(driver_pool),
+        driver_zygote_(driver_zygote),
         driver_hal_spec_dir_path_(spec_dir_path),
         driver_hal_binary32_(hal_path32),
         driver_hal_binary64_(hal_path64),
         driver_shell_binary32_(shell_path32),
         driver_shell_binary64_(shell_path64) {}
 
+  // closes the connection to the driver, if any. The runner connection is
+  // left to the caller.
+  ~AgentRequestHandler();
 
   // handles a new session.
   bool ProcessOneCommand();
 
+  // Runs a command which the caller has received, and sends its response.
+  // Returns false if the session can't go on.
+  bool ProcessCommand(const AndroidSystemControlCommandMessage& command_msg);
+
  protected:
   // for the LIST_HAL command
   bool ListHals(
@@ -74,10 +89,16 @@ class AgentRequestHandler : public VtsDriverCommUtil {
   bool ListApis();
 
   // for the CALL_API command
-  bool CallApi(const string& call_payload, const string& uid);
+  bool CallApi(const AndroidSystemControlCommandMessage& command_msg);
+
+  // for the CALL_API_BATCH command
+  bool CallApiBatch(const AndroidSystemControlCommandMessage& command_msg);
 
   // for the VTS_AGENT_COMMAND_GET_ATTRIBUTE
-  bool GetAttribute(const string& payload);
+  bool GetAttribute(const AndroidSystemControlCommandMessage& command_msg);
+
+  // for the VTS_AGENT_COMMAND_GET_STATUS command
+  bool GetStatus(const AndroidSystemControlCommandMessage& command_msg);
 
   // for the EXECUTE_SHELL command
   bool ExecuteShellCommand(
@@ -93,6 +114,10 @@ class AgentRequestHandler : public VtsDriverCommUtil {
   int callback_port_;
   // the socket client of a launched or connected driver.
   VtsDriverSocketClient* driver_client_;
+  // idle drivers shared with the other sessions, or NULL.
+  DriverPool* driver_pool_;
+  // HAL driver zygotes shared with the other sessions, or NULL.
+  DriverZygote* driver_zygote_;
 
   void CreateSystemControlResponseFromDriverControlResponse(
       const VtsDriverControlResponseMessage& driver_control_response_message,
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AgentRequestHandler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <VtsDriverCommUtil.h>
+
+#include "SocketClientToDriver.h"
+#include "test/vts/proto/AndroidSystemControlMessage.pb.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+static const int32_t kCacheHits = 42;
+static const char kCallQueueStats[] = "handle 0: max depth 3";
+
+// An agent session whose driver is the given socket.
+class AgentRequestHandlerForTest : public AgentRequestHandler {
+ public:
+  AgentRequestHandlerForTest(int runner_sockfd, int driver_sockfd)
+      : AgentRequestHandler("", "", "", "", "") {
+    SetSockfd(runner_sockfd);
+    driver_client_ = new VtsDriverSocketClient();
+    driver_client_->SetSockfd(driver_sockfd);
+  }
+};
+
+/*
+ * Answers one command on sockfd the way a HAL driver answers GET_STATUS
+ * (see SocketServer.cpp), and stores the command in command_message.
+ */
+static void ServeOneDriverCommand(
+    int sockfd, VtsDriverControlCommandMessage* command_message) {
+  VtsDriverCommUtil driver(sockfd);
+  if (!driver.VtsSocketRecvMessage(command_message)) return;
+  VtsDriverControlResponseMessage response_message;
+  if (command_message->command_type() != GET_STATUS) {
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_FAIL);
+  } else if (command_message->status_type() ==
+             VTS_DRIVER_STATUS_FUZZER_CACHE_HITS) {
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+    response_message.set_return_value(kCacheHits);
+  } else if (command_message->status_type() ==
+             VTS_DRIVER_STATUS_CALL_QUEUE_MAX_DEPTH) {
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+    response_message.set_return_value(3);
+    response_message.set_return_message(kCallQueueStats);
+  } else {
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_FAIL);
+  }
+  if (command_message->has_request_id()) {
+    response_message.set_request_id(command_message->request_id());
+  }
+  driver.VtsSocketSendMessage(response_message);
+}
+
+/*
+ * Sends a VTS_AGENT_COMMAND_GET_STATUS command of status_type to an agent
+ * session whose driver answers as above, and stores the command the driver
+ * got and the response the runner got.
+ */
+static void GetStatusThroughAgent(
+    int32_t status_type, VtsDriverControlCommandMessage* driver_command,
+    AndroidSystemControlResponseMessage* response_msg) {
+  int runner_fds[2];
+  int driver_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, runner_fds));
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, driver_fds));
+  thread driver_thread(ServeOneDriverCommand, driver_fds[1], driver_command);
+
+  VtsDriverCommUtil runner(runner_fds[1]);
+  AndroidSystemControlCommandMessage command_msg;
+  command_msg.set_command_type(VTS_AGENT_COMMAND_GET_STATUS);
+  command_msg.set_status_type(status_type);
+  EXPECT_TRUE(runner.VtsSocketSendMessage(command_msg));
+  {
+    AgentRequestHandlerForTest handler(runner_fds[0], driver_fds[0]);
+    EXPECT_TRUE(handler.ProcessOneCommand());
+  }
+  EXPECT_TRUE(runner.VtsSocketRecvMessage(response_msg));
+
+  driver_thread.join();
+  close(runner_fds[0]);
+  close(runner_fds[1]);
+  close(driver_fds[1]);
+}
+
+/*
+ * Reads the FuzzerBase cache hits of a driver through the agent.
+ */
+TEST(vts_hal_agent, get_status_fuzzer_cache_hits) {
+  VtsDriverControlCommandMessage driver_command;
+  AndroidSystemControlResponseMessage response_msg;
+  GetStatusThroughAgent(VTS_DRIVER_STATUS_FUZZER_CACHE_HITS, &driver_command,
+                        &response_msg);
+  EXPECT_EQ(GET_STATUS, driver_command.command_type());
+  EXPECT_EQ(VTS_DRIVER_STATUS_FUZZER_CACHE_HITS,
+            driver_command.status_type());
+  EXPECT_EQ(SUCCESS, response_msg.response_code());
+  EXPECT_EQ(kCacheHits, response_msg.status_value());
+  EXPECT_FALSE(response_msg.has_result());
+}
+
+/*
+ * Reads a call queue counter, which comes with the metrics of each queue.
+ */
+TEST(vts_hal_agent, get_status_call_queue_max_depth) {
+  VtsDriverControlCommandMessage driver_command;
+  AndroidSystemControlResponseMessage response_msg;
+  GetStatusThroughAgent(VTS_DRIVER_STATUS_CALL_QUEUE_MAX_DEPTH,
+                        &driver_command, &response_msg);
+  EXPECT_EQ(SUCCESS, response_msg.response_code());
+  EXPECT_EQ(3, response_msg.status_value());
+  EXPECT_EQ(kCallQueueStats, response_msg.result());
+}
+
+/*
+ * A counter the driver doesn't know fails.
+ */
+TEST(vts_hal_agent, get_status_unknown_type) {
+  VtsDriverControlCommandMessage driver_command;
+  AndroidSystemControlResponseMessage response_msg;
+  GetStatusThroughAgent(UNKNOWN_VTS_DRIVER_STATUS_TYPE, &driver_command,
+                        &response_msg);
+  EXPECT_EQ(FAIL, response_msg.response_code());
+  EXPECT_FALSE(response_msg.has_status_value());
+}
+
+/*
+ * Reads num_calls CALL_FUNCTION commands on sockfd, answers the first one and
+ * closes sockfd, as a driver which crashes in the middle of a batch.
+ */
+static void AnswerOneCallAndClose(int sockfd, int num_calls) {
+  VtsDriverCommUtil driver(sockfd);
+  VtsDriverControlCommandMessage first_command;
+  VtsDriverControlCommandMessage command_message;
+  for (int i = 0; i < num_calls; i++) {
+    if (!driver.VtsSocketRecvMessage(i == 0 ? &first_command
+                                            : &command_message)) {
+      break;
+    }
+  }
+  VtsDriverControlResponseMessage response_message;
+  response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+  response_message.set_return_message(first_command.arg());
+  response_message.set_request_id(first_command.request_id());
+  driver.VtsSocketSendMessage(response_message);
+  driver.Close();
+}
+
+/*
+ * Answers one command on sockfd with a successful GET_STATUS response without
+ * a request id, as a driver which doesn't echo them, and closes sockfd.
+ */
+static void AnswerStatusWithoutRequestId(int sockfd) {
+  VtsDriverCommUtil driver(sockfd);
+  VtsDriverControlCommandMessage command_message;
+  if (driver.VtsSocketRecvMessage(&command_message)) {
+    VtsDriverControlResponseMessage response_message;
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+    response_message.set_return_value(kCacheHits);
+    driver.VtsSocketSendMessage(response_message);
+  }
+  driver.Close();
+}
+
+/*
+ * A pipelined batch whose driver goes away fails and drops the connection
+ * with the requests left in flight, so a response on the next connection is
+ * matched to its own request.
+ */
+TEST(vts_hal_agent, call_pipelined_failed_batch) {
+  const vector<string> args{"call 1", "call 2", "call 3", "call 4"};
+  int driver_fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, driver_fds));
+  thread driver_thread(AnswerOneCallAndClose, driver_fds[1], args.size());
+  VtsDriverSocketClient client;
+  client.SetSockfd(driver_fds[0]);
+  vector<string> results;
+  EXPECT_FALSE(client.CallPipelined(args, "", args.size(), &results));
+  driver_thread.join();
+  EXPECT_EQ(args[0], results[0]);
+  // the client has closed its end.
+  EXPECT_EQ(-1, fcntl(driver_fds[0], F_GETFD));
+  EXPECT_EQ(EBADF, errno);
+
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, driver_fds));
+  thread status_thread(AnswerStatusWithoutRequestId, driver_fds[1]);
+  client.SetSockfd(driver_fds[0]);
+  int32_t value = 0;
+  EXPECT_TRUE(client.Status(VTS_DRIVER_STATUS_FUZZER_CACHE_HITS, &value));
+  EXPECT_EQ(kCacheHits, value);
+  status_thread.join();
+  client.Close();
+}
+
+}  // namespace vts
+}  // namespace android
@@ -29,6 +29,7 @@ LOCAL_SRC_FILES := \
   VtsAgentMain.cpp \
   TcpServerForRunner.cpp \
   AgentRequestHandler.cpp \
+  DriverLauncher.cpp \
   SocketClientToDriver.cpp \
   BinderClientToDriver.cpp \
   SocketServerForDriver.cpp \
@@ -57,3 +58,151 @@ LOCAL_C_INCLUDES += \
 LOCAL_MULTILIB := both
 
 include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_agent_pipeline_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  vts_agent_pipeline_benchmark.cpp \
+  SocketClientToDriver.cpp \
+
+LOCAL_SHARED_LIBRARIES := \
+  libutils \
+  libcutils \
+  libvts_common \
+  libc++ \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+  libvts_drivercomm \
+
+LOCAL_C_INCLUDES += \
+  bionic \
+  external/libcxx/include \
+  frameworks/native/include \
+  system/core/include \
+  test/vts/agents/hal \
+  test/vts/drivers/hal/common \
+  test/vts/drivers/libdrivercomm \
+  external/protobuf/src \
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_agent_session_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  vts_agent_session_benchmark.cpp \
+  TcpServerForRunner.cpp \
+  AgentRequestHandler.cpp \
+  DriverLauncher.cpp \
+  SocketClientToDriver.cpp \
+  BinderClientToDriver.cpp \
+  SocketServerForDriver.cpp \
+
+LOCAL_SHARED_LIBRARIES := \
+  libutils \
+  libcutils \
+  libbinder \
+  libvts_common \
+  libc++ \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+  libvts_drivercomm \
+
+LOCAL_C_INCLUDES += \
+  bionic \
+  external/libcxx/include \
+  frameworks/native/include \
+  system/core/include \
+  test/vts/agents/hal \
+  test/vts/agents/hal/proto \
+  test/vts/drivers/hal/common \
+  test/vts/drivers/libdrivercomm \
+  external/protobuf/src \
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_driver_launch_benchmark
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  vts_driver_launch_benchmark.cpp \
+  TcpServerForRunner.cpp \
+  AgentRequestHandler.cpp \
+  DriverLauncher.cpp \
+  SocketClientToDriver.cpp \
+  BinderClientToDriver.cpp \
+  SocketServerForDriver.cpp \
+
+LOCAL_SHARED_LIBRARIES := \
+  libutils \
+  libcutils \
+  libbinder \
+  libvts_common \
+  libc++ \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+  libvts_drivercomm \
+
+LOCAL_C_INCLUDES += \
+  bionic \
+  external/libcxx/include \
+  frameworks/native/include \
+  system/core/include \
+  test/vts/agents/hal \
+  test/vts/agents/hal/proto \
+  test/vts/drivers/hal/common \
+  test/vts/drivers/libdrivercomm \
+  external/protobuf/src \
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_hal_agent_test
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  AgentRequestHandlerTest.cpp \
+  AgentRequestHandler.cpp \
+  DriverLauncher.cpp \
+  SocketClientToDriver.cpp \
+  BinderClientToDriver.cpp \
+  SocketServerForDriver.cpp \
+
+LOCAL_SHARED_LIBRARIES := \
+  libutils \
+  libcutils \
+  libbinder \
+  libvts_common \
+  libc++ \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+  libvts_drivercomm \
+
+LOCAL_C_INCLUDES += \
+  bionic \
+  external/libcxx/include \
+  frameworks/native/include \
+  system/core/include \
+  test/vts/agents/hal \
+  test/vts/agents/hal/proto \
+  test/vts/drivers/hal/common \
+  test/vts/drivers/libdrivercomm \
+  external/protobuf/src \
+
+include $(BUILD_NATIVE_TEST)
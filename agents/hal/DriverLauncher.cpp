@@ -0,0 +1,412 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DriverLauncher.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include <VtsDriverCommUtil.h>
+#include <VtsDriverFileUtil.h>
+
+#include "SocketClientToDriver.h"
+#include "specification_parser/ComponentSpecificationBundle.h"
+#include "SocketServerForDriver.h"
+#include "test/vts/proto/AndroidSystemControlMessage.pb.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+static const char kUnixSocketNamePrefixForCallbackServer[] =
+    "/data/local/tmp/vts_agent_callback";
+
+// how long a replacement of a claimed driver waits before it is launched, so
+// that it doesn't compete with the first calls to the claimed driver.
+static const int kPoolRefillDelayMsec = 50;
+
+// numbers the callback sockets of the drivers launched by this process.
+static std::atomic<int> callback_socket_count(0);
+
+static string NewCallbackSocketName() {
+  return kUnixSocketNamePrefixForCallbackServer + to_string(getpid()) + "_" +
+         to_string(callback_socket_count++);
+}
+
+// A driver launched or forked for this process, until it is reaped.
+struct TrackedDriver {
+  // whether the driver is a child of this process; a driver forked by a
+  // zygote is a child, and is reaped, of the zygote.
+  bool is_child;
+  // the callback socket served for the driver, if any.
+  string callback_socket_name;
+};
+
+static std::mutex tracked_drivers_mutex;
+static map<pid_t, TrackedDriver> tracked_drivers;
+
+static void TrackDriver(pid_t pid, bool is_child,
+                        const string& callback_socket_name) {
+  std::lock_guard<std::mutex> lock(tracked_drivers_mutex);
+  TrackedDriver& driver = tracked_drivers[pid];
+  driver.is_child = is_child;
+  driver.callback_socket_name = callback_socket_name;
+}
+
+// Forgets a driver which has exited, and closes its callback socket. Must hold
+// tracked_drivers_mutex.
+static void ForgetDriver(map<pid_t, TrackedDriver>::iterator it) {
+  if (!it->second.callback_socket_name.empty()) {
+    StopSocketServerForDriver(it->second.callback_socket_name);
+  }
+  tracked_drivers.erase(it);
+}
+
+// Returns whether a tracked driver has exited, and reaps it if it is a child.
+static bool HasExited(pid_t pid, const TrackedDriver& driver) {
+  if (driver.is_child) return waitpid(pid, NULL, WNOHANG) != 0;
+  // the zygote reaps its drivers soon, so a pid which still exists is
+  // assumed to be the driver's.
+  return kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+void ReapExitedDrivers() {
+  std::lock_guard<std::mutex> lock(tracked_drivers_mutex);
+  for (auto it = tracked_drivers.begin(); it != tracked_drivers.end();) {
+    if (HasExited(it->first, it->second)) {
+      cout << __func__ << " driver " << it->first << " has exited" << endl;
+      ForgetDriver(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
+bool IsDriverAlive(pid_t pid) {
+  std::lock_guard<std::mutex> lock(tracked_drivers_mutex);
+  auto it = tracked_drivers.find(pid);
+  if (it == tracked_drivers.end()) return false;
+  if (!HasExited(it->first, it->second)) return true;
+  ForgetDriver(it);
+  return false;
+}
+
+void KillDriver(pid_t pid) {
+  std::lock_guard<std::mutex> lock(tracked_drivers_mutex);
+  auto it = tracked_drivers.find(pid);
+  if (it == tracked_drivers.end()) return;  // already reaped.
+  kill(pid, SIGKILL);
+  if (it->second.is_child) waitpid(pid, NULL, 0);
+  ForgetDriver(it);
+}
+
+vector<int> ListInheritedFileDescriptors(int keep_fd) {
+  vector<int> fds;
+  DIR* dp = opendir("/proc/self/fd");
+  if (!dp) return fds;
+  struct dirent* dirp;
+  while ((dirp = readdir(dp)) != NULL) {
+    int fd = atoi(dirp->d_name);  // 0 for "." and ".."
+    if (fd > STDERR_FILENO && fd != keep_fd && fd != dirfd(dp)) {
+      fds.push_back(fd);
+    }
+  }
+  closedir(dp);
+  return fds;
+}
+
+// Adds the args which give a HAL driver the spec dir and, if vtsc has
+// compiled one there, the spec bundle.
+static void AddSpecArgs(const DriverBinaryPaths& paths, vector<string>* args) {
+  if (paths.spec_dir_path.empty()) return;
+  args->push_back("--spec_dir=" + paths.spec_dir_path);
+  string bundle_path = paths.spec_dir_path + "/" + VTS_SPEC_BUNDLE_FILE_NAME;
+  if (access(bundle_path.c_str(), R_OK) == 0) {
+    args->push_back("--spec_bundle=" + bundle_path);
+  }
+}
+
+pid_t LaunchDriver(const DriverBinaryPaths& paths, int driver_type, int bits,
+                   const string& socket_path, const string& service_name,
+                   int* ready_fd, bool zygote) {
+  string driver_binary_path;
+  string callback_socket_name;
+  if (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
+      driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
+      driver_type == VTS_DRIVER_TYPE_HAL_HIDL) {
+    driver_binary_path = bits == 32 ? paths.hal_binary32 : paths.hal_binary64;
+    // a zygote gets the callback socket of each driver it forks.
+    if (!zygote) callback_socket_name = NewCallbackSocketName();
+  } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
+#ifdef VTS_AGENT_DRIVER_COMM_BINDER  // binder
+    cerr << __func__ << " no binder implementation available." << endl;
+    return -1;
+#endif
+    driver_binary_path =
+        bits == 32 ? paths.shell_binary32 : paths.shell_binary64;
+  } else {
+    cerr << __func__ << " unsupported driver type." << endl;
+    return -1;
+  }
+
+  // the write end is passed to the driver, which writes to it once ready.
+  int pipe_fds[2];
+  if (pipe2(pipe_fds, O_CLOEXEC) != 0) {
+    cerr << __func__ << " ERROR can't create a pipe. errno = " << errno
+         << endl;
+    return -1;
+  }
+
+  vector<string> args;
+  args.push_back(driver_binary_path);
+  if (zygote) {
+    args.push_back("--server");
+    args.push_back("--zygote");
+    args.push_back("--server_socket_path=" + socket_path);
+    AddSpecArgs(paths, &args);
+  } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
+    args.push_back("--server_socket_path=" + socket_path);
+  } else {  // hal
+    args.push_back("--server");
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+    args.push_back("--server_socket_path=" + socket_path);
+#else  // binder
+    args.push_back("--service_name=" + service_name);
+#endif
+    AddSpecArgs(paths, &args);
+    args.push_back("--callback_socket_name=" + callback_socket_name);
+  }
+  args.push_back("--ready_fd=" + to_string(pipe_fds[1]));
+  vector<char*> argv;
+  for (const string& arg : args) argv.push_back((char*)arg.c_str());
+  argv.push_back(NULL);
+
+  string ld_library_path = GetDirFromFilePath(driver_binary_path);
+  const char* inherited_ld_library_path = getenv("LD_LIBRARY_PATH");
+  if (inherited_ld_library_path && *inherited_ld_library_path) {
+    ld_library_path += ":" + string(inherited_ld_library_path);
+  }
+  vector<string> env;
+  for (char** var = environ; *var; var++) {
+    if (strncmp(*var, "LD_LIBRARY_PATH=", strlen("LD_LIBRARY_PATH="))) {
+      env.push_back(*var);
+    }
+  }
+  env.push_back("LD_LIBRARY_PATH=" + ld_library_path);
+  vector<char*> envp;
+  for (const string& var : env) envp.push_back((char*)var.c_str());
+  envp.push_back(NULL);
+
+  // the relay runs in this process; the driver connects to it on a callback.
+  if (!callback_socket_name.empty()) {
+    cout << "callback_socket_name: " << callback_socket_name << endl;
+    if (StartSocketServerForDriver(callback_socket_name) < 0) {
+      cerr << __func__ << " ERROR can't start the callback server" << endl;
+      callback_socket_name.clear();
+    }
+  }
+
+  // the agent has other threads, which may hold e.g. the malloc or stdio
+  // locks at the fork, so the child only makes async-signal-safe calls and
+  // everything it needs is prepared here.
+  vector<int> inherited_fds = ListInheritedFileDescriptors(pipe_fds[1]);
+  string exec_error =
+      string(__func__) + " ERROR can't exec " + driver_binary_path + "\n";
+
+  cout << __func__ << " launch a driver - " << driver_binary_path << endl;
+  pid_t pid = fork();
+  if (pid == 0) {  // child
+    for (int fd : inherited_fds) close(fd);
+    // the agent may ignore SIGPIPE; the driver gets the default.
+    signal(SIGPIPE, SIG_DFL);
+    fcntl(pipe_fds[1], F_SETFD, 0);
+    execve(argv[0], argv.data(), envp.data());
+    write(STDERR_FILENO, exec_error.c_str(), exec_error.length());
+    _exit(-1);
+  }
+  close(pipe_fds[1]);
+  if (pid < 0) {
+    cerr << __func__ << " ERROR can't fork. errno = " << errno << endl;
+    close(pipe_fds[0]);
+    if (!callback_socket_name.empty()) {
+      StopSocketServerForDriver(callback_socket_name);
+    }
+    return -1;
+  }
+  TrackDriver(pid, true, callback_socket_name);
+  *ready_fd = pipe_fds[0];
+  return pid;
+}
+
+int DriverPool::GetDriverKind(int driver_type, int bits) {
+  if (driver_type == VTS_DRIVER_TYPE_HAL_CONVENTIONAL ||
+      driver_type == VTS_DRIVER_TYPE_HAL_LEGACY ||
+      driver_type == VTS_DRIVER_TYPE_HAL_HIDL) {
+    return bits == 32 ? DRIVER_KIND_HAL32 : DRIVER_KIND_HAL64;
+  } else if (driver_type == VTS_DRIVER_TYPE_SHELL) {
+    return bits == 32 ? DRIVER_KIND_SHELL32 : DRIVER_KIND_SHELL64;
+  }
+  return -1;
+}
+
+void DriverPool::Start() {
+  cout << __func__ << " keeps " << size_per_kind_
+       << " idle drivers of each kind" << endl;
+  for (int kind = 0; kind < NUM_DRIVER_KINDS; kind++) {
+    for (int count = 0; count < size_per_kind_; count++) AddDriver(kind, 0);
+  }
+}
+
+void DriverPool::AddDriver(int kind, int delay_msec) {
+  std::thread([this, kind, delay_msec] {
+    if (delay_msec > 0) usleep(delay_msec * 1000);
+    int driver_type = (kind == DRIVER_KIND_HAL32 || kind == DRIVER_KIND_HAL64)
+                          ? VTS_DRIVER_TYPE_HAL_HIDL
+                          : VTS_DRIVER_TYPE_SHELL;
+    int bits = (kind == DRIVER_KIND_HAL32 || kind == DRIVER_KIND_SHELL32)
+                   ? 32
+                   : 64;
+    IdleDriver driver;
+    driver.socket_path = GetSocketPortFilePath(
+        "vts_driver_pool_" + to_string(getpid()) + "_" +
+        to_string(next_driver_id_++));
+    int ready_fd;
+    driver.pid = LaunchDriver(paths_, driver_type, bits, driver.socket_path,
+                              "", &ready_fd);
+    if (driver.pid < 0 ||
+        !WaitForDriverReady(ready_fd, kDriverReadyTimeoutMsec)) {
+      // not retried, so that a missing binary doesn't launch drivers forever.
+      cerr << "DriverPool can't launch an idle driver of kind " << kind
+           << endl;
+      if (driver.pid > 0) KillDriver(driver.pid);
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_drivers_[kind].push_back(driver);
+  }).detach();
+}
+
+bool DriverPool::Claim(int driver_type, int bits, const string& socket_path) {
+  int kind = GetDriverKind(driver_type, bits);
+  if (kind < 0) return false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  while (!idle_drivers_[kind].empty()) {
+    IdleDriver driver = idle_drivers_[kind].back();
+    idle_drivers_[kind].pop_back();
+    AddDriver(kind, kPoolRefillDelayMsec);
+    // a driver which died while idle is dropped (and already replaced).
+    if (!IsDriverAlive(driver.pid)) {
+      unlink(driver.socket_path.c_str());
+      continue;
+    }
+    if (rename(driver.socket_path.c_str(), socket_path.c_str()) != 0) {
+      cerr << __func__ << " ERROR can't move " << driver.socket_path
+           << " errno = " << errno << endl;
+      KillDriver(driver.pid);
+      unlink(driver.socket_path.c_str());
+      continue;
+    }
+    cout << __func__ << " driver " << driver.pid << " serves " << socket_path
+         << endl;
+    return true;
+  }
+  return false;
+}
+
+bool DriverZygote::Start() {
+  bool started = false;
+  for (int bits : {32, 64}) {
+    string socket_path =
+        GetSocketPortFilePath("vts_driver_zygote" + to_string(bits));
+    unlink(socket_path.c_str());
+    int ready_fd;
+    pid_t pid = LaunchDriver(paths_, VTS_DRIVER_TYPE_HAL_HIDL, bits,
+                             socket_path, "", &ready_fd, true);
+    if (pid < 0 || !WaitForDriverReady(ready_fd, kDriverReadyTimeoutMsec)) {
+      cerr << "DriverZygote can't launch the " << bits << "-bit zygote"
+           << endl;
+      if (pid > 0) KillDriver(pid);
+      continue;
+    }
+    cout << "DriverZygote " << bits << "-bit zygote " << pid << " serves "
+         << socket_path << endl;
+    zygote_socket_paths_[bits == 32 ? 0 : 1] = socket_path;
+    started = true;
+  }
+  return started;
+}
+
+bool DriverZygote::ForkDriver(int bits, const string& socket_path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const string& zygote_socket_path = zygote_socket_paths_[bits == 32 ? 0 : 1];
+  if (zygote_socket_path.empty()) return false;
+
+  VtsDriverCommUtil zygote;
+  if (!zygote.Connect(zygote_socket_path)) {
+    cerr << __func__ << " ERROR can't connect to " << zygote_socket_path
+         << endl;
+    return false;
+  }
+  // the callback server runs in the agent as it does for a launched driver.
+  string callback_socket_name = NewCallbackSocketName();
+  if (StartSocketServerForDriver(callback_socket_name) < 0) {
+    zygote.Close();
+    return false;
+  }
+
+  VtsDriverControlCommandMessage command_message;
+  command_message.set_command_type(FORK_DRIVER);
+  command_message.set_server_socket_path(socket_path);
+  command_message.set_callback_socket_name(callback_socket_name);
+  VtsDriverControlResponseMessage response_message;
+  bool success = zygote.VtsSocketSendMessage(command_message) &&
+                 zygote.VtsSocketRecvMessage(&response_message) &&
+                 response_message.response_code() ==
+                     VTS_DRIVER_RESPONSE_SUCCESS;
+  zygote.Close();
+  if (!success) {
+    cerr << __func__ << " ERROR the zygote can't fork a driver for "
+         << socket_path << endl;
+    StopSocketServerForDriver(callback_socket_name);
+    return false;
+  }
+  // the zygote returns the pid of the driver.
+  pid_t pid = response_message.return_value();
+  if (pid > 0) {
+    TrackDriver(pid, false, callback_socket_name);
+  } else {  // a zygote which doesn't return pids; the socket can't be closed.
+    cerr << __func__ << " the zygote returned no pid" << endl;
+  }
+  cout << __func__ << " forked a driver " << pid << " for " << socket_path
+       << endl;
+  return true;
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_AGENT_DRIVER_LAUNCHER_H_
+#define __VTS_AGENT_DRIVER_LAUNCHER_H_
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// how long the agent waits for a launched driver to accept connections.
+static const int kDriverReadyTimeoutMsec = 10 * 1000;
+
+// Paths of the driver binaries and of the spec dir given to the agent.
+struct DriverBinaryPaths {
+  string spec_dir_path;
+  string hal_binary32;
+  string hal_binary64;
+  string shell_binary32;
+  string shell_binary64;
+};
+
+// Lists the descriptors which a forked process inherits from the agent
+// (e.g., the sockets of the runner sessions), except stdio and keep_fd, so
+// that a child can close them without allocating after the fork.
+extern vector<int> ListInheritedFileDescriptors(int keep_fd);
+
+// Launches a driver of driver_type (a VtsDriverType) and bits which serves
+// socket_path (socket) or registers service_name (binder). *ready_fd is set to
+// a pipe for WaitForDriverReady. If zygote is true, the HAL driver runs as a
+// zygote at socket_path (see DriverZygote). Returns the pid of the driver or
+// -1.
+extern pid_t LaunchDriver(const DriverBinaryPaths& paths, int driver_type,
+                          int bits, const string& socket_path,
+                          const string& service_name, int* ready_fd,
+                          bool zygote = false);
+
+// Reaps the launched drivers which have exited. Only the pids of drivers
+// launched by LaunchDriver or forked by DriverZygote are waited for, so a pid
+// which a caller still holds isn't reaped, and recycled, behind its back.
+extern void ReapExitedDrivers();
+
+// Returns whether a launched driver is still running. A driver which has
+// exited is reaped.
+extern bool IsDriverAlive(pid_t pid);
+
+// Kills a launched driver and, if it is a child of this process, waits for
+// it.
+extern void KillDriver(pid_t pid);
+
+// Idle drivers launched ahead of time so that LAUNCH_DRIVER_SERVICE does not
+// wait for a driver to start. An idle driver listens at a path of the pool
+// and, when claimed, its socket file is renamed to the path of the service;
+// the listening socket keeps working under the new name. A claimed driver is
+// replaced in the background.
+//
+// Drivers are shared by all sessions in the agent's process, so a pool is used
+// only by the epoll session server, and only with socket drivers.
+class DriverPool {
+ public:
+  // size_per_kind idle drivers are kept for each of the 32- and 64-bit HAL
+  // and shell drivers.
+  DriverPool(const DriverBinaryPaths& paths, int size_per_kind)
+      : paths_(paths), size_per_kind_(size_per_kind), next_driver_id_(0) {}
+
+  // Launches the idle drivers in the background.
+  void Start();
+
+  // Moves an idle driver of driver_type and bits to socket_path. Returns
+  // false if no such driver is ready.
+  bool Claim(int driver_type, int bits, const string& socket_path);
+
+ private:
+  enum DriverKind {
+    DRIVER_KIND_HAL32,
+    DRIVER_KIND_HAL64,
+    DRIVER_KIND_SHELL32,
+    DRIVER_KIND_SHELL64,
+    NUM_DRIVER_KINDS,
+  };
+
+  struct IdleDriver {
+    pid_t pid;
+    string socket_path;
+  };
+
+  // Returns the kind of a driver, or -1 for a type the pool doesn't keep.
+  static int GetDriverKind(int driver_type, int bits);
+
+  // Launches a driver of kind after delay_msec in a detached thread, which
+  // adds the driver to the pool once it is ready.
+  void AddDriver(int kind, int delay_msec);
+
+  const DriverBinaryPaths paths_;
+  const int size_per_kind_;
+  std::atomic<int> next_driver_id_;
+
+  std::mutex mutex_;
+  vector<IdleDriver> idle_drivers_[NUM_DRIVER_KINDS];
+};
+
+// HAL driver zygotes, which have loaded the driver libraries and parsed the
+// specification files once. A driver forked from a zygote starts without
+// exec'ing and loading them again. Like DriverPool, zygotes are used only
+// with socket drivers.
+class DriverZygote {
+ public:
+  explicit DriverZygote(const DriverBinaryPaths& paths) : paths_(paths) {}
+
+  // Launches the 32- and 64-bit zygotes and waits until they are ready.
+  // Returns false if neither is.
+  bool Start();
+
+  // Forks a HAL driver of bits which serves socket_path. Returns false if
+  // there is no zygote of bits or the fork fails.
+  bool ForkDriver(int bits, const string& socket_path);
+
+ private:
+  const DriverBinaryPaths paths_;
+
+  // serializes the FORK_DRIVER commands to a zygote.
+  std::mutex mutex_;
+  // the sockets of the 32- and 64-bit zygotes; empty if not running.
+  string zygote_socket_paths_[2];
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_AGENT_DRIVER_LAUNCHER_H_
@@ -34,6 +34,7 @@
 
 #include <utils/RefBase.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -57,10 +58,11 @@ namespace vts {
 bool VtsDriverSocketClient::Exit() {
   VtsDriverControlCommandMessage command_message;
   command_message.set_command_type(EXIT);
-  if (!VtsSocketSendMessage(command_message)) return false;
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return false;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return false;
+  if (!RecvResponse(request_id, &response_message)) return false;
   return true;
 }
 
@@ -81,13 +83,20 @@ int32_t VtsDriverSocketClient::LoadHal(const string& file_path,
   command_message.set_target_component_name(target_component_name);
   command_message.set_module_name(module_name);
   command_message.set_hw_binder_service_name(hw_binder_service_name);
-  if (!VtsSocketSendMessage(command_message)) return -1;
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return -1;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return -1;
+  if (!RecvResponse(request_id, &response_message)) return -1;
   cout << __func__ << " response code: " << response_message.response_code()
-       << endl;
-  return response_message.response_code();
+       << " component handle: " << response_message.return_value() << endl;
+  if (response_message.response_code() != VTS_DRIVER_RESPONSE_SUCCESS) {
+    return -1;
+  }
+  if (response_message.return_value() >= 0) {
+    component_handle_ = response_message.return_value();
+  }
+  return response_message.return_value();
 }
 
 const char* VtsDriverSocketClient::GetFunctions() {
@@ -95,10 +104,12 @@ const char* VtsDriverSocketClient::GetFunctions() {
 
   VtsDriverControlCommandMessage command_message;
   command_message.set_command_type(LIST_FUNCTIONS);
-  if (!VtsSocketSendMessage(command_message)) return NULL;
+  command_message.set_component_handle(component_handle_);
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return NULL;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return NULL;
+  if (!RecvResponse(request_id, &response_message)) return NULL;
 
   char* result =
       (char*)malloc(strlen(response_message.return_message().c_str()) + 1);
@@ -127,10 +138,11 @@ const char* VtsDriverSocketClient::ReadSpecification(
   command_message.set_target_version(target_version);
   command_message.set_target_package(target_package);
 
-  if (!VtsSocketSendMessage(command_message)) return NULL;
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return NULL;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return NULL;
+  if (!RecvResponse(request_id, &response_message)) return NULL;
 
   char* result =
       (char*)malloc(strlen(response_message.return_message().c_str()) + 1);
@@ -142,43 +154,59 @@ const char* VtsDriverSocketClient::ReadSpecification(
   return result;
 }
 
-const char* VtsDriverSocketClient::Call(const string& arg, const string& uid) {
+bool VtsDriverSocketClient::Call(const string& arg, const string& uid,
+                                 VtsDriverPayloadFormat payload_format,
+                                 string* result) {
   VtsDriverControlCommandMessage command_message;
   command_message.set_command_type(CALL_FUNCTION);
   command_message.set_arg(arg);
   command_message.set_driver_caller_uid(uid);
-  if (!VtsSocketSendMessage(command_message)) return NULL;
+  command_message.set_payload_format(payload_format);
+  command_message.set_component_handle(component_handle_);
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return false;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return NULL;
+  if (!RecvResponse(request_id, &response_message)) return false;
+  response_message.mutable_return_message()->swap(*result);
+  return true;
+}
 
-  char* result =
-      (char*)malloc(strlen(response_message.return_message().c_str()) + 1);
-  if (!result) {
-    cerr << __func__ << " ERROR result is NULL" << endl;
-    return NULL;
+bool VtsDriverSocketClient::CallBatch(
+    const ::google::protobuf::RepeatedPtrField<::std::string>& args,
+    const string& uid, bool continue_on_error,
+    VtsDriverPayloadFormat payload_format,
+    VtsDriverControlResponseMessage* response_message) {
+  VtsDriverControlCommandMessage command_message;
+  command_message.set_command_type(CALL_FUNCTION_BATCH);
+  for (const auto& arg : args) {
+    command_message.add_batch_arg(arg);
   }
-  strcpy(result, response_message.return_message().c_str());
-  return result;
+  command_message.set_continue_on_error(continue_on_error);
+  command_message.set_payload_format(payload_format);
+  command_message.set_driver_caller_uid(uid);
+  command_message.set_component_handle(component_handle_);
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return false;
+
+  return RecvResponse(request_id, response_message);
 }
 
-const char* VtsDriverSocketClient::GetAttribute(const string& arg) {
+bool VtsDriverSocketClient::GetAttribute(const string& arg,
+                                         VtsDriverPayloadFormat payload_format,
+                                         string* result) {
   VtsDriverControlCommandMessage command_message;
   command_message.set_command_type(GET_ATTRIBUTE);
   command_message.set_arg(arg);
-  if (!VtsSocketSendMessage(command_message)) return NULL;
+  command_message.set_payload_format(payload_format);
+  command_message.set_component_handle(component_handle_);
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return false;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return NULL;
-
-  char* result =
-      (char*)malloc(strlen(response_message.return_message().c_str()) + 1);
-  if (!result) {
-    cerr << __func__ << " ERROR result is NULL" << endl;
-    return NULL;
-  }
-  strcpy(result, response_message.return_message().c_str());
-  return result;
+  if (!RecvResponse(request_id, &response_message)) return false;
+  response_message.mutable_return_message()->swap(*result);
+  return true;
 }
 
 VtsDriverControlResponseMessage* VtsDriverSocketClient::ExecuteShellCommand(
@@ -188,24 +216,127 @@ VtsDriverControlResponseMessage* VtsDriverSocketClient::ExecuteShellCommand(
   for (const auto& cmd : shell_command) {
     command_message.add_shell_command(cmd);
   }
-  if (!VtsSocketSendMessage(command_message)) return NULL;
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return NULL;
 
   VtsDriverControlResponseMessage* response_message =
       new VtsDriverControlResponseMessage();
-  if (!VtsSocketRecvMessage(response_message)) return NULL;
+  if (!RecvResponse(request_id, response_message)) {
+    delete response_message;
+    return NULL;
+  }
 
   return response_message;
 }
 
-int32_t VtsDriverSocketClient::Status(int32_t type) {
+bool VtsDriverSocketClient::Status(int32_t type, int32_t* value,
+                                   string* details) {
   VtsDriverControlCommandMessage command_message;
-  command_message.set_command_type(CALL_FUNCTION);
+  command_message.set_command_type(GET_STATUS);
   command_message.set_status_type(type);
-  if (!VtsSocketSendMessage(command_message)) return 0;
+  int64_t request_id = SendCommand(&command_message);
+  if (!request_id) return false;
 
   VtsDriverControlResponseMessage response_message;
-  if (!VtsSocketRecvMessage(&response_message)) return 0;
-  return response_message.return_value();
+  if (!RecvResponse(request_id, &response_message)) return false;
+  if (response_message.response_code() != VTS_DRIVER_RESPONSE_SUCCESS) {
+    cerr << __func__ << " response code: "
+         << response_message.response_code() << endl;
+    return false;
+  }
+  *value = response_message.return_value();
+  if (details) *details = response_message.return_message();
+  return true;
+}
+
+bool VtsDriverSocketClient::CallPipelined(const vector<string>& args,
+                                          const string& uid, int depth,
+                                          vector<string>* results) {
+  if (depth < 1) depth = 1;
+  results->clear();
+  results->resize(args.size());
+  vector<int64_t> request_ids(args.size());
+  size_t num_sent = 0;
+  size_t num_received = 0;
+  VtsDriverControlCommandMessage command_message;
+  VtsDriverControlResponseMessage response_message;
+  // on an error, SendCommand or RecvResponse has dropped the connection and
+  // the rest of the window with it.
+  while (num_received < args.size()) {
+    // keeps the window full before waiting for the oldest response.
+    while (num_sent < args.size() &&
+           num_sent - num_received < (size_t)depth) {
+      command_message.Clear();
+      command_message.set_command_type(CALL_FUNCTION);
+      command_message.set_arg(args[num_sent]);
+      command_message.set_component_handle(component_handle_);
+      if (!uid.empty()) command_message.set_driver_caller_uid(uid);
+      request_ids[num_sent] = SendCommand(&command_message);
+      if (!request_ids[num_sent]) return false;
+      num_sent++;
+    }
+    if (!RecvResponse(request_ids[num_received], &response_message)) {
+      return false;
+    }
+    (*results)[num_received].swap(*response_message.mutable_return_message());
+    num_received++;
+  }
+  return true;
+}
+
+int64_t VtsDriverSocketClient::SendCommand(
+    VtsDriverControlCommandMessage* command_message) {
+  int64_t request_id = next_request_id_++;
+  command_message->set_request_id(request_id);
+  if (!VtsSocketSendMessage(*command_message)) {
+    DropConnection();
+    return 0;
+  }
+  in_flight_request_ids_.push_back(request_id);
+  return request_id;
+}
+
+bool VtsDriverSocketClient::RecvResponse(
+    int64_t request_id, VtsDriverControlResponseMessage* response_message) {
+  auto early_response = early_responses_.find(request_id);
+  if (early_response != early_responses_.end()) {
+    response_message->Swap(&early_response->second);
+    early_responses_.erase(early_response);
+    return true;
+  }
+
+  while (!in_flight_request_ids_.empty()) {
+    if (!VtsSocketRecvMessage(response_message)) {
+      DropConnection();
+      return false;
+    }
+    // a driver which doesn't echo request ids answers in the sending order.
+    int64_t response_id = response_message->has_request_id()
+                              ? response_message->request_id()
+                              : in_flight_request_ids_.front();
+    auto in_flight = find(in_flight_request_ids_.begin(),
+                          in_flight_request_ids_.end(), response_id);
+    if (in_flight == in_flight_request_ids_.end()) {
+      cerr << __func__ << " ERROR response to an unknown request "
+           << response_id << endl;
+      DropConnection();
+      return false;
+    }
+    in_flight_request_ids_.erase(in_flight);
+    if (response_id == request_id) return true;
+    early_responses_[response_id].Swap(response_message);
+  }
+  cerr << __func__ << " ERROR request " << request_id << " is not in flight"
+       << endl;
+  return false;
+}
+
+void VtsDriverSocketClient::DropConnection() {
+  cerr << __func__ << " dropping " << in_flight_request_ids_.size()
+       << " requests in flight" << endl;
+  in_flight_request_ids_.clear();
+  early_responses_.clear();
+  Close();
 }
 
 string GetSocketPortFilePath(const string& service_name) {
@@ -239,6 +370,9 @@ VtsDriverSocketClient* GetDriverSocketClient(const string& service_name) {
     delete client;
     return NULL;
   }
+  // drivers are launched from the same package as the agent, so the binary
+  // framing is always available.
+  client->SetSendFraming(VTS_SOCKET_FRAMING_BINARY);
   return client;
 }
 
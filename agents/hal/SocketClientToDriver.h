@@ -17,6 +17,8 @@
 #ifndef __VTS_FUZZER_TCP_CLIENT_H_
 #define __VTS_FUZZER_TCP_CLIENT_H_
 
+#include <deque>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -31,15 +33,15 @@ namespace vts {
 // Socket client instance for an agent to control a driver.
 class VtsDriverSocketClient : public VtsDriverCommUtil {
  public:
-  explicit VtsDriverSocketClient() : VtsDriverCommUtil() {}
-
-  // closes the socket.
-  void Close();
+  explicit VtsDriverSocketClient()
+      : VtsDriverCommUtil(), next_request_id_(1), component_handle_(-1) {}
 
   // Sends a EXIT request;
   bool Exit();
 
-  // Sends a LOAD_HAL request.
+  // Sends a LOAD_HAL request. The driver keeps the HALs loaded before. Returns
+  // the handle of the loaded component, to which the calls made after are
+  // sent, or -1 on error.
   int32_t LoadHal(const string& file_path, int target_class, int target_type,
                   float target_version, const string& target_package,
                   const string& target_component_name,
@@ -57,18 +59,67 @@ class VtsDriverSocketClient : public VtsDriverCommUtil {
           float target_version,
           const string& target_package);
 
-  // Sends a CALL_FUNCTION request.
-  const char* Call(const string& arg, const string& uid);
-
-  // Sends a GET_ATTRIBUTE request.
-  const char* GetAttribute(const string& arg);
-
-  // Sends a GET_STATUS request.
-  int32_t Status(int32_t type);
+  // Sends a CALL_FUNCTION request whose arg is encoded in payload_format, and
+  // stores the result, encoded in the same format, in result.
+  bool Call(const string& arg, const string& uid,
+            VtsDriverPayloadFormat payload_format, string* result);
+
+  // Sends a CALL_FUNCTION_BATCH request and stores its response, which has
+  // the result of each call made, in response_message.
+  bool CallBatch(
+      const ::google::protobuf::RepeatedPtrField<::std::string>& args,
+      const string& uid, bool continue_on_error,
+      VtsDriverPayloadFormat payload_format,
+      VtsDriverControlResponseMessage* response_message);
+
+  // Sends a GET_ATTRIBUTE request. The payloads are encoded as in Call.
+  bool GetAttribute(const string& arg, VtsDriverPayloadFormat payload_format,
+                    string* result);
+
+  // Sends a GET_STATUS request for the counter of the given
+  // VtsDriverStatusType and stores its value in value and the metrics which
+  // come with it, if any, in details (if not NULL). Returns true iff
+  // successful.
+  bool Status(int32_t type, int32_t* value, string* details = NULL);
 
   // Sends a EXECUTE request.
   VtsDriverControlResponseMessage* ExecuteShellCommand(
       const ::google::protobuf::RepeatedPtrField<::std::string> shell_command);
+
+  // Sends CALL_FUNCTION requests for all args while keeping up to 'depth'
+  // requests in flight, and stores their results in the order of args. If a
+  // request can't be sent or a response received, the connection is dropped
+  // (see SendCommand and RecvResponse) and false is returned.
+  bool CallPipelined(const vector<string>& args, const string& uid, int depth,
+                     vector<string>* results);
+
+  // Sends a command without waiting for its response. Returns the request id
+  // assigned to the command, or 0 on error, in which case the connection is
+  // dropped.
+  int64_t SendCommand(VtsDriverControlCommandMessage* command_message);
+
+  // Receives the response to an in-flight request. Responses to other
+  // requests which arrive earlier are kept until they are asked for. The
+  // connection is dropped if no response can be received or one answers a
+  // request which isn't in flight.
+  bool RecvResponse(int64_t request_id,
+                    VtsDriverControlResponseMessage* response_message);
+
+ private:
+  // Forgets the requests in flight and the responses kept for them, and
+  // closes the socket. After a failed send or receive, the stream may be cut
+  // in the middle of a message, so a later response can't be matched to its
+  // request.
+  void DropConnection();
+
+  // the request id assigned to the next command.
+  int64_t next_request_id_;
+  // the handle of the component loaded by the last LoadHal, or -1.
+  int32_t component_handle_;
+  // ids of the requests sent but not answered yet, in the sending order.
+  deque<int64_t> in_flight_request_ids_;
+  // responses received before they were asked for, keyed by request id.
+  map<int64_t, VtsDriverControlResponseMessage> early_responses_;
 };
 
 // returns the socket port file's path for the given service_name.
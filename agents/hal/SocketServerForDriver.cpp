@@ -17,18 +17,25 @@
 #include "SocketServerForDriver.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include <VtsDriverCommUtil.h>
 
@@ -41,66 +48,306 @@ namespace vts {
 
 static const int kCallbackServerPort = 5010;
 
-void SocketServerForDriver::RpcCallToRunner(
-    const AndroidSystemCallbackRequestMessage& message) {
-  cout << __func__ << ":" << __LINE__ << " " << message.id() << endl;
-  struct sockaddr_in serv_addr;
-  struct hostent* server;
+// max number of events handled per epoll_wait call.
+static const int kMaxEpollEvents = 64;
 
-  int sockfd;
-  sockfd = socket(AF_INET, SOCK_STREAM, 0);
+// queued requests are sent once they reach this size even in the middle of a
+// round.
+static const size_t kMaxQueuedCallBytes = 64 * 1024;
+
+// the relay of all callback sockets of this process; see GetRelay.
+static std::once_flag relay_once;
+static SocketServerForDriver* relay = NULL;
+
+// Returns the relay, which is started on a thread by the first call, or NULL
+// if it can't be started.
+static SocketServerForDriver* GetRelay() {
+  std::call_once(relay_once, [] {
+    SocketServerForDriver* server =
+        new SocketServerForDriver(kCallbackServerPort);
+    if (!server->Init()) {
+      delete server;
+      return;
+    }
+    // a thread rather than a forked child, as the agent is multithreaded and
+    // a child which doesn't exec can't safely run the relay.
+    std::thread([server] { server->Start(); }).detach();
+    relay = server;
+  });
+  return relay;
+}
+
+bool SocketServerForDriver::Init() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    cerr << __func__ << " ERROR epoll_create1 errno = " << errno << endl;
+    return false;
+  }
+  wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wake_fd_ < 0) {
+    cerr << __func__ << " ERROR eventfd errno = " << errno << endl;
+    return false;
+  }
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = wake_fd_;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &event) != 0) {
+    cerr << __func__ << " ERROR epoll_ctl errno = " << errno << endl;
+    return false;
+  }
+  return true;
+}
+
+bool SocketServerForDriver::AddListenSocket(int sockfd,
+                                            const string& socket_name) {
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    if (stopped_) return false;
+    pending_listen_sockets_.push_back(make_pair(sockfd, socket_name));
+  }
+  uint64_t one = 1;
+  write(wake_fd_, &one, sizeof(one));
+  return true;
+}
+
+void SocketServerForDriver::RemoveListenSocket(const string& socket_name) {
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    if (stopped_) return;
+    pending_removals_.push_back(socket_name);
+  }
+  uint64_t one = 1;
+  write(wake_fd_, &one, sizeof(one));
+}
+
+void SocketServerForDriver::UpdateListenSockets() {
+  uint64_t count;
+  read(wake_fd_, &count, sizeof(count));
+  vector<pair<int, string>> added;
+  vector<string> removed;
+  {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    added.swap(pending_listen_sockets_);
+    removed.swap(pending_removals_);
+  }
+  for (const pair<int, string>& socket : added) {
+    int flags = fcntl(socket.first, F_GETFL, 0);
+    fcntl(socket.first, F_SETFL, flags | O_NONBLOCK);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = socket.first;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, socket.first, &event) != 0) {
+      cerr << __func__ << " ERROR epoll_ctl errno = " << errno << endl;
+      close(socket.first);
+      unlink(socket.second.c_str());
+      continue;
+    }
+    listen_sockets_[socket.first] = socket.second;
+  }
+  // a socket added and removed in the same round is removed as well.
+  for (const string& socket_name : removed) {
+    for (map<int, string>::iterator it = listen_sockets_.begin();
+         it != listen_sockets_.end(); ++it) {
+      if (it->second != socket_name) continue;
+      cout << "[agent] callback server at " << socket_name << " stops" << endl;
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->first, NULL);
+      close(it->first);
+      unlink(socket_name.c_str());
+      listen_sockets_.erase(it);
+      break;
+    }
+  }
+}
+
+bool SocketServerForDriver::ConnectToRunner() {
+  struct sockaddr_in serv_addr;
+  int sockfd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
   if (sockfd < 0) {
     cerr << __func__ << " ERROR opening socket" << endl;
-    exit(-1);
-    return;
-  }
-  server = gethostbyname("127.0.0.1");
-  if (server == NULL) {
-    cerr << __func__ << " ERROR can't resolve the host name, localhost" << endl;
-    exit(-1);
-    return;
+    return false;
   }
   bzero((char*)&serv_addr, sizeof(serv_addr));
   serv_addr.sin_family = AF_INET;
-  bcopy((char*)server->h_addr, (char*)&serv_addr.sin_addr.s_addr,
-        server->h_length);
+  serv_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
   serv_addr.sin_port = htons(runner_port_);
 
   if (connect(sockfd, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) < 0) {
     cerr << __func__ << " ERROR connecting" << endl;
-    exit(-1);
-    return;
+    close(sockfd);
+    return false;
   }
 
-  VtsDriverCommUtil util(sockfd);
-  if (!util.VtsSocketSendMessage(message)) return;
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.fd = sockfd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, sockfd, &event) != 0) {
+    cerr << __func__ << " ERROR epoll_ctl errno = " << errno << endl;
+    close(sockfd);
+    return false;
+  }
+  runner_sockfd_ = sockfd;
+  SetSockfd(sockfd);
+  return true;
 }
 
-void SocketServerForDriver::Start() {
-  AndroidSystemCallbackRequestMessage message;
-  if (!VtsSocketRecvMessage(&message)) return;
-  cout << __func__ << " Callback ID: " << message.id() << endl;
-  RpcCallToRunner(message);
-  Close();
+bool SocketServerForDriver::DrainRunnerResponses() {
+  char buffer[4096];
+  while (true) {
+    ssize_t ret = recv(runner_sockfd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (ret > 0) continue;
+    if (ret < 0 && errno == EINTR) continue;
+    return ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
 }
 
-int StartSocketServerForDriver(const string& callback_socket_name,
-                               int runner_port) {
-  struct sockaddr_un serv_addr;
-  int pid = fork();
-  if (pid < 0) {
-    cerr << __func__ << " ERROR on fork" << endl;
-    return -1;
-  } else if (pid > 0) {
-    return 0;
+void SocketServerForDriver::RpcCallToRunner(
+    const AndroidSystemCallbackRequestMessage& message) {
+  cout << __func__ << ":" << __LINE__ << " " << message.id() << endl;
+  if (AppendFramedMessage(message, &queued_calls_)) num_queued_calls_++;
+}
+
+bool SocketServerForDriver::FlushRpcCallsToRunner() {
+  if (num_queued_calls_ == 0) return true;
+  bool sent = (runner_sockfd_ != -1 || ConnectToRunner()) &&
+              VtsSocketSendFramedBytes(queued_calls_);
+  if (!sent) {
+    cerr << __func__ << " ERROR dropped " << num_queued_calls_
+         << " callback requests" << endl;
+    if (runner_sockfd_ != -1) {
+      epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, runner_sockfd_, NULL);
+      Close();
+      runner_sockfd_ = -1;
+    }
+  }
+  queued_calls_.clear();
+  num_queued_calls_ = 0;
+  return sent;
+}
+
+bool SocketServerForDriver::AcceptDriverConnections(int listen_sockfd) {
+  while (true) {
+    int newsockfd = accept4(listen_sockfd, NULL, NULL, SOCK_CLOEXEC);
+    if (newsockfd < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR ||
+          errno == ECONNABORTED) {
+        return true;
+      }
+      cerr << __func__ << " ERROR on accept " << strerror(errno) << endl;
+      return false;
+    }
+    cout << "[agent] new callback connection." << endl;
+    DriverConnection* connection =
+        new DriverConnection(newsockfd, next_connection_id_++);
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = newsockfd;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, newsockfd, &event) != 0) {
+      cerr << __func__ << " ERROR epoll_ctl errno = " << errno << endl;
+      connection->util.Close();
+      delete connection;
+      continue;
+    }
+    driver_connections_[newsockfd] = connection;
   }
+}
+
+bool SocketServerForDriver::ReadDriverConnection(
+    DriverConnection* connection) {
+  // a driver may have sent several requests; all which were read along with
+  // the first one are relayed now as epoll won't report them.
+  do {
+    AndroidSystemCallbackRequestMessage message;
+    if (!connection->util.VtsSocketRecvMessage(&message)) return false;
+    cout << __func__ << " Callback ID: " << message.id() << endl;
+    RpcCallToRunner(message);
+    if (queued_calls_.size() >= kMaxQueuedCallBytes) FlushRpcCallsToRunner();
+  } while (connection->util.GetNumBufferedBytes() > 0);
+  return true;
+}
+
+void SocketServerForDriver::CloseDriverConnection(
+    DriverConnection* connection) {
+  map<int, DriverConnection*>::iterator it =
+      driver_connections_.begin();
+  for (; it != driver_connections_.end(); ++it) {
+    if (it->second == connection) break;
+  }
+  if (it != driver_connections_.end()) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->first, NULL);
+    driver_connections_.erase(it);
+  }
+  connection->util.Close();
+  delete connection;
+}
+
+void SocketServerForDriver::Start() {
+  // a runner which goes away must not kill the relay.
+  signal(SIGPIPE, SIG_IGN);
+  Loop();
+  // later sockets are refused; the registered ones are left as they are.
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  stopped_ = true;
+}
 
-  if (runner_port == -1) {
-    runner_port = kCallbackServerPort;
+void SocketServerForDriver::Loop() {
+  struct epoll_event events[kMaxEpollEvents];
+  while (true) {
+    int count = epoll_wait(epoll_fd_, events, kMaxEpollEvents, -1);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      cerr << __func__ << " ERROR epoll_wait errno = " << errno << endl;
+      return;
+    }
+
+    vector<DriverConnection*> ready_connections;
+    bool listen_sockets_changed = false;
+    for (int i = 0; i < count; i++) {
+      int fd = events[i].data.fd;
+      if (fd == wake_fd_) {
+        listen_sockets_changed = true;
+      } else if (listen_sockets_.count(fd)) {
+        if (!AcceptDriverConnections(fd)) return;
+      } else if (fd == runner_sockfd_) {
+        if (!DrainRunnerResponses()) {
+          cerr << __func__ << " the runner closed the connection" << endl;
+          epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, runner_sockfd_, NULL);
+          Close();
+          runner_sockfd_ = -1;
+        }
+      } else {
+        map<int, DriverConnection*>::iterator it =
+            driver_connections_.find(fd);
+        if (it != driver_connections_.end()) {
+          ready_connections.push_back(it->second);
+        }
+      }
+    }
+
+    // older connections first; see the class comment.
+    sort(ready_connections.begin(), ready_connections.end(),
+         [](const DriverConnection* a, const DriverConnection* b) {
+           return a->id < b->id;
+         });
+    for (DriverConnection* connection : ready_connections) {
+      if (!ReadDriverConnection(connection)) {
+        CloseDriverConnection(connection);
+      }
+    }
+    FlushRpcCallsToRunner();
+    // after the round, so that no event of the round refers to a socket
+    // which is closed, or to a new one which got the same number.
+    if (listen_sockets_changed) UpdateListenSockets();
   }
-  // only child process continues;
+}
+
+int StartSocketServerForDriver(const string& callback_socket_name) {
+  SocketServerForDriver* server = GetRelay();
+  if (!server) return -1;
+
+  struct sockaddr_un serv_addr;
+  // not inherited by the drivers launched later.
   int sockfd;
-  sockfd = socket(PF_UNIX, SOCK_STREAM, 0);
+  sockfd = socket(PF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
   if (sockfd < 0) {
     cerr << __func__ << " ERROR opening socket" << endl;
     return -1;
@@ -116,41 +363,30 @@ int StartSocketServerForDriver(const string& callback_socket_name,
     cerr << getpid() << " " << __func__ << " ERROR on binding "
          << callback_socket_name << " errno = " << error_save << " "
          << strerror(error_save) << endl;
+    close(sockfd);
     return -1;
   }
 
-  if (listen(sockfd, 5) < 0) {
+  // callbacks may come in bursts, each on a new connection.
+  if (listen(sockfd, SOMAXCONN) < 0) {
     cerr << __func__ << " ERROR on listening" << endl;
+    close(sockfd);
+    unlink(callback_socket_name.c_str());
     return -1;
   }
 
-  while (1) {
-    int newsockfd;
-    struct sockaddr_in cli_addr;
-    socklen_t clilen;
-
-    clilen = sizeof(cli_addr);
-    newsockfd = accept(sockfd, (struct sockaddr*) &cli_addr, &clilen);
-    if (newsockfd < 0) {
-      cerr << __func__ << " ERROR on accept " << strerror(errno) << endl;
-      break;
-    }
-    cout << "[agent] new callback connection." << endl;
-    pid = fork();
-    if (pid == 0) {
-      close(sockfd);
-      SocketServerForDriver server(newsockfd, runner_port);
-      server.Start();
-      exit(0);
-    } else if (pid > 0) {
-      close(newsockfd);
-    } else {
-      cerr << __func__ << " ERROR on fork" << endl;
-      break;
-    }
+  if (!server->AddListenSocket(sockfd, callback_socket_name)) {
+    cerr << __func__ << " ERROR the callback relay has stopped" << endl;
+    close(sockfd);
+    unlink(callback_socket_name.c_str());
+    return -1;
   }
-  close(sockfd);
-  exit(0);
+  return 0;
+}
+
+void StopSocketServerForDriver(const string& callback_socket_name) {
+  SocketServerForDriver* server = GetRelay();
+  if (server) server->RemoveListenSocket(callback_socket_name);
 }
 
 }  // namespace vts
@@ -17,6 +17,14 @@
 #ifndef __VTS_AGENT_SOCKET_SERVER_FOR_DRIVER_H_
 #define __VTS_AGENT_SOCKET_SERVER_FOR_DRIVER_H_
 
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include <VtsDriverCommUtil.h>
 
 #include "test/vts/proto/AndroidSystemControlMessage.pb.h"
@@ -24,26 +32,116 @@
 namespace android {
 namespace vts {
 
-// Launches a server which accepts connection requests from drivers.
-extern int StartSocketServerForDriver(const string& callback_socket_name,
-                                      int runner_port);
+// Starts to accept connection requests from drivers at callback_socket_name.
+// The callback sockets of all drivers are served by one relay on a thread of
+// this process, which the first call starts. Returns -1 if the socket can't be
+// set up.
+extern int StartSocketServerForDriver(const string& callback_socket_name);
+
+// Stops accepting connection requests at callback_socket_name, e.g. once its
+// driver has exited, and removes the socket file.
+extern void StopSocketServerForDriver(const string& callback_socket_name);
 
-// Class which contains actual methods to handle the callback requests.
+// Relays the callback requests of all driver connections to the runner over
+// one persistent connection (the VtsDriverCommUtil of this class). The
+// listening sockets and the driver connections are multiplexed with epoll,
+// and the requests read in one round are sent to the runner in one write.
+//
+// Requests keep their order per driver connection. Across connections, they
+// are relayed in the order in which the connections were accepted, so two
+// callbacks with the same id which a driver makes one after the other, each
+// on a new connection, also reach the runner in order.
 class SocketServerForDriver : public VtsDriverCommUtil {
  public:
-  SocketServerForDriver(int sock, int runner_port)
-      : VtsDriverCommUtil(sock),
-        runner_port_(runner_port) {}
+  explicit SocketServerForDriver(int runner_port)
+      : VtsDriverCommUtil(),
+        runner_port_(runner_port),
+        runner_sockfd_(-1),
+        epoll_fd_(-1),
+        wake_fd_(-1),
+        stopped_(false),
+        next_connection_id_(0),
+        num_queued_calls_(0) {}
 
-  // Starts to process requests.
+  // Creates the epoll set. Returns false on error.
+  bool Init();
+
+  // Starts to process requests. Returns only on error.
   void Start();
 
-  // Sends a RPC call to the runner.
+  // Adds a listening socket, which the relay then owns. Thread-safe; the
+  // socket is added by the relay's thread. Returns false if the relay has
+  // stopped.
+  bool AddListenSocket(int sockfd, const string& socket_name);
+
+  // Closes and unlinks the listening socket of socket_name. Thread-safe.
+  void RemoveListenSocket(const string& socket_name);
+
+  // Queues a RPC call to the runner. The queued calls are sent by
+  // FlushRpcCallsToRunner.
   void RpcCallToRunner(const AndroidSystemCallbackRequestMessage& message);
 
+  // Sends the queued RPC calls to the runner in one write, connecting to the
+  // runner if needed. Returns false if the calls are dropped because the
+  // runner can't be reached.
+  bool FlushRpcCallsToRunner();
+
  private:
+  // A connection from a driver.
+  struct DriverConnection {
+    VtsDriverCommUtil util;
+    // the accept order of the connection.
+    uint64_t id;
+
+    DriverConnection(int sockfd, uint64_t id) : util(sockfd), id(id) {}
+  };
+
+  // Connects to the runner's callback server.
+  bool ConnectToRunner();
+
+  // Runs the event loop. Returns only on error.
+  void Loop();
+
+  // Applies the listening sockets added and removed by other threads.
+  void UpdateListenSockets();
+
+  // Accepts all pending driver connections on listen_sockfd.
+  bool AcceptDriverConnections(int listen_sockfd);
+
+  // Queues all the requests buffered or pending on a driver connection.
+  // Returns false if the connection is closed.
+  bool ReadDriverConnection(DriverConnection* connection);
+
+  // Closes a driver connection.
+  void CloseDriverConnection(DriverConnection* connection);
+
+  // Reads and drops the responses of the runner, which the drivers don't
+  // wait for. Returns false if the runner closed the connection.
+  bool DrainRunnerResponses();
+
   // TCP port number of a runner's callback server.
   int runner_port_;
+  // the connection to the runner, or -1.
+  int runner_sockfd_;
+  int epoll_fd_;
+  // an eventfd which wakes up the relay when listening sockets change.
+  int wake_fd_;
+  // the sockets on which driver connections are accepted, by socket; used
+  // only by the relay's thread.
+  map<int, string> listen_sockets_;
+
+  // guards the listening socket changes made by other threads.
+  std::mutex pending_mutex_;
+  vector<pair<int, string>> pending_listen_sockets_;
+  vector<string> pending_removals_;
+  bool stopped_;
+
+  uint64_t next_connection_id_;
+  // open driver connections by socket.
+  map<int, DriverConnection*> driver_connections_;
+  // framed requests not sent to the runner yet.
+  string queued_calls_;
+  int num_queued_calls_;
 };
 
 }  // namespace vts
@@ -17,6 +17,8 @@
 #include "TcpServerForRunner.h"
 
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -28,16 +30,25 @@
 #include <netdb.h>
 #include <netinet/in.h>
 
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 
 #include <utils/RefBase.h>
 
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include "AgentRequestHandler.h"
 #include "BinderClientToDriver.h"
+#include "DriverLauncher.h"
 #include "test/vts/proto/AndroidSystemControlMessage.pb.h"
 
 using namespace std;
@@ -45,15 +56,418 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// number of worker threads which run the driver calls (e.g., CALL_API) of the
+// sessions in the epoll mode.
+static const int kNumCallWorkers = 8;
+
+// number of worker threads which launch drivers or wait for them. A
+// LAUNCH_DRIVER_SERVICE command can keep its worker for seconds, so launches
+// don't hold up the driver calls of other sessions.
+static const int kNumLaunchWorkers = 4;
+
+// max number of events handled per epoll_wait call.
+static const int kMaxEpollEvents = 64;
+
+// how often the epoll loop wakes up to reap exited drivers (ms).
+static const int kEpollTimeoutMsec = 1000;
+
+// Where the epoll server runs a command.
+enum RunnerCommandKind {
+  // answered by the agent itself on the event loop.
+  RUNNER_COMMAND_INLINE,
+  // a round trip to the session's driver on a call worker.
+  RUNNER_COMMAND_DRIVER_CALL,
+  // launches a driver or waits for one on a launch worker.
+  RUNNER_COMMAND_LAUNCH,
+};
+
+static RunnerCommandKind GetCommandKind(int command_type) {
+  switch (command_type) {
+    case CHECK_DRIVER_SERVICE:
+    case LAUNCH_DRIVER_SERVICE:
+      return RUNNER_COMMAND_LAUNCH;
+    case VTS_AGENT_COMMAND_READ_SPECIFICATION:
+    case LIST_APIS:
+    case CALL_API:
+    case CALL_API_BATCH:
+    case VTS_AGENT_COMMAND_GET_ATTRIBUTE:
+    case VTS_AGENT_COMMAND_GET_STATUS:
+    case VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND:
+      return RUNNER_COMMAND_DRIVER_CALL;
+    default:  // e.g., LIST_HALS, SET_HOST_INFO, and unknown commands.
+      return RUNNER_COMMAND_INLINE;
+  }
+}
+
+// State of a runner session in the epoll mode.
+enum RunnerSessionState {
+  // its next command is read, and inline commands are run, on the event
+  // loop; the session is in the epoll set while the command is incomplete.
+  RUNNER_SESSION_IDLE,
+  // a worker runs its command.
+  RUNNER_SESSION_BUSY,
+};
+
+struct RunnerSession {
+  AgentRequestHandler* handler;
+  int sockfd;
+  RunnerSessionState state;
+  // the command being run, and whether the session can go on after it.
+  AndroidSystemControlCommandMessage command;
+  bool command_succeeded;
+};
+
+// Sessions whose commands wait for a worker.
+struct RunnerSessionQueue {
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::deque<RunnerSession*> sessions;
+};
+
+// Serves all runner sessions in one process. The event loop reads commands
+// without blocking and runs those which the agent answers by itself. A
+// command which blocks on a driver goes to a worker pool; the worker hands
+// the session back through an eventfd, and the loop then reads the next
+// command or re-arms the session. Idle sessions are in an epoll set with
+// EPOLLONESHOT, so only one thread serves a session at a time.
+class EpollRunnerSessionServer {
+ public:
+  EpollRunnerSessionServer(int sockfd, const char* spec_dir_path,
+                           const char* fuzzer_path32,
+                           const char* fuzzer_path64,
+                           const char* shell_path32, const char* shell_path64,
+                           DriverPool* driver_pool, DriverZygote* driver_zygote)
+      : listen_sockfd_(sockfd),
+        epoll_fd_(-1),
+        done_fd_(-1),
+        spec_dir_path_(spec_dir_path),
+        fuzzer_path32_(fuzzer_path32),
+        fuzzer_path64_(fuzzer_path64),
+        shell_path32_(shell_path32),
+        shell_path64_(shell_path64),
+        driver_pool_(driver_pool),
+        driver_zygote_(driver_zygote) {}
+
+  // Runs the event loop. Returns only on error.
+  int Run();
+
+ private:
+  // Accepts all pending connections.
+  bool AcceptSessions();
+
+  // Reads and dispatches the commands of an idle session until one goes to
+  // a worker or more bytes are needed.
+  void ServeSession(RunnerSession* session);
+
+  // Runs the commands of the sessions in queue.
+  void WorkerLoop(RunnerSessionQueue* queue);
+
+  // Takes back the sessions whose commands the workers have run.
+  void FinishCommands();
+
+  // Puts an idle session back into the epoll set.
+  bool ArmSession(RunnerSession* session, int op);
+
+  // Closes a session whose runner is gone.
+  void CloseSession(RunnerSession* session);
+
+  int listen_sockfd_;
+  int epoll_fd_;
+  // an eventfd which the workers signal when they finish a command.
+  int done_fd_;
+  const char* spec_dir_path_;
+  const char* fuzzer_path32_;
+  const char* fuzzer_path64_;
+  const char* shell_path32_;
+  const char* shell_path64_;
+  DriverPool* driver_pool_;
+  DriverZygote* driver_zygote_;
+
+  RunnerSessionQueue call_queue_;
+  RunnerSessionQueue launch_queue_;
+
+  // sessions whose commands are done.
+  std::mutex done_mutex_;
+  std::vector<RunnerSession*> done_sessions_;
+};
+
+int EpollRunnerSessionServer::Run() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    cerr << __func__ << " epoll_create1 failed. errno = " << errno << endl;
+    return -1;
+  }
+  done_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (done_fd_ < 0) {
+    cerr << __func__ << " eventfd failed. errno = " << errno << endl;
+    return -1;
+  }
+  int flags = fcntl(listen_sockfd_, F_GETFL, 0);
+  fcntl(listen_sockfd_, F_SETFL, flags | O_NONBLOCK);
+  fcntl(listen_sockfd_, F_SETFD, FD_CLOEXEC);
+  // the listening socket and the eventfd are told from sessions by data.ptr.
+  struct epoll_event listen_event;
+  listen_event.events = EPOLLIN;
+  listen_event.data.ptr = NULL;
+  struct epoll_event done_event;
+  done_event.events = EPOLLIN;
+  done_event.data.ptr = this;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_sockfd_, &listen_event) !=
+          0 ||
+      epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, done_fd_, &done_event) != 0) {
+    cerr << __func__ << " epoll_ctl failed. errno = " << errno << endl;
+    return -1;
+  }
+
+  // a runner which goes away mid-response must not kill the other sessions.
+  signal(SIGPIPE, SIG_IGN);
+
+  for (int i = 0; i < kNumCallWorkers; i++) {
+    std::thread(&EpollRunnerSessionServer::WorkerLoop, this, &call_queue_)
+        .detach();
+  }
+  for (int i = 0; i < kNumLaunchWorkers; i++) {
+    std::thread(&EpollRunnerSessionServer::WorkerLoop, this, &launch_queue_)
+        .detach();
+  }
+
+  cout << "[agent] serving sessions with " << kNumCallWorkers
+       << " call workers and " << kNumLaunchWorkers << " launch workers"
+       << endl;
+  struct epoll_event events[kMaxEpollEvents];
+  while (true) {
+    int count = epoll_wait(epoll_fd_, events, kMaxEpollEvents,
+                           kEpollTimeoutMsec);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      cerr << __func__ << " epoll_wait failed. errno = " << errno << endl;
+      return -1;
+    }
+    ReapExitedDrivers();
+
+    for (int i = 0; i < count; i++) {
+      if (events[i].data.ptr == NULL) {
+        if (!AcceptSessions()) return -1;
+      } else if (events[i].data.ptr == this) {
+        FinishCommands();
+      } else {
+        RunnerSession* session = (RunnerSession*)events[i].data.ptr;
+        if (session->state == RUNNER_SESSION_IDLE) ServeSession(session);
+      }
+    }
+  }
+  return 0;
+}
+
+bool EpollRunnerSessionServer::AcceptSessions() {
+  while (true) {
+    struct sockaddr_in cli_addr;
+    socklen_t clilen = sizeof(cli_addr);
+    int newsockfd = accept4(listen_sockfd_, (struct sockaddr*)&cli_addr,
+                            &clilen, SOCK_CLOEXEC);
+    if (newsockfd < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+      if (errno == EINTR || errno == ECONNABORTED || errno == EMFILE ||
+          errno == ENFILE) {
+        cerr << __func__ << " accept failed. errno = " << errno << endl;
+        return true;
+      }
+      cerr << __func__ << " accept failed" << endl;
+      return false;
+    }
+
+    cout << "[runner->agent] NEW SESSION" << endl;
+    cout << "[runner->agent] ===========" << endl;
+    RunnerSession* session = new RunnerSession();
+    session->handler =
+        new AgentRequestHandler(spec_dir_path_, fuzzer_path32_,
+                                fuzzer_path64_, shell_path32_, shell_path64_,
+                                driver_pool_, driver_zygote_);
+    session->handler->SetSockfd(newsockfd);
+    session->sockfd = newsockfd;
+    session->state = RUNNER_SESSION_IDLE;
+    if (!ArmSession(session, EPOLL_CTL_ADD)) CloseSession(session);
+  }
+}
+
+void EpollRunnerSessionServer::ServeSession(RunnerSession* session) {
+  while (true) {
+    session->command.Clear();
+    int received =
+        session->handler->VtsSocketRecvMessageNonBlocking(&session->command);
+    if (received < 0) {
+      CloseSession(session);
+      return;
+    }
+    if (received == 0) {
+      if (!ArmSession(session, EPOLL_CTL_MOD)) CloseSession(session);
+      return;
+    }
+
+    RunnerCommandKind kind = GetCommandKind(session->command.command_type());
+    if (kind == RUNNER_COMMAND_INLINE) {
+      // the response is small, so sending it doesn't hold up the loop.
+      if (!session->handler->ProcessCommand(session->command)) {
+        CloseSession(session);
+        return;
+      }
+      continue;
+    }
+    RunnerSessionQueue* queue =
+        kind == RUNNER_COMMAND_LAUNCH ? &launch_queue_ : &call_queue_;
+    session->state = RUNNER_SESSION_BUSY;
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->sessions.push_back(session);
+    queue->cond.notify_one();
+    return;
+  }
+}
+
+void EpollRunnerSessionServer::WorkerLoop(RunnerSessionQueue* queue) {
+  while (true) {
+    RunnerSession* session;
+    {
+      std::unique_lock<std::mutex> lock(queue->mutex);
+      queue->cond.wait(lock, [queue] { return !queue->sessions.empty(); });
+      session = queue->sessions.front();
+      queue->sessions.pop_front();
+    }
+
+    session->command_succeeded =
+        session->handler->ProcessCommand(session->command);
+    {
+      std::lock_guard<std::mutex> lock(done_mutex_);
+      done_sessions_.push_back(session);
+    }
+    uint64_t one = 1;
+    write(done_fd_, &one, sizeof(one));
+  }
+}
+
+void EpollRunnerSessionServer::FinishCommands() {
+  uint64_t count;
+  read(done_fd_, &count, sizeof(count));
+  std::vector<RunnerSession*> sessions;
+  {
+    std::lock_guard<std::mutex> lock(done_mutex_);
+    sessions.swap(done_sessions_);
+  }
+  for (RunnerSession* session : sessions) {
+    if (!session->command_succeeded) {
+      CloseSession(session);
+      continue;
+    }
+    // the next command may be buffered already, which epoll won't report.
+    session->state = RUNNER_SESSION_IDLE;
+    ServeSession(session);
+  }
+}
+
+bool EpollRunnerSessionServer::ArmSession(RunnerSession* session, int op) {
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = session;
+  if (epoll_ctl(epoll_fd_, op, session->sockfd, &event) != 0) {
+    cerr << __func__ << " epoll_ctl failed. errno = " << errno << endl;
+    return false;
+  }
+  return true;
+}
+
+void EpollRunnerSessionServer::CloseSession(RunnerSession* session) {
+  cout << "[agent] session " << session->sockfd << " ends" << endl;
+  // a oneshot socket which fired is disarmed, so no event refers to the
+  // session after this.
+  epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, session->sockfd, NULL);
+  session->handler->Close();
+  delete session->handler;
+  delete session;
+}
+
+// Serves each session in a forked process.
+static int ServeRunnerSessionsInForkedProcesses(
+    int sockfd, const char* spec_dir_path, const char* fuzzer_path32,
+    const char* fuzzer_path64, const char* shell_path32,
+    const char* shell_path64) {
+  socklen_t clilen;
+  struct sockaddr_in cli_addr;
+
+  clilen = sizeof(cli_addr);
+  while (true) {
+    cout << "[agent] accepting" << endl;
+    int newsockfd = ::accept(sockfd, (struct sockaddr*)&cli_addr, &clilen);
+    if (newsockfd < 0) {
+      cerr << __func__ << " accept failed" << endl;
+      return -1;
+    }
+
+    cout << "[runner->agent] NEW SESSION" << endl;
+    cout << "[runner->agent] ===========" << endl;
+    pid_t pid = fork();
+    if (pid == 0) {  // child
+      close(sockfd);
+      cout << "[agent] process for a runner - pid = " << getpid() << endl;
+      AgentRequestHandler handler(spec_dir_path, fuzzer_path32, fuzzer_path64,
+                                  shell_path32, shell_path64);
+      handler.SetSockfd(newsockfd);
+      while (handler.ProcessOneCommand())
+        ;
+      exit(-1);
+    } else if (pid < 0) {
+      cerr << "can't fork a child process to handle a session." << endl;
+      return -1;
+    } else {
+      close(newsockfd);
+    }
+  }
+  return 0;
+}
+
+int ServeRunnerSessions(int sockfd, const char* spec_dir_path,
+                        const char* fuzzer_path32, const char* fuzzer_path64,
+                        const char* shell_path32, const char* shell_path64,
+                        TcpServerMode mode, int driver_pool_size,
+                        bool driver_zygote) {
+  if (mode == TCP_SERVER_MODE_FORK_PER_SESSION) {
+    return ServeRunnerSessionsInForkedProcesses(sockfd, spec_dir_path,
+                                                fuzzer_path32, fuzzer_path64,
+                                                shell_path32, shell_path64);
+  }
+  DriverPool* driver_pool = NULL;
+  DriverZygote* zygote = NULL;
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+  DriverBinaryPaths paths;
+  paths.spec_dir_path = spec_dir_path ? spec_dir_path : "";
+  paths.hal_binary32 = fuzzer_path32;
+  paths.hal_binary64 = fuzzer_path64;
+  paths.shell_binary32 = shell_path32;
+  paths.shell_binary64 = shell_path64;
+  if (driver_pool_size > 0) {
+    driver_pool = new DriverPool(paths, driver_pool_size);
+    driver_pool->Start();
+  }
+  if (driver_zygote) {
+    zygote = new DriverZygote(paths);
+    if (!zygote->Start()) {
+      delete zygote;
+      zygote = NULL;
+    }
+  }
+#endif
+  EpollRunnerSessionServer server(sockfd, spec_dir_path, fuzzer_path32,
+                                  fuzzer_path64, shell_path32, shell_path64,
+                                  driver_pool, zygote);
+  return server.Run();
+}
+
 // Starts to run a TCP server (foreground).
 int StartTcpServerForRunner(const char* spec_dir_path,
                             const char* fuzzer_path32,
                             const char* fuzzer_path64, const char* shell_path32,
-                            const char* shell_path64) {
+                            const char* shell_path64, TcpServerMode mode,
+                            int driver_pool_size, bool driver_zygote) {
   int sockfd;
-  socklen_t clilen;
   struct sockaddr_in serv_addr;
-  struct sockaddr_in cli_addr;
 
   sockfd = socket(AF_INET, SOCK_STREAM, 0);
   if (sockfd < 0) {
@@ -95,35 +509,9 @@ int StartTcpServerForRunner(const char* spec_dir_path,
     cerr << __func__ << " listen failed." << endl;
     return -1;
   }
-  clilen = sizeof(cli_addr);
-  while (true) {
-    cout << "[agent] accepting" << endl;
-    int newsockfd = ::accept(sockfd, (struct sockaddr*)&cli_addr, &clilen);
-    if (newsockfd < 0) {
-      cerr << __func__ << " accept failed" << endl;
-      return -1;
-    }
-
-    cout << "[runner->agent] NEW SESSION" << endl;
-    cout << "[runner->agent] ===========" << endl;
-    pid_t pid = fork();
-    if (pid == 0) {  // child
-      close(sockfd);
-      cout << "[agent] process for a runner - pid = " << getpid() << endl;
-      AgentRequestHandler handler(spec_dir_path, fuzzer_path32, fuzzer_path64,
-                                  shell_path32, shell_path64);
-      handler.SetSockfd(newsockfd);
-      while (handler.ProcessOneCommand())
-        ;
-      exit(-1);
-    } else if (pid < 0) {
-      cerr << "can't fork a child process to handle a session." << endl;
-      return -1;
-    } else {
-      close(newsockfd);
-    }
-  }
-  return 0;
+  return ServeRunnerSessions(sockfd, spec_dir_path, fuzzer_path32,
+                             fuzzer_path64, shell_path32, shell_path64, mode,
+                             driver_pool_size, driver_zygote);
 }
 
 }  // namespace vts
@@ -20,11 +20,38 @@
 namespace android {
 namespace vts {
 
+// How the agent serves runner sessions.
+enum TcpServerMode {
+  // one forked process per session (the original agent).
+  TCP_SERVER_MODE_FORK_PER_SESSION = 0,
+  // all sessions in one process; an epoll loop reads the commands without
+  // blocking and hands those which block on a driver to worker threads.
+  TCP_SERVER_MODE_EPOLL = 1,
+};
+
+// Starts to run a TCP server (foreground) on a free port, which is written to
+// /data/local/tmp/vts_tcp_server_port.
 extern int StartTcpServerForRunner(const char* spec_dir_path,
                                    const char* fuzzer_path32,
                                    const char* fuzzer_path64,
                                    const char* shell_path32,
-                                   const char* shell_path64);
+                                   const char* shell_path64,
+                                   TcpServerMode mode = TCP_SERVER_MODE_EPOLL,
+                                   int driver_pool_size = 0,
+                                   bool driver_zygote = false);
+
+// Serves the runner sessions accepted on the listening socket sockfd
+// (foreground). Returns only on error. In the epoll mode, driver_pool_size
+// idle drivers of each kind are kept for LAUNCH_DRIVER_SERVICE (see
+// DriverPool), and HAL drivers are forked from zygotes if driver_zygote is
+// true (see DriverZygote).
+extern int ServeRunnerSessions(int sockfd, const char* spec_dir_path,
+                               const char* fuzzer_path32,
+                               const char* fuzzer_path64,
+                               const char* shell_path32,
+                               const char* shell_path64, TcpServerMode mode,
+                               int driver_pool_size = 0,
+                               bool driver_zygote = false);
 
 }  // namespace vts
 }  // namespace android
@@ -14,6 +14,8 @@
  * limitations under the License.
  */
 
+#include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -31,11 +33,33 @@ int main(int argc, char* argv[]) {
   char* spec_dir_path = NULL;
   char* hal_path32;
   char* hal_path64;
-  char* shell_path32;
-  char* shell_path64;
+  char* shell_path32 = (char*) DEFAULT_SHELL_DRIVER_FILE_PATH32;
+  char* shell_path64 = (char*) DEFAULT_SHELL_DRIVER_FILE_PATH64;
 
   printf("|| VTS AGENT ||\n");
 
+  // --fork_per_session serves each runner session in a forked process as the
+  // agent used to. --driver_pool_size=<n> keeps n idle drivers of each kind
+  // for LAUNCH_DRIVER_SERVICE, and --driver_zygote forks HAL drivers from
+  // zygotes which have preloaded the specs (both not with --fork_per_session).
+  // They may come anywhere; the other arguments are positional.
+  android::vts::TcpServerMode mode = android::vts::TCP_SERVER_MODE_EPOLL;
+  int driver_pool_size = 0;
+  bool driver_zygote = false;
+  int arg_count = 1;
+  for (int index = 1; index < argc; index++) {
+    if (!strcmp(argv[index], "--fork_per_session")) {
+      mode = android::vts::TCP_SERVER_MODE_FORK_PER_SESSION;
+    } else if (!strncmp(argv[index], "--driver_pool_size=", 19)) {
+      driver_pool_size = atoi(argv[index] + 19);
+    } else if (!strcmp(argv[index], "--driver_zygote")) {
+      driver_zygote = true;
+    } else {
+      argv[arg_count++] = argv[index];
+    }
+  }
+  argc = arg_count;
+
   if (argc == 1) {
     hal_path32 = (char*) DEFAULT_HAL_DRIVER_FILE_PATH32;
     hal_path64 = (char*) DEFAULT_HAL_DRIVER_FILE_PATH64;
@@ -61,7 +85,8 @@ int main(int argc, char* argv[]) {
     shell_path32 = argv[4];
     shell_path64 = argv[5];
   } else {
-    std::cerr << "usage: vts_hal_agent "
+    std::cerr << "usage: vts_hal_agent [--fork_per_session] "
+              << "[--driver_pool_size=<n>] [--driver_zygote] "
               << "[[<hal 32-bit binary path> [<hal 64-bit binary path>] "
               << "[<spec file base dir path>]]"
               << "[[<shell 32-bit binary path> [<shell 64-bit binary path>] "
@@ -84,6 +109,6 @@ int main(int argc, char* argv[]) {
   android::vts::StartTcpServerForRunner(
       (const char*)spec_dir_path, (const char*)hal_path32,
       (const char*)hal_path64, (const char*)shell_path32,
-      (const char*)shell_path64);
+      (const char*)shell_path64, mode, driver_pool_size, driver_zygote);
   return 0;
 }
@@ -0,0 +1,159 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SocketClientToDriver.h"
+#include "VtsDriverCommUtil.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+/*
+ * Measures CALL_FUNCTION throughput of VtsDriverSocketClient against a stub
+ * HAL driver, with one request in flight, with a pipelined window, and with
+ * all calls sent as one CALL_FUNCTION_BATCH.
+ *
+ * Usage: vts_agent_pipeline_benchmark [<call count> [<depth> [<stub usec>]]]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultCallCount = 20000;
+static const int kDefaultDepth = 16;
+static const int kDefaultStubServiceTimeUsec = 20;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Answers every command like a HAL driver whose calls take
+// service_time_usec, until EOF.
+static void StubDriver(VtsDriverCommUtil* server, int service_time_usec) {
+  VtsDriverControlCommandMessage command_message;
+  VtsDriverControlResponseMessage response_message;
+  while (server->VtsSocketRecvMessage(&command_message)) {
+    response_message.Clear();
+    response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+    if (command_message.command_type() == CALL_FUNCTION_BATCH) {
+      for (const auto& arg : command_message.batch_arg()) {
+        if (service_time_usec > 0) usleep(service_time_usec);
+        response_message.add_batch_return_message(arg);
+        response_message.add_batch_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+      }
+    } else {
+      if (service_time_usec > 0) usleep(service_time_usec);
+      response_message.set_return_message(command_message.arg());
+    }
+    if (command_message.has_request_id()) {
+      response_message.set_request_id(command_message.request_id());
+    }
+    if (!server->VtsSocketSendMessage(response_message)) break;
+  }
+}
+
+// Makes all calls with one CALL_FUNCTION_BATCH when depth is 0, or with
+// CallPipelined otherwise.
+static bool RunBenchmark(const vector<string>& args, int depth,
+                         int service_time_usec) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    fprintf(stderr, "socketpair failed\n");
+    return false;
+  }
+  VtsDriverSocketClient client;
+  client.SetSockfd(fds[0]);
+  client.SetSendFraming(VTS_SOCKET_FRAMING_BINARY);
+  VtsDriverCommUtil server(fds[1]);
+  thread server_thread(StubDriver, &server, service_time_usec);
+
+  vector<string> results;
+  double start = NowSeconds();
+  bool ok;
+  if (depth == 0) {
+    google::protobuf::RepeatedPtrField<string> batch_args(args.begin(),
+                                                          args.end());
+    VtsDriverControlResponseMessage response_message;
+    ok = client.CallBatch(batch_args, "", false,
+                          VTS_DRIVER_PAYLOAD_FORMAT_TEXT, &response_message);
+    results.assign(response_message.batch_return_message().begin(),
+                   response_message.batch_return_message().end());
+    ok = ok && results.size() == args.size();
+  } else {
+    ok = client.CallPipelined(args, "", depth, &results);
+  }
+  double elapsed = NowSeconds() - start;
+
+  client.Close();
+  server_thread.join();
+  server.Close();
+
+  if (!ok) {
+    fprintf(stderr, "depth %d failed\n", depth);
+    return false;
+  }
+  for (size_t i = 0; i < args.size(); i++) {
+    if (results[i] != args[i]) {
+      fprintf(stderr, "depth %d: result %zu out of order\n", depth, i);
+      return false;
+    }
+  }
+  if (depth == 0) {
+    printf("batch    ");
+  } else {
+    printf("depth %3d", depth);
+  }
+  printf(" %12.0f calls/sec %10.2f usec/call\n", args.size() / elapsed,
+         elapsed * 1e6 / args.size());
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int call_count = argc > 1 ? atoi(argv[1]) : kDefaultCallCount;
+  int depth = argc > 2 ? atoi(argv[2]) : kDefaultDepth;
+  int service_time_usec =
+      argc > 3 ? atoi(argv[3]) : kDefaultStubServiceTimeUsec;
+  if (call_count <= 0 || depth <= 0 || service_time_usec < 0) {
+    fprintf(stderr, "usage: %s [<call count> [<depth> [<stub usec>]]]\n",
+            argv[0]);
+    return 2;
+  }
+  // the client and the comm library log every call; keep that out of the
+  // measurement.
+  cout.rdbuf(NULL);
+  cerr.rdbuf(NULL);
+
+  vector<string> args;
+  for (int i = 0; i < call_count; i++) {
+    args.push_back("call " + to_string(i));
+  }
+  if (!RunBenchmark(args, 1, service_time_usec) ||
+      !RunBenchmark(args, depth, service_time_usec) ||
+      !RunBenchmark(args, 0, service_time_usec)) {
+    return 1;
+  }
+  return 0;
+}
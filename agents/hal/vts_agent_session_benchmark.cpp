@@ -0,0 +1,213 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <VtsDriverCommUtil.h>
+
+#include "TcpServerForRunner.h"
+#include "test/vts/proto/AndroidSystemControlMessage.pb.h"
+
+/*
+ * Measures how the agent's session server modes scale with runner sessions.
+ * The server runs in a forked process on a loopback port.
+ *   - sessions/sec: sessions which connect, make one LIST_HALS round trip and
+ *     close, one after another.
+ *   - per-session memory: the RSS and PSS growth of the server (and its
+ *     children) per session while the given number of sessions stay open.
+ *
+ * Usage: vts_agent_session_benchmark [<session count> [<open sessions>]]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultSessions = 2000;
+static const int kDefaultOpenSessions = 100;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the value (in kB) of the given field of a /proc file, or 0.
+static long ReadProcField(const string& path, const string& field) {
+  ifstream in(path.c_str());
+  string line;
+  while (getline(in, line)) {
+    if (line.compare(0, field.size(), field) == 0) {
+      return atol(line.c_str() + field.size());
+    }
+  }
+  return 0;
+}
+
+// Sums the RSS and PSS (kB) of pid and its children.
+static void GetTreeMemory(pid_t pid, long* rss_kb, long* pss_kb) {
+  vector<pid_t> pids(1, pid);
+  DIR* dp = opendir("/proc");
+  struct dirent* dirp;
+  while (dp && (dirp = readdir(dp)) != NULL) {
+    pid_t child = atoi(dirp->d_name);
+    if (child <= 0) continue;
+    ifstream stat_file(("/proc/" + string(dirp->d_name) + "/stat").c_str());
+    string stat;
+    getline(stat_file, stat);
+    // the parent pid is the second field after the ")" of the command name.
+    size_t pos = stat.rfind(')');
+    if (pos == string::npos) continue;
+    istringstream fields(stat.substr(pos + 1));
+    string state;
+    pid_t ppid = 0;
+    fields >> state >> ppid;
+    if (ppid == pid && state != "Z") pids.push_back(child);
+  }
+  if (dp) closedir(dp);
+
+  *rss_kb = *pss_kb = 0;
+  for (pid_t p : pids) {
+    string dir = "/proc/" + to_string(p);
+    *rss_kb += ReadProcField(dir + "/status", "VmRSS:");
+    *pss_kb += ReadProcField(dir + "/smaps_rollup", "Pss:");
+  }
+}
+
+static int ConnectToServer(int port) {
+  int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (sockfd < 0 ||
+      connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    if (sockfd >= 0) close(sockfd);
+    return -1;
+  }
+  return sockfd;
+}
+
+// Makes one LIST_HALS round trip on the session.
+static bool RoundTrip(VtsDriverCommUtil* session) {
+  AndroidSystemControlCommandMessage command;
+  command.set_command_type(LIST_HALS);
+  AndroidSystemControlResponseMessage response;
+  return session->VtsSocketSendMessage(command) &&
+         session->VtsSocketRecvMessage(&response);
+}
+
+static bool RunBenchmark(TcpServerMode mode, int sessions, int open_sessions) {
+  int listen_sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t addr_len = sizeof(addr);
+  if (listen_sockfd < 0 ||
+      ::bind(listen_sockfd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+      getsockname(listen_sockfd, (struct sockaddr*)&addr, &addr_len) != 0 ||
+      listen(listen_sockfd, 128) != 0) {
+    fprintf(stderr, "can't listen on a loopback port\n");
+    return false;
+  }
+  int port = ntohs(addr.sin_port);
+
+  pid_t server_pid = fork();
+  if (server_pid == 0) {
+    ServeRunnerSessions(listen_sockfd, "", "", "", "", "", mode);
+    _exit(1);
+  }
+  close(listen_sockfd);
+  if (server_pid < 0) {
+    fprintf(stderr, "can't fork the server\n");
+    return false;
+  }
+
+  bool success = true;
+  double start = NowSeconds();
+  for (int i = 0; i < sessions && success; i++) {
+    VtsDriverCommUtil session(ConnectToServer(port));
+    success = RoundTrip(&session);
+    session.Close();
+  }
+  double elapsed = NowSeconds() - start;
+
+  // lets the forked sessions above exit before the memory baseline.
+  usleep(200 * 1000);
+  long rss_before, pss_before, rss_after = 0, pss_after = 0;
+  GetTreeMemory(server_pid, &rss_before, &pss_before);
+  vector<VtsDriverCommUtil*> open;
+  for (int i = 0; i < open_sessions && success; i++) {
+    VtsDriverCommUtil* session = new VtsDriverCommUtil(ConnectToServer(port));
+    open.push_back(session);
+    success = RoundTrip(session);
+  }
+  if (success) GetTreeMemory(server_pid, &rss_after, &pss_after);
+  for (VtsDriverCommUtil* session : open) {
+    session->Close();
+    delete session;
+  }
+
+  kill(server_pid, SIGKILL);
+  waitpid(server_pid, NULL, 0);
+  if (!success) {
+    fprintf(stderr, "a session failed\n");
+    return false;
+  }
+  printf("%-16s %10.0f sessions/sec %10.1f kB RSS/session "
+         "%10.1f kB PSS/session\n",
+         mode == TCP_SERVER_MODE_EPOLL ? "epoll" : "fork_per_session",
+         sessions / elapsed, (double)(rss_after - rss_before) / open_sessions,
+         (double)(pss_after - pss_before) / open_sessions);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int sessions = argc > 1 ? atoi(argv[1]) : kDefaultSessions;
+  int open_sessions = argc > 2 ? atoi(argv[2]) : kDefaultOpenSessions;
+  if (sessions <= 0 || open_sessions <= 0) {
+    fprintf(stderr, "usage: %s [<session count> [<open sessions>]]\n",
+            argv[0]);
+    return 2;
+  }
+  // the agent logs every command; keep that out of the measurement.
+  cout.rdbuf(NULL);
+  cerr.rdbuf(NULL);
+
+  if (!RunBenchmark(TCP_SERVER_MODE_FORK_PER_SESSION, sessions,
+                    open_sessions) ||
+      !RunBenchmark(TCP_SERVER_MODE_EPOLL, sessions, open_sessions)) {
+    return 1;
+  }
+  return 0;
+}
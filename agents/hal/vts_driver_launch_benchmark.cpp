@@ -0,0 +1,178 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <netinet/in.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <VtsDriverCommUtil.h>
+
+#include "TcpServerForRunner.h"
+#include "test/vts/proto/AndroidSystemControlMessage.pb.h"
+
+/*
+ * Measures the launch-to-first-call latency of a driver: the time from
+ * sending LAUNCH_DRIVER_SERVICE for a shell driver until the response of its
+ * first EXECUTE_SHELL_COMMAND. The agent's epoll session server runs in a
+ * forked process on a loopback port, first launching each driver on demand
+ * and then claiming it from a warm pool. (An agent which polls for the driver
+ * with sleep(1) takes at least 1 s per launch.)
+ *
+ * Usage: vts_driver_launch_benchmark <shell driver binary> [<launch count>]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultLaunches = 20;
+static const int kPoolSize = 2;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int ConnectToServer(int port) {
+  int sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(port);
+  if (sockfd < 0 ||
+      connect(sockfd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+    if (sockfd >= 0) close(sockfd);
+    return -1;
+  }
+  return sockfd;
+}
+
+// Launches a shell driver as service_name and runs a command on it. Returns
+// the seconds taken, or a negative value on error.
+static double LaunchAndCall(int port, const string& service_name) {
+  VtsDriverCommUtil session(ConnectToServer(port));
+  double start = NowSeconds();
+  AndroidSystemControlCommandMessage launch;
+  launch.set_command_type(LAUNCH_DRIVER_SERVICE);
+  launch.set_driver_type(VTS_DRIVER_TYPE_SHELL);
+  launch.set_service_name(service_name);
+  launch.set_bits(sizeof(void*) * 8);
+  AndroidSystemControlResponseMessage response;
+  if (!session.VtsSocketSendMessage(launch) ||
+      !session.VtsSocketRecvMessage(&response) ||
+      response.response_code() != SUCCESS) {
+    return -1;
+  }
+  AndroidSystemControlCommandMessage call;
+  call.set_command_type(VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND);
+  call.add_shell_command("true");
+  if (!session.VtsSocketSendMessage(call) ||
+      !session.VtsSocketRecvMessage(&response) ||
+      response.response_code() != SUCCESS) {
+    return -1;
+  }
+  double elapsed = NowSeconds() - start;
+  session.Close();
+  return elapsed;
+}
+
+static bool RunBenchmark(const char* shell_path, int driver_pool_size,
+                         int launches) {
+  int listen_sockfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;
+  socklen_t addr_len = sizeof(addr);
+  if (listen_sockfd < 0 ||
+      ::bind(listen_sockfd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+      getsockname(listen_sockfd, (struct sockaddr*)&addr, &addr_len) != 0 ||
+      listen(listen_sockfd, 16) != 0) {
+    fprintf(stderr, "can't listen on a loopback port\n");
+    return false;
+  }
+  int port = ntohs(addr.sin_port);
+
+  // the server and the drivers it launches form one process group, which is
+  // killed at the end.
+  pid_t server_pid = fork();
+  if (server_pid == 0) {
+    setpgid(0, 0);
+    ServeRunnerSessions(listen_sockfd, "", "", "", shell_path, shell_path,
+                        TCP_SERVER_MODE_EPOLL, driver_pool_size);
+    _exit(1);
+  }
+  close(listen_sockfd);
+  if (server_pid < 0) {
+    fprintf(stderr, "can't fork the server\n");
+    return false;
+  }
+  setpgid(server_pid, server_pid);
+
+  vector<double> latencies;
+  for (int i = 0; i < launches; i++) {
+    // gives the pool time to replace the claimed driver, as a runner would
+    // between test modules.
+    if (driver_pool_size > 0) usleep(200 * 1000);
+    double latency = LaunchAndCall(
+        port, "vts_driver_launch_benchmark_" + to_string(i));
+    if (latency < 0) break;
+    latencies.push_back(latency);
+  }
+
+  kill(-server_pid, SIGKILL);
+  waitpid(server_pid, NULL, 0);
+  if ((int)latencies.size() != launches) {
+    fprintf(stderr, "a launch failed\n");
+    return false;
+  }
+  sort(latencies.begin(), latencies.end());
+  printf("%-10s %10.2f ms median %10.2f ms max\n",
+         driver_pool_size > 0 ? "warm pool" : "cold",
+         latencies[latencies.size() / 2] * 1000, latencies.back() * 1000);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int launches = argc > 2 ? atoi(argv[2]) : kDefaultLaunches;
+  if (argc < 2 || launches <= 0) {
+    fprintf(stderr, "usage: %s <shell driver binary> [<launch count>]\n",
+            argv[0]);
+    return 2;
+  }
+  // the agent logs every command; keep that out of the measurement.
+  cout.rdbuf(NULL);
+  cerr.rdbuf(NULL);
+
+  if (!RunBenchmark(argv[1], 0, launches) ||
+      !RunBenchmark(argv[1], kPoolSize, launches)) {
+    return 1;
+  }
+  return 0;
+}
@@ -22,6 +22,7 @@
 #include <iostream>
 
 #include "code_gen/CodeGenBase.h"
+#include "specification_parser/ComponentSpecificationBundle.h"
 #include "VtsCompilerUtils.h"
 
 using namespace std;
@@ -39,6 +40,15 @@ using namespace std;
 // where <base path> is a base path of where .vts input file or dir is
 // stored but should be excluded when computing the package path of generated
 // source or header output file(s).
+// To generate a fuzzer which decodes each input as a sequence of calls
+// instead of the args of one function given by --vts_target_func,
+//   Usage: vtsc -mSEQUENCE_FUZZER -tSOURCE -b<base path> \
+//          <.vts input file or dir path> \
+//          <C/C++ source output file or dir path>
+// To compile all .vts files under a spec dir into one bundle which drivers
+// load instead of the .vts files (see ComponentSpecificationBundle),
+//   Usage: vtsc -mSPEC_BUNDLE <spec dir path> <bundle output file path>
+// where the bundle is usually <spec dir path>/vts_specs.bundle.
 
 int main(int argc, char* argv[]) {
 #ifdef VTS_DEBUG
@@ -64,6 +74,16 @@ int main(int argc, char* argv[]) {
           mode = android::vts::kFuzzer;
 #ifdef VTS_DEBUG
           cout << "- mode: FUZZER" << endl;
+#endif
+        } else if (!strcmp(&argv[i][2], "SEQUENCE_FUZZER")) {
+          mode = android::vts::kSequenceFuzzer;
+#ifdef VTS_DEBUG
+          cout << "- mode: SEQUENCE_FUZZER" << endl;
+#endif
+        } else if (!strcmp(&argv[i][2], "SPEC_BUNDLE")) {
+          mode = android::vts::kSpecBundle;
+#ifdef VTS_DEBUG
+          cout << "- mode: SPEC_BUNDLE" << endl;
 #endif
         }
       }
@@ -88,6 +108,21 @@ int main(int argc, char* argv[]) {
       }
     }
   }
+  if (mode == android::vts::kSpecBundle) {
+    if (argc < opt_count + 3) {
+      cerr << "argc " << argc << " < " << opt_count + 3 << endl;
+      return -1;
+    }
+    int count = android::vts::ComponentSpecificationBundle::Write(
+        argv[opt_count + 1], argv[opt_count + 2]);
+    if (count < 0) {
+      cerr << __func__ << " can't compile " << argv[opt_count + 1] << endl;
+      return -1;
+    }
+    cout << "compiled " << count << " specification files into "
+         << argv[opt_count + 2] << endl;
+    return 0;
+  }
   if (argc < 5) {
     cerr << "argc " << argc << " < 5" << endl;
     return -1;
@@ -43,6 +43,7 @@
 #include "code_gen/driver/LibSharedCodeGen.h"
 #include "code_gen/fuzzer/FuzzerCodeGenBase.h"
 #include "code_gen/fuzzer/HalHidlFuzzerCodeGen.h"
+#include "code_gen/fuzzer/HalHidlSequenceFuzzerCodeGen.h"
 #include "code_gen/profiler/ProfilerCodeGenBase.h"
 #include "code_gen/profiler/HalHidlProfilerCodeGen.h"
 
@@ -122,11 +123,16 @@ void Translate(VtsCompileMode mode,
         exit(-1);
     }
     code_generator->GenerateAll(header_out, source_out, message);
-  } else if (mode == kFuzzer) {
+  } else if (mode == kFuzzer || mode == kSequenceFuzzer) {
     unique_ptr<FuzzerCodeGenBase> fuzzer_generator;
     switch (message.component_class()) {
       case HAL_HIDL:
-        fuzzer_generator = make_unique<HalHidlFuzzerCodeGen>(message);
+        if (mode == kSequenceFuzzer) {
+          fuzzer_generator = make_unique<HalHidlSequenceFuzzerCodeGen>(
+              message, input_vts_file_path);
+        } else {
+          fuzzer_generator = make_unique<HalHidlFuzzerCodeGen>(message);
+        }
         break;
       default:
         cerr << "not yet supported component_class "
@@ -207,12 +213,17 @@ void TranslateToFile(VtsCompileMode mode,
       cerr << __func__ << " doesn't support file_type = kBoth." << endl;
       exit(-1);
     }
-  } else if (mode == kFuzzer) {
+  } else if (mode == kFuzzer || mode == kSequenceFuzzer) {
     unique_ptr<FuzzerCodeGenBase> fuzzer_generator;
     switch (message.component_class()) {
       case HAL_HIDL:
         {
-          fuzzer_generator = make_unique<HalHidlFuzzerCodeGen>(message);
+          if (mode == kSequenceFuzzer) {
+            fuzzer_generator = make_unique<HalHidlSequenceFuzzerCodeGen>(
+                message, input_vts_file_path);
+          } else {
+            fuzzer_generator = make_unique<HalHidlFuzzerCodeGen>(message);
+          }
           break;
         }
       default:
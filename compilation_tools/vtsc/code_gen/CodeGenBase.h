@@ -32,7 +32,11 @@ namespace vts {
 enum VtsCompileMode {
   kDriver = 0,
   kProfiler,
-  kFuzzer
+  kFuzzer,
+  // generates a fuzzer which calls a sequence of functions per input.
+  kSequenceFuzzer,
+  // compiles a spec dir into one ComponentSpecificationBundle.
+  kSpecBundle
 };
 
 // Specifies what kinds of files to generate.
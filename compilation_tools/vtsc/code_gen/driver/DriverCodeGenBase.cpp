@@ -195,6 +195,8 @@ void DriverCodeGenBase::GenerateSourceIncludeFiles(Formatter& out,
   }
   if (message.component_class() != HAL_HIDL) {
     out << "#include \"vts_datatype.h\"" << "\n";
+  } else {
+    out << "#include \"vts_random.h\"" << "\n";
   }
   out << "#include \"vts_measurement.h\"" << "\n";
   out << "#include <iostream>" << "\n";
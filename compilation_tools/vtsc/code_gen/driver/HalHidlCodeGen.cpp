@@ -588,42 +588,17 @@ void HalHidlCodeGen::GenerateRandomFunctionImplForAttribute(Formatter& out,
     out << attribute.name() << " " << "Random" << attribute_name << "() {"
         << "\n";
     out.indent();
-    out << attribute.enum_value().scalar_type() << " choice = " << "("
-        << attribute.enum_value().scalar_type() << ") " << "rand() / "
-        << attribute.enum_value().enumerator().size() << ";" << "\n";
-    if (attribute.enum_value().scalar_type().find("u") != 0) {
-      out << "if (choice < 0) choice *= -1;" << "\n";
-    }
-    for (int index = 0; index < attribute.enum_value().enumerator().size();
-        index++) {
-      out << "if (choice == ";
-      out << "(" << attribute.enum_value().scalar_type() << ") ";
-      if (attribute.enum_value().scalar_type() == "int8_t") {
-        out << attribute.enum_value().scalar_value(index).int8_t();
-      } else if (attribute.enum_value().scalar_type() == "uint8_t") {
-        out << attribute.enum_value().scalar_value(index).uint8_t();
-      } else if (attribute.enum_value().scalar_type() == "int16_t") {
-        out << attribute.enum_value().scalar_value(index).int16_t();
-      } else if (attribute.enum_value().scalar_type() == "uint16_t") {
-        out << attribute.enum_value().scalar_value(index).uint16_t();
-      } else if (attribute.enum_value().scalar_type() == "int32_t") {
-        out << attribute.enum_value().scalar_value(index).int32_t();
-      } else if (attribute.enum_value().scalar_type() == "uint32_t") {
-        out << attribute.enum_value().scalar_value(index).uint32_t();
-      } else if (attribute.enum_value().scalar_type() == "int64_t") {
-        out << attribute.enum_value().scalar_value(index).int64_t();
-      } else if (attribute.enum_value().scalar_type() == "uint64_t") {
-        out << attribute.enum_value().scalar_value(index).uint64_t();
-      } else {
-        cerr << __func__ << ":" << __LINE__ << " ERROR unsupported enum type "
-            << attribute.enum_value().scalar_type() << "\n";
-        exit(-1);
-      }
-      out << ") return " << attribute.name() << "::"
-          << attribute.enum_value().enumerator(index) << ";" << "\n";
+    // Picks one of the enumerators with the per-thread engine of
+    // libvts_datatype, so the values follow the fuzzer seed.
+    out << "static const " << attribute.name() << " kValues[] = {\n";
+    out.indent();
+    for (const auto& enumerator : attribute.enum_value().enumerator()) {
+      out << attribute.name() << "::" << enumerator << ",\n";
     }
-    out << "return " << attribute.name() << "::"
-        << attribute.enum_value().enumerator(0) << ";" << "\n";
+    out.unindent();
+    out << "};\n";
+    out << "return RandomChoice(kValues, "
+        << attribute.enum_value().enumerator_size() << ");\n";
     out.unindent();
     out << "}" << "\n";
   }
@@ -737,11 +712,31 @@ void HalHidlCodeGen::GenerateDriverImplForAttribute(Formatter& out,
 void HalHidlCodeGen::GenerateGetServiceImpl(Formatter& out,
     const ComponentSpecificationMessage& message,
     const string& fuzzer_extended_class_name) {
+  // HIDL holds a death recipient weakly, so FuzzerBase keeps it.
+  out << "namespace {" << "\n";
+  out << "// Marks the service of a fuzzer as dead." << "\n";
+  out << "struct ServiceDeathRecipient"
+      << " : public ::android::hardware::hidl_death_recipient {" << "\n";
+  out.indent();
+  out << "explicit ServiceDeathRecipient(FuzzerBase* fuzzer)"
+      << " : fuzzer_(fuzzer) {}" << "\n";
+  out << "void serviceDied(uint64_t /*cookie*/, "
+      << "const ::android::wp<::android::hidl::base::V1_0::IBase>& /*who*/) "
+      << "override {" << "\n";
+  out.indent();
+  out << "fuzzer_->SetServiceDied();" << "\n";
+  out.unindent();
+  out << "}" << "\n";
+  out << "FuzzerBase* fuzzer_;" << "\n";
+  out.unindent();
+  out << "};" << "\n";
+  out << "}  // namespace" << "\n" << "\n";
+
   out << "bool " << fuzzer_extended_class_name
       << "::GetService(bool get_stub, const char* service_name) {" << "\n";
   out.indent();
-  out << "static bool initialized = false;" << "\n";
-  out << "if (!initialized) {" << "\n";
+  out << "if (" << kInstanceVariableName << " == nullptr || HasServiceDied()) {"
+      << "\n";
   out.indent();
   out << "cout << \"[agent:hal] HIDL getService\" << endl;" << "\n";
   out << "if (service_name) {\n"
@@ -752,7 +747,22 @@ void HalHidlCodeGen::GenerateGetServiceImpl(Formatter& out,
       << "service_name, get_stub);" << "\n";
   out << "cout << \"[agent:hal] " << kInstanceVariableName << " = \" << "
       << kInstanceVariableName << ".get() << endl;" << "\n";
-  out << "initialized = true;" << "\n";
+  out << "if (" << kInstanceVariableName << " == nullptr) {" << "\n";
+  out.indent();
+  out << "return false;" << "\n";
+  out.unindent();
+  out << "}" << "\n";
+  out << "sp<ServiceDeathRecipient> recipient = "
+      << "new ServiceDeathRecipient(this);" << "\n";
+  out << "::android::hardware::Return<bool> linked = " << kInstanceVariableName
+      << "->linkToDeath(recipient, 0 /*cookie*/);" << "\n";
+  out << "if (!linked.isOk() || !linked) {" << "\n";
+  out.indent();
+  out << "cerr << \"[agent:hal] can't link to the death of the service\" << "
+      << "endl;" << "\n";
+  out.unindent();
+  out << "}" << "\n";
+  out << "SetServiceDeathRecipient(recipient);" << "\n";
   out.unindent();
   out << "}" << "\n";
   out << "return true;" << "\n";
@@ -34,7 +34,7 @@ class HalHidlFuzzerCodeGen : public FuzzerCodeGenBase {
   void GenerateLLVMFuzzerInitialize(Formatter &out) override;
   void GenerateLLVMFuzzerTestOneInput(Formatter &out) override;
 
- private:
+ protected:
   // Generates return callback function for HAL function being fuzzed.
   void GenerateReturnCallback(Formatter &out,
                               const FunctionSpecificationMessage &func_spec);
@@ -0,0 +1,413 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "HalHidlSequenceFuzzerCodeGen.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <hidl-util/FQName.h>
+
+#include "VtsCompilerUtils.h"
+#include "code_gen/common/HalHidlCodeGenUtils.h"
+#include "specification_parser/InterfaceSpecificationParser.h"
+#include "utils/InterfaceSpecUtil.h"
+#include "utils/StringUtil.h"
+
+using std::cerr;
+using std::endl;
+using std::string;
+using std::vector;
+
+namespace android {
+namespace vts {
+
+HalHidlSequenceFuzzerCodeGen::HalHidlSequenceFuzzerCodeGen(
+    const ComponentSpecificationMessage &comp_spec,
+    const string &input_vts_file_path)
+    : HalHidlFuzzerCodeGen(comp_spec) {
+  AddTypeDefinitions(comp_spec_);
+  // hidl-gen writes the specs of a package version into one dir, naming the
+  // spec of an interface without its leading 'I'.
+  string spec_dir_path = input_vts_file_path.substr(
+      0, input_vts_file_path.find_last_of('/') + 1);
+  string comp_version = GetVersionString(comp_spec_.component_type_version());
+  for (const auto &import : comp_spec_.import()) {
+    FQName import_name = FQName(import);
+    if (import_name.package() != comp_spec_.package() ||
+        import_name.version() != comp_version) {
+      continue;
+    }
+    string import_file_name = import_name.name();
+    if (import_file_name.size() > 1 && import_file_name[0] == 'I') {
+      import_file_name = import_file_name.substr(1);
+    }
+    string import_path = spec_dir_path + import_file_name + ".vts";
+    ComponentSpecificationMessage import_spec;
+    if (!InterfaceSpecificationParser::parse(import_path.c_str(),
+                                             &import_spec)) {
+      cerr << __func__ << ": can't parse " << import_path << endl;
+      continue;
+    }
+    AddTypeDefinitions(import_spec);
+  }
+
+  for (int i = 0; i < comp_spec_.interface().api_size(); ++i) {
+    const FunctionSpecificationMessage &func_spec =
+        comp_spec_.interface().api(i);
+    string missing_type;
+    bool decodable = true;
+    for (const auto &var_spec : func_spec.arg()) {
+      if (!AddDecodedTypes(var_spec, &missing_type)) {
+        decodable = false;
+        break;
+      }
+    }
+    if (decodable) {
+      called_funcs_.push_back(i);
+    } else {
+      cerr << __func__ << ": not calling " << func_spec.name()
+           << " as there is no definition of " << missing_type << endl;
+    }
+  }
+}
+
+void HalHidlSequenceFuzzerCodeGen::AddTypeDefinitions(
+    const VariableSpecificationMessage &var_spec) {
+  if (var_spec.type() == TYPE_ENUM || var_spec.type() == TYPE_STRUCT) {
+    type_defs_.emplace(var_spec.name(), var_spec);
+  }
+  for (const auto &sub_struct : var_spec.sub_struct()) {
+    AddTypeDefinitions(sub_struct);
+  }
+  for (const auto &sub_union : var_spec.sub_union()) {
+    AddTypeDefinitions(sub_union);
+  }
+}
+
+void HalHidlSequenceFuzzerCodeGen::AddTypeDefinitions(
+    const ComponentSpecificationMessage &spec) {
+  for (const auto &attribute : spec.attribute()) {
+    AddTypeDefinitions(attribute);
+  }
+  for (const auto &attribute : spec.interface().attribute()) {
+    AddTypeDefinitions(attribute);
+  }
+}
+
+bool HalHidlSequenceFuzzerCodeGen::AddDecodedTypes(
+    const VariableSpecificationMessage &var_spec, string *missing_type) {
+  switch (var_spec.type()) {
+    case TYPE_ENUM:
+    case TYPE_STRUCT: {
+      string type = GetCppVariableType(var_spec);
+      if (std::find(decoded_types_.begin(), decoded_types_.end(), type) !=
+          decoded_types_.end()) {
+        return true;
+      }
+      // a nested type is defined where it is used.
+      if (var_spec.enum_value().enumerator_size() > 0 ||
+          var_spec.struct_value_size() > 0) {
+        type_defs_.emplace(type, var_spec);
+      }
+      auto def = type_defs_.find(type);
+      if (def == type_defs_.end() ||
+          (var_spec.type() == TYPE_ENUM &&
+           def->second.enum_value().enumerator_size() == 0)) {
+        *missing_type = type;
+        return false;
+      }
+      decoded_types_.push_back(type);
+      for (const auto &member : def->second.struct_value()) {
+        if (!AddDecodedTypes(member, missing_type)) {
+          decoded_types_.erase(
+              std::find(decoded_types_.begin(), decoded_types_.end(), type));
+          return false;
+        }
+      }
+      return true;
+    }
+    case TYPE_VECTOR:
+    case TYPE_ARRAY:
+      return AddDecodedTypes(var_spec.vector_value(0), missing_type);
+    default:
+      return true;
+  }
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateSourceIncludeFiles(Formatter &out) {
+  out << "#include <string.h>\n\n";
+  out << "#include <iostream>\n";
+  out << "#include <type_traits>\n\n";
+
+  string package_path = comp_spec_.package();
+  ReplaceSubString(package_path, ".", "/");
+  string comp_version = GetVersionString(comp_spec_.component_type_version());
+  string comp_name = comp_spec_.component_name();
+
+  out << "#include <" << package_path << "/" << comp_version << "/" << comp_name
+      << ".h>\n";
+  out << "\n";
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateUsingDeclaration(Formatter &out) {
+  out << "using std::cerr;\n";
+  out << "using std::endl;\n\n";
+
+  string package_path = comp_spec_.package();
+  ReplaceSubString(package_path, ".", "::");
+  string comp_version =
+      GetVersionString(comp_spec_.component_type_version(), true);
+
+  out << "using namespace ::" << package_path << "::" << comp_version << ";\n";
+  out << "using namespace ::android::hardware;\n";
+  out << "\n";
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateGlobalVars(Formatter &out) {
+  out << "// The most calls made for one input.\n";
+  out << "static const size_t kMaxCalls = 64;\n";
+  out << "// The most elements decoded into one hidl_vec or hidl_string.\n";
+  out << "static const size_t kMaxElements = 256;\n\n";
+
+  out << "// Reads a value from the front of the input. Returns false if the "
+         "input is\n";
+  out << "// too short.\n";
+  out << "template <typename T>\n";
+  out << "static typename std::enable_if<std::is_trivially_copyable<T>::value, "
+         "bool>::type\n";
+  out << "ReadFuzzInput(const uint8_t **data, size_t *size, T *value) {\n";
+  out.indent();
+  out << "if (*size < sizeof(T)) { return false; }\n";
+  out << "memcpy(value, *data, sizeof(T));\n";
+  out << "*data += sizeof(T);\n";
+  out << "*size -= sizeof(T);\n";
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  out << "// Leaves a value which can't be copied from the input (e.g., a "
+         "handle or an\n";
+  out << "// interface) default constructed.\n";
+  out << "template <typename T>\n";
+  out << "static typename std::enable_if<"
+         "!std::is_trivially_copyable<T>::value, bool>::type\n";
+  out << "ReadFuzzInput(const uint8_t ** /* data */, size_t * /* size */, "
+         "T * /* value */) {\n";
+  out.indent();
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  out << "// Reads a bool from the low bit of a byte, as a bool of any other "
+         "value is\n";
+  out << "// undefined.\n";
+  out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+         "bool *value) {\n";
+  out.indent();
+  out << "uint8_t byte;\n";
+  out << "if (!ReadFuzzInput(data, size, &byte)) { return false; }\n";
+  out << "*value = byte & 1;\n";
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  if (!decoded_types_.empty()) {
+    out << "// Reads the enums and structs which the functions take; defined "
+           "below.\n";
+    for (const string &type : decoded_types_) {
+      out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+          << type << " *value);\n";
+    }
+    out << "\n";
+  }
+
+  out << "// Reads a 16-bit length and then that many chars, up to "
+         "kMaxElements.\n";
+  out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+         "hidl_string *value) {\n";
+  out.indent();
+  out << "uint16_t length;\n";
+  out << "if (!ReadFuzzInput(data, size, &length)) { return false; }\n";
+  out << "length %= kMaxElements + 1;\n";
+  out << "if (*size < length) { return false; }\n";
+  out << "*value = hidl_string(reinterpret_cast<const char *>(*data), "
+         "length);\n";
+  out << "*data += length;\n";
+  out << "*size -= length;\n";
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  out << "// Reads a 16-bit length and then that many elements, up to "
+         "kMaxElements.\n";
+  out << "template <typename T>\n";
+  out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+         "hidl_vec<T> *value) {\n";
+  out.indent();
+  out << "uint16_t length;\n";
+  out << "if (!ReadFuzzInput(data, size, &length)) { return false; }\n";
+  out << "value->resize(length % (kMaxElements + 1));\n";
+  out << "for (size_t i = 0; i < value->size(); ++i) {\n";
+  out.indent();
+  out << "if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }\n";
+  out.unindent();
+  out << "}\n";
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  out << "// Reads the elements of a one-dimensional hidl_array.\n";
+  out << "template <typename T, size_t SIZE>\n";
+  out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+         "hidl_array<T, SIZE> *value) {\n";
+  out.indent();
+  out << "for (size_t i = 0; i < SIZE; ++i) {\n";
+  out.indent();
+  out << "if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }\n";
+  out.unindent();
+  out << "}\n";
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+
+  for (const string &type : decoded_types_) {
+    GenerateReadFuzzInputForType(out, type_defs_.at(type));
+  }
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateReadFuzzInputForType(
+    Formatter &out, const VariableSpecificationMessage &def) {
+  string type = GetCppVariableType(def);
+  if (def.type() == TYPE_ENUM) {
+    int num_values = def.enum_value().enumerator_size();
+    out << "// Reads an index into the enumerators of " << type << ".\n";
+    out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+        << type << " *value) {\n";
+    out.indent();
+    out << "static const " << type << " kValues[] = {\n";
+    out.indent();
+    for (const auto &enumerator : def.enum_value().enumerator()) {
+      out << type << "::" << enumerator << ",\n";
+    }
+    out.unindent();
+    out << "};\n";
+    out << (num_values > 256 ? "uint16_t" : "uint8_t") << " index;\n";
+    out << "if (!ReadFuzzInput(data, size, &index)) { return false; }\n";
+    out << "*value = kValues[index % " << num_values << "];\n";
+  } else {
+    out << "// Reads the members of " << type << " in order.\n";
+    out << "static bool ReadFuzzInput(const uint8_t **data, size_t *size, "
+        << type << " *value) {\n";
+    out.indent();
+    for (const auto &member : def.struct_value()) {
+      out << "if (!ReadFuzzInput(data, size, &value->" << member.name()
+          << ")) { return false; }\n";
+    }
+  }
+  out << "return true;\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateLLVMFuzzerInitialize(
+    Formatter &out) {
+  out << "extern \"C\" int LLVMFuzzerInitialize(int * /* argc */, "
+         "char *** /* argv */) {\n";
+  out.indent();
+  out << "return 0;\n";
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateLLVMFuzzerTestOneInput(
+    Formatter &out) {
+  int num_funcs = called_funcs_.size();
+  out << "extern \"C\" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t "
+         "size) {\n";
+  out.indent();
+  out << "static ::android::sp<" << comp_spec_.component_name() << "> "
+      << GetHalPointerName() << " = " << comp_spec_.component_name()
+      << "::getService(true);\n";
+  out << "if (" << GetHalPointerName() << " == nullptr) {\n";
+  out.indent();
+  out << "cerr << \"" << comp_spec_.component_name()
+      << "::getService() failed\" << endl;\n";
+  out << "exit(1);\n";
+  out.unindent();
+  out << "}\n\n";
+  if (num_funcs == 0) {
+    out << "return 0;\n";
+    out.unindent();
+    out << "}\n\n";
+    return;
+  }
+
+  out << "for (size_t call = 0; call < kMaxCalls; ++call) {\n";
+  out.indent();
+  out << (num_funcs > 256 ? "uint16_t" : "uint8_t") << " func;\n";
+  out << "if (!ReadFuzzInput(&data, &size, &func)) { return 0; }\n";
+  out << "switch (func % " << num_funcs << ") {\n";
+  out.indent();
+  for (int i = 0; i < num_funcs; ++i) {
+    GenerateHalFunctionCase(out, comp_spec_.interface().api(called_funcs_[i]),
+                            i);
+  }
+  out.unindent();
+  out << "}\n";
+  out.unindent();
+  out << "}\n";
+  out << "return 0;\n";
+
+  out.unindent();
+  out << "}\n\n";
+}
+
+void HalHidlSequenceFuzzerCodeGen::GenerateHalFunctionCase(
+    Formatter &out, const FunctionSpecificationMessage &func_spec, int index) {
+  out << "case " << index << ": {\n";
+  out.indent();
+
+  vector<string> types{GetFuncArgTypes(func_spec)};
+  for (size_t i = 0; i < types.size(); ++i) {
+    out << types[i] << " arg" << i << ";\n";
+    out << "if (!ReadFuzzInput(&data, &size, &arg" << i
+        << ")) { return 0; }\n";
+  }
+  if (!types.empty()) {
+    out << "\n";
+  }
+  GenerateReturnCallback(out, func_spec);
+
+  out << GetHalPointerName() << "->" << func_spec.name() << "(";
+  for (size_t i = 0; i < types.size(); ++i) {
+    out << "arg" << i << ((i != types.size() - 1) ? ", " : "");
+  }
+  if (!CanElideCallback(func_spec)) {
+    if (func_spec.arg_size() > 0) {
+      out << ", ";
+    }
+    out << return_cb_name;
+  }
+  out << ");\n";
+  out << "break;\n";
+
+  out.unindent();
+  out << "}\n";
+}
+
+}  // namespace vts
+}  // namespace android
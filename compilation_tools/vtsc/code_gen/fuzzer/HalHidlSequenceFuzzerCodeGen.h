@@ -0,0 +1,82 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_FUZZER_HALHIDLSEQUENCEFUZZERCODEGEN_H_
+#define VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_FUZZER_HALHIDLSEQUENCEFUZZERCODEGEN_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "code_gen/fuzzer/HalHidlFuzzerCodeGen.h"
+
+namespace android {
+namespace vts {
+
+// Generates fuzzer code for HIDL HALs which calls a sequence of functions
+// per input, so the fuzzer can reach the states which only a series of
+// calls leads to. The input is decoded as records of a function index
+// followed by the args of that function; a hidl_vec or hidl_string arg is
+// a 16-bit length followed by its elements, a bool is the low bit of a byte,
+// an enum is an index into its enumerators and a struct is its members in
+// order. The enums and structs are looked up in the spec and in the specs it
+// imports from its own package, which are read from the dir of the spec; a
+// function which takes one that isn't found there is not called.
+class HalHidlSequenceFuzzerCodeGen : public HalHidlFuzzerCodeGen {
+ public:
+  HalHidlSequenceFuzzerCodeGen(const ComponentSpecificationMessage &comp_spec,
+                               const std::string &input_vts_file_path);
+
+  void GenerateSourceIncludeFiles(Formatter &out) override;
+  void GenerateUsingDeclaration(Formatter &out) override;
+  void GenerateGlobalVars(Formatter &out) override;
+  void GenerateLLVMFuzzerInitialize(Formatter &out) override;
+  void GenerateLLVMFuzzerTestOneInput(Formatter &out) override;
+
+ private:
+  // Generates the case of the function dispatch switch which calls the
+  // function at index.
+  void GenerateHalFunctionCase(Formatter &out,
+                               const FunctionSpecificationMessage &func_spec,
+                               int index);
+
+  // Adds the enums and structs defined in spec to type_defs_.
+  void AddTypeDefinitions(const VariableSpecificationMessage &var_spec);
+  void AddTypeDefinitions(const ComponentSpecificationMessage &spec);
+
+  // Adds the enums and structs which var_spec is made of to decoded_types_.
+  // Returns false, and puts its name in missing_type, if one of them has no
+  // definition.
+  bool AddDecodedTypes(const VariableSpecificationMessage &var_spec,
+                       std::string *missing_type);
+
+  // Generates the ReadFuzzInput overload of the enum or struct def.
+  void GenerateReadFuzzInputForType(Formatter &out,
+                                    const VariableSpecificationMessage &def);
+
+  // The enums and structs defined in the spec and its imports, by type name.
+  std::map<std::string, VariableSpecificationMessage> type_defs_;
+  // The enums and structs for which a ReadFuzzInput overload is generated,
+  // in the order they are first used.
+  std::vector<std::string> decoded_types_;
+  // The indexes of the functions which are called.
+  std::vector<int> called_funcs_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // VTS_COMPILATION_TOOLS_VTSC_CODE_GEN_FUZZER_HALHIDLSEQUENCEFUZZERCODEGEN_H_
@@ -1,4 +1,5 @@
 #include "test/vts/specification/hal/Nfc.vts.h"
+#include "vts_random.h"
 #include "vts_measurement.h"
 #include <iostream>
 #include <hidl/HidlSupport.h>
@@ -11,16 +12,34 @@
 using namespace android::hardware::nfc::V1_0;
 namespace android {
 namespace vts {
+namespace {
+// Marks the service of a fuzzer as dead.
+struct ServiceDeathRecipient : public ::android::hardware::hidl_death_recipient {
+    explicit ServiceDeathRecipient(FuzzerBase* fuzzer) : fuzzer_(fuzzer) {}
+    void serviceDied(uint64_t /*cookie*/, const ::android::wp<::android::hidl::base::V1_0::IBase>& /*who*/) override {
+        fuzzer_->SetServiceDied();
+    }
+    FuzzerBase* fuzzer_;
+};
+}  // namespace
+
 bool FuzzerExtended_android_hardware_nfc_V1_0_INfc::GetService(bool get_stub, const char* service_name) {
-    static bool initialized = false;
-    if (!initialized) {
+    if (hw_binder_proxy_ == nullptr || HasServiceDied()) {
         cout << "[agent:hal] HIDL getService" << endl;
         if (service_name) {
           cout << "  - service name: " << service_name << endl;
         }
         hw_binder_proxy_ = ::android::hardware::nfc::V1_0::INfc::getService(service_name, get_stub);
         cout << "[agent:hal] hw_binder_proxy_ = " << hw_binder_proxy_.get() << endl;
-        initialized = true;
+        if (hw_binder_proxy_ == nullptr) {
+            return false;
+        }
+        sp<ServiceDeathRecipient> recipient = new ServiceDeathRecipient(this);
+        ::android::hardware::Return<bool> linked = hw_binder_proxy_->linkToDeath(recipient, 0 /*cookie*/);
+        if (!linked.isOk() || !linked) {
+            cerr << "[agent:hal] can't link to the death of the service" << endl;
+        }
+        SetServiceDeathRecipient(recipient);
     }
     return true;
 }
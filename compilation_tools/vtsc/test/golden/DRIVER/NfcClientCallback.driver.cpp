@@ -1,4 +1,5 @@
 #include "test/vts/specification/hal/NfcClientCallback.vts.h"
+#include "vts_random.h"
 #include "vts_measurement.h"
 #include <iostream>
 #include <hidl/HidlSupport.h>
@@ -1,4 +1,5 @@
 #include "test/vts/specification/hal/types.vts.h"
+#include "vts_random.h"
 #include "vts_measurement.h"
 #include <iostream>
 #include <hidl/HidlSupport.h>
@@ -12,15 +13,16 @@ namespace vts {
     return (::android::hardware::nfc::V1_0::NfcEvent) arg.uint32_t();
 }
 ::android::hardware::nfc::V1_0::NfcEvent Random__android__hardware__nfc__V1_0__NfcEvent() {
-    uint32_t choice = (uint32_t) rand() / 7;
-    if (choice == (uint32_t) 0) return ::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT;
-    if (choice == (uint32_t) 1) return ::android::hardware::nfc::V1_0::NfcEvent::CLOSE_CPLT;
-    if (choice == (uint32_t) 2) return ::android::hardware::nfc::V1_0::NfcEvent::POST_INIT_CPLT;
-    if (choice == (uint32_t) 3) return ::android::hardware::nfc::V1_0::NfcEvent::PRE_DISCOVER_CPLT;
-    if (choice == (uint32_t) 4) return ::android::hardware::nfc::V1_0::NfcEvent::REQUEST_CONTROL;
-    if (choice == (uint32_t) 5) return ::android::hardware::nfc::V1_0::NfcEvent::RELEASE_CONTROL;
-    if (choice == (uint32_t) 6) return ::android::hardware::nfc::V1_0::NfcEvent::ERROR;
-    return ::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT;
+    static const ::android::hardware::nfc::V1_0::NfcEvent kValues[] = {
+        ::android::hardware::nfc::V1_0::NfcEvent::OPEN_CPLT,
+        ::android::hardware::nfc::V1_0::NfcEvent::CLOSE_CPLT,
+        ::android::hardware::nfc::V1_0::NfcEvent::POST_INIT_CPLT,
+        ::android::hardware::nfc::V1_0::NfcEvent::PRE_DISCOVER_CPLT,
+        ::android::hardware::nfc::V1_0::NfcEvent::REQUEST_CONTROL,
+        ::android::hardware::nfc::V1_0::NfcEvent::RELEASE_CONTROL,
+        ::android::hardware::nfc::V1_0::NfcEvent::ERROR,
+    };
+    return RandomChoice(kValues, 7);
 }
 bool Verify__android__hardware__nfc__V1_0__NfcEvent(const VariableSpecificationMessage& expected_result, const VariableSpecificationMessage& actual_result){
     if (actual_result.scalar_value().uint32_t() != expected_result.scalar_value().uint32_t()) { return false; }
@@ -37,13 +39,14 @@ void SetResult__android__hardware__nfc__V1_0__NfcEvent(VariableSpecificationMess
     return (::android::hardware::nfc::V1_0::NfcStatus) arg.uint32_t();
 }
 ::android::hardware::nfc::V1_0::NfcStatus Random__android__hardware__nfc__V1_0__NfcStatus() {
-    uint32_t choice = (uint32_t) rand() / 5;
-    if (choice == (uint32_t) 0) return ::android::hardware::nfc::V1_0::NfcStatus::OK;
-    if (choice == (uint32_t) 1) return ::android::hardware::nfc::V1_0::NfcStatus::FAILED;
-    if (choice == (uint32_t) 2) return ::android::hardware::nfc::V1_0::NfcStatus::ERR_TRANSPORT;
-    if (choice == (uint32_t) 3) return ::android::hardware::nfc::V1_0::NfcStatus::ERR_CMD_TIMEOUT;
-    if (choice == (uint32_t) 4) return ::android::hardware::nfc::V1_0::NfcStatus::REFUSED;
-    return ::android::hardware::nfc::V1_0::NfcStatus::OK;
+    static const ::android::hardware::nfc::V1_0::NfcStatus kValues[] = {
+        ::android::hardware::nfc::V1_0::NfcStatus::OK,
+        ::android::hardware::nfc::V1_0::NfcStatus::FAILED,
+        ::android::hardware::nfc::V1_0::NfcStatus::ERR_TRANSPORT,
+        ::android::hardware::nfc::V1_0::NfcStatus::ERR_CMD_TIMEOUT,
+        ::android::hardware::nfc::V1_0::NfcStatus::REFUSED,
+    };
+    return RandomChoice(kValues, 5);
 }
 bool Verify__android__hardware__nfc__V1_0__NfcStatus(const VariableSpecificationMessage& expected_result, const VariableSpecificationMessage& actual_result){
     if (actual_result.scalar_value().uint32_t() != expected_result.scalar_value().uint32_t()) { return false; }
@@ -0,0 +1,1212 @@
+// This file was auto-generated by VTS compiler.
+
+#include <string.h>
+
+#include <iostream>
+#include <type_traits>
+
+#include <android/hardware/renderscript/1.0/IContext.h>
+
+using std::cerr;
+using std::endl;
+
+using namespace ::android::hardware::renderscript::V1_0;
+using namespace ::android::hardware;
+
+namespace android {
+namespace vts {
+
+// The most calls made for one input.
+static const size_t kMaxCalls = 64;
+// The most elements decoded into one hidl_vec or hidl_string.
+static const size_t kMaxElements = 256;
+
+// Reads a value from the front of the input. Returns false if the input is
+// too short.
+template <typename T>
+static typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+ReadFuzzInput(const uint8_t **data, size_t *size, T *value) {
+    if (*size < sizeof(T)) { return false; }
+    memcpy(value, *data, sizeof(T));
+    *data += sizeof(T);
+    *size -= sizeof(T);
+    return true;
+}
+
+// Leaves a value which can't be copied from the input (e.g., a handle or an
+// interface) default constructed.
+template <typename T>
+static typename std::enable_if<!std::is_trivially_copyable<T>::value, bool>::type
+ReadFuzzInput(const uint8_t ** /* data */, size_t * /* size */, T * /* value */) {
+    return true;
+}
+
+// Reads a bool from the low bit of a byte, as a bool of any other value is
+// undefined.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, bool *value) {
+    uint8_t byte;
+    if (!ReadFuzzInput(data, size, &byte)) { return false; }
+    *value = byte & 1;
+    return true;
+}
+
+// Reads the enums and structs which the functions take; defined below.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationMipmapControl *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationCubemapFace *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationUsageType *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::DataType *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::DataKind *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::YuvFormat *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ThreadPriorities *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::SamplerValue *value);
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ScriptIntrinsicID *value);
+
+// Reads a 16-bit length and then that many chars, up to kMaxElements.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_string *value) {
+    uint16_t length;
+    if (!ReadFuzzInput(data, size, &length)) { return false; }
+    length %= kMaxElements + 1;
+    if (*size < length) { return false; }
+    *value = hidl_string(reinterpret_cast<const char *>(*data), length);
+    *data += length;
+    *size -= length;
+    return true;
+}
+
+// Reads a 16-bit length and then that many elements, up to kMaxElements.
+template <typename T>
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_vec<T> *value) {
+    uint16_t length;
+    if (!ReadFuzzInput(data, size, &length)) { return false; }
+    value->resize(length % (kMaxElements + 1));
+    for (size_t i = 0; i < value->size(); ++i) {
+        if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }
+    }
+    return true;
+}
+
+// Reads the elements of a one-dimensional hidl_array.
+template <typename T, size_t SIZE>
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_array<T, SIZE> *value) {
+    for (size_t i = 0; i < SIZE; ++i) {
+        if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }
+    }
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::AllocationMipmapControl.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationMipmapControl *value) {
+    static const ::android::hardware::renderscript::V1_0::AllocationMipmapControl kValues[] = {
+        ::android::hardware::renderscript::V1_0::AllocationMipmapControl::NONE,
+        ::android::hardware::renderscript::V1_0::AllocationMipmapControl::FULL,
+        ::android::hardware::renderscript::V1_0::AllocationMipmapControl::ON_SYNC_TO_TEXTURE,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 3];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::AllocationCubemapFace.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationCubemapFace *value) {
+    static const ::android::hardware::renderscript::V1_0::AllocationCubemapFace kValues[] = {
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::POSITIVE_X,
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::NEGATIVE_X,
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::POSITIVE_Y,
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::NEGATIVE_Y,
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::POSITIVE_Z,
+        ::android::hardware::renderscript::V1_0::AllocationCubemapFace::NEGATIVE_Z,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 6];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::AllocationUsageType.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::AllocationUsageType *value) {
+    static const ::android::hardware::renderscript::V1_0::AllocationUsageType kValues[] = {
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::SCRIPT,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::GRAPHICS_TEXTURE,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::GRAPHICS_VERTEX,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::GRAPHICS_CONSTANTS,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::GRAPHICS_RENDER_TARGET,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::IO_INPUT,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::IO_OUTPUT,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::SHARED,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::OEM,
+        ::android::hardware::renderscript::V1_0::AllocationUsageType::ALL,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 10];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::DataType.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::DataType *value) {
+    static const ::android::hardware::renderscript::V1_0::DataType kValues[] = {
+        ::android::hardware::renderscript::V1_0::DataType::NONE,
+        ::android::hardware::renderscript::V1_0::DataType::FLOAT_16,
+        ::android::hardware::renderscript::V1_0::DataType::FLOAT_32,
+        ::android::hardware::renderscript::V1_0::DataType::FLOAT_64,
+        ::android::hardware::renderscript::V1_0::DataType::SIGNED_8,
+        ::android::hardware::renderscript::V1_0::DataType::SIGNED_16,
+        ::android::hardware::renderscript::V1_0::DataType::SIGNED_32,
+        ::android::hardware::renderscript::V1_0::DataType::SIGNED_64,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_8,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_16,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_32,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_64,
+        ::android::hardware::renderscript::V1_0::DataType::BOOLEAN,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_5_6_5,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_5_5_5_1,
+        ::android::hardware::renderscript::V1_0::DataType::UNSIGNED_4_4_4_4,
+        ::android::hardware::renderscript::V1_0::DataType::MATRIX_4X4,
+        ::android::hardware::renderscript::V1_0::DataType::MATRIX_3X3,
+        ::android::hardware::renderscript::V1_0::DataType::MATRIX_2X2,
+        ::android::hardware::renderscript::V1_0::DataType::RS_ELEMENT,
+        ::android::hardware::renderscript::V1_0::DataType::RS_TYPE,
+        ::android::hardware::renderscript::V1_0::DataType::RS_ALLOCATION,
+        ::android::hardware::renderscript::V1_0::DataType::RS_SAMPLER,
+        ::android::hardware::renderscript::V1_0::DataType::RS_SCRIPT,
+        ::android::hardware::renderscript::V1_0::DataType::RS_MESH,
+        ::android::hardware::renderscript::V1_0::DataType::RS_PROGRAM_FRAGMENT,
+        ::android::hardware::renderscript::V1_0::DataType::RS_PROGRAM_VERTEX,
+        ::android::hardware::renderscript::V1_0::DataType::RS_PROGRAM_RASTER,
+        ::android::hardware::renderscript::V1_0::DataType::RS_PROGRAM_STORE,
+        ::android::hardware::renderscript::V1_0::DataType::RS_FONT,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 30];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::DataKind.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::DataKind *value) {
+    static const ::android::hardware::renderscript::V1_0::DataKind kValues[] = {
+        ::android::hardware::renderscript::V1_0::DataKind::USER,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_L,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_A,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_LA,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_RGB,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_RGBA,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_DEPTH,
+        ::android::hardware::renderscript::V1_0::DataKind::PIXEL_YUV,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 8];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::YuvFormat.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::YuvFormat *value) {
+    static const ::android::hardware::renderscript::V1_0::YuvFormat kValues[] = {
+        ::android::hardware::renderscript::V1_0::YuvFormat::YUV_NONE,
+        ::android::hardware::renderscript::V1_0::YuvFormat::YUV_YV12,
+        ::android::hardware::renderscript::V1_0::YuvFormat::YUV_NV21,
+        ::android::hardware::renderscript::V1_0::YuvFormat::YUV_420_888,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 4];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::ThreadPriorities.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ThreadPriorities *value) {
+    static const ::android::hardware::renderscript::V1_0::ThreadPriorities kValues[] = {
+        ::android::hardware::renderscript::V1_0::ThreadPriorities::LOW,
+        ::android::hardware::renderscript::V1_0::ThreadPriorities::NORMAL_GRAPHICS,
+        ::android::hardware::renderscript::V1_0::ThreadPriorities::NORMAL,
+        ::android::hardware::renderscript::V1_0::ThreadPriorities::LOW_LATENCY,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 4];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::SamplerValue.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::SamplerValue *value) {
+    static const ::android::hardware::renderscript::V1_0::SamplerValue kValues[] = {
+        ::android::hardware::renderscript::V1_0::SamplerValue::NEAREST,
+        ::android::hardware::renderscript::V1_0::SamplerValue::LINEAR,
+        ::android::hardware::renderscript::V1_0::SamplerValue::LINEAR_MIP_LINEAR,
+        ::android::hardware::renderscript::V1_0::SamplerValue::WRAP,
+        ::android::hardware::renderscript::V1_0::SamplerValue::CLAMP,
+        ::android::hardware::renderscript::V1_0::SamplerValue::LINEAR_MIP_NEAREST,
+        ::android::hardware::renderscript::V1_0::SamplerValue::MIRRORED_REPEAT,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 7];
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::ScriptIntrinsicID.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ScriptIntrinsicID *value) {
+    static const ::android::hardware::renderscript::V1_0::ScriptIntrinsicID kValues[] = {
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_UNDEFINED,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_CONVOLVE_3x3,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_COLOR_MATRIX,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_LUT,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_CONVOLVE_5x5,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_BLUR,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_YUV_TO_RGB,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_BLEND,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_3DLUT,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_HISTOGRAM,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_RESIZE,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_BLAS,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_EXTBLAS,
+        ::android::hardware::renderscript::V1_0::ScriptIntrinsicID::ID_OEM_START,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 14];
+    return true;
+}
+
+extern "C" int LLVMFuzzerInitialize(int * /* argc */, char *** /* argv */) {
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static ::android::sp<IContext> renderscript = IContext::getService(true);
+    if (renderscript == nullptr) {
+        cerr << "IContext::getService() failed" << endl;
+        exit(1);
+    }
+
+    for (size_t call = 0; call < kMaxCalls; ++call) {
+        uint8_t func;
+        if (!ReadFuzzInput(&data, &size, &func)) { return 0; }
+        switch (func % 76) {
+            case 0: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationAdapterCreate(arg0, arg1);
+                break;
+            }
+            case 1: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_vec<uint32_t> arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationAdapterOffset(arg0, arg1);
+                break;
+            }
+            case 2: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->allocationGetType(arg0);
+                break;
+            }
+            case 3: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                void* arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->allocationCreateTyped(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 4: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                int32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->allocationCreateFromBitmap(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 5: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationMipmapControl arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                int32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->allocationCubeCreateFromBitmap(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 6: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->allocationGetNativeWindow(arg0);
+                break;
+            }
+            case 7: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationSetNativeWindow(arg0, arg1);
+                break;
+            }
+            case 8: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationSetupBufferQueue(arg0, arg1);
+                break;
+            }
+            case 9: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationShareBufferQueue(arg0, arg1);
+                break;
+            }
+            case 10: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                void* arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->allocationCopyToBitmap(arg0, arg1, arg2);
+                break;
+            }
+            case 11: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+
+                renderscript->allocation1DWrite(arg0, arg1, arg2, arg3, arg4);
+                break;
+            }
+            case 12: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                uint32_t arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint64_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+
+                renderscript->allocationElementWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+                break;
+            }
+            case 13: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                uint64_t arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+
+                renderscript->allocation2DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8);
+                break;
+            }
+            case 14: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                uint32_t arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                uint32_t arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+                uint64_t arg9;
+                if (!ReadFuzzInput(&data, &size, &arg9)) { return 0; }
+
+                renderscript->allocation3DWrite(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
+                break;
+            }
+            case 15: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->allocationGenerateMipmaps(arg0);
+                break;
+            }
+            case 16: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                void* arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->allocationRead(arg0, arg1, arg2);
+                break;
+            }
+            case 17: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                void* arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint64_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+
+                renderscript->allocation1DRead(arg0, arg1, arg2, arg3, arg4, arg5);
+                break;
+            }
+            case 18: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                uint32_t arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                void* arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint64_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                uint64_t arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+
+                renderscript->allocationElementRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7);
+                break;
+            }
+            case 19: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                void* arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                uint64_t arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+                uint64_t arg9;
+                if (!ReadFuzzInput(&data, &size, &arg9)) { return 0; }
+
+                renderscript->allocation2DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9);
+                break;
+            }
+            case 20: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                uint32_t arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                uint32_t arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                void* arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+                uint64_t arg9;
+                if (!ReadFuzzInput(&data, &size, &arg9)) { return 0; }
+                uint64_t arg10;
+                if (!ReadFuzzInput(&data, &size, &arg10)) { return 0; }
+
+                renderscript->allocation3DRead(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10);
+                break;
+            }
+            case 21: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationUsageType arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationSyncAll(arg0, arg1);
+                break;
+            }
+            case 22: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->allocationResize1D(arg0, arg1);
+                break;
+            }
+            case 23: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                uint64_t arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                uint32_t arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+                uint32_t arg9;
+                if (!ReadFuzzInput(&data, &size, &arg9)) { return 0; }
+                uint32_t arg10;
+                if (!ReadFuzzInput(&data, &size, &arg10)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg11;
+                if (!ReadFuzzInput(&data, &size, &arg11)) { return 0; }
+
+                renderscript->allocationCopy2DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11);
+                break;
+            }
+            case 24: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                uint32_t arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                uint32_t arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                uint32_t arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+                uint32_t arg7;
+                if (!ReadFuzzInput(&data, &size, &arg7)) { return 0; }
+                uint64_t arg8;
+                if (!ReadFuzzInput(&data, &size, &arg8)) { return 0; }
+                uint32_t arg9;
+                if (!ReadFuzzInput(&data, &size, &arg9)) { return 0; }
+                uint32_t arg10;
+                if (!ReadFuzzInput(&data, &size, &arg10)) { return 0; }
+                uint32_t arg11;
+                if (!ReadFuzzInput(&data, &size, &arg11)) { return 0; }
+                uint32_t arg12;
+                if (!ReadFuzzInput(&data, &size, &arg12)) { return 0; }
+
+                renderscript->allocationCopy3DRange(arg0, arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10, arg11, arg12);
+                break;
+            }
+            case 25: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->allocationIoSend(arg0);
+                break;
+            }
+            case 26: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->allocationIoReceive(arg0);
+                break;
+            }
+            case 27: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::renderscript::V1_0::AllocationCubemapFace arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](void* arg0, uint64_t arg1){};
+
+                renderscript->allocationGetPointer(arg0, arg1, arg2, arg3, hidl_cb);
+                break;
+            }
+            case 28: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](const ::android::hardware::hidl_vec<uint32_t>& arg0){};
+
+                renderscript->elementGetNativeMetadata(arg0, hidl_cb);
+                break;
+            }
+            case 29: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0, const ::android::hardware::hidl_vec<::android::hardware::hidl_string>& arg1, const ::android::hardware::hidl_vec<uint64_t>& arg2){};
+
+                renderscript->elementGetSubElements(arg0, arg1, hidl_cb);
+                break;
+            }
+            case 30: {
+                ::android::hardware::renderscript::V1_0::DataType arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::DataKind arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                bool arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->elementCreate(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 31: {
+                ::android::hardware::hidl_vec<uint64_t> arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_vec<::android::hardware::hidl_string> arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->elementComplexCreate(arg0, arg1, arg2);
+                break;
+            }
+            case 32: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](const ::android::hardware::hidl_vec<uint64_t>& arg0){};
+
+                renderscript->typeGetNativeMetadata(arg0, hidl_cb);
+                break;
+            }
+            case 33: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                bool arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                bool arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                ::android::hardware::renderscript::V1_0::YuvFormat arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+
+                renderscript->typeCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+                break;
+            }
+            case 34: {
+                renderscript->contextDestroy();
+                break;
+            }
+            case 35: {
+                void* arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1){};
+
+                renderscript->contextGetMessage(arg0, arg1, hidl_cb);
+                break;
+            }
+            case 36: {
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](::android::hardware::renderscript::V1_0::MessageToClientType arg0, uint64_t arg1, uint32_t arg2){};
+
+                renderscript->contextPeekMessage(hidl_cb);
+                break;
+            }
+            case 37: {
+                uint32_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->contextSendMessage(arg0, arg1);
+                break;
+            }
+            case 38: {
+                renderscript->contextInitToClient();
+                break;
+            }
+            case 39: {
+                renderscript->contextDeinitToClient();
+                break;
+            }
+            case 40: {
+                renderscript->contextFinish();
+                break;
+            }
+            case 41: {
+                renderscript->contextLog();
+                break;
+            }
+            case 42: {
+                ::android::hardware::hidl_string arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->contextSetCacheDir(arg0);
+                break;
+            }
+            case 43: {
+                ::android::hardware::renderscript::V1_0::ThreadPriorities arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->contextSetPriority(arg0);
+                break;
+            }
+            case 44: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_string arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->assignName(arg0, arg1);
+                break;
+            }
+            case 45: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](const ::android::hardware::hidl_string& arg0){};
+
+                renderscript->getName(arg0, hidl_cb);
+                break;
+            }
+            case 46: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                ::android::hardware::hidl_vec<int64_t> arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<int32_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg6;
+                if (!ReadFuzzInput(&data, &size, &arg6)) { return 0; }
+
+                renderscript->closureCreate(arg0, arg1, arg2, arg3, arg4, arg5, arg6);
+                break;
+            }
+            case 47: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                ::android::hardware::hidl_vec<int64_t> arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<int32_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+
+                renderscript->invokeClosureCreate(arg0, arg1, arg2, arg3, arg4);
+                break;
+            }
+            case 48: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                void* arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                int32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->closureSetArg(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 49: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                int32_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+
+                renderscript->closureSetGlobal(arg0, arg1, arg2, arg3);
+                break;
+            }
+            case 50: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                int32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptKernelIDCreate(arg0, arg1, arg2);
+                break;
+            }
+            case 51: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                int32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->scriptInvokeIDCreate(arg0, arg1);
+                break;
+            }
+            case 52: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                int32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->scriptFieldIDCreate(arg0, arg1);
+                break;
+            }
+            case 53: {
+                ::android::hardware::hidl_vec<uint64_t> arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+
+                renderscript->scriptGroupCreate(arg0, arg1, arg2, arg3, arg4);
+                break;
+            }
+            case 54: {
+                ::android::hardware::hidl_string arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_string arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptGroup2Create(arg0, arg1, arg2);
+                break;
+            }
+            case 55: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptGroupSetOutput(arg0, arg1, arg2);
+                break;
+            }
+            case 56: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptGroupSetInput(arg0, arg1, arg2);
+                break;
+            }
+            case 57: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->scriptGroupExecute(arg0);
+                break;
+            }
+            case 58: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+
+                renderscript->objDestroy(arg0);
+                break;
+            }
+            case 59: {
+                ::android::hardware::renderscript::V1_0::SamplerValue arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::SamplerValue arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::renderscript::V1_0::SamplerValue arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                ::android::hardware::renderscript::V1_0::SamplerValue arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::renderscript::V1_0::SamplerValue arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                float arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+
+                renderscript->samplerCreate(arg0, arg1, arg2, arg3, arg4, arg5);
+                break;
+            }
+            case 60: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptBindAllocation(arg0, arg1, arg2);
+                break;
+            }
+            case 61: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_string arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->scriptSetTimeZone(arg0, arg1);
+                break;
+            }
+            case 62: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->scriptInvoke(arg0, arg1);
+                break;
+            }
+            case 63: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptInvokeV(arg0, arg1, arg2);
+                break;
+            }
+            case 64: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint64_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+                void* arg5;
+                if (!ReadFuzzInput(&data, &size, &arg5)) { return 0; }
+
+                renderscript->scriptForEach(arg0, arg1, arg2, arg3, arg4, arg5);
+                break;
+            }
+            case 65: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint64_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint64_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                void* arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+
+                renderscript->scriptReduce(arg0, arg1, arg2, arg3, arg4);
+                break;
+            }
+            case 66: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarI(arg0, arg1, arg2);
+                break;
+            }
+            case 67: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarObj(arg0, arg1, arg2);
+                break;
+            }
+            case 68: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarJ(arg0, arg1, arg2);
+                break;
+            }
+            case 69: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                float arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarF(arg0, arg1, arg2);
+                break;
+            }
+            case 70: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                double arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarD(arg0, arg1, arg2);
+                break;
+            }
+            case 71: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptSetVarV(arg0, arg1, arg2);
+                break;
+            }
+            case 72: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                uint64_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                // No-op. Only need this to make HAL function call.
+                auto hidl_cb = [](const ::android::hardware::hidl_vec<uint8_t>& arg0){};
+
+                renderscript->scriptGetVarV(arg0, arg1, arg2, hidl_cb);
+                break;
+            }
+            case 73: {
+                uint64_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint32_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+                uint64_t arg3;
+                if (!ReadFuzzInput(&data, &size, &arg3)) { return 0; }
+                ::android::hardware::hidl_vec<uint32_t> arg4;
+                if (!ReadFuzzInput(&data, &size, &arg4)) { return 0; }
+
+                renderscript->scriptSetVarVE(arg0, arg1, arg2, arg3, arg4);
+                break;
+            }
+            case 74: {
+                ::android::hardware::hidl_string arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::hidl_string arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                ::android::hardware::hidl_vec<uint8_t> arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->scriptCCreate(arg0, arg1, arg2);
+                break;
+            }
+            case 75: {
+                ::android::hardware::renderscript::V1_0::ScriptIntrinsicID arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                uint64_t arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+
+                renderscript->scriptIntrinsicCreate(arg0, arg1);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+}  // namespace vts
+}  // namespace android
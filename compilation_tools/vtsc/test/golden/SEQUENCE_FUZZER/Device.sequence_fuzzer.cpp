@@ -0,0 +1,134 @@
+// This file was auto-generated by VTS compiler.
+
+#include <string.h>
+
+#include <iostream>
+#include <type_traits>
+
+#include <android/hardware/renderscript/1.0/IDevice.h>
+
+using std::cerr;
+using std::endl;
+
+using namespace ::android::hardware::renderscript::V1_0;
+using namespace ::android::hardware;
+
+namespace android {
+namespace vts {
+
+// The most calls made for one input.
+static const size_t kMaxCalls = 64;
+// The most elements decoded into one hidl_vec or hidl_string.
+static const size_t kMaxElements = 256;
+
+// Reads a value from the front of the input. Returns false if the input is
+// too short.
+template <typename T>
+static typename std::enable_if<std::is_trivially_copyable<T>::value, bool>::type
+ReadFuzzInput(const uint8_t **data, size_t *size, T *value) {
+    if (*size < sizeof(T)) { return false; }
+    memcpy(value, *data, sizeof(T));
+    *data += sizeof(T);
+    *size -= sizeof(T);
+    return true;
+}
+
+// Leaves a value which can't be copied from the input (e.g., a handle or an
+// interface) default constructed.
+template <typename T>
+static typename std::enable_if<!std::is_trivially_copyable<T>::value, bool>::type
+ReadFuzzInput(const uint8_t ** /* data */, size_t * /* size */, T * /* value */) {
+    return true;
+}
+
+// Reads a bool from the low bit of a byte, as a bool of any other value is
+// undefined.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, bool *value) {
+    uint8_t byte;
+    if (!ReadFuzzInput(data, size, &byte)) { return false; }
+    *value = byte & 1;
+    return true;
+}
+
+// Reads the enums and structs which the functions take; defined below.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ContextType *value);
+
+// Reads a 16-bit length and then that many chars, up to kMaxElements.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_string *value) {
+    uint16_t length;
+    if (!ReadFuzzInput(data, size, &length)) { return false; }
+    length %= kMaxElements + 1;
+    if (*size < length) { return false; }
+    *value = hidl_string(reinterpret_cast<const char *>(*data), length);
+    *data += length;
+    *size -= length;
+    return true;
+}
+
+// Reads a 16-bit length and then that many elements, up to kMaxElements.
+template <typename T>
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_vec<T> *value) {
+    uint16_t length;
+    if (!ReadFuzzInput(data, size, &length)) { return false; }
+    value->resize(length % (kMaxElements + 1));
+    for (size_t i = 0; i < value->size(); ++i) {
+        if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }
+    }
+    return true;
+}
+
+// Reads the elements of a one-dimensional hidl_array.
+template <typename T, size_t SIZE>
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, hidl_array<T, SIZE> *value) {
+    for (size_t i = 0; i < SIZE; ++i) {
+        if (!ReadFuzzInput(data, size, &(*value)[i])) { return false; }
+    }
+    return true;
+}
+
+// Reads an index into the enumerators of ::android::hardware::renderscript::V1_0::ContextType.
+static bool ReadFuzzInput(const uint8_t **data, size_t *size, ::android::hardware::renderscript::V1_0::ContextType *value) {
+    static const ::android::hardware::renderscript::V1_0::ContextType kValues[] = {
+        ::android::hardware::renderscript::V1_0::ContextType::NORMAL,
+        ::android::hardware::renderscript::V1_0::ContextType::DEBUG,
+        ::android::hardware::renderscript::V1_0::ContextType::PROFILE,
+    };
+    uint8_t index;
+    if (!ReadFuzzInput(data, size, &index)) { return false; }
+    *value = kValues[index % 3];
+    return true;
+}
+
+extern "C" int LLVMFuzzerInitialize(int * /* argc */, char *** /* argv */) {
+    return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    static ::android::sp<IDevice> renderscript = IDevice::getService(true);
+    if (renderscript == nullptr) {
+        cerr << "IDevice::getService() failed" << endl;
+        exit(1);
+    }
+
+    for (size_t call = 0; call < kMaxCalls; ++call) {
+        uint8_t func;
+        if (!ReadFuzzInput(&data, &size, &func)) { return 0; }
+        switch (func % 1) {
+            case 0: {
+                uint32_t arg0;
+                if (!ReadFuzzInput(&data, &size, &arg0)) { return 0; }
+                ::android::hardware::renderscript::V1_0::ContextType arg1;
+                if (!ReadFuzzInput(&data, &size, &arg1)) { return 0; }
+                int32_t arg2;
+                if (!ReadFuzzInput(&data, &size, &arg2)) { return 0; }
+
+                renderscript->contextCreate(arg0, arg1, arg2);
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+}  // namespace vts
+}  // namespace android
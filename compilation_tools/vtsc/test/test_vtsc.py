@@ -120,6 +120,10 @@ class VtscTester(unittest.TestCase):
             self.RunTest("FUZZER",
                          os.path.join(self._temp_dir, component_name + ".vts"),
                          "%s.fuzzer.cpp" % component_name, "SOURCE")
+        for component_name in ["Context", "Device"]:
+            self.RunTest("SEQUENCE_FUZZER",
+                         os.path.join(self._temp_dir, component_name + ".vts"),
+                         "%s.sequence_fuzzer.cpp" % component_name, "SOURCE")
 
     def RunFuzzerTest(self, mode, vts_file_path, source_file_name):
         vtsc_cmd = [
@@ -0,0 +1,422 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fuzz_tester/FuzzCoverageScheduler.h"
+
+#include <ctype.h>
+#include <float.h>
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <random>
+
+using namespace google::protobuf;
+
+namespace android {
+namespace vts {
+
+// the percentage of the inputs of a function which are fresh once it has a
+// corpus.
+static const uint32_t kFreshInputPercent = 20;
+// the max number of inputs kept in the corpus of a function.
+static const size_t kMaxCorpusEntries = 256;
+// the max number of scalars mutated in an input.
+static const size_t kMaxMutatedScalars = 4;
+// the factor by which the energy of a function or a scalar decays each time
+// it's called or mutated, and the weight of the energy when picking them.
+static const double kEnergyDecay = 0.9;
+static const double kEnergyWeight = 10.0;
+// the max delta of an arithmetic mutation.
+static const uint32_t kMaxArithmeticDelta = 35;
+
+static const int64_t kInterestingIntegers[] = {
+    0, 1, -1, 2, 16, 32, 64, 100, 127, -128, 128, 255, 256, 1024, 4096,
+    32767, -32768, 65535, 65536, numeric_limits<int32_t>::max(),
+    numeric_limits<int32_t>::min(), numeric_limits<int64_t>::max(),
+    numeric_limits<int64_t>::min()};
+
+static const double kInterestingFloats[] = {
+    0.0, 1.0, -1.0, 0.5, 100.0, -100.0, FLT_MIN, FLT_MAX, -FLT_MAX,
+    numeric_limits<double>::infinity()};
+
+// Returns the bucket (as a bit) of a counter hit count times.
+static uint8_t CountBucket(uint32_t count) {
+  if (count <= 3) return 1 << (count - 1);
+  if (count < 8) return 1 << 3;
+  if (count < 16) return 1 << 4;
+  if (count < 32) return 1 << 5;
+  if (count < 128) return 1 << 6;
+  return 1 << 7;
+}
+
+// Returns the field of ScalarDataValueMessage which holds the value of var if
+// it's a number, or NULL (e.g., for a pointer).
+static const FieldDescriptor* GetScalarValueField(
+    const VariableSpecificationMessage& var) {
+  const string& scalar_type = var.scalar_type();
+  if (scalar_type.empty() || scalar_type.find("pointer") != string::npos ||
+      scalar_type == "opaque") {
+    return NULL;
+  }
+  return ScalarDataValueMessage::descriptor()->FindFieldByName(scalar_type);
+}
+
+// Returns the number of bits of the values of var's scalar type.
+static int GetScalarBits(const VariableSpecificationMessage& var) {
+  const string& scalar_type = var.scalar_type();
+  if (scalar_type == "bool_t") return 1;
+  if (scalar_type == "char" || scalar_type == "uchar" ||
+      scalar_type.find("int8_t") != string::npos) {
+    return 8;
+  }
+  if (scalar_type.find("int16_t") != string::npos) return 16;
+  if (scalar_type.find("int64_t") != string::npos) return 64;
+  return 32;
+}
+
+// Gets the bits of the integer in field of value.
+static uint64_t GetIntegerBits(const Message& value,
+                               const FieldDescriptor* field) {
+  const Reflection* reflection = value.GetReflection();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      return (uint64_t)(int64_t)reflection->GetInt32(value, field);
+    case FieldDescriptor::CPPTYPE_UINT32:
+      return reflection->GetUInt32(value, field);
+    case FieldDescriptor::CPPTYPE_INT64:
+      return (uint64_t)reflection->GetInt64(value, field);
+    default:
+      return reflection->GetUInt64(value, field);
+  }
+}
+
+// Sets the integer in field of value to the low bits bits of value_bits,
+// sign-extended if the field is signed.
+static void SetIntegerBits(Message* value, const FieldDescriptor* field,
+                           int bits, uint64_t value_bits) {
+  if (bits < 64) {
+    value_bits &= (1ULL << bits) - 1;
+    if (bits > 1 && (field->cpp_type() == FieldDescriptor::CPPTYPE_INT32 ||
+                     field->cpp_type() == FieldDescriptor::CPPTYPE_INT64) &&
+        (value_bits >> (bits - 1)) & 1) {
+      value_bits |= ~((1ULL << bits) - 1);
+    }
+  }
+  const Reflection* reflection = value->GetReflection();
+  switch (field->cpp_type()) {
+    case FieldDescriptor::CPPTYPE_INT32:
+      reflection->SetInt32(value, field, (int32_t)value_bits);
+      break;
+    case FieldDescriptor::CPPTYPE_UINT32:
+      reflection->SetUInt32(value, field, (uint32_t)value_bits);
+      break;
+    case FieldDescriptor::CPPTYPE_INT64:
+      reflection->SetInt64(value, field, (int64_t)value_bits);
+      break;
+    default:
+      reflection->SetUInt64(value, field, value_bits);
+      break;
+  }
+}
+
+// Sets the number in field of value, which is a float or a double.
+static void SetFloatingPoint(Message* value, const FieldDescriptor* field,
+                             double number) {
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT) {
+    value->GetReflection()->SetFloat(value, field, (float)number);
+  } else {
+    value->GetReflection()->SetDouble(value, field, number);
+  }
+}
+
+FuzzCoverageScheduler::FuzzCoverageScheduler(uint64_t seed)
+    : random_(seed),
+      covered_counter_count_(0),
+      covered_unit_count_(0),
+      exec_count_(0),
+      last_function_(-1) {}
+
+int FuzzCoverageScheduler::AddFunction(
+    const FunctionSpecificationMessage& func_msg,
+    const ComponentSpecificationMessage& iface_spec_msg) {
+  FunctionState state;
+  state.seed = func_msg;
+  for (VariableSpecificationMessage& arg : *state.seed.mutable_arg()) {
+    if (arg.type() != TYPE_PREDEFINED || arg.struct_value_size() > 0) {
+      continue;
+    }
+    // e.g., "struct light_state_t*" is defined by the attribute
+    // light_state_t.
+    string type_name = arg.predefined_type();
+    if (type_name.compare(0, 7, "struct ") == 0) type_name.erase(0, 7);
+    while (!type_name.empty() &&
+           (isspace(type_name.back()) || type_name.back() == '*')) {
+      type_name.pop_back();
+    }
+    for (const VariableSpecificationMessage& attribute :
+         iface_spec_msg.interface().attribute()) {
+      if (attribute.type() == TYPE_STRUCT && attribute.name() == type_name) {
+        arg.mutable_struct_value()->CopyFrom(attribute.struct_value());
+        break;
+      }
+    }
+  }
+  state.scalar_energy.resize(CollectArgScalars(&state.seed).size(), 0);
+  state.energy = 0;
+  state.execs = 0;
+  state.new_units = 0;
+  functions_.push_back(state);
+  return functions_.size() - 1;
+}
+
+int FuzzCoverageScheduler::NextInput(FunctionSpecificationMessage* input) {
+  if (functions_.empty()) return -1;
+  int function = -1;
+  // each function is called once before they are weighed.
+  for (size_t index = 0; index < functions_.size(); index++) {
+    if (functions_[index].execs == 0 && (int)index != last_function_) {
+      function = index;
+      break;
+    }
+  }
+  if (function < 0) {
+    vector<double> weights;
+    for (const FunctionState& state : functions_) {
+      weights.push_back(1 + kEnergyWeight * state.energy);
+    }
+    function = PickWeighted(weights);
+  }
+
+  FunctionState& state = functions_[function];
+  last_function_ = function;
+  last_mutated_scalars_.clear();
+  if (state.corpus.empty() || random_.Below(100) < kFreshInputPercent) {
+    input->CopyFrom(state.seed);
+    for (VariableSpecificationMessage* scalar : CollectArgScalars(input)) {
+      RandomizeScalar(scalar);
+    }
+  } else {
+    vector<double> weights;
+    for (const CorpusEntry& entry : state.corpus) {
+      weights.push_back((1.0 + entry.new_units) / (1 + entry.picks));
+    }
+    CorpusEntry& entry = state.corpus[PickWeighted(weights)];
+    entry.picks++;
+    input->CopyFrom(entry.input);
+    vector<VariableSpecificationMessage*> scalars = CollectArgScalars(input);
+    if (!scalars.empty()) {
+      vector<double> scalar_weights;
+      for (double energy : state.scalar_energy) {
+        scalar_weights.push_back(1 + kEnergyWeight * energy);
+      }
+      size_t count = 1 + random_.Below(min(kMaxMutatedScalars, scalars.size()));
+      for (size_t i = 0; i < count; i++) {
+        size_t scalar = PickWeighted(scalar_weights);
+        MutateScalar(scalars[scalar]);
+        last_mutated_scalars_.push_back(scalar);
+      }
+    }
+  }
+  last_input_.CopyFrom(*input);
+  return function;
+}
+
+int FuzzCoverageScheduler::RecordCoverage(
+    const FunctionSpecificationMessage& coverage_msg) {
+  int new_units = 0;
+  for (const auto& delta_msg : coverage_msg.coverage_delta()) {
+    // the counters of each file get a range of counter_buckets_ the first
+    // time the file is seen.
+    auto range = file_counter_ranges_.find(delta_msg.file_path());
+    if (range == file_counter_ranges_.end()) {
+      range = file_counter_ranges_
+                  .insert(make_pair(delta_msg.file_path(),
+                                    make_pair(counter_buckets_.size(),
+                                              delta_msg.counter_count())))
+                  .first;
+      counter_buckets_.resize(
+          counter_buckets_.size() + delta_msg.counter_count(), 0);
+    }
+    size_t index = range->second.first;
+    size_t end = index + range->second.second;
+    int count = min(delta_msg.counter_index_delta_size(),
+                    delta_msg.counter_increment_size());
+    for (int i = 0; i < count; i++) {
+      index += delta_msg.counter_index_delta(i);
+      if (index >= end) break;
+      uint64_t increment = delta_msg.counter_increment(i);
+      if (increment == 0) continue;
+      uint8_t bucket = CountBucket(min<uint64_t>(increment, UINT32_MAX));
+      if (counter_buckets_[index] & bucket) continue;
+      if (!counter_buckets_[index]) covered_counter_count_++;
+      counter_buckets_[index] |= bucket;
+      new_units++;
+    }
+  }
+  covered_unit_count_ += new_units;
+  exec_count_++;
+  if (last_function_ < 0) return new_units;
+
+  FunctionState& state = functions_[last_function_];
+  state.execs++;
+  state.new_units += new_units;
+  state.energy = state.energy * kEnergyDecay + new_units;
+  for (size_t scalar : last_mutated_scalars_) {
+    state.scalar_energy[scalar] =
+        state.scalar_energy[scalar] * kEnergyDecay + new_units;
+  }
+  if (new_units > 0) {
+    CorpusEntry entry;
+    entry.input.Swap(&last_input_);
+    entry.new_units = new_units;
+    entry.picks = 0;
+    if (state.corpus.size() < kMaxCorpusEntries) {
+      state.corpus.push_back(entry);
+    } else {
+      // replaces the entry which found the fewest units per pick.
+      size_t worst = 0;
+      for (size_t index = 1; index < state.corpus.size(); index++) {
+        const CorpusEntry& candidate = state.corpus[index];
+        const CorpusEntry& current = state.corpus[worst];
+        if ((1.0 + candidate.new_units) / (1 + candidate.picks) <
+            (1.0 + current.new_units) / (1 + current.picks)) {
+          worst = index;
+        }
+      }
+      state.corpus[worst] = entry;
+    }
+  }
+  last_function_ = -1;
+  return new_units;
+}
+
+size_t FuzzCoverageScheduler::GetCorpusSize() const {
+  size_t size = 0;
+  for (const FunctionState& state : functions_) size += state.corpus.size();
+  return size;
+}
+
+void FuzzCoverageScheduler::PrintFunctionStats() const {
+  for (const FunctionState& state : functions_) {
+    cout << "[coverage]   " << state.seed.name() << " execs " << state.execs
+         << " units " << state.new_units << " corpus " << state.corpus.size()
+         << endl;
+  }
+}
+
+void FuzzCoverageScheduler::CollectScalars(
+    VariableSpecificationMessage* var,
+    vector<VariableSpecificationMessage*>* scalars) {
+  if (!var->is_input()) return;
+  if ((var->type() == TYPE_SCALAR || var->type() == TYPE_ENUM) &&
+      GetScalarValueField(*var)) {
+    scalars->push_back(var);
+  }
+  for (VariableSpecificationMessage& value : *var->mutable_struct_value()) {
+    CollectScalars(&value, scalars);
+  }
+  for (VariableSpecificationMessage& value : *var->mutable_vector_value()) {
+    CollectScalars(&value, scalars);
+  }
+  for (VariableSpecificationMessage& value : *var->mutable_union_value()) {
+    CollectScalars(&value, scalars);
+  }
+}
+
+vector<VariableSpecificationMessage*> FuzzCoverageScheduler::CollectArgScalars(
+    FunctionSpecificationMessage* func_msg) {
+  vector<VariableSpecificationMessage*> scalars;
+  for (VariableSpecificationMessage& arg : *func_msg->mutable_arg()) {
+    CollectScalars(&arg, &scalars);
+  }
+  return scalars;
+}
+
+void FuzzCoverageScheduler::MutateScalar(VariableSpecificationMessage* scalar) {
+  const FieldDescriptor* field = GetScalarValueField(*scalar);
+  Message* value = scalar->mutable_scalar_value();
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT ||
+      field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+    double number =
+        field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT
+            ? value->GetReflection()->GetFloat(*value, field)
+            : value->GetReflection()->GetDouble(*value, field);
+    switch (random_.Below(3)) {
+      case 0:
+        number = kInterestingFloats[random_.Below(
+            sizeof(kInterestingFloats) / sizeof(double))];
+        break;
+      case 1:
+        number *= random_.Below(2) ? 2.0 : -0.5;
+        break;
+      default:
+        number += uniform_real_distribution<double>(-1000.0, 1000.0)(random_);
+        break;
+    }
+    SetFloatingPoint(value, field, number);
+    return;
+  }
+
+  int bits = GetScalarBits(*scalar);
+  uint64_t value_bits = GetIntegerBits(*value, field);
+  switch (random_.Below(4)) {
+    case 0:
+      value_bits ^= 1ULL << random_.Below(bits);
+      break;
+    case 1: {
+      uint64_t delta = 1 + random_.Below(kMaxArithmeticDelta);
+      value_bits += random_.Below(2) ? delta : -delta;
+      break;
+    }
+    case 2:
+      value_bits = (uint64_t)kInterestingIntegers[
+          random_.Below(sizeof(kInterestingIntegers) / sizeof(int64_t))];
+      break;
+    default:
+      value_bits = random_();
+      break;
+  }
+  SetIntegerBits(value, field, bits, value_bits);
+}
+
+void FuzzCoverageScheduler::RandomizeScalar(
+    VariableSpecificationMessage* scalar) {
+  const FieldDescriptor* field = GetScalarValueField(*scalar);
+  Message* value = scalar->mutable_scalar_value();
+  if (field->cpp_type() == FieldDescriptor::CPPTYPE_FLOAT ||
+      field->cpp_type() == FieldDescriptor::CPPTYPE_DOUBLE) {
+    SetFloatingPoint(
+        value, field,
+        uniform_real_distribution<double>(-1000000.0, 1000000.0)(random_));
+  } else {
+    SetIntegerBits(value, field, GetScalarBits(*scalar), random_());
+  }
+}
+
+size_t FuzzCoverageScheduler::PickWeighted(const vector<double>& weights) {
+  double total = 0;
+  for (double weight : weights) total += weight;
+  double point = uniform_real_distribution<double>(0, total)(random_);
+  for (size_t index = 0; index < weights.size(); index++) {
+    if (point < weights[index]) return index;
+    point -= weights[index];
+  }
+  return weights.size() - 1;
+}
+
+}  // namespace vts
+}  // namespace android
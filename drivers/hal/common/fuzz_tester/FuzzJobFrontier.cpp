@@ -0,0 +1,198 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fuzz_tester/FuzzJobFrontier.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <new>
+
+namespace android {
+namespace vts {
+
+const uint32_t FuzzJobFrontier::kMaxConsecutiveCrashes;
+
+FuzzJobFrontier* FuzzJobFrontier::Create(int num_workers, int epoch_count) {
+  if (num_workers < 1 || num_workers > kMaxWorkers) {
+    cerr << __func__ << " can't have " << num_workers << " workers" << endl;
+    return NULL;
+  }
+  size_t size = sizeof(FuzzJobFrontier);
+  void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    cerr << __func__ << " ERROR mmap failed. errno = " << errno << endl;
+    return NULL;
+  }
+  FuzzJobFrontier* frontier =
+      new (memory) FuzzJobFrontier(num_workers, epoch_count);
+  frontier->mapping_size_ = size;
+  return frontier;
+}
+
+FuzzJobFrontier::FuzzJobFrontier(int num_workers, int epoch_count)
+    : mapping_size_(0),
+      num_workers_(num_workers),
+      epoch_count_(epoch_count),
+      lock_owner_(0),
+      epochs_started_(0),
+      next_job_(0),
+      num_jobs_(0),
+      num_submodules_(0) {
+  for (WorkerSlot& slot : workers_) {
+    slot.pid = 0;
+    slot.busy = false;
+    slot.execs = 0;
+    slot.crashes = 0;
+    slot.consecutive_crashes = 0;
+    slot.retired = false;
+  }
+}
+
+void FuzzJobFrontier::Destroy() {
+  size_t size = mapping_size_;
+  this->~FuzzJobFrontier();
+  munmap(this, size);
+}
+
+void FuzzJobFrontier::Lock() {
+  pid_t self = getpid();
+  while (true) {
+    pid_t owner = 0;
+    if (lock_owner_.compare_exchange_weak(owner, self)) return;
+    // the lock of a process which died goes to the first one to notice.
+    if (owner != 0 && kill(owner, 0) != 0 && errno == ESRCH &&
+        lock_owner_.compare_exchange_strong(owner, self)) {
+      return;
+    }
+    sched_yield();
+  }
+}
+
+void FuzzJobFrontier::Unlock() { lock_owner_ = 0; }
+
+int FuzzJobFrontier::AddSubmodule(const string& submodule_name,
+                                  bool* added) {
+  *added = false;
+  if (submodule_name.size() >= kMaxSubmoduleNameLength) return -1;
+  Lock();
+  uint32_t num_submodules = num_submodules_;
+  for (uint32_t index = 0; index < num_submodules; index++) {
+    if (submodule_name == submodule_names_[index]) {
+      Unlock();
+      return index;
+    }
+  }
+  int index = -1;
+  if (num_submodules < kMaxSubmodules) {
+    strcpy(submodule_names_[num_submodules], submodule_name.c_str());
+    num_submodules_ = num_submodules + 1;
+    index = num_submodules;
+    *added = true;
+  }
+  Unlock();
+  return index;
+}
+
+string FuzzJobFrontier::GetSubmoduleName(uint32_t index) const {
+  if (index >= num_submodules_) return "";
+  return submodule_names_[index];
+}
+
+bool FuzzJobFrontier::AddJob(const FuzzJob& job) {
+  Lock();
+  uint32_t num_jobs = num_jobs_;
+  bool success = num_jobs < kMaxJobs;
+  if (success) {
+    jobs_[num_jobs] = job;
+    // publishes the job to the workers which claim jobs without the lock.
+    num_jobs_ = num_jobs + 1;
+  }
+  Unlock();
+  return success;
+}
+
+FuzzJobClaim FuzzJobFrontier::ClaimJob(int worker, FuzzJob* job) {
+  WorkerSlot& slot = workers_[worker];
+  slot.busy = true;
+  uint32_t next_job = next_job_;
+  while (next_job < num_jobs_) {
+    if (next_job_.compare_exchange_weak(next_job, next_job + 1)) {
+      if (epochs_started_++ >= epoch_count_) break;
+      *job = jobs_[next_job];
+      return FUZZ_JOB_CLAIMED;
+    }
+  }
+  slot.busy = false;
+  if (IsDone()) return FUZZ_JOB_DONE;
+  for (int index = 0; index < num_workers_; index++) {
+    if (workers_[index].busy) return FUZZ_JOB_PENDING;
+  }
+  // a worker adds its jobs before it stops being busy.
+  return next_job_ < num_jobs_ ? FUZZ_JOB_PENDING : FUZZ_JOB_DONE;
+}
+
+void FuzzJobFrontier::FinishJob(int worker) {
+  workers_[worker].execs++;
+  workers_[worker].consecutive_crashes = 0;
+  workers_[worker].busy = false;
+}
+
+bool FuzzJobFrontier::IsDone() const {
+  if (epochs_started_ >= epoch_count_) return true;
+  bool all_retired = true;
+  for (int index = 0; index < num_workers_; index++) {
+    if (!workers_[index].retired) all_retired = false;
+  }
+  if (all_retired) return true;
+  if (next_job_ < num_jobs_) return false;
+  for (int index = 0; index < num_workers_; index++) {
+    if (workers_[index].busy) return false;
+  }
+  return true;
+}
+
+void FuzzJobFrontier::SetWorkerPid(int worker, pid_t pid) {
+  workers_[worker].pid = pid;
+}
+
+bool FuzzJobFrontier::AbandonWorker(int worker) {
+  WorkerSlot& slot = workers_[worker];
+  slot.crashes++;
+  slot.busy = false;
+  if (++slot.consecutive_crashes >= kMaxConsecutiveCrashes) {
+    slot.retired = true;
+  }
+  return !slot.retired;
+}
+
+FuzzWorkerStats FuzzJobFrontier::GetWorkerStats(int worker) const {
+  FuzzWorkerStats stats;
+  stats.pid = workers_[worker].pid;
+  stats.execs = workers_[worker].execs;
+  stats.crashes = workers_[worker].crashes;
+  stats.retired = workers_[worker].retired;
+  return stats;
+}
+
+}  // namespace vts
+}  // namespace android
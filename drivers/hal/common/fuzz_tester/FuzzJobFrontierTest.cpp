@@ -0,0 +1,164 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fuzz_tester/FuzzJobFrontier.h"
+
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace android {
+namespace vts {
+
+class FuzzJobFrontierTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    if (frontier_) frontier_->Destroy();
+  }
+
+  // Creates a frontier with num_jobs jobs of the component.
+  void CreateFrontier(int num_workers, int epoch_count, int num_jobs) {
+    frontier_ = FuzzJobFrontier::Create(num_workers, epoch_count);
+    ASSERT_TRUE(frontier_ != NULL);
+    bool added;
+    ASSERT_EQ(0, frontier_->AddSubmodule("", &added));
+    for (int index = 0; index < num_jobs; index++) {
+      ASSERT_TRUE(frontier_->AddJob({0, (uint32_t)index}));
+    }
+  }
+
+  FuzzJobFrontier* frontier_ = NULL;
+};
+
+/*
+ * The jobs are claimed in order and each takes an epoch.
+ */
+TEST_F(FuzzJobFrontierTest, claims_jobs_in_order) {
+  CreateFrontier(1, 3, 5);
+  FuzzJob job;
+  for (uint32_t index = 0; index < 3; index++) {
+    ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(0, &job));
+    EXPECT_EQ(index, job.function_index);
+    frontier_->FinishJob(0);
+  }
+  EXPECT_EQ(FUZZ_JOB_DONE, frontier_->ClaimJob(0, &job));
+  EXPECT_TRUE(frontier_->IsDone());
+  EXPECT_EQ(3u, frontier_->GetWorkerStats(0).execs);
+}
+
+/*
+ * A busy worker may still add jobs, so the others wait for it.
+ */
+TEST_F(FuzzJobFrontierTest, waits_for_busy_worker) {
+  CreateFrontier(2, 100, 1);
+  FuzzJob job;
+  ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(0, &job));
+  EXPECT_EQ(FUZZ_JOB_PENDING, frontier_->ClaimJob(1, &job));
+  EXPECT_FALSE(frontier_->IsDone());
+  ASSERT_TRUE(frontier_->AddJob({0, 1}));
+  frontier_->FinishJob(0);
+  ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(1, &job));
+  EXPECT_EQ(1u, job.function_index);
+  frontier_->FinishJob(1);
+  EXPECT_EQ(FUZZ_JOB_DONE, frontier_->ClaimJob(0, &job));
+}
+
+/*
+ * A worker which dies is restarted, and its crashes in a row are forgotten
+ * once it finishes a job.
+ */
+TEST_F(FuzzJobFrontierTest, restarts_worker_which_finishes_jobs) {
+  CreateFrontier(1, 1000, 1);
+  FuzzJob job;
+  for (int round = 0; round < 3; round++) {
+    for (uint32_t crash = 1; crash < FuzzJobFrontier::kMaxConsecutiveCrashes;
+         crash++) {
+      ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(0, &job));
+      ASSERT_TRUE(frontier_->AddJob({0, 0}));
+      EXPECT_TRUE(frontier_->AbandonWorker(0));
+      EXPECT_FALSE(frontier_->IsDone());
+    }
+    ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(0, &job));
+    ASSERT_TRUE(frontier_->AddJob({0, 0}));
+    frontier_->FinishJob(0);
+  }
+  FuzzWorkerStats stats = frontier_->GetWorkerStats(0);
+  EXPECT_EQ(3 * (FuzzJobFrontier::kMaxConsecutiveCrashes - 1), stats.crashes);
+  EXPECT_FALSE(stats.retired);
+}
+
+/*
+ * A worker which keeps dying before it claims a job (so no epoch is used
+ * up) is retired, after which the run is done.
+ */
+TEST_F(FuzzJobFrontierTest, retires_worker_which_keeps_crashing) {
+  CreateFrontier(1, 1000, 10);
+  for (uint32_t crash = 1; crash < FuzzJobFrontier::kMaxConsecutiveCrashes;
+       crash++) {
+    EXPECT_TRUE(frontier_->AbandonWorker(0));
+    EXPECT_FALSE(frontier_->IsDone());
+  }
+  EXPECT_FALSE(frontier_->AbandonWorker(0));
+  EXPECT_TRUE(frontier_->IsDone());
+  FuzzWorkerStats stats = frontier_->GetWorkerStats(0);
+  EXPECT_EQ(FuzzJobFrontier::kMaxConsecutiveCrashes, stats.crashes);
+  EXPECT_TRUE(stats.retired);
+}
+
+/*
+ * The run goes on while a worker which isn't retired is left.
+ */
+TEST_F(FuzzJobFrontierTest, goes_on_with_remaining_workers) {
+  CreateFrontier(2, 1000, 10);
+  for (uint32_t crash = 0; crash < FuzzJobFrontier::kMaxConsecutiveCrashes;
+       crash++) {
+    frontier_->AbandonWorker(0);
+  }
+  EXPECT_FALSE(frontier_->IsDone());
+  FuzzJob job;
+  ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(1, &job));
+  EXPECT_EQ(0u, job.function_index);
+}
+
+/*
+ * The frontier is shared with forked worker processes, and a dead worker's
+ * claimed job is released.
+ */
+TEST_F(FuzzJobFrontierTest, shares_jobs_with_worker_processes) {
+  CreateFrontier(2, 2, 2);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    FuzzJob job;
+    frontier_->SetWorkerPid(0, getpid());
+    if (frontier_->ClaimJob(0, &job) == FUZZ_JOB_CLAIMED) abort();
+    _exit(0);
+  }
+  int status;
+  ASSERT_EQ(pid, waitpid(pid, &status, 0));
+  EXPECT_TRUE(WIFSIGNALED(status));
+  EXPECT_EQ(pid, frontier_->GetWorkerStats(0).pid);
+  EXPECT_TRUE(frontier_->AbandonWorker(0));
+
+  FuzzJob job;
+  ASSERT_EQ(FUZZ_JOB_CLAIMED, frontier_->ClaimJob(1, &job));
+  EXPECT_EQ(1u, job.function_index);
+  frontier_->FinishJob(1);
+  EXPECT_TRUE(frontier_->IsDone());
+}
+
+}  // namespace vts
+}  // namespace android
@@ -17,15 +17,22 @@
 #include "fuzz_tester/FuzzerBase.h"
 
 #include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -36,6 +43,8 @@
 #include "utils/InterfaceSpecUtil.h"
 
 #include "GcdaParser.h"
+#include "GcovCapture.h"
+#include "vts_random.h"
 
 using namespace std;
 using namespace android;
@@ -230,6 +239,18 @@ namespace vts {
 
 const string default_gcov_output_basepath = "/data/misc/gcov";
 
+// the state below is shared by all the FuzzerBase objects (as they share the
+// gcda files), which may make calls on several threads, so it's guarded by
+// a lock.
+static mutex coverage_lock;
+// whether only the counters which changed since the last call are sent
+// (see SetCoverageDeltaOnly).
+static bool coverage_delta_only = false;
+// the arc counters of each gcda file as of the last FunctionCallEnd.
+static map<string, vector<uint64_t>> coverage_snapshots;
+// the gcda dirs removed so far (in the delta only mode, once each).
+static set<string> cleared_gcov_basepaths;
+
 static void RemoveDir(char* path) {
   struct dirent* entry = NULL;
   DIR* dir = opendir(path);
@@ -259,16 +280,42 @@ FuzzerBase::FuzzerBase(int target_class)
       target_dll_path_(NULL),
       target_class_(target_class),
       component_filename_(NULL),
-      gcov_output_basepath_(NULL) {}
+      gcov_output_basepath_(NULL),
+      service_died_(false) {}
 
 FuzzerBase::~FuzzerBase() { free(component_filename_); }
 
+// Called by the profile runtime once the counters are written out at exit.
 void wfn() {
   cout << __func__ << endl;
+  GcovCaptureFinishDump();
 }
 
+// Called by the profile runtime once the counters are flushed, which ends the
+// dump captured in memory (if enabled).
 void ffn() {
   cout << __func__ << endl;
+  GcovCaptureFinishDump();
+}
+
+bool FuzzerBase::EnableInMemoryCoverage() { return GcovCaptureEnable(); }
+
+void FuzzerBase::SetCoverageDeltaOnly(bool delta_only) {
+  lock_guard<mutex> lock(coverage_lock);
+  coverage_delta_only = delta_only;
+}
+
+bool FuzzerBase::CollectsCoverage() {
+#if USE_GCOV
+  return true;
+#else
+  return false;
+#endif
+}
+
+mutex& FuzzerBase::CoverageCallLock() {
+  static mutex call_lock;
+  return call_lock;
 }
 
 bool FuzzerBase::LoadTargetComponent(const char* target_dll_path) {
@@ -361,12 +408,88 @@ bool FuzzerBase::Fuzz(vts::ComponentSpecificationMessage* message,
   return true;
 }
 
+bool FuzzerBase::ForkAndRun(int num_calls, const function<void(int)>& call,
+                            int timeout_ms, ForkRunResult* result) {
+  result->completed_calls = 0;
+  result->crashed = false;
+  result->signal = 0;
+  result->timed_out = false;
+
+  // the child writes a byte on progress_fds[1] after each call.
+  int progress_fds[2];
+  if (pipe(progress_fds) < 0) {
+    cerr << __func__ << " ERROR can't create a pipe " << errno << endl;
+    return false;
+  }
+  // otherwise each child would draw the same values.
+  uint64_t child_seed = GetRandomEngine()();
+  // otherwise the buffered output would be printed by the child too.
+  cout.flush();
+  fflush(stdout);
+  pid_t pid = fork();
+  if (pid < 0) {
+    cerr << __func__ << " ERROR can't fork " << errno << endl;
+    close(progress_fds[0]);
+    close(progress_fds[1]);
+    return false;
+  }
+  if (pid == 0) {
+    close(progress_fds[0]);
+    RandomNumberGeneratorSeed(child_seed);
+    for (int index = 0; index < num_calls; index++) {
+      call(index);
+      char done = 0;
+      if (write(progress_fds[1], &done, 1) != 1) break;
+    }
+#if USE_GCOV
+    // _exit skips the gcov writeout at exit.
+    target_loader_.GcovFlush();
+#endif
+    cout.flush();
+    fflush(stdout);
+    _exit(0);
+  }
+
+  close(progress_fds[1]);
+  struct pollfd progress = {progress_fds[0], POLLIN, 0};
+  while (true) {
+    int ready = poll(&progress, 1, timeout_ms);
+    if (ready < 0 && errno == EINTR) continue;
+    if (ready == 0) {
+      result->timed_out = true;
+      kill(pid, SIGKILL);
+      break;
+    }
+    char done[64];
+    ssize_t count = ready > 0 ? read(progress_fds[0], done, sizeof(done)) : -1;
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) break;
+    result->completed_calls += count;
+  }
+  close(progress_fds[0]);
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR) {
+      cerr << __func__ << " ERROR can't wait for the child " << errno << endl;
+      return true;
+    }
+  }
+  if (!result->timed_out && WIFSIGNALED(status)) {
+    result->crashed = true;
+    result->signal = WTERMSIG(status);
+  }
+  return true;
+}
+
 void FuzzerBase::FunctionCallBegin() {
   char product_path[4096];
   char product[128];
   char module_basepath[4096];
 
   cout << __func__ << ":" << __LINE__ << " begin" << endl;
+  // the counters in memory are reset by each flush.
+  if (GcovCaptureIsEnabled()) return;
   snprintf(product_path, 4096, "%s/%s", default_gcov_output_basepath.c_str(),
            "proc/self/cwd/out/target/product");
   DIR* srcdir = opendir(product_path);
@@ -433,16 +556,30 @@ void FuzzerBase::FunctionCallBegin() {
         dir_count++;
       }
     }
+    string basepath = string(module_basepath) + "/" + target;
     if (hit) {
       free(gcov_output_basepath_);
-      gcov_output_basepath_ =
-          (char*)malloc(strlen(module_basepath) + target.length() + 2);
+      gcov_output_basepath_ = (char*)malloc(basepath.length() + 1);
       if (!gcov_output_basepath_) {
         cerr << __FUNCTION__ << ": couldn't alloc memory" << endl;
         return;
       }
-      sprintf(gcov_output_basepath_, "%s/%s", module_basepath, target.c_str());
-      RemoveDir(gcov_output_basepath_);
+      strcpy(gcov_output_basepath_, basepath.c_str());
+      // in the delta only mode, the gcda files are only removed the first
+      // time, so they add up the counts of all the calls and
+      // FunctionCallEnd diffs them with the last snapshot.
+      lock_guard<mutex> lock(coverage_lock);
+      if (!coverage_delta_only) {
+        RemoveDir(gcov_output_basepath_);
+      } else if (cleared_gcov_basepaths.insert(basepath).second) {
+        RemoveDir(gcov_output_basepath_);
+        string prefix = basepath + "/";
+        for (auto it = coverage_snapshots.lower_bound(prefix);
+             it != coverage_snapshots.end() &&
+             !it->first.compare(0, prefix.length(), prefix);) {
+          it = coverage_snapshots.erase(it);
+        }
+      }
     }
   } else {
     cerr << __func__ << ":" << __LINE__ << " component_filename_ is NULL"
@@ -453,6 +590,45 @@ void FuzzerBase::FunctionCallBegin() {
   cout << __func__ << ":" << __LINE__ << " end" << endl;
 }
 
+// Adds the arc counters in functions (of a gcda file) which differ from
+// *snapshot_ptr to msg, sparse-encoded, and makes them the new snapshot.
+static void AddCoverageDelta(const string& filename,
+                             const vector<GcdaFunctionCounters>& functions,
+                             vector<uint64_t>* snapshot_ptr,
+                             FunctionSpecificationMessage* msg) {
+  size_t counter_count = 0;
+  for (const auto& function : functions) {
+    counter_count += function.counters.size();
+  }
+  vector<uint64_t>& snapshot = *snapshot_ptr;
+  // a file of another shape (e.g., the module was rebuilt) starts over.
+  if (snapshot.size() != counter_count) snapshot.assign(counter_count, 0);
+
+  NativeCodeCoverageDeltaMessage* delta_msg = NULL;
+  size_t index = 0;
+  size_t last_index = 0;
+  for (const auto& function : functions) {
+    for (gcov_type counter : function.counters) {
+      uint64_t value = counter;
+      uint64_t& previous = snapshot[index];
+      if (value != previous) {
+        if (!delta_msg) {
+          delta_msg = msg->add_coverage_delta();
+          delta_msg->set_file_path(filename);
+          delta_msg->set_counter_count(counter_count);
+        }
+        delta_msg->add_counter_index_delta(index - last_index);
+        // a counter which went down was reset along with its file.
+        delta_msg->add_counter_increment(
+            value > previous ? value - previous : value);
+        previous = value;
+        last_index = index;
+      }
+      index++;
+    }
+  }
+}
+
 bool FuzzerBase::ReadGcdaFile(
     const string& basepath, const string& filename,
     FunctionSpecificationMessage* msg) {
@@ -462,12 +638,25 @@ bool FuzzerBase::ReadGcdaFile(
 #endif
   if (string(filename).rfind(".gcda") != string::npos) {
     string buffer = basepath + "/" + filename;
-    vector<unsigned> processed_data =
-      android::vts::GcdaRawCoverageParser(buffer.c_str()).Parse();
+    android::vts::GcdaRawCoverageParser parser(buffer.c_str());
+    vector<unsigned> processed_data = parser.Parse();
     for (const auto& data : processed_data) {
       msg->mutable_processed_coverage_data()->Add(data);
     }
 
+    {
+      lock_guard<mutex> lock(coverage_lock);
+      // by default, the raw file alone carries the counters of the call.
+      if (coverage_delta_only) {
+        // the whole file is only sent the first time; after that, the
+        // counters which changed are enough.
+        bool has_snapshot = coverage_snapshots.count(buffer) > 0;
+        AddCoverageDelta(filename, parser.GetFunctionCounters(),
+                         &coverage_snapshots[buffer], msg);
+        if (has_snapshot) return true;
+      }
+    }
+
     FILE* gcda_file = fopen(buffer.c_str(), "rb");
     if (!gcda_file) {
       cerr << __func__ << ":" << __LINE__
@@ -519,6 +708,24 @@ bool FuzzerBase::ReadGcdaFile(
   return false;
 }
 
+// Adds the counters of the dumps captured in memory since the last call to
+// msg. Each flush resets the counters, so they're all the call's own.
+static void AddCapturedCoverage(FunctionSpecificationMessage* msg) {
+  vector<GcovCapturedFile> files;
+  GcovCaptureTakeFiles(&files);
+  for (const auto& file : files) {
+    for (const auto& function : file.functions) {
+      msg->mutable_processed_coverage_data()->Add(function.lineno_checksum);
+    }
+    size_t offset = file.filename.rfind('/');
+    string filename = offset == string::npos
+                          ? file.filename
+                          : file.filename.substr(offset + 1);
+    vector<uint64_t> zeros;
+    AddCoverageDelta(filename, file.functions, &zeros, msg);
+  }
+}
+
 bool FuzzerBase::ScanAllGcdaFiles(
     const string& basepath, FunctionSpecificationMessage* msg) {
   DIR* srcdir = opendir(basepath.c_str());
@@ -560,6 +767,10 @@ bool FuzzerBase::FunctionCallEnd(FunctionSpecificationMessage* msg) {
   cout << __func__ << ": gcov flush " << endl;
 #if USE_GCOV
   target_loader_.GcovFlush();
+  if (GcovCaptureIsEnabled()) {
+    AddCapturedCoverage(msg);
+    return true;
+  }
   // find the file.
   if (!gcov_output_basepath_) {
     cerr << __FUNCTION__ << ": no gcov basepath set" << endl;
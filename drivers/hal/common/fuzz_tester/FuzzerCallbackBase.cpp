@@ -17,20 +17,28 @@
 #include "fuzz_tester/FuzzerCallbackBase.h"
 
 #include <dirent.h>
+#include <errno.h>
+#include <linux/futex.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <VtsDriverCommUtil.h>
@@ -47,6 +55,274 @@ namespace vts {
 
 static std::map<string, string> id_map_;
 
+// max number of requests waiting in a send queue; more are dropped so that a
+// HAL thread never waits for the agent.
+static const uint64_t kMaxQueueDepth = 8192;
+// max number of requests written to the agent at once.
+static const int kMaxBatchSize = 256;
+// how long an idle sender thread sleeps before it checks its queue again.
+static const long kSenderWaitTimeoutNsec = 1000 * 1000 * 1000;
+// how long the queued requests may take to go out when the process exits.
+static const int kExitFlushTimeoutMsec = 1000;
+
+// A serialized request in a send queue.
+struct QueuedCallbackRequest {
+  std::atomic<QueuedCallbackRequest*> next;
+  string payload;
+};
+
+// Sends the callback requests of all the threads of this process to one
+// callback socket of the agent. The HAL threads push requests onto a
+// lock-free multi-producer/single-consumer queue (an intrusive list with a
+// stub node, after Dmitry Vyukov), and a sender thread pops them, connects
+// lazily, and writes what it popped in one write.
+class FuzzerCallbackChannel {
+ public:
+  FuzzerCallbackChannel(const string& socket_name)
+      : socket_name_(socket_name),
+        pid_(getpid()),
+        next_channel_(NULL),
+        head_(&stub_),
+        tail_(&stub_),
+        depth_(0),
+        num_queued_(0),
+        num_sent_(0),
+        num_dropped_(0),
+        max_depth_(0),
+        wake_seq_(0),
+        sender_waiting_(0),
+        connected_(false) {
+    stub_.next.store(NULL);
+    // framing must be set before requests are framed by the sender thread.
+    util_.SetSendFraming(VTS_SOCKET_FRAMING_BINARY);
+  }
+
+  // Returns the channel of this process for socket_name, creating it (and
+  // its sender thread) on first use.
+  static FuzzerCallbackChannel* Get(const string& socket_name);
+
+  // Returns the first channel; channels are never deleted.
+  static FuzzerCallbackChannel* GetFirst() { return channels_.load(); }
+  FuzzerCallbackChannel* GetNext() const { return next_channel_; }
+  pid_t GetPid() const { return pid_; }
+
+  // Queues message. Returns false if it is dropped.
+  bool Enqueue(const AndroidSystemCallbackRequestMessage& message);
+
+  // Adds the counters of this channel to stats.
+  void AddStats(FuzzerCallbackStats* stats) const;
+
+  // Returns true if all queued requests are sent or dropped.
+  bool IsDrained() const {
+    return num_sent_.load() + num_dropped_.load() == num_queued_.load();
+  }
+
+ private:
+  void Push(QueuedCallbackRequest* request);
+  // Returns NULL if the queue is empty or a push is not complete yet.
+  QueuedCallbackRequest* Pop();
+  void SenderLoop();
+  // Writes batch, which holds count requests, to the agent.
+  void SendBatch(const string& batch, int count);
+
+  const string socket_name_;
+  // the process which owns the sender thread (a forked child gets its own
+  // channel).
+  const pid_t pid_;
+  FuzzerCallbackChannel* next_channel_;
+
+  // producers swap themselves into head_; the sender pops from tail_.
+  std::atomic<QueuedCallbackRequest*> head_;
+  QueuedCallbackRequest* tail_;
+  QueuedCallbackRequest stub_;
+
+  std::atomic<uint64_t> depth_;
+  std::atomic<uint64_t> num_queued_;
+  std::atomic<uint64_t> num_sent_;
+  std::atomic<uint64_t> num_dropped_;
+  std::atomic<uint64_t> max_depth_;
+
+  // bumped by every push; the sender sleeps on it as a futex.
+  std::atomic<uint32_t> wake_seq_;
+  std::atomic<uint32_t> sender_waiting_;
+
+  // used by the sender thread only.
+  VtsDriverCommUtil util_;
+  bool connected_;
+
+  // all channels of this process (and of its parents before a fork).
+  static std::atomic<FuzzerCallbackChannel*> channels_;
+  static std::mutex channels_mutex_;
+};
+
+std::atomic<FuzzerCallbackChannel*> FuzzerCallbackChannel::channels_(NULL);
+std::mutex FuzzerCallbackChannel::channels_mutex_;
+
+static void FlushCallbacksAtExit() {
+  FuzzerCallbackBase::Flush(kExitFlushTimeoutMsec);
+}
+
+FuzzerCallbackChannel* FuzzerCallbackChannel::Get(const string& socket_name) {
+  pid_t pid = getpid();
+  for (FuzzerCallbackChannel* channel = channels_.load(); channel;
+       channel = channel->next_channel_) {
+    if (channel->pid_ == pid && channel->socket_name_ == socket_name) {
+      return channel;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(channels_mutex_);
+  for (FuzzerCallbackChannel* channel = channels_.load(); channel;
+       channel = channel->next_channel_) {
+    if (channel->pid_ == pid && channel->socket_name_ == socket_name) {
+      return channel;
+    }
+  }
+  FuzzerCallbackChannel* channel = new FuzzerCallbackChannel(socket_name);
+  channel->next_channel_ = channels_.load();
+  channels_.store(channel);
+  std::thread(&FuzzerCallbackChannel::SenderLoop, channel).detach();
+  static pid_t atexit_pid = 0;
+  if (atexit_pid != pid) {
+    // a forked child inherits the registration of its parent.
+    if (atexit_pid == 0) atexit(FlushCallbacksAtExit);
+    atexit_pid = pid;
+  }
+  return channel;
+}
+
+void FuzzerCallbackChannel::Push(QueuedCallbackRequest* request) {
+  request->next.store(NULL, std::memory_order_relaxed);
+  QueuedCallbackRequest* prev = head_.exchange(request);
+  prev->next.store(request);
+}
+
+QueuedCallbackRequest* FuzzerCallbackChannel::Pop() {
+  QueuedCallbackRequest* tail = tail_;
+  QueuedCallbackRequest* next = tail->next.load();
+  if (tail == &stub_) {
+    if (!next) return NULL;
+    tail_ = next;
+    tail = next;
+    next = next->next.load();
+  }
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+  if (tail != head_.load()) return NULL;
+  // tail is the last request; the stub goes behind it so that it can be
+  // taken.
+  Push(&stub_);
+  next = tail->next.load();
+  if (next) {
+    tail_ = next;
+    return tail;
+  }
+  return NULL;
+}
+
+bool FuzzerCallbackChannel::Enqueue(
+    const AndroidSystemCallbackRequestMessage& message) {
+  uint64_t depth = depth_.fetch_add(1) + 1;
+  if (depth > kMaxQueueDepth) {
+    depth_.fetch_sub(1);
+    num_queued_.fetch_add(1);
+    // logs only the first drop so that a full queue does not slow down the
+    // HAL threads further.
+    if (num_dropped_.fetch_add(1) == 0) {
+      cerr << __func__ << " ERROR the queue for " << socket_name_
+           << " is full; dropping callback requests" << endl;
+    }
+    return false;
+  }
+  uint64_t max_depth = max_depth_.load();
+  while (depth > max_depth &&
+         !max_depth_.compare_exchange_weak(max_depth, depth)) {
+  }
+
+  QueuedCallbackRequest* request = new QueuedCallbackRequest();
+  if (!message.SerializeToString(&request->payload)) {
+    delete request;
+    depth_.fetch_sub(1);
+    num_queued_.fetch_add(1);
+    num_dropped_.fetch_add(1);
+    return false;
+  }
+  num_queued_.fetch_add(1);
+  Push(request);
+  wake_seq_.fetch_add(1);
+  if (sender_waiting_.load()) {
+    syscall(__NR_futex, &wake_seq_, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+  }
+  return true;
+}
+
+void FuzzerCallbackChannel::SendBatch(const string& batch, int count) {
+  if (!connected_) {
+    connected_ = util_.Connect(socket_name_);
+    if (!connected_) {
+      cerr << __func__ << " ERROR can't connect to " << socket_name_ << endl;
+    }
+  }
+  if (connected_ && util_.VtsSocketSendFramedBytes(batch)) {
+    num_sent_.fetch_add(count);
+    return;
+  }
+  cerr << __func__ << " ERROR dropped " << count << " callback requests"
+       << endl;
+  num_dropped_.fetch_add(count);
+  if (connected_) {
+    util_.Close();
+    connected_ = false;
+  }
+}
+
+void FuzzerCallbackChannel::SenderLoop() {
+  string batch;
+  while (true) {
+    batch.clear();
+    int count = 0;
+    QueuedCallbackRequest* request;
+    while (count < kMaxBatchSize && (request = Pop()) != NULL) {
+      if (util_.AppendFramedBytes(request->payload, &batch)) {
+        count++;
+      } else {
+        num_dropped_.fetch_add(1);
+      }
+      delete request;
+      depth_.fetch_sub(1);
+    }
+    if (count > 0) {
+      SendBatch(batch, count);
+      continue;
+    }
+
+    if (depth_.load() > 0) {
+      // a push is half done; it completes within a few instructions.
+      sched_yield();
+      continue;
+    }
+    uint32_t seq = wake_seq_.load();
+    sender_waiting_.store(1);
+    if (depth_.load() == 0) {
+      struct timespec timeout = {0, kSenderWaitTimeoutNsec};
+      syscall(__NR_futex, &wake_seq_, FUTEX_WAIT_PRIVATE, seq, &timeout, NULL,
+              0);
+    }
+    sender_waiting_.store(0);
+  }
+}
+
+void FuzzerCallbackChannel::AddStats(FuzzerCallbackStats* stats) const {
+  stats->num_queued += num_queued_.load();
+  stats->num_sent += num_sent_.load();
+  stats->num_dropped += num_dropped_.load();
+  if (max_depth_.load() > stats->max_queue_depth) {
+    stats->max_queue_depth = max_depth_.load();
+  }
+}
+
 FuzzerCallbackBase::FuzzerCallbackBase() {}
 
 FuzzerCallbackBase::~FuzzerCallbackBase() {}
@@ -90,10 +366,31 @@ void FuzzerCallbackBase::RpcCallToAgent(
          << "Abort callback forwarding." << endl;
     return;
   }
-  VtsDriverCommUtil util;
-  if (!util.Connect(callback_socket_name)) exit(-1);
-  util.VtsSocketSendMessage(message);
-  util.Close();
+  FuzzerCallbackChannel::Get(callback_socket_name)->Enqueue(message);
+}
+
+FuzzerCallbackStats FuzzerCallbackBase::GetStats() {
+  FuzzerCallbackStats stats = {0, 0, 0, 0};
+  pid_t pid = getpid();
+  for (FuzzerCallbackChannel* channel = FuzzerCallbackChannel::GetFirst();
+       channel; channel = channel->GetNext()) {
+    if (channel->GetPid() == pid) channel->AddStats(&stats);
+  }
+  return stats;
+}
+
+bool FuzzerCallbackBase::Flush(int timeout_msec) {
+  pid_t pid = getpid();
+  for (int waited_msec = 0;; waited_msec++) {
+    bool drained = true;
+    for (FuzzerCallbackChannel* channel = FuzzerCallbackChannel::GetFirst();
+         channel; channel = channel->GetNext()) {
+      if (channel->GetPid() == pid && !channel->IsDrained()) drained = false;
+    }
+    if (drained) return true;
+    if (waited_msec >= timeout_msec) return false;
+    usleep(1000);
+  }
 }
 
 }  // namespace vts
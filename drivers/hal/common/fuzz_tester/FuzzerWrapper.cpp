@@ -68,18 +68,31 @@ FuzzerBase* FuzzerWrapper::GetFuzzer(
     return fuzzer_base_;
   }
 
+  FuzzerBase* fuzzer = CreateFuzzer(message);
+  if (!fuzzer) return NULL;
+  fuzzer_base_ = fuzzer;
+  free(function_name_prefix_chars_);
+  function_name_prefix_chars_ =
+      (char*)malloc(strlen(function_name_prefix_chars) + 1);
+  strcpy(function_name_prefix_chars_, function_name_prefix_chars);
+  return fuzzer_base_;
+}
+
+FuzzerBase* FuzzerWrapper::CreateFuzzer(
+    const vts::ComponentSpecificationMessage& message) {
+  if (spec_dll_path_.size() == 0) {
+    cerr << __func__ << ": spec_dll_path_ not set" << endl;
+    return NULL;
+  }
+  string function_name_prefix = GetFunctionNamePrefix(message);
   loader_function func =
-      dll_loader_.GetLoaderFunction(function_name_prefix_chars);
+      dll_loader_.GetLoaderFunction(function_name_prefix.c_str());
   if (!func) {
     cerr << __func__ << ": function not found." << endl;
     return NULL;
   }
   cout << __func__ << ": function found; trying to call." << endl;
-  fuzzer_base_ = func();
-  function_name_prefix_chars_ =
-      (char*)malloc(strlen(function_name_prefix_chars) + 1);
-  strcpy(function_name_prefix_chars_, function_name_prefix_chars);
-  return fuzzer_base_;
+  return func();
 }
 
 }  // namespace vts
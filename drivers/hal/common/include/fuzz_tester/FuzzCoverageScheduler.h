@@ -0,0 +1,145 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_FUZZ_COVERAGE_SCHEDULER_H__
+#define __VTS_SYSFUZZER_COMMON_FUZZ_COVERAGE_SCHEDULER_H__
+
+#include <stdint.h>
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "vts_random.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Picks the inputs of a coverage-guided fuzz run from the coverage the
+// earlier inputs reached.
+//
+// A coverage unit is an arc counter of a gcda file (see the coverage_delta
+// which FuzzerBase::FunctionCallEnd fills in) hit a number of times by a call
+// within a bucket (1, 2, 3, 4-7, 8-15, 16-31, 32-127 or 128+), so a loop
+// which runs more often also counts as new. The inputs which reach new units are kept in a corpus per
+// function and mutated: a few of the scalar values in their args (including
+// the fields of struct args) are flipped, nudged, or set to an interesting or
+// random value. A function is picked with a weight which grows with the
+// units it found recently, and so is each scalar value of its args, so the
+// time goes to what is still discovering coverage. Each function also gets
+// fresh inputs, whose scalars all have random values, now and then.
+class FuzzCoverageScheduler {
+ public:
+  explicit FuzzCoverageScheduler(uint64_t seed);
+
+  // Adds the function in func_msg of the component in iface_spec_msg, whose
+  // struct attributes seed the values of the struct args. Returns the index
+  // of the function.
+  int AddFunction(const FunctionSpecificationMessage& func_msg,
+                  const ComponentSpecificationMessage& iface_spec_msg);
+
+  // Puts the input to call next in input. Returns the index of its function,
+  // or -1 if no function is added.
+  int NextInput(FunctionSpecificationMessage* input);
+
+  // Records the coverage deltas in coverage_msg, which the last input
+  // returned by NextInput reached. Returns the number of new units.
+  int RecordCoverage(const FunctionSpecificationMessage& coverage_msg);
+
+  // Returns the number of counters hit at least once.
+  size_t GetCoveredCounterCount() const { return covered_counter_count_; }
+
+  // Returns the number of units reached so far.
+  size_t GetCoveredUnitCount() const { return covered_unit_count_; }
+
+  // Returns the number of inputs kept in the corpus.
+  size_t GetCorpusSize() const;
+
+  // Returns the number of inputs whose coverage is recorded.
+  uint64_t GetExecCount() const { return exec_count_; }
+
+  // Prints the execs, found units and corpus of each function.
+  void PrintFunctionStats() const;
+
+ private:
+  // An input which reached new units.
+  struct CorpusEntry {
+    FunctionSpecificationMessage input;
+    // the number of units the input reached first.
+    uint32_t new_units;
+    // the number of times the input was mutated.
+    uint32_t picks;
+  };
+
+  struct FunctionState {
+    // the spec of the function with the fields of its struct args filled in,
+    // of which the fresh inputs are made.
+    FunctionSpecificationMessage seed;
+    vector<CorpusEntry> corpus;
+    // the units found recently by a value of each scalar (in the order of
+    // CollectScalars), decayed as the function is called.
+    vector<double> scalar_energy;
+    // the units found recently, decayed as the function is called.
+    double energy;
+    uint64_t execs;
+    uint64_t new_units;
+  };
+
+  // Appends the scalars with a value which can be mutated in var, including
+  // those in its struct, vector and union values, to scalars.
+  static void CollectScalars(VariableSpecificationMessage* var,
+                             vector<VariableSpecificationMessage*>* scalars);
+
+  // Returns the scalars of the args of func_msg as CollectScalars.
+  static vector<VariableSpecificationMessage*> CollectArgScalars(
+      FunctionSpecificationMessage* func_msg);
+
+  // Mutates the value of scalar.
+  void MutateScalar(VariableSpecificationMessage* scalar);
+
+  // Sets the value of scalar at random.
+  void RandomizeScalar(VariableSpecificationMessage* scalar);
+
+  // Returns an index picked at random with a probability proportional to
+  // weights[index].
+  size_t PickWeighted(const vector<double>& weights);
+
+  VtsRandomEngine random_;
+  vector<FunctionState> functions_;
+  // the buckets (as bits) in which each counter was hit so far.
+  vector<uint8_t> counter_buckets_;
+  // the first index and the number of the counters of each gcda file in
+  // counter_buckets_.
+  map<string, pair<size_t, size_t>> file_counter_ranges_;
+  size_t covered_counter_count_;
+  size_t covered_unit_count_;
+  uint64_t exec_count_;
+
+  // the input returned by the last NextInput, its function (or -1 once its
+  // coverage is recorded) and its mutated scalars.
+  int last_function_;
+  vector<size_t> last_mutated_scalars_;
+  FunctionSpecificationMessage last_input_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_FUZZ_COVERAGE_SCHEDULER_H__
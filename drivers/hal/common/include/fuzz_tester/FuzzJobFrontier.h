@@ -0,0 +1,156 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_FUZZ_JOB_FRONTIER_H__
+#define __VTS_SYSFUZZER_COMMON_FUZZ_JOB_FRONTIER_H__
+
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <string>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// A fuzzing job: a function of the fuzzed component (submodule 0) or of one
+// of its submodules found so far.
+struct FuzzJob {
+  uint32_t submodule_index;
+  // the index of the function in the api of the submodule's specification.
+  uint32_t function_index;
+};
+
+// Result of FuzzJobFrontier::ClaimJob.
+enum FuzzJobClaim {
+  // a job is claimed.
+  FUZZ_JOB_CLAIMED,
+  // no job is left for now, but a busy worker may add some.
+  FUZZ_JOB_PENDING,
+  // the epochs are used up or no job is left.
+  FUZZ_JOB_DONE,
+};
+
+// Stats of a fuzz worker process.
+struct FuzzWorkerStats {
+  pid_t pid;
+  // number of functions called.
+  uint64_t execs;
+  // number of times the worker process died (e.g., crashed in the HAL).
+  uint32_t crashes;
+  // whether the worker died too many times in a row to be restarted.
+  bool retired;
+};
+
+// The job frontier and the found submodules of a fuzz run, shared by the
+// worker processes which carry out the jobs. It lives in anonymous shared
+// memory mapped before the workers are forked, and holds no pointers.
+//
+// Jobs are taken in the order added (breadth-first) and each takes one of
+// the epochs. A worker which dies takes at most its claimed job with it: jobs
+// are claimed without locks, and the lock held while adding jobs is taken
+// over from a dead holder. A worker which keeps dying without finishing a job
+// is retired, and the run is done once all the workers are.
+class FuzzJobFrontier {
+ public:
+  static const int kMaxWorkers = 64;
+  static const uint32_t kMaxJobs = 64 * 1024;
+  static const uint32_t kMaxSubmodules = 256;
+  static const size_t kMaxSubmoduleNameLength = 128;
+  // number of times in a row a worker can die before it is retired.
+  static const uint32_t kMaxConsecutiveCrashes = 8;
+
+  // Maps a frontier for num_workers workers which carry out up to
+  // epoch_count jobs. Returns NULL on error.
+  static FuzzJobFrontier* Create(int num_workers, int epoch_count);
+
+  // Unmaps the frontier.
+  void Destroy();
+
+  // Returns the index of the submodule submodule_name (the component itself
+  // if empty), adding it if it is new, in which case *added is set. Returns
+  // -1 if the table is full.
+  int AddSubmodule(const string& submodule_name, bool* added);
+
+  // Returns the name of the submodule at index.
+  string GetSubmoduleName(uint32_t index) const;
+
+  // Adds a job behind the others. Returns false if the frontier is full.
+  bool AddJob(const FuzzJob& job);
+
+  // Claims the next job for worker, which is busy until FinishJob.
+  FuzzJobClaim ClaimJob(int worker, FuzzJob* job);
+
+  // Marks the claimed job of worker, and the jobs it added, as done.
+  void FinishJob(int worker);
+
+  // Returns true if no job is left to be claimed or all the workers are
+  // retired.
+  bool IsDone() const;
+
+  // Records that worker runs in process pid.
+  void SetWorkerPid(int worker, pid_t pid);
+
+  // Releases the job of a worker whose process died, and counts the crash.
+  // Returns false if the worker is retired, i.e., it died
+  // kMaxConsecutiveCrashes times in a row without finishing a job, in which
+  // case it is not to be restarted.
+  bool AbandonWorker(int worker);
+
+  FuzzWorkerStats GetWorkerStats(int worker) const;
+
+ private:
+  struct WorkerSlot {
+    atomic<pid_t> pid;
+    // whether the worker carries out a job, which may add more jobs.
+    atomic<bool> busy;
+    atomic<uint64_t> execs;
+    atomic<uint32_t> crashes;
+    // number of crashes since the last finished job.
+    atomic<uint32_t> consecutive_crashes;
+    atomic<bool> retired;
+  };
+
+  FuzzJobFrontier(int num_workers, int epoch_count);
+
+  // Takes the lock which serializes the additions, from its holder if that
+  // process has died.
+  void Lock();
+  void Unlock();
+
+  // the size of the shared memory mapping.
+  size_t mapping_size_;
+  const int num_workers_;
+  const int epoch_count_;
+  // pid of the process which holds the lock, or 0.
+  atomic<pid_t> lock_owner_;
+  // number of jobs claimed so far, including those past epoch_count_.
+  atomic<int> epochs_started_;
+  // the index of the next job to claim and the number of added jobs.
+  atomic<uint32_t> next_job_;
+  atomic<uint32_t> num_jobs_;
+  atomic<uint32_t> num_submodules_;
+  WorkerSlot workers_[kMaxWorkers];
+  char submodule_names_[kMaxSubmodules][kMaxSubmoduleNameLength];
+  FuzzJob jobs_[kMaxJobs];
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_FUZZ_JOB_FRONTIER_H__
@@ -17,6 +17,12 @@
 #ifndef __VTS_SYSFUZZER_COMMON_FUZZER_BASE_H__
 #define __VTS_SYSFUZZER_COMMON_FUZZER_BASE_H__
 
+#include <atomic>
+#include <functional>
+#include <mutex>
+
+#include <utils/RefBase.h>
+
 #include "component_loader/DllLoader.h"
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
@@ -26,6 +32,18 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// The outcome of the calls run by FuzzerBase::ForkAndRun.
+struct ForkRunResult {
+  // the number of calls the child finished.
+  int completed_calls;
+  // true if the child was killed by a signal (e.g., crashed in the target),
+  // which is in signal.
+  bool crashed;
+  int signal;
+  // true if a call took longer than the timeout, so the child was killed.
+  bool timed_out;
+};
+
 class FuzzerBase {
  public:
   FuzzerBase(int target_class);
@@ -38,10 +56,20 @@ class FuzzerBase {
   // sets the target object (used for HAL_CONVENTIONAL_SUBMODULE).
   bool SetTargetObject(void* object_pointer);
 
+  // returns the target object set by SetTargetObject.
+  void* GetTargetObject() const { return hmi_; }
+
   // Gets the HIDL service.
   // Returns true iff successful.
   virtual bool GetService(bool get_stub, const char* service_name);
 
+  // Returns true if the HIDL service got by GetService has died since, in
+  // which case the next GetService gets it again.
+  bool HasServiceDied() const { return service_died_; }
+
+  // Marks the HIDL service as dead (e.g., on a binder death notification).
+  void SetServiceDied() { service_died_ = true; }
+
   // Open Conventional Hal
   int OpenConventionalHal(const char* module_name = NULL);
 
@@ -75,6 +103,39 @@ class FuzzerBase {
     return false;
   }
 
+  // Runs call(index) for each index in [0, num_calls) in a child forked from
+  // this process, where the target is already loaded (and opened), so the
+  // calls don't pay for that and a crash or hang in the target only takes the
+  // child down. The child is killed if a call takes more than timeout_ms.
+  // Returns false if the child can't be started; otherwise puts how far it
+  // got and how it ended in result (if the target exits the child, it got
+  // less than num_calls far without crashing).
+  bool ForkAndRun(int num_calls, const std::function<void(int)>& call,
+                  int timeout_ms, ForkRunResult* result);
+
+  // Makes the targets loaded from now on dump their code coverage counters
+  // in memory instead of in gcda files, which FunctionCallEnd then reads
+  // without any file I/O. FunctionCallEnd takes all the dumps made since the
+  // last one, so the calls must not run concurrently. Returns true iff
+  // successful.
+  static bool EnableInMemoryCoverage();
+
+  // By default, FunctionCallEnd sends the raw gcda files of each call. If
+  // delta_only, the gcda files add up all the calls, the raw files are only
+  // sent the first time and coverage_delta has the counters which changed
+  // since the last call, which the host then has to add up.
+  static void SetCoverageDeltaOnly(bool delta_only);
+
+  // Returns true iff FunctionCallEnd collects the code coverage (i.e., in a
+  // coverage build).
+  static bool CollectsCoverage();
+
+  // The gcda files FunctionCallBegin removes and the counters FunctionCallEnd
+  // flushes are shared by the whole process, so calls of which the coverage
+  // is collected must run one at a time from FunctionCallBegin through
+  // FunctionCallEnd, holding this lock (e.g., with --call_threads).
+  static std::mutex& CoverageCallLock();
+
   // Called before calling a target function.
   void FunctionCallBegin();
 
@@ -100,6 +161,14 @@ class FuzzerBase {
   // component.
   struct hw_module_t* hmi_;
 
+  // Called by GetService once it has a new service linked to recipient, a
+  // hidl_death_recipient which is kept alive (HIDL holds it weakly) for as
+  // long as this.
+  void SetServiceDeathRecipient(const sp<RefBase>& recipient) {
+    service_death_recipient_ = recipient;
+    service_died_ = false;
+  }
+
  private:
   // a pointer to the string which contains the loaded component.
   char* target_dll_path_;
@@ -115,6 +184,12 @@ class FuzzerBase {
 
   // path to store the gcov output files.
   char* gcov_output_basepath_;
+
+  // the death recipient linked to the HIDL service.
+  sp<RefBase> service_death_recipient_;
+
+  // whether the HIDL service has died since GetService.
+  std::atomic<bool> service_died_;
 };
 
 }  // namespace vts
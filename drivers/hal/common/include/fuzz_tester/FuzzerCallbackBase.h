@@ -19,6 +19,8 @@
 
 #include "component_loader/DllLoader.h"
 
+#include <stdint.h>
+
 #include <string>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
@@ -29,6 +31,18 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// Counters of the callback requests which this process sends to the agent.
+struct FuzzerCallbackStats {
+  // requests accepted into a send queue.
+  uint64_t num_queued;
+  // requests written to the agent.
+  uint64_t num_sent;
+  // requests dropped as a send queue was full or the agent was unreachable.
+  uint64_t num_dropped;
+  // the most requests a send queue has held.
+  uint64_t max_queue_depth;
+};
+
 class FuzzerCallbackBase {
  public:
   FuzzerCallbackBase();
@@ -36,9 +50,20 @@ class FuzzerCallbackBase {
 
   static bool Register(const VariableSpecificationMessage& message);
 
+  // Returns the counters summed over the callback sockets of this process.
+  static FuzzerCallbackStats GetStats();
+
+  // Waits up to timeout_msec until all queued requests are sent or dropped.
+  // Returns true if none is left.
+  static bool Flush(int timeout_msec);
+
  protected:
   static const char* GetCallbackID(const string& name);
 
+  // Queues message for the agent's callback server at callback_socket_name
+  // and returns without waiting for the agent. A sender thread per process
+  // and socket writes the queued requests, in order, in batches over one
+  // connection.
   static void RpcCallToAgent(
       const AndroidSystemCallbackRequestMessage& message,
       const string& callback_socket_name);
@@ -42,6 +42,10 @@ class FuzzerWrapper {
   // specification message.
   FuzzerBase* GetFuzzer(const vts::ComponentSpecificationMessage& message);
 
+  // Returns a new instance of the FuzzerBase class which GetFuzzer returns
+  // for message, which the caller owns, or NULL.
+  FuzzerBase* CreateFuzzer(const vts::ComponentSpecificationMessage& message);
+
  private:
   // loaded file path.
   string spec_dll_path_;
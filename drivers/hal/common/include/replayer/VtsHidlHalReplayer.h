@@ -17,6 +17,7 @@
 #define __VTS_SYSFUZZER_COMMON_REPLAYER_VTSHIDLHALREPLAYER_H__
 
 #include "fuzz_tester/FuzzerWrapper.h"
+#include "specification_parser/ComponentSpecificationBundle.h"
 #include "test/vts/proto/VtsProfilingMessage.pb.h"
 
 namespace android {
@@ -33,8 +34,8 @@ class VtsHidlHalReplayer {
   VtsHidlHalReplayer(const std::string& spec_path,
       const std::string& callback_socket_name);
 
-  // Loads the given interface specification (.vts file) and parses it to
-  // ComponentSpecificationMessage.
+  // Loads the given interface specification from the spec bundle in
+  // spec_path, or else parses its .vts file, to ComponentSpecificationMessage.
   bool LoadComponentSpecification(const std::string& package,
                                   float version,
                                   const std::string& interface_name,
@@ -55,6 +56,8 @@ class VtsHidlHalReplayer {
   FuzzerWrapper wrapper_;
   // The interface specification ASCII proto file.
   std::string spec_path_;
+  // The compiled interface specification files in spec_path_, if any.
+  ComponentSpecificationBundle spec_bundle_;
   // The server socket port # of the agent.
   std::string callback_socket_name_;
 };
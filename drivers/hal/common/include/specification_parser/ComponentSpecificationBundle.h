@@ -0,0 +1,153 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUNDLE_H__
+#define __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUNDLE_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+using namespace std;
+
+// the name of the bundle which drivers look for in a spec dir.
+#define VTS_SPEC_BUNDLE_FILE_NAME "vts_specs.bundle"
+
+namespace android {
+namespace vts {
+
+// A spec dir compiled by vtsc -mSPEC_BUNDLE into one file: every
+// ComponentSpecificationMessage in the wire format plus a table of lookup
+// keys sorted by package/version dir, then by the key of
+// ComponentSpecificationIndex. A reader maps the file and decodes a message on
+// its first lookup, so nothing is parsed in the text format at runtime.
+//
+// Each spec also records the path, size and mtime (in seconds, which adb push
+// keeps) of its .vts file. On every lookup of a spec, its file in the spec dir
+// is stat'ed; if it has changed (or is gone) since the bundle was compiled,
+// the bundle doesn't return that spec, so the caller falls back to the .vts
+// files.
+//
+// The file is in the byte order of the host which wrote it (little endian on
+// all supported devices):
+//   BundleHeader
+//   BundleSpecEntry[num_specs]
+//   BundleKeyEntry[num_keys], sorted by key
+//   keys, .vts file paths and serialized messages
+class ComponentSpecificationBundle {
+ public:
+  ComponentSpecificationBundle() : data_(NULL), size_(0) {}
+  ~ComponentSpecificationBundle() { Close(); }
+
+  // Maps the bundle at path, which was compiled from the .vts files under
+  // spec_dir_path. Returns false if there's none or it is invalid.
+  bool Open(const string& path, const string& spec_dir_path);
+
+  bool IsOpen() const { return data_ != NULL; }
+
+  void Close();
+
+  // Returns the specification of a component in package_dir (the dir of
+  // package and version relative to the spec dir, e.g. "hal/conventional/
+  // light/1.0"), or NULL. The matching is that of ComponentSpecificationIndex.
+  // NULL is also returned if the .vts file of the spec has changed, even if
+  // the spec was returned before.
+  shared_ptr<const ComponentSpecificationMessage> Find(
+      const string& package_dir, int target_class, int target_type,
+      float target_version, const string& submodule_name,
+      const string& package, const string& component_name);
+
+  // Compiles the .vts files under spec_dir_path into a bundle at bundle_path.
+  // Returns the number of the bundled files, or -1 on error.
+  static int Write(const string& spec_dir_path, const string& bundle_path);
+
+ private:
+  static const char kMagic[4];
+  static const uint32_t kFormatVersion = 3;
+
+  struct BundleHeader {
+    char magic[4];
+    uint32_t format_version;
+    uint32_t num_keys;
+    uint32_t num_specs;
+  };
+
+  struct BundleKeyEntry {
+    uint32_t key_offset;
+    uint32_t key_length;
+    uint32_t spec_index;
+  };
+
+  // follows the 16-byte header, so source_mtime is aligned.
+  struct BundleSpecEntry {
+    uint32_t offset;
+    uint32_t length;
+    // the .vts file relative to the spec dir, and its mtime and size.
+    uint32_t source_path_offset;
+    uint32_t source_path_length;
+    int64_t source_mtime;
+    uint64_t source_size;
+  };
+
+  // The states of the specs in decoded_specs_.
+  enum SpecState : uint8_t {
+    SPEC_UNCHECKED,
+    SPEC_DECODED,
+    // it can't be decoded.
+    SPEC_UNUSABLE,
+  };
+
+  // Returns the bundle key of a lookup.
+  static string GetBundleKey(const string& package_dir, int target_class,
+                             int target_type, float target_version,
+                             const string& submodule_name,
+                             const string& package,
+                             const string& component_name);
+
+  // Compares the key of entry with key as memcmp does.
+  int CompareKey(const BundleKeyEntry& entry, const string& key) const;
+
+  // Returns true if the .vts file of spec has the mtime and size it had when
+  // the bundle was compiled.
+  bool IsSourceUnchanged(const BundleSpecEntry& spec) const;
+
+  // Returns the message of the spec at spec_index, decoding it if needed, or
+  // NULL if it's unusable or its .vts file has changed.
+  shared_ptr<const ComponentSpecificationMessage> GetSpec(uint32_t spec_index);
+
+  void* data_;
+  size_t size_;
+  const BundleHeader* header_;
+  const BundleKeyEntry* keys_;
+  const BundleSpecEntry* specs_;
+  string spec_dir_path_;
+
+  // guards decoded_specs_ and spec_states_.
+  std::mutex mutex_;
+  vector<shared_ptr<const ComponentSpecificationMessage>> decoded_specs_;
+  vector<SpecState> spec_states_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUNDLE_H__
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECINDEX_H__
+#define __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECINDEX_H__
+
+#include <time.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Index of the interface specification files under the package/version dirs
+// of a spec dir, keyed by (class, type, version, package, component,
+// submodule). A dir is parsed on its first lookup; after that a lookup parses
+// nothing unless the dir or the found file has a new mtime, in which case the
+// changed files of the dir are parsed again.
+//
+// The messages are shared and immutable. One stays valid for as long as the
+// caller holds it, even if the index drops it. The index is thread-safe.
+class ComponentSpecificationIndex {
+ public:
+  ComponentSpecificationIndex() : num_parsed_files_(0) {}
+
+  // Returns the specification of a component in dir_path (a package/version
+  // dir), or NULL. The matching is that of
+  // SpecificationBuilder::FindComponentSpecification: the class and version
+  // always match; a HIDL HAL matches package and, if given, component_name;
+  // any other component matches target_type and, if given, submodule_name.
+  shared_ptr<const ComponentSpecificationMessage> Find(
+      const string& dir_path, int target_class, int target_type,
+      float target_version, const string& submodule_name,
+      const string& package, const string& component_name);
+
+  // Indexes all the package/version dirs under spec_dir_path ahead of time.
+  // Returns the number of indexed files.
+  int Preload(const string& spec_dir_path);
+
+  // Returns the number of files parsed so far.
+  int GetNumParsedFiles() const { return num_parsed_files_; }
+
+  // Returns the key of a lookup, where "" stands for a field not given.
+  static string GetKey(int target_class, int target_type, float target_version,
+                       const string& submodule_name, const string& package,
+                       const string& component_name);
+
+  // Adds the keys under which a lookup finds message to files_by_key (as
+  // file_index, unless the key is there already).
+  static void AddKeys(const ComponentSpecificationMessage& message,
+                      size_t file_index,
+                      unordered_map<string, size_t>* files_by_key);
+
+ private:
+  struct SpecFile {
+    string path;
+    struct timespec mtime;
+    shared_ptr<const ComponentSpecificationMessage> message;
+  };
+
+  struct SpecDir {
+    struct timespec mtime;
+    // in the readdir order, which decides between the files of a key.
+    vector<SpecFile> files;
+    // maps a key to the index of its first file.
+    unordered_map<string, size_t> files_by_key;
+  };
+
+  // (Re)indexes the dir at dir_path whose mtime is given, parsing only the
+  // files which are not in old_dir with the same mtime. Returns false if the
+  // dir can't be read.
+  bool IndexDir(const string& dir_path, const struct timespec& mtime,
+                const SpecDir* old_dir, SpecDir* dir);
+
+  // Indexes the dirs under dir_path recursively. Returns the number of
+  // indexed files.
+  int PreloadDir(const string& dir_path);
+
+  std::mutex mutex_;
+  // keyed by normalized dir path.
+  unordered_map<string, SpecDir> dirs_;
+  std::atomic<int> num_parsed_files_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECINDEX_H__
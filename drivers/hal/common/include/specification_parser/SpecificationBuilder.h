@@ -17,13 +17,20 @@
 #ifndef __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUILDER_H__
 #define __VTS_SYSFUZZER_COMMON_SPECPARSER_SPECBUILDER_H__
 
+#include <sys/types.h>
+
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <string>
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
 #include "fuzz_tester/FuzzerWrapper.h"
+#include "specification_parser/ComponentSpecificationBundle.h"
+#include "specification_parser/ComponentSpecificationIndex.h"
 
 using namespace std;
 
@@ -33,24 +40,40 @@ using namespace std;
 namespace android {
 namespace vts {
 
+class FuzzJobFrontier;
 class FuzzerBase;
 class InterfaceSpecification;
 
 // Builder of an interface specification.
 class SpecificationBuilder {
  public:
+  // The handle which refers to the last loaded component.
+  static const int kLastLoadedComponent = -1;
+
   // Constructor where the first argument is the path of a dir which contains
-  // all available interface specification files.
+  // all available interface specification files. The bundle of the dir
+  // (VTS_SPEC_BUNDLE_FILE_NAME), if any, is opened.
   SpecificationBuilder(const string dir_path, int epoch_count,
                        const string& callback_socket_name);
 
-  // scans the dir and returns an interface specification for a requested
-  // component.
+  // returns a new copy of the interface specification for a requested
+  // component, which the caller owns.
   vts::ComponentSpecificationMessage* FindComponentSpecification(
       const int target_class, const int target_type, const float target_version,
       const string submodule_name = "", const string package = "",
       const string component_name = "");
 
+  // returns the interface specification for a requested component from the
+  // spec bundle or else the index of the dir, without copying or (after the
+  // first lookup) parsing it.
+  shared_ptr<const ComponentSpecificationMessage>
+  FindSharedComponentSpecification(const int target_class,
+                                   const int target_type,
+                                   const float target_version,
+                                   const string& submodule_name = "",
+                                   const string& package = "",
+                                   const string& component_name = "");
+
   vts::ComponentSpecificationMessage*
       FindComponentSpecification(const string& component_name);
 
@@ -60,39 +83,211 @@ class SpecificationBuilder {
       const vts::ComponentSpecificationMessage& iface_spec_msg,
       const char* dll_file_name);
 
-  const string& CallFunction(FunctionSpecificationMessage* func_msg);
+  // Calls the function in func_msg of the component whose handle is
+  // component_handle (by default, the last loaded one) and puts its result in
+  // result, serialized in the protobuf wire format if binary_result is true or
+  // in the text format otherwise. Returns *result. If func_msg is on an arena,
+  // so are the messages made for the call.
+  const string& CallFunction(FunctionSpecificationMessage* func_msg,
+                             string* result, bool binary_result = false,
+                             int component_handle = kLastLoadedComponent);
 
-  const string& GetAttribute(FunctionSpecificationMessage* func_msg);
+  // Gets the attribute in func_msg. The result is put in result as in
+  // CallFunction.
+  const string& GetAttribute(FunctionSpecificationMessage* func_msg,
+                             string* result, bool binary_result = false,
+                             int component_handle = kLastLoadedComponent);
 
   // Main function for the VTS system fuzzer where dll_file_name is the path of
   // a target component, spec_lib_file_path is the path of a specification
   // library file, and the rest three arguments are the basic information of
-  // the target component.
+  // the target component. If jobs is more than 1, the fuzzing is done by that
+  // many worker processes (see ProcessInWorkers). If coverage_guided is true,
+  // the inputs are picked from the coverage of the earlier ones (see
+  // ProcessCoverageGuided). If fork_server_calls is more than 0, the target (a
+  // conventional HAL) is loaded once and each child forked from it makes that
+  // many calls (see ProcessInForkServer).
   bool Process(const char* dll_file_name, const char* spec_lib_file_path,
                int target_class, int target_type, float target_version,
-               const char* target_package, const char* target_component_name);
+               const char* target_package, const char* target_component_name,
+               int jobs = 1, bool coverage_guided = false,
+               int fork_server_calls = 0);
+
+  // Loads a target component in addition to those already loaded. Returns
+  // the handle of the component, which is that of an identical component if
+  // it is already loaded, or -1 on error.
+  int LoadTargetComponent(const char* dll_file_name,
+                          const char* spec_lib_file_path, int target_class,
+                          int target_type, float target_version,
+                          const char* target_package,
+                          const char* target_component_name,
+                          const char* hw_binder_service_name,
+                          const char* module_name);
+
+  // Returns the interface specification message of the loaded component whose
+  // handle is component_handle, or NULL.
+  ComponentSpecificationMessage* GetComponentSpecification(
+      int component_handle = kLastLoadedComponent) const;
+
+  // Returns the number of loaded components.
+  size_t GetLoadedComponentCount() const { return components_.size(); }
+
+  // Returns the handle which component_handle refers to (e.g., that of the
+  // last loaded component for kLastLoadedComponent).
+  int ResolveComponentHandle(int component_handle) const {
+    return component_handle == kLastLoadedComponent ? last_loaded_component_
+                                                    : component_handle;
+  }
 
-  bool LoadTargetComponent(const char* dll_file_name,
-                           const char* spec_lib_file_path, int target_class,
-                           int target_type, float target_version,
-                           const char* target_package,
-                           const char* target_component_name,
-                           const char* hw_binder_service_name,
-                           const char* module_name);
+  // Indexes all the interface specification files under the dir ahead of
+  // time (e.g., in a zygote driver before it forks) instead of on the first
+  // lookup of each package, unless a spec bundle is open. Returns the number
+  // of indexed files.
+  int PreloadComponentSpecifications() {
+    return spec_bundle_.IsOpen() ? 0 : spec_index_.Preload(dir_path_);
+  }
+
+  // Uses the spec bundle at bundle_path (compiled from the dir) instead of
+  // that of the dir. Returns false if it can't be opened.
+  bool OpenSpecificationBundle(const string& bundle_path) {
+    return spec_bundle_.Open(bundle_path, dir_path_);
+  }
+
+  // Sets the name of the HW binder service which Process fuzzes (for a HIDL
+  // HAL). By default, it's the last part of the package name.
+  void SetHwBinderServiceName(const string& service_name) {
+    hw_binder_service_name_ = service_name;
+  }
+
+  // Returns the number of GetFuzzerBase calls which reused a cached instance.
+  uint64_t GetFuzzerCacheHits() const { return fuzzer_cache_hits_; }
+
+  // Returns the number of GetFuzzerBase calls which had to load the target.
+  uint64_t GetFuzzerCacheMisses() const { return fuzzer_cache_misses_; }
+
+  // Sets the socket of the agent's callback server (e.g., in a driver forked
+  // by a zygote driver).
+  void SetCallbackSocketName(const string& callback_socket_name) {
+    callback_socket_name_ = callback_socket_name;
+  }
+
+ private:
+  // A component loaded by LoadTargetComponent.
+  struct LoadedComponent {
+    LoadedComponent() : handle(-1), if_spec_msg(NULL) {}
 
+    // the handle returned by LoadTargetComponent.
+    int handle;
+
+    // the specification library of the component.
+    FuzzerWrapper wrapper;
+    // the interface specification message.
+    ComponentSpecificationMessage* if_spec_msg;
+    string spec_lib_file_path;
+    string dll_file_name;
+    string module_name;
+    // HW binder service name only used for HIDL HAL
+    string hw_binder_service_name;
+    // map for submodule interface specification messages.
+    map<string, ComponentSpecificationMessage*> submodule_if_spec_map;
+    map<string, FuzzerBase*> submodule_fuzzerbase_map;
+  };
+
+  // Returns the loaded component whose handle is component_handle, or NULL.
+  LoadedComponent* GetLoadedComponent(int component_handle) const;
+
+  // Returns a FuzzerBase of the component in iface_spec_msg, which is that of
+  // component or one of its submodules, whose target (the dll file or, for
+  // HIDL, the service) is loaded. The instance is cached for component (so
+  // that two components with the same target, which may be called on
+  // different threads, don't share one) and returned again until the service
+  // dies.
   FuzzerBase* GetFuzzerBase(
+      LoadedComponent* component,
       const ComponentSpecificationMessage& iface_spec_msg,
-      const char* dll_file_name, const char* target_func_name);
+      const char* target_func_name);
 
+  // Returns a FuzzerBase of the submodule in iface_spec_msg whose target is
+  // object_pointer (e.g., returned by a call to component). One instance is
+  // cached for each component and submodule, and its target is replaced when
+  // a later call returns another object, as the old one may have been freed
+  // (and its address reused).
   FuzzerBase* GetFuzzerBaseSubModule(
+      LoadedComponent* component,
       const vts::ComponentSpecificationMessage& iface_spec_msg,
       void* object_pointer);
 
-  // Returns the loaded interface specification message.
-  ComponentSpecificationMessage* GetComponentSpecification() const;
+  // Returns the FuzzerBase which serves func_msg of component, which is that
+  // of a submodule if func_msg names one, or NULL.
+  FuzzerBase* GetFuzzerBaseForCall(LoadedComponent* component,
+                                   const FunctionSpecificationMessage& func_msg);
 
- private:
-  // A FuzzerWrapper instance.
+  // Finds the interface specification of the submodule returned by the call
+  // in func_msg and keeps a FuzzerBase for it in component, of which the
+  // object is return_value. Then puts func_msg in output as in
+  // SerializeResult.
+  const string& LoadSubModule(LoadedComponent* component,
+                              FunctionSpecificationMessage* func_msg,
+                              void* return_value, bool binary,
+                              string* output);
+
+  // Gets the service or loads the target component (dll_file_name) of
+  // iface_spec_msg for fuzzer.
+  bool LoadFuzzTarget(FuzzerBase* fuzzer,
+                      const ComponentSpecificationMessage& iface_spec_msg,
+                      const char* dll_file_name);
+
+  // Fuzzes the component in iface_spec_msg as Process does, with jobs worker
+  // processes which share the job frontier and the found submodules (see
+  // FuzzJobFrontier). Each worker has its own FuzzerBase instances, and one
+  // which dies (e.g., crashes in the HAL) is replaced while the others go on.
+  // The execs/sec and the stats of each worker are printed periodically.
+  bool ProcessInWorkers(const ComponentSpecificationMessage& iface_spec_msg,
+                        const char* dll_file_name, int target_class,
+                        int target_type, float target_version, int jobs);
+
+  // Fuzzes the conventional HAL in iface_spec_msg as Process does, except
+  // that the HAL is loaded and opened once and the calls are made by children
+  // forked from this process, calls_per_child each. The call in which a
+  // child crashes or times out (see FuzzerBase::ForkAndRun) is printed and the
+  // next child goes on from the call after it. Unlike in Process, the
+  // submodules returned in a child aren't fuzzed, since their objects are
+  // gone with the child.
+  bool ProcessInForkServer(const ComponentSpecificationMessage& iface_spec_msg,
+                           const char* dll_file_name, int calls_per_child);
+
+  // Fuzzes the component in iface_spec_msg for epoch_count_ calls whose
+  // inputs are picked by a FuzzCoverageScheduler from the coverage of each
+  // call (see FuzzerBase::FunctionCallEnd), instead of in the order of the
+  // job queue. The functions of a submodule are added once it's returned.
+  // The coverage reached over time is printed periodically.
+  bool ProcessCoverageGuided(
+      const ComponentSpecificationMessage& iface_spec_msg,
+      const char* dll_file_name, int target_class, int target_type,
+      float target_version);
+
+  // Forks a process which runs RunFuzzWorker. Its generators are seeded from
+  // the run's seed, worker and restart_count (the number of times worker has
+  // been replaced). Returns its pid, or -1.
+  pid_t StartFuzzWorker(FuzzJobFrontier* frontier, int worker,
+                        int restart_count,
+                        const ComponentSpecificationMessage& iface_spec_msg,
+                        const char* dll_file_name, int target_class,
+                        int target_type, float target_version);
+
+  // Carries out the jobs of frontier as worker until they are done.
+  void RunFuzzWorker(FuzzJobFrontier* frontier, int worker,
+                     const ComponentSpecificationMessage& iface_spec_msg,
+                     const char* dll_file_name, int target_class,
+                     int target_type, float target_version);
+
+  // Puts result_msg in output in the wire format if binary is true, or in the
+  // text format otherwise. Returns *output.
+  static const string& SerializeResult(
+      const FunctionSpecificationMessage& result_msg, bool binary,
+      string* output);
+
+  // A FuzzerWrapper instance used by Process.
   FuzzerWrapper wrapper_;
   // the path of a dir which contains interface specification ASCII proto files.
   const string dir_path_;
@@ -100,19 +295,29 @@ class SpecificationBuilder {
   const int epoch_count_;
   // fuzzing job queue.
   queue<pair<FunctionSpecificationMessage*, FuzzerBase*>> job_queue_;
-  // Loaded interface specification message.
-  ComponentSpecificationMessage* if_spec_msg_;
-  // TODO: use unique_ptr
-  char* spec_lib_file_path_;
-  char* dll_file_name_;
-  char* module_name_;
-  // HW binder service name only used for HIDL HAL
-  char* hw_binder_service_name_;
+  // the loaded components, keyed by their handles.
+  map<int, LoadedComponent*> components_;
+  // the handles of the loaded components, keyed by their LoadTargetComponent
+  // arguments.
+  map<string, int> component_handles_;
+  // the handle of the last loaded component, or -1.
+  int last_loaded_component_;
   // the server socket port # of the agent.
-  const string& callback_socket_name_;
-  // map for submodule interface specification messages.
-  map<string, ComponentSpecificationMessage*> submodule_if_spec_map_;
-  map<string, FuzzerBase*> submodule_fuzzerbase_map_;
+  string callback_socket_name_;
+  // the HW binder service name used by Process, or empty.
+  string hw_binder_service_name_;
+  // the compiled interface specification files, preferred if open.
+  ComponentSpecificationBundle spec_bundle_;
+  // the parsed interface specification files under dir_path_.
+  ComponentSpecificationIndex spec_index_;
+  // the FuzzerBase instances returned by GetFuzzerBase and
+  // GetFuzzerBaseSubModule, keyed by component and target.
+  map<string, FuzzerBase*> fuzzer_cache_;
+  // guards fuzzer_cache_, which the calls to different components (e.g., run
+  // by the threads of a driver session) share.
+  std::mutex fuzzer_cache_mutex_;
+  std::atomic<uint64_t> fuzzer_cache_hits_;
+  std::atomic<uint64_t> fuzzer_cache_misses_;
 };
 
 }  // namespace vts
@@ -26,6 +26,7 @@
 
 #include "fuzz_tester/FuzzerBase.h"
 #include "fuzz_tester/FuzzerWrapper.h"
+#include "specification_parser/ComponentSpecificationBundle.h"
 #include "specification_parser/InterfaceSpecificationParser.h"
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 #include "test/vts/proto/VtsProfilingMessage.pb.h"
@@ -38,7 +39,12 @@ namespace vts {
 
 VtsHidlHalReplayer::VtsHidlHalReplayer(const string& spec_path,
                                        const string& callback_socket_name)
-    : spec_path_(spec_path), callback_socket_name_(callback_socket_name) {}
+    : spec_path_(spec_path), callback_socket_name_(callback_socket_name) {
+  if (!spec_path_.empty()) {
+    spec_bundle_.Open(spec_path_ + '/' + VTS_SPEC_BUNDLE_FILE_NAME,
+                      spec_path_);
+  }
+}
 
 bool VtsHidlHalReplayer::LoadComponentSpecification(const string& package,
     float version, const string& interface_name,
@@ -56,10 +62,19 @@ bool VtsHidlHalReplayer::LoadComponentSpecification(const string& package,
   stringstream stream;
   stream << fixed << setprecision(1) << version;
   string version_str = stream.str();
+  shared_ptr<const ComponentSpecificationMessage> bundled_message =
+      spec_bundle_.Find(package_name + '/' + version_str, HAL_HIDL, 0, version,
+                        "", package, interface_name);
   string spec_file = spec_path_ + '/' + package_name + '/'
       + version_str + '/' + interface_name.substr(1) + ".vts";
-  cout << "spec_file: " << spec_file << endl;
-  if (InterfaceSpecificationParser::parse(spec_file.c_str(), message)) {
+  if (bundled_message) {
+    cout << "spec_file: " << spec_file << " (from the spec bundle)" << endl;
+    message->CopyFrom(*bundled_message);
+  } else {
+    cout << "spec_file: " << spec_file << endl;
+  }
+  if (bundled_message ||
+      InterfaceSpecificationParser::parse(spec_file.c_str(), message)) {
     if (message->component_class() != HAL_HIDL) {
       cerr << __func__ << ": only support Hidl Hal. " << endl;
       return false;
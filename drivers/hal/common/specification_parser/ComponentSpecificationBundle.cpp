@@ -0,0 +1,351 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "specification_parser/ComponentSpecificationBundle.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "specification_parser/ComponentSpecificationIndex.h"
+#include "specification_parser/InterfaceSpecificationParser.h"
+
+#define SPEC_FILE_EXT ".vts"
+
+namespace android {
+namespace vts {
+
+const char ComponentSpecificationBundle::kMagic[4] = {'V', 'T', 'S', 'B'};
+
+// A spec to be written to a bundle.
+struct BundledSpec {
+  string serialized;
+  // the .vts file relative to the spec dir, and its mtime and size.
+  string source_path;
+  int64_t source_mtime;
+  uint64_t source_size;
+};
+
+// Puts the mtime (in seconds) and size of the file at path in mtime and size.
+// Returns false if there's no such file.
+static bool StatFile(const string& path, int64_t* mtime, uint64_t* size) {
+  struct stat file_stat;
+  if (stat(path.c_str(), &file_stat) != 0) return false;
+  *mtime = file_stat.st_mtime;
+  *size = file_stat.st_size;
+  return true;
+}
+
+// Returns path with each run of '/'s collapsed into one and without a leading
+// or trailing '/'.
+static string NormalizePackageDir(const string& path) {
+  string result;
+  for (char c : path) {
+    if (c == '/' && (result.empty() || result.back() == '/')) continue;
+    result += c;
+  }
+  if (!result.empty() && result.back() == '/') result.pop_back();
+  return result;
+}
+
+string ComponentSpecificationBundle::GetBundleKey(
+    const string& package_dir, int target_class, int target_type,
+    float target_version, const string& submodule_name, const string& package,
+    const string& component_name) {
+  return NormalizePackageDir(package_dir) + '\0' +
+         ComponentSpecificationIndex::GetKey(target_class, target_type,
+                                             target_version, submodule_name,
+                                             package, component_name);
+}
+
+bool ComponentSpecificationBundle::Open(const string& path,
+                                        const string& spec_dir_path) {
+  Close();
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    if (errno != ENOENT) {
+      cerr << __func__ << ": Can't open " << path << " errno = " << errno
+           << endl;
+    }
+    return false;
+  }
+  struct stat file_stat;
+  void* data = MAP_FAILED;
+  if (fstat(fd, &file_stat) == 0 &&
+      (size_t)file_stat.st_size >= sizeof(BundleHeader)) {
+    data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  close(fd);
+  if (data == MAP_FAILED) {
+    cerr << __func__ << ": Can't map " << path << endl;
+    return false;
+  }
+  size_t size = file_stat.st_size;
+  const BundleHeader* header = (const BundleHeader*)data;
+  if (memcmp(header->magic, kMagic, sizeof(kMagic)) ||
+      header->format_version != kFormatVersion ||
+      header->num_keys > size / sizeof(BundleKeyEntry) ||
+      header->num_specs > size / sizeof(BundleSpecEntry) ||
+      sizeof(BundleHeader) + header->num_keys * sizeof(BundleKeyEntry) +
+              header->num_specs * sizeof(BundleSpecEntry) >
+          size) {
+    cerr << __func__ << ": " << path << " is not a valid bundle" << endl;
+    munmap(data, size);
+    return false;
+  }
+  data_ = data;
+  size_ = size;
+  header_ = header;
+  specs_ = (const BundleSpecEntry*)(header_ + 1);
+  keys_ = (const BundleKeyEntry*)(specs_ + header_->num_specs);
+  spec_dir_path_ = spec_dir_path;
+  decoded_specs_.assign(header_->num_specs, NULL);
+  spec_states_.assign(header_->num_specs, SPEC_UNCHECKED);
+  cout << __func__ << ": " << path << " has " << header_->num_specs
+       << " specifications" << endl;
+  return true;
+}
+
+void ComponentSpecificationBundle::Close() {
+  if (!data_) return;
+  munmap(data_, size_);
+  data_ = NULL;
+  size_ = 0;
+  decoded_specs_.clear();
+  spec_states_.clear();
+}
+
+int ComponentSpecificationBundle::CompareKey(const BundleKeyEntry& entry,
+                                             const string& key) const {
+  // an entry out of the file compares as the empty key.
+  size_t length = 0;
+  if (entry.key_offset <= size_ &&
+      entry.key_length <= size_ - entry.key_offset) {
+    length = entry.key_length;
+  }
+  int result = memcmp((const char*)data_ + entry.key_offset, key.data(),
+                      min(length, key.size()));
+  if (result != 0) return result;
+  return length < key.size() ? -1 : (length > key.size() ? 1 : 0);
+}
+
+shared_ptr<const ComponentSpecificationMessage>
+ComponentSpecificationBundle::Find(const string& package_dir, int target_class,
+                                   int target_type, float target_version,
+                                   const string& submodule_name,
+                                   const string& package,
+                                   const string& component_name) {
+  if (!data_) return NULL;
+  const string key =
+      GetBundleKey(package_dir, target_class, target_type, target_version,
+                   submodule_name, package, component_name);
+  const BundleKeyEntry* end = keys_ + header_->num_keys;
+  const BundleKeyEntry* entry = std::lower_bound(
+      keys_, end, key, [this](const BundleKeyEntry& a, const string& b) {
+        return CompareKey(a, b) < 0;
+      });
+  if (entry == end || CompareKey(*entry, key) != 0) return NULL;
+  return GetSpec(entry->spec_index);
+}
+
+bool ComponentSpecificationBundle::IsSourceUnchanged(
+    const BundleSpecEntry& spec) const {
+  if (spec.source_path_offset > size_ ||
+      spec.source_path_length > size_ - spec.source_path_offset) {
+    return false;
+  }
+  const string source_path =
+      spec_dir_path_ + "/" +
+      string((const char*)data_ + spec.source_path_offset,
+             spec.source_path_length);
+  int64_t source_mtime;
+  uint64_t source_size;
+  if (!StatFile(source_path, &source_mtime, &source_size) ||
+      source_mtime != spec.source_mtime || source_size != spec.source_size) {
+    cerr << __func__ << ": " << source_path
+         << " has changed since the bundle was compiled; using the file"
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+shared_ptr<const ComponentSpecificationMessage>
+ComponentSpecificationBundle::GetSpec(uint32_t spec_index) {
+  if (spec_index >= header_->num_specs) return NULL;
+  const BundleSpecEntry& spec = specs_[spec_index];
+  // checked on every lookup, as a .vts file can be pushed at any time.
+  if (!IsSourceUnchanged(spec)) return NULL;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (spec_states_[spec_index] == SPEC_DECODED) {
+    return decoded_specs_[spec_index];
+  }
+  if (spec_states_[spec_index] == SPEC_UNUSABLE) return NULL;
+  // an undecodable spec stays so.
+  spec_states_[spec_index] = SPEC_UNUSABLE;
+  if (spec.offset > size_ || spec.length > size_ - spec.offset) return NULL;
+  ComponentSpecificationMessage* message = new ComponentSpecificationMessage();
+  if (!message->ParseFromArray((const char*)data_ + spec.offset,
+                               spec.length)) {
+    cerr << __func__ << ": Can't decode specification " << spec_index << endl;
+    delete message;
+    return NULL;
+  }
+  decoded_specs_[spec_index].reset(message);
+  spec_states_[spec_index] = SPEC_DECODED;
+  return decoded_specs_[spec_index];
+}
+
+// Adds the keys and serialized messages of the specification files in
+// dir_path (whose path relative to the spec dir is package_dir) and its
+// subdirs.
+static bool CollectSpecs(const string& dir_path, const string& package_dir,
+                         vector<pair<string, uint32_t>>* keys,
+                         vector<BundledSpec>* specs) {
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir) {
+    cerr << __func__ << ": Can't opendir " << dir_path << endl;
+    return false;
+  }
+  vector<string> subdirs;
+  vector<string> files;
+  struct dirent* ent;
+  while ((ent = readdir(dir))) {
+    string name(ent->d_name);
+    if (ent->d_type == DT_DIR) {
+      if (name != "." && name != "..") subdirs.push_back(name);
+    } else if (ent->d_type == DT_REG &&
+               name.find(SPEC_FILE_EXT) != string::npos) {
+      files.push_back(name);
+    }
+  }
+  closedir(dir);
+
+  // the first file of a key in the readdir order wins, as in
+  // ComponentSpecificationIndex.
+  unordered_map<string, size_t> specs_by_key;
+  for (const string& name : files) {
+    ComponentSpecificationMessage message;
+    const string file_path = dir_path + "/" + name;
+    // skipped as it is by the drivers.
+    if (!InterfaceSpecificationParser::parse(file_path.c_str(), &message)) {
+      cerr << __func__ << ": skipping " << file_path << endl;
+      continue;
+    }
+    BundledSpec spec;
+    if (!message.SerializeToString(&spec.serialized)) return false;
+    spec.source_path = NormalizePackageDir(package_dir + "/" + name);
+    if (!StatFile(file_path, &spec.source_mtime, &spec.source_size)) {
+      cerr << __func__ << ": Can't read " << file_path << endl;
+      return false;
+    }
+    ComponentSpecificationIndex::AddKeys(message, specs->size(),
+                                         &specs_by_key);
+    specs->push_back(spec);
+  }
+  const string normalized_package_dir = NormalizePackageDir(package_dir);
+  for (const auto& key : specs_by_key) {
+    keys->push_back(
+        make_pair(normalized_package_dir + '\0' + key.first, key.second));
+  }
+
+  for (const string& name : subdirs) {
+    if (!CollectSpecs(dir_path + "/" + name, package_dir + "/" + name, keys,
+                      specs)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int ComponentSpecificationBundle::Write(const string& spec_dir_path,
+                                       const string& bundle_path) {
+  vector<pair<string, uint32_t>> keys;
+  vector<BundledSpec> specs;
+  if (!CollectSpecs(spec_dir_path, "", &keys, &specs)) return -1;
+  sort(keys.begin(), keys.end());
+
+  BundleHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.format_version = kFormatVersion;
+  header.num_keys = keys.size();
+  header.num_specs = specs.size();
+  vector<BundleKeyEntry> key_entries(keys.size());
+  vector<BundleSpecEntry> spec_entries(specs.size());
+  uint64_t offset = sizeof(header) + specs.size() * sizeof(BundleSpecEntry) +
+                    keys.size() * sizeof(BundleKeyEntry);
+  for (size_t i = 0; i < keys.size(); i++) {
+    key_entries[i].key_offset = offset;
+    key_entries[i].key_length = keys[i].first.size();
+    key_entries[i].spec_index = keys[i].second;
+    offset += keys[i].first.size();
+  }
+  for (size_t i = 0; i < specs.size(); i++) {
+    spec_entries[i].source_path_offset = offset;
+    spec_entries[i].source_path_length = specs[i].source_path.size();
+    spec_entries[i].source_mtime = specs[i].source_mtime;
+    spec_entries[i].source_size = specs[i].source_size;
+    offset += specs[i].source_path.size();
+  }
+  for (size_t i = 0; i < specs.size(); i++) {
+    spec_entries[i].offset = offset;
+    spec_entries[i].length = specs[i].serialized.size();
+    offset += specs[i].serialized.size();
+  }
+  if (offset > UINT32_MAX) {
+    cerr << __func__ << ": the bundle is too large" << endl;
+    return -1;
+  }
+
+  // written to a temporary file and renamed, so a driver which has mapped the
+  // old bundle keeps it intact.
+  const string temp_path = bundle_path + ".tmp";
+  ofstream out(temp_path, ios::binary | ios::trunc);
+  out.write((const char*)&header, sizeof(header));
+  out.write((const char*)spec_entries.data(),
+            spec_entries.size() * sizeof(BundleSpecEntry));
+  out.write((const char*)key_entries.data(),
+            key_entries.size() * sizeof(BundleKeyEntry));
+  for (const auto& key : keys) out.write(key.first.data(), key.first.size());
+  for (const BundledSpec& spec : specs) {
+    out.write(spec.source_path.data(), spec.source_path.size());
+  }
+  for (const BundledSpec& spec : specs) {
+    out.write(spec.serialized.data(), spec.serialized.size());
+  }
+  out.close();
+  if (!out || rename(temp_path.c_str(), bundle_path.c_str()) != 0) {
+    cerr << __func__ << ": Can't write " << bundle_path << endl;
+    unlink(temp_path.c_str());
+    return -1;
+  }
+  return specs.size();
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "specification_parser/ComponentSpecificationIndex.h"
+
+#include <dirent.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+#include <iostream>
+#include <string>
+
+#include "specification_parser/InterfaceSpecificationParser.h"
+
+#define SPEC_FILE_EXT ".vts"
+
+namespace android {
+namespace vts {
+
+// Returns path with each run of '/'s collapsed into one and without a
+// trailing '/'.
+static string NormalizePath(const string& path) {
+  string result;
+  for (char c : path) {
+    if (c == '/' && !result.empty() && result.back() == '/') continue;
+    result += c;
+  }
+  if (result.size() > 1 && result.back() == '/') result.pop_back();
+  return result;
+}
+
+// Returns the mtime of the file at path in mtime, or false if there's none.
+static bool GetMtime(const string& path, struct timespec* mtime) {
+  struct stat file_stat;
+  if (stat(path.c_str(), &file_stat) != 0) return false;
+  *mtime = file_stat.st_mtim;
+  return true;
+}
+
+static bool SameMtime(const struct timespec& a, const struct timespec& b) {
+  return a.tv_sec == b.tv_sec && a.tv_nsec == b.tv_nsec;
+}
+
+string ComponentSpecificationIndex::GetKey(int target_class, int target_type,
+                                           float target_version,
+                                           const string& submodule_name,
+                                           const string& package,
+                                           const string& component_name) {
+  // %a keeps every bit of the version.
+  char version[32];
+  snprintf(version, sizeof(version), "%a", target_version);
+  string key = to_string(target_class) + '\0' + version + '\0';
+  if (target_class == HAL_HIDL) {
+    key += package + '\0' + component_name;
+  } else {
+    key += to_string(target_type) + '\0' + submodule_name;
+  }
+  return key;
+}
+
+void ComponentSpecificationIndex::AddKeys(
+    const ComponentSpecificationMessage& message, size_t file_index,
+    unordered_map<string, size_t>* files_by_key) {
+  // emplace keeps the first file of a key.
+  int component_class = message.component_class();
+  float version = message.component_type_version();
+  if (component_class == HAL_HIDL) {
+    files_by_key->emplace(
+        GetKey(component_class, 0, version, "", message.package(), ""),
+        file_index);
+    files_by_key->emplace(GetKey(component_class, 0, version, "",
+                                 message.package(), message.component_name()),
+                          file_index);
+  } else {
+    files_by_key->emplace(
+        GetKey(component_class, message.component_type(), version, "", "", ""),
+        file_index);
+    if (component_class == HAL_CONVENTIONAL_SUBMODULE) {
+      files_by_key->emplace(
+          GetKey(component_class, message.component_type(), version,
+                 message.original_data_structure_name(), "", ""),
+          file_index);
+    }
+  }
+}
+
+bool ComponentSpecificationIndex::IndexDir(const string& dir_path,
+                                           const struct timespec& mtime,
+                                           const SpecDir* old_dir,
+                                           SpecDir* dir) {
+  DIR* dp = opendir(dir_path.c_str());
+  if (!dp) {
+    cerr << __func__ << ": Can't opendir " << dir_path << endl;
+    return false;
+  }
+  dir->mtime = mtime;
+  struct dirent* ent;
+  while ((ent = readdir(dp))) {
+    string name(ent->d_name);
+    if (ent->d_type != DT_REG || name.find(SPEC_FILE_EXT) == string::npos) {
+      continue;
+    }
+    SpecFile file;
+    file.path = dir_path + "/" + name;
+    if (!GetMtime(file.path, &file.mtime)) continue;
+    if (old_dir) {
+      for (const SpecFile& old_file : old_dir->files) {
+        if (old_file.path == file.path &&
+            SameMtime(old_file.mtime, file.mtime)) {
+          file.message = old_file.message;
+          break;
+        }
+      }
+    }
+    if (!file.message) {
+      ComponentSpecificationMessage* message =
+          new ComponentSpecificationMessage();
+      num_parsed_files_++;
+      if (!InterfaceSpecificationParser::parse(file.path.c_str(), message)) {
+        delete message;
+        continue;
+      }
+      file.message.reset(message);
+    }
+    AddKeys(*file.message, dir->files.size(), &dir->files_by_key);
+    dir->files.push_back(file);
+  }
+  closedir(dp);
+  return true;
+}
+
+shared_ptr<const ComponentSpecificationMessage>
+ComponentSpecificationIndex::Find(const string& dir_path, int target_class,
+                                  int target_type, float target_version,
+                                  const string& submodule_name,
+                                  const string& package,
+                                  const string& component_name) {
+  const string path = NormalizePath(dir_path);
+  const string key = GetKey(target_class, target_type, target_version,
+                            submodule_name, package, component_name);
+  std::lock_guard<std::mutex> lock(mutex_);
+  struct timespec dir_mtime;
+  if (!GetMtime(path, &dir_mtime)) {
+    cerr << __func__ << ": Can't stat " << path << endl;
+    dirs_.erase(path);
+    return NULL;
+  }
+  auto dir = dirs_.find(path);
+  // the second pass is taken only if the found file has changed.
+  for (int pass = 0; pass < 2; pass++) {
+    if (pass > 0 || dir == dirs_.end() ||
+        !SameMtime(dir->second.mtime, dir_mtime)) {
+      SpecDir new_dir;
+      if (!IndexDir(path, dir_mtime,
+                    dir == dirs_.end() ? NULL : &dir->second, &new_dir)) {
+        dirs_.erase(path);
+        return NULL;
+      }
+      dirs_[path] = std::move(new_dir);
+      dir = dirs_.find(path);
+    }
+    auto file_index = dir->second.files_by_key.find(key);
+    if (file_index == dir->second.files_by_key.end()) return NULL;
+    const SpecFile& file = dir->second.files[file_index->second];
+    struct timespec file_mtime;
+    if (GetMtime(file.path, &file_mtime) &&
+        SameMtime(file.mtime, file_mtime)) {
+      return file.message;
+    }
+  }
+  return NULL;
+}
+
+int ComponentSpecificationIndex::PreloadDir(const string& dir_path) {
+  DIR* dp = opendir(dir_path.c_str());
+  if (!dp) {
+    cerr << __func__ << ": Can't opendir " << dir_path << endl;
+    return 0;
+  }
+  int count = 0;
+  bool has_spec_files = false;
+  struct dirent* ent;
+  while ((ent = readdir(dp))) {
+    string name(ent->d_name);
+    if (ent->d_type == DT_DIR) {
+      if (name != "." && name != "..") {
+        count += PreloadDir(dir_path + "/" + name);
+      }
+    } else if (ent->d_type == DT_REG &&
+               name.find(SPEC_FILE_EXT) != string::npos) {
+      has_spec_files = true;
+    }
+  }
+  closedir(dp);
+
+  struct timespec mtime;
+  if (has_spec_files && GetMtime(dir_path, &mtime)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto old_dir = dirs_.find(dir_path);
+    SpecDir dir;
+    if (IndexDir(dir_path, mtime,
+                 old_dir == dirs_.end() ? NULL : &old_dir->second, &dir)) {
+      count += dir.files.size();
+      dirs_[dir_path] = std::move(dir);
+    }
+  }
+  return count;
+}
+
+int ComponentSpecificationIndex::Preload(const string& spec_dir_path) {
+  return PreloadDir(NormalizePath(spec_dir_path));
+}
+
+}  // namespace vts
+}  // namespace android
@@ -16,37 +16,89 @@
 
 #include "specification_parser/SpecificationBuilder.h"
 
-#include <dirent.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <deque>
 #include <iomanip>
 #include <iostream>
 #include <queue>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include <cutils/properties.h>
 
+#include "fuzz_tester/FuzzCoverageScheduler.h"
+#include "fuzz_tester/FuzzJobFrontier.h"
 #include "fuzz_tester/FuzzerBase.h"
 #include "fuzz_tester/FuzzerWrapper.h"
 #include "specification_parser/InterfaceSpecificationParser.h"
 #include "utils/InterfaceSpecUtil.h"
 #include "utils/StringUtil.h"
+#include "vts_random.h"
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/text_format.h>
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
 namespace android {
 namespace vts {
 
+// how often a parallel or coverage-guided fuzz run reports its stats.
+static const int kFuzzStatsIntervalSeconds = 5;
+// how long the parent of the fuzz workers sleeps between checks for exited
+// workers, and how long a worker waits for the jobs of busy workers.
+static const useconds_t kFuzzMonitorPollUsec = 10 * 1000;
+static const useconds_t kFuzzWorkerWaitUsec = 1000;
+// how long a call may take in a child of the fork server before the child is
+// killed.
+static const int kForkServerCallTimeoutMs = 10 * 1000;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns true if the passthrough (stub) implementation of a HIDL HAL is to
+// be used, as set by the vts.hidl.get_stub property, and puts the name of
+// the service of iface_spec_msg to get in service_name: hw_binder_service_name
+// if not empty or else the last part of the package name.
+static bool GetHidlServiceToUse(
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const string& hw_binder_service_name, string* service_name) {
+  bool get_stub = false;  /* default is binderized */
+  char get_sub_property[PROPERTY_VALUE_MAX];
+  if (property_get("vts.hidl.get_stub", get_sub_property, "") > 0) {
+    if (!strcmp(get_sub_property, "true") ||
+        !strcmp(get_sub_property, "True") ||
+        !strcmp(get_sub_property, "1")) {
+      get_stub = true;
+    }
+  }
+  if (!hw_binder_service_name.empty()) {
+    *service_name = hw_binder_service_name;
+  } else {
+    *service_name = iface_spec_msg.package().substr(
+        iface_spec_msg.package().find_last_of(".") + 1);
+  }
+  return get_stub;
+}
+
 SpecificationBuilder::SpecificationBuilder(const string dir_path,
                                            int epoch_count,
                                            const string& callback_socket_name)
     : dir_path_(dir_path),
       epoch_count_(epoch_count),
-      if_spec_msg_(NULL),
-      module_name_(NULL),
-      hw_binder_service_name_(NULL),
-      callback_socket_name_(callback_socket_name) {}
+      last_loaded_component_(-1),
+      callback_socket_name_(callback_socket_name),
+      fuzzer_cache_hits_(0),
+      fuzzer_cache_misses_(0) {
+  spec_bundle_.Open(dir_path_ + "/" + VTS_SPEC_BUNDLE_FILE_NAME, dir_path_);
+}
 
 vts::ComponentSpecificationMessage*
 SpecificationBuilder::FindComponentSpecification(const int target_class,
@@ -55,112 +107,108 @@ SpecificationBuilder::FindComponentSpecification(const int target_class,
                                                  const string submodule_name,
                                                  const string package,
                                                  const string component_name) {
-  DIR* dir;
-  struct dirent* ent;
+  shared_ptr<const ComponentSpecificationMessage> message =
+      FindSharedComponentSpecification(target_class, target_type,
+                                       target_version, submodule_name, package,
+                                       component_name);
+  if (!message) return NULL;
+  return new vts::ComponentSpecificationMessage(*message);
+}
+
+shared_ptr<const ComponentSpecificationMessage>
+SpecificationBuilder::FindSharedComponentSpecification(
+    const int target_class, const int target_type, const float target_version,
+    const string& submodule_name, const string& package,
+    const string& component_name) {
   cerr << __func__ << ": component " << component_name << endl;
 
   // Derive the package-specific dir which contains .vts files
-  string target_dir_path = dir_path_;
-  if (!endsWith(target_dir_path, "/")) {
-    target_dir_path += "/";
-  }
   string target_subdir_path = package;
   ReplaceSubString(target_subdir_path, ".", "/");
-  target_dir_path += target_subdir_path + "/";
-
   stringstream stream;
   stream << fixed << setprecision(1) << target_version;
-  target_dir_path += stream.str();
+  target_subdir_path += "/" + stream.str();
 
-  if (!(dir = opendir(target_dir_path.c_str()))) {
-    cerr << __func__ << ": Can't opendir " << target_dir_path << endl;
-    target_dir_path = "";
-    return NULL;
+  if (spec_bundle_.IsOpen()) {
+    shared_ptr<const ComponentSpecificationMessage> message =
+        spec_bundle_.Find(target_subdir_path, target_class, target_type,
+                          target_version, submodule_name, package,
+                          component_name);
+    if (message) {
+      cout << __func__ << ": found in the spec bundle" << endl;
+      return message;
+    }
   }
 
-  while ((ent = readdir(dir))) {
-    if (ent->d_type == DT_REG) {
-      if (string(ent->d_name).find(SPEC_FILE_EXT) != std::string::npos) {
-        cout << __func__ << ": Checking a file " << ent->d_name << endl;
-        const string file_path = target_dir_path + "/" + string(ent->d_name);
-        vts::ComponentSpecificationMessage* message =
-            new vts::ComponentSpecificationMessage();
-        if (InterfaceSpecificationParser::parse(file_path.c_str(), message)) {
-          if (message->component_class() != target_class) continue;
-
-          if (message->component_class() != HAL_HIDL) {
-            if (message->component_type() == target_type &&
-                message->component_type_version() == target_version) {
-              if (submodule_name.length() > 0) {
-                if (message->component_class() != HAL_CONVENTIONAL_SUBMODULE ||
-                    message->original_data_structure_name() != submodule_name) {
-                  continue;
-                }
-              }
-              closedir(dir);
-              return message;
-            }
-          } else {
-            if (message->package() == package &&
-                message->component_type_version() == target_version) {
-              if (component_name.length() > 0) {
-                if (message->component_name() != component_name) {
-                  continue;
-                }
-              }
-              closedir(dir);
-              return message;
-            }
-          }
-        }
-        delete message;
-      }
-    }
+  string target_dir_path = dir_path_;
+  if (!endsWith(target_dir_path, "/")) {
+    target_dir_path += "/";
   }
-  closedir(dir);
-  return NULL;
+  target_dir_path += target_subdir_path;
+  return spec_index_.Find(target_dir_path, target_class, target_type,
+                          target_version, submodule_name, package,
+                          component_name);
 }
 
 FuzzerBase* SpecificationBuilder::GetFuzzerBase(
+    LoadedComponent* component,
     const vts::ComponentSpecificationMessage& iface_spec_msg,
-    const char* dll_file_name, const char* /*target_func_name*/) {
+    const char* /*target_func_name*/) {
   cout << __func__ << ":" << __LINE__ << " " << "entry" << endl;
-  FuzzerBase* fuzzer = wrapper_.GetFuzzer(iface_spec_msg);
-  if (!fuzzer) {
-    cerr << __func__ << ": couldn't get a fuzzer base class" << endl;
-    return NULL;
+  bool get_stub = false;  /* default is binderized */
+  string service_name;
+  // a ready FuzzerBase is kept for each component and target: the dll file
+  // or, for HIDL, the service name and mode.
+  string cache_key = to_string(component->handle) + '\0' +
+                     GetFunctionNamePrefix(iface_spec_msg) + '\0';
+  if (iface_spec_msg.component_class() == HAL_HIDL) {
+    get_stub = GetHidlServiceToUse(
+        iface_spec_msg, component->hw_binder_service_name, &service_name);
+    cache_key += service_name + '\0' + (get_stub ? "stub" : "binderized");
+  } else {
+    cache_key += component->dll_file_name;
   }
 
-  // TODO: don't load multiple times. reuse FuzzerBase*.
-  cout << __func__ << ":" << __LINE__ << " " << "got fuzzer" << endl;
-  if (iface_spec_msg.component_class() == HAL_HIDL) {
-    char get_sub_property[PROPERTY_VALUE_MAX];
-    bool get_stub = false;  /* default is binderized */
-    if (property_get("vts.hidl.get_stub", get_sub_property, "") > 0) {
-      if (!strcmp(get_sub_property, "true") ||
-          !strcmp(get_sub_property, "True") ||
-          !strcmp(get_sub_property, "1")) {
-        get_stub = true;
-      }
-    }
-    const char* service_name;
-    if (hw_binder_service_name_ && strlen(hw_binder_service_name_) > 0) {
-      service_name = hw_binder_service_name_;
-    } else {
-      service_name = iface_spec_msg.package().substr(
-          iface_spec_msg.package().find_last_of(".") + 1).c_str();
+  // a target is loaded by one call at a time.
+  lock_guard<std::mutex> lock(fuzzer_cache_mutex_);
+  FuzzerBase* fuzzer = NULL;
+  auto cached = fuzzer_cache_.find(cache_key);
+  if (cached != fuzzer_cache_.end()) {
+    fuzzer = cached->second;
+    if (!fuzzer->HasServiceDied()) {
+      fuzzer_cache_hits_++;
+      return fuzzer;
     }
-    if (!fuzzer->GetService(get_stub, service_name)) {
-      cerr << __FUNCTION__ << ": couldn't get service" << endl;
+    // the same instance gets the restarted service below.
+    cout << __func__ << ": service " << service_name << " has died" << endl;
+  }
+  fuzzer_cache_misses_++;
+  if (!fuzzer) {
+    fuzzer = component->wrapper.CreateFuzzer(iface_spec_msg);
+    if (!fuzzer) {
+      cerr << __func__ << ": couldn't get a fuzzer base class" << endl;
       return NULL;
     }
+  }
+
+  cout << __func__ << ":" << __LINE__ << " " << "got fuzzer" << endl;
+  bool loaded;
+  if (iface_spec_msg.component_class() == HAL_HIDL) {
+    loaded = fuzzer->GetService(get_stub, service_name.c_str());
+    if (!loaded) cerr << __FUNCTION__ << ": couldn't get service" << endl;
   } else {
-    if (!fuzzer->LoadTargetComponent(dll_file_name)) {
+    loaded = fuzzer->LoadTargetComponent(component->dll_file_name.c_str());
+    if (!loaded) {
       cerr << __FUNCTION__ << ": couldn't load target component file, "
-           << dll_file_name << endl;
-      return NULL;
+           << component->dll_file_name << endl;
     }
   }
+  if (!loaded) {
+    if (cached != fuzzer_cache_.end()) fuzzer_cache_.erase(cached);
+    delete fuzzer;
+    return NULL;
+  }
+  fuzzer_cache_[cache_key] = fuzzer;
   cout << __func__ << ":" << __LINE__ << " "
        << "loaded target comp" << endl;
 
@@ -184,75 +232,83 @@ FuzzerBase* SpecificationBuilder::GetFuzzerBase(
 }
 
 FuzzerBase* SpecificationBuilder::GetFuzzerBaseSubModule(
+    LoadedComponent* component,
     const vts::ComponentSpecificationMessage& iface_spec_msg,
     void* object_pointer) {
   cout << __func__ << ":" << __LINE__ << " "
        << "entry object_pointer " << ((uint64_t)object_pointer) << endl;
-  FuzzerWrapper wrapper;
-  if (!wrapper.LoadInterfaceSpecificationLibrary(spec_lib_file_path_)) {
-    cerr << __func__ << " can't load specification lib, "
-         << spec_lib_file_path_ << endl;
+  if (iface_spec_msg.component_class() == HAL_HIDL) {
+    cerr << __func__ << " HIDL not supported" << endl;
     return NULL;
   }
-  FuzzerBase* fuzzer = wrapper.GetFuzzer(iface_spec_msg);
+  // a submodule's FuzzerBase is kept for each component and submodule, not
+  // for each target object, whose address may be reused once it's freed.
+  string cache_key = to_string(component->handle) + '\0' +
+                     GetFunctionNamePrefix(iface_spec_msg) + '\0' +
+                     "submodule";
+
+  lock_guard<std::mutex> lock(fuzzer_cache_mutex_);
+  auto cached = fuzzer_cache_.find(cache_key);
+  if (cached != fuzzer_cache_.end()) {
+    fuzzer_cache_hits_++;
+    FuzzerBase* fuzzer = cached->second;
+    if (fuzzer->GetTargetObject() != object_pointer) {
+      cout << __func__ << " the submodule object has changed" << endl;
+      fuzzer->SetTargetObject(object_pointer);
+    }
+    return fuzzer;
+  }
+  fuzzer_cache_misses_++;
+  FuzzerBase* fuzzer = component->wrapper.CreateFuzzer(iface_spec_msg);
   if (!fuzzer) {
     cerr << __FUNCTION__ << ": couldn't get a fuzzer base class" << endl;
     return NULL;
   }
 
-  // TODO: don't load multiple times. reuse FuzzerBase*.
   cout << __func__ << ":" << __LINE__ << " "
        << "got fuzzer" << endl;
-  if (iface_spec_msg.component_class() == HAL_HIDL) {
-    cerr << __func__ << " HIDL not supported" << endl;
+  if (!fuzzer->SetTargetObject(object_pointer)) {
+    cerr << __FUNCTION__ << ": couldn't set target object" << endl;
+    delete fuzzer;
     return NULL;
-  } else {
-    if (!fuzzer->SetTargetObject(object_pointer)) {
-      cerr << __FUNCTION__ << ": couldn't set target object" << endl;
-      return NULL;
-    }
   }
+  fuzzer_cache_[cache_key] = fuzzer;
   cout << __func__ << ":" << __LINE__ << " "
        << "loaded target comp" << endl;
   return fuzzer;
 }
 
-FuzzerBase* SpecificationBuilder::GetFuzzerBaseAndAddAllFunctionsToQueue(
+bool SpecificationBuilder::LoadFuzzTarget(
+    FuzzerBase* fuzzer,
     const vts::ComponentSpecificationMessage& iface_spec_msg,
     const char* dll_file_name) {
-  FuzzerBase* fuzzer = wrapper_.GetFuzzer(iface_spec_msg);
-  if (!fuzzer) {
-    cerr << __FUNCTION__ << ": couldn't get a fuzzer base class" << endl;
-    return NULL;
-  }
-
   if (iface_spec_msg.component_class() == HAL_HIDL) {
-    char get_sub_property[PROPERTY_VALUE_MAX];
-    bool get_stub = false; /* default is binderized */
-    if (property_get("vts.hidl.get_stub", get_sub_property, "") > 0) {
-      if (!strcmp(get_sub_property, "true") || !strcmp(get_sub_property, "True")
-          || !strcmp(get_sub_property, "1")) {
-        get_stub = true;
-      }
-    }
-    const char* service_name;
-    if (hw_binder_service_name_ && strlen(hw_binder_service_name_) > 0) {
-      service_name = hw_binder_service_name_;
-    } else {
-      service_name = iface_spec_msg.package().substr(
-          iface_spec_msg.package().find_last_of(".") + 1).c_str();
-    }
-    if (!fuzzer->GetService(get_stub, service_name)) {
+    string service_name;
+    bool get_stub = GetHidlServiceToUse(iface_spec_msg,
+                                        hw_binder_service_name_, &service_name);
+    if (!fuzzer->GetService(get_stub, service_name.c_str())) {
       cerr << __FUNCTION__ << ": couldn't get service" << endl;
-      return NULL;
+      return false;
     }
   } else {
     if (!fuzzer->LoadTargetComponent(dll_file_name)) {
       cerr << __FUNCTION__ << ": couldn't load target component file, "
           << dll_file_name << endl;
-      return NULL;
+      return false;
     }
   }
+  return true;
+}
+
+FuzzerBase* SpecificationBuilder::GetFuzzerBaseAndAddAllFunctionsToQueue(
+    const vts::ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name) {
+  FuzzerBase* fuzzer = wrapper_.GetFuzzer(iface_spec_msg);
+  if (!fuzzer) {
+    cerr << __FUNCTION__ << ": couldn't get a fuzzer base class" << endl;
+    return NULL;
+  }
+  if (!LoadFuzzTarget(fuzzer, iface_spec_msg, dll_file_name)) return NULL;
 
   for (const vts::FunctionSpecificationMessage& func_msg :
        iface_spec_msg.interface().api()) {
@@ -264,88 +320,189 @@ FuzzerBase* SpecificationBuilder::GetFuzzerBaseAndAddAllFunctionsToQueue(
   return fuzzer;
 }
 
-bool SpecificationBuilder::LoadTargetComponent(
+int SpecificationBuilder::LoadTargetComponent(
     const char* dll_file_name, const char* spec_lib_file_path, int target_class,
     int target_type, float target_version, const char* target_package,
     const char* target_component_name,
     const char* hw_binder_service_name, const char* module_name) {
   cout << __func__ << " entry dll_file_name = " << dll_file_name << endl;
-  if_spec_msg_ =
+  LoadedComponent* component = new LoadedComponent();
+  if (target_class == HAL_HIDL) {
+    component->spec_lib_file_path = string(target_package) + "@" +
+        GetVersionString(target_version) + "-vts.driver.so";
+    cout << __func__ << " spec lib path " << component->spec_lib_file_path
+         << endl;
+  } else {
+    component->spec_lib_file_path = spec_lib_file_path;
+  }
+  component->dll_file_name = dll_file_name;
+  component->module_name = module_name;
+  if (hw_binder_service_name) {
+    component->hw_binder_service_name = hw_binder_service_name;
+    cout << __func__ << ":" << __LINE__ << " hw_binder_service_name "
+         << component->hw_binder_service_name << endl;
+  }
+
+  // a component which is already loaded keeps its handle.
+  stringstream key;
+  key << target_class << '\0' << target_type << '\0' << target_version
+      << '\0' << target_package << '\0' << target_component_name << '\0'
+      << component->spec_lib_file_path << '\0' << component->dll_file_name
+      << '\0' << component->module_name << '\0'
+      << component->hw_binder_service_name;
+  auto loaded = component_handles_.find(key.str());
+  if (loaded != component_handles_.end()) {
+    cout << __func__ << " already loaded as " << loaded->second << endl;
+    delete component;
+    last_loaded_component_ = loaded->second;
+    return last_loaded_component_;
+  }
+
+  component->if_spec_msg =
       FindComponentSpecification(target_class, target_type, target_version,
                                  module_name, target_package,
                                  target_component_name);
-  if (!if_spec_msg_) {
+  if (!component->if_spec_msg) {
     cerr << __func__ << ": no interface specification file found for "
          << "class " << target_class << " type " << target_type << " version "
          << target_version << endl;
-    return false;
+    delete component;
+    return -1;
   }
-
-  if (target_class == HAL_HIDL) {
-    asprintf(&spec_lib_file_path_, "%s@%s-vts.driver.so", target_package,
-             GetVersionString(target_version).c_str());
-    cout << __func__ << " spec lib path " << spec_lib_file_path_ << endl;
-  } else {
-    spec_lib_file_path_ = (char*)malloc(strlen(spec_lib_file_path) + 1);
-    strcpy(spec_lib_file_path_, spec_lib_file_path);
+  if (!component->wrapper.LoadInterfaceSpecificationLibrary(
+          component->spec_lib_file_path.c_str())) {
+    cerr << __func__ << " can't load specification lib, "
+         << component->spec_lib_file_path << endl;
+    delete component->if_spec_msg;
+    delete component;
+    return -1;
   }
-
-  dll_file_name_ = (char*)malloc(strlen(dll_file_name) + 1);
-  strcpy(dll_file_name_, dll_file_name);
-
   string output;
-  if_spec_msg_->SerializeToString(&output);
+  component->if_spec_msg->SerializeToString(&output);
   cout << "loaded ifspec length " << output.length() << endl;
+  cout << __func__ << ":" << __LINE__ << " module_name "
+       << component->module_name << endl;
 
-  module_name_ = (char*)malloc(strlen(module_name) + 1);
-  strcpy(module_name_, module_name);
-  cout << __func__ << ":" << __LINE__ << " module_name " << module_name_
-       << endl;
-
-  if (hw_binder_service_name) {
-    hw_binder_service_name_ = (char*)malloc(strlen(hw_binder_service_name) + 1);
-    strcpy(hw_binder_service_name_, hw_binder_service_name);
-    cout << __func__ << ":" << __LINE__ << " hw_binder_service_name "
-         << hw_binder_service_name_ << endl;
-  }
-  return true;
+  int component_handle =
+      components_.empty() ? 0 : components_.rbegin()->first + 1;
+  component->handle = component_handle;
+  components_[component_handle] = component;
+  component_handles_[key.str()] = component_handle;
+  last_loaded_component_ = component_handle;
+  cout << __func__ << " component handle " << component_handle << endl;
+  return component_handle;
 }
 
-const string empty_string = string();
-
-const string& SpecificationBuilder::CallFunction(
-    FunctionSpecificationMessage* func_msg) {
-  cout << __func__ << ":" << __LINE__ << " entry" << endl;
-  if (!wrapper_.LoadInterfaceSpecificationLibrary(spec_lib_file_path_)) {
-    cerr << __func__ << ":" << __LINE__ << " lib loading failed" << endl;
-    return empty_string;
+SpecificationBuilder::LoadedComponent*
+SpecificationBuilder::GetLoadedComponent(int component_handle) const {
+  component_handle = ResolveComponentHandle(component_handle);
+  auto component = components_.find(component_handle);
+  if (component == components_.end()) {
+    cerr << __func__ << " no component loaded as " << component_handle
+         << endl;
+    return NULL;
   }
-  cout << __func__ << ":" << __LINE__ << " "
-       << "loaded if_spec lib " << func_msg << endl;
-  cout << __func__ << " " << dll_file_name_ << " " << func_msg->name() << endl;
+  return component->second;
+}
 
+FuzzerBase* SpecificationBuilder::GetFuzzerBaseForCall(
+    LoadedComponent* component, const FunctionSpecificationMessage& func_msg) {
+  cout << __func__ << " " << component->dll_file_name << " "
+       << func_msg.name() << endl;
   FuzzerBase* func_fuzzer;
-  if (func_msg->submodule_name().size() > 0) {
-    string submodule_name = func_msg->submodule_name();
+  if (func_msg.submodule_name().size() > 0) {
+    const string& submodule_name = func_msg.submodule_name();
     cout << __func__ << " submodule name " << submodule_name << endl;
-    if (submodule_fuzzerbase_map_.find(submodule_name)
-        != submodule_fuzzerbase_map_.end()) {
-      cout << __func__ << " call is for a submodule" << endl;
-      func_fuzzer = submodule_fuzzerbase_map_[submodule_name];
-    } else {
+    auto submodule = component->submodule_fuzzerbase_map.find(submodule_name);
+    if (submodule == component->submodule_fuzzerbase_map.end()) {
       cerr << __func__ << " called an API of a non-loaded submodule." << endl;
-      return empty_string;
+      return NULL;
     }
+    cout << __func__ << " call is for a submodule" << endl;
+    func_fuzzer = submodule->second;
   } else {
-    func_fuzzer = GetFuzzerBase(*if_spec_msg_, dll_file_name_,
-                                func_msg->name().c_str());
+    func_fuzzer = GetFuzzerBase(component, *component->if_spec_msg,
+                                func_msg.name().c_str());
   }
-  cout << __func__ << ":" << __LINE__ << endl;
   if (!func_fuzzer) {
-    cerr << "can't find FuzzerBase for '" << func_msg->name() << "' using '"
-         << dll_file_name_ << "'" << endl;
-    return empty_string;
+    cerr << "can't find FuzzerBase for '" << func_msg.name() << "' using '"
+         << component->dll_file_name << "'" << endl;
+  }
+  return func_fuzzer;
+}
+
+const string& SpecificationBuilder::LoadSubModule(
+    LoadedComponent* component, FunctionSpecificationMessage* func_msg,
+    void* return_value, bool binary, string* output) {
+  cerr << __func__ << "[driver:hal] return type TYPE_SUBMODULE" << endl;
+  if (return_value != NULL) {
+    // loads that interface spec and enqueues all functions.
+    cout << __func__ << " return type: " << func_msg->return_type().type()
+         << endl;
+  } else {
+    cout << __func__ << " return value = NULL" << endl;
   }
+  // find a VTS spec for that module
+  string submodule_name = func_msg->return_type().predefined_type().substr(
+      0, func_msg->return_type().predefined_type().size() - 1);
+  vts::ComponentSpecificationMessage* submodule_iface_spec_msg;
+  auto loaded = component->submodule_if_spec_map.find(submodule_name);
+  if (loaded != component->submodule_if_spec_map.end()) {
+    cout << __func__ << " submodule InterfaceSpecification already loaded"
+         << endl;
+    submodule_iface_spec_msg = loaded->second;
+    func_msg->mutable_return_type_submodule_spec()->CopyFrom(
+        *submodule_iface_spec_msg);
+    // the calls to the submodule go to the object returned this time.
+    component->submodule_fuzzerbase_map[submodule_name] =
+        GetFuzzerBaseSubModule(component, *submodule_iface_spec_msg,
+                               return_value);
+  } else {
+    const ComponentSpecificationMessage& if_spec_msg =
+        *component->if_spec_msg;
+    submodule_iface_spec_msg = FindComponentSpecification(
+        if_spec_msg.component_class(), if_spec_msg.component_type(),
+        if_spec_msg.component_type_version(), submodule_name,
+        if_spec_msg.package(), if_spec_msg.component_name());
+    if (!submodule_iface_spec_msg) {
+      cerr << __func__ << " submodule InterfaceSpecification not found" << endl;
+    } else {
+      cout << __func__ << " submodule InterfaceSpecification found" << endl;
+      func_msg->mutable_return_type_submodule_spec()->CopyFrom(
+          *submodule_iface_spec_msg);
+      FuzzerBase* func_fuzzer = GetFuzzerBaseSubModule(
+          component, *submodule_iface_spec_msg, return_value);
+      component->submodule_if_spec_map[submodule_name] =
+          submodule_iface_spec_msg;
+      component->submodule_fuzzerbase_map[submodule_name] = func_fuzzer;
+    }
+  }
+  return SerializeResult(*func_msg, binary, output);
+}
+
+const string& SpecificationBuilder::SerializeResult(
+    const FunctionSpecificationMessage& result_msg, bool binary,
+    string* output) {
+  if (binary) {
+    result_msg.SerializeToString(output);
+  } else {
+    google::protobuf::TextFormat::PrintToString(result_msg, output);
+  }
+  return *output;
+}
+
+const string& SpecificationBuilder::CallFunction(
+    FunctionSpecificationMessage* func_msg, string* result,
+    bool binary_result, int component_handle) {
+  cout << __func__ << ":" << __LINE__ << " entry" << endl;
+  LoadedComponent* component = GetLoadedComponent(component_handle);
+  if (!component) return result->assign("");
+  cout << __func__ << ":" << __LINE__ << " "
+       << "loaded if_spec lib " << func_msg << endl;
+
+  FuzzerBase* func_fuzzer = GetFuzzerBaseForCall(component, *func_msg);
+  cout << __func__ << ":" << __LINE__ << endl;
+  if (!func_fuzzer) return result->assign("");
 
   if (func_msg->name() == "#Open") {
     cout << __func__ << ":" << __LINE__ << " #Open" << endl;
@@ -368,36 +525,42 @@ const string& SpecificationBuilder::CallFunction(
         func_msg->mutable_return_type()->mutable_scalar_value()->set_int32_t(0);
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       }
     }
     cerr << __func__ << " return_type unknown" << endl;
-    string* output = new string();
-    google::protobuf::TextFormat::PrintToString(*func_msg, output);
-    return *output;
+    return SerializeResult(*func_msg, binary_result, result);
   }
   cout << __func__ << ":" << __LINE__ << endl;
 
-  void* result;
-  FunctionSpecificationMessage result_msg;
+  void* return_value;
+  // the result lives on the arena of the call, if any.
+  FunctionSpecificationMessage* result_msg =
+      google::protobuf::Arena::CreateMessage<FunctionSpecificationMessage>(
+          func_msg->GetArena());
+  unique_ptr<FunctionSpecificationMessage> result_msg_owner(
+      func_msg->GetArena() ? NULL : result_msg);
+  // calls to other components may run on other threads, but the coverage of
+  // each call has to be its own.
+  unique_lock<std::mutex> coverage_call_lock(FuzzerBase::CoverageCallLock(),
+                                             defer_lock);
+  if (FuzzerBase::CollectsCoverage()) coverage_call_lock.lock();
   func_fuzzer->FunctionCallBegin();
   cout << __func__ << " Call Function " << func_msg->name() << " parent_path("
        << func_msg->parent_path() << ")" << endl;
   // For Hidl HAL, use CallFunction method.
-  if (if_spec_msg_ && if_spec_msg_->component_class() == HAL_HIDL) {
+  if (component->if_spec_msg->component_class() == HAL_HIDL) {
     if (!func_fuzzer->CallFunction(*func_msg, callback_socket_name_,
-                                   &result_msg)) {
+                                   result_msg)) {
       cerr << __func__ << " function not found - todo handle more explicitly"
            << endl;
-      return *(new string("error"));
+      return result->assign("error");
     }
   } else {
-    if (!func_fuzzer->Fuzz(func_msg, &result, callback_socket_name_)) {
+    if (!func_fuzzer->Fuzz(func_msg, &return_value, callback_socket_name_)) {
       cerr << __func__ << " function not found - todo handle more explicitly"
            << endl;
-      return *(new string("error"));
+      return result->assign("error");
     }
   }
   cout << __func__ << ": called" << endl;
@@ -405,14 +568,12 @@ const string& SpecificationBuilder::CallFunction(
   // set coverage data.
   func_fuzzer->FunctionCallEnd(func_msg);
 
-  if (if_spec_msg_ && if_spec_msg_->component_class() == HAL_HIDL) {
-    string* output = new string();
-    google::protobuf::TextFormat::PrintToString(result_msg, output);
-    return *output;
+  if (component->if_spec_msg->component_class() == HAL_HIDL) {
+    return SerializeResult(*result_msg, binary_result, result);
   } else {
     if (func_msg->return_type().type() == TYPE_PREDEFINED) {
       // TODO: actually handle this case.
-      if (result != NULL) {
+      if (return_value != NULL) {
         // loads that interface spec and enqueues all functions.
         cout << __func__ << " return type: " << func_msg->return_type().type()
              << endl;
@@ -420,124 +581,58 @@ const string& SpecificationBuilder::CallFunction(
         cout << __func__ << " return value = NULL" << endl;
       }
       cerr << __func__ << " todo: support aggregate" << endl;
-      string* output = new string();
-      google::protobuf::TextFormat::PrintToString(*func_msg, output);
-      return *output;
+      return SerializeResult(*func_msg, binary_result, result);
     } else if (func_msg->return_type().type() == TYPE_SCALAR) {
       // TODO handle when the size > 1.
       if (!strcmp(func_msg->return_type().scalar_type().c_str(), "int32_t")) {
         func_msg->mutable_return_type()->mutable_scalar_value()->set_int32_t(
-            *((int*)(&result)));
+            *((int*)(&return_value)));
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       }
     } else if (func_msg->return_type().type() == TYPE_SUBMODULE) {
-      cerr << __func__ << "[driver:hal] return type TYPE_SUBMODULE" << endl;
-      if (result != NULL) {
-        // loads that interface spec and enqueues all functions.
-        cout << __func__ << " return type: " << func_msg->return_type().type()
-             << endl;
-      } else {
-        cout << __func__ << " return value = NULL" << endl;
-      }
-      // find a VTS spec for that module
-      string submodule_name = func_msg->return_type().predefined_type().substr(
-          0, func_msg->return_type().predefined_type().size() - 1);
-      vts::ComponentSpecificationMessage* submodule_iface_spec_msg;
-      if (submodule_if_spec_map_.find(submodule_name)
-          != submodule_if_spec_map_.end()) {
-        cout << __func__ << " submodule InterfaceSpecification already loaded"
-             << endl;
-        submodule_iface_spec_msg = submodule_if_spec_map_[submodule_name];
-        func_msg->set_allocated_return_type_submodule_spec(
-            submodule_iface_spec_msg);
-      } else {
-        submodule_iface_spec_msg =
-            FindComponentSpecification(
-                if_spec_msg_->component_class(), if_spec_msg_->component_type(),
-                if_spec_msg_->component_type_version(), submodule_name,
-                if_spec_msg_->package(), if_spec_msg_->component_name());
-        if (!submodule_iface_spec_msg) {
-          cerr << __func__ << " submodule InterfaceSpecification not found" << endl;
-        } else {
-          cout << __func__ << " submodule InterfaceSpecification found" << endl;
-          func_msg->set_allocated_return_type_submodule_spec(
-              submodule_iface_spec_msg);
-          FuzzerBase* func_fuzzer = GetFuzzerBaseSubModule(
-              *submodule_iface_spec_msg, result);
-          submodule_if_spec_map_[submodule_name] = submodule_iface_spec_msg;
-          submodule_fuzzerbase_map_[submodule_name] = func_fuzzer;
-        }
-      }
-      string* output = new string();
-      google::protobuf::TextFormat::PrintToString(*func_msg, output);
-      return *output;
+      return LoadSubModule(component, func_msg, return_value, binary_result,
+                           result);
     }
   }
-  return *(new string("void"));
+  return result->assign("void");
 }
 
 const string& SpecificationBuilder::GetAttribute(
-    FunctionSpecificationMessage* func_msg) {
-  if (!wrapper_.LoadInterfaceSpecificationLibrary(spec_lib_file_path_)) {
-    return empty_string;
-  }
-  cout << __func__ << " "
-       << "loaded if_spec lib" << endl;
-  cout << __func__ << " " << dll_file_name_ << " " << func_msg->name() << endl;
+    FunctionSpecificationMessage* func_msg, string* result,
+    bool binary_result, int component_handle) {
+  LoadedComponent* component = GetLoadedComponent(component_handle);
+  if (!component) return result->assign("");
 
-  FuzzerBase* func_fuzzer;
-  if (func_msg->submodule_name().size() > 0) {
-    string submodule_name = func_msg->submodule_name();
-    cout << __func__ << " submodule name " << submodule_name << endl;
-    if (submodule_fuzzerbase_map_.find(submodule_name)
-        != submodule_fuzzerbase_map_.end()) {
-      cout << __func__ << " call is for a submodule" << endl;
-      func_fuzzer = submodule_fuzzerbase_map_[submodule_name];
-    } else {
-      cerr << __func__ << " called an API of a non-loaded submodule." << endl;
-      return empty_string;
-    }
-  } else {
-    func_fuzzer = GetFuzzerBase(*if_spec_msg_, dll_file_name_,
-                                func_msg->name().c_str());
-  }
+  FuzzerBase* func_fuzzer = GetFuzzerBaseForCall(component, *func_msg);
   cout << __func__ << ":" << __LINE__ << endl;
-  if (!func_fuzzer) {
-    cerr << "can't find FuzzerBase for " << func_msg->name() << " using "
-         << dll_file_name_ << endl;
-    return empty_string;
-  }
+  if (!func_fuzzer) return result->assign("");
 
-  void* result;
+  void* return_value;
   cout << __func__ << " Get Atrribute " << func_msg->name() << " parent_path("
        << func_msg->parent_path() << ")" << endl;
-  if (!func_fuzzer->GetAttribute(func_msg, &result)) {
+  if (!func_fuzzer->GetAttribute(func_msg, &return_value)) {
     cerr << __func__ << " attribute not found - todo handle more explicitly"
          << endl;
-    return *(new string("error"));
+    return result->assign("error");
   }
   cout << __func__ << ": called" << endl;
 
-  if (if_spec_msg_ && if_spec_msg_->component_class() == HAL_HIDL) {
+  if (component->if_spec_msg->component_class() == HAL_HIDL) {
     cout << __func__ << ": for a HIDL HAL" << endl;
     func_msg->mutable_return_type()->set_type(TYPE_STRING);
     func_msg->mutable_return_type()->mutable_string_value()->set_message(
-        *(string*)result);
+        *(string*)return_value);
     func_msg->mutable_return_type()->mutable_string_value()->set_length(
-        ((string*)result)->size());
-    free(result);
-    string* output = new string();
-    google::protobuf::TextFormat::PrintToString(*func_msg, output);
-    return *output;
+        ((string*)return_value)->size());
+    free(return_value);
+    return SerializeResult(*func_msg, binary_result, result);
   } else {
     cout << __func__ << ": for a non-HIDL HAL" << endl;
     if (func_msg->return_type().type() == TYPE_PREDEFINED) {
       // TODO: actually handle this case.
-      if (result != NULL) {
+      if (return_value != NULL) {
         // loads that interface spec and enqueues all functions.
         cout << __func__ << " return type: " << func_msg->return_type().type()
              << endl;
@@ -545,88 +640,40 @@ const string& SpecificationBuilder::GetAttribute(
         cout << __func__ << " return value = NULL" << endl;
       }
       cerr << __func__ << " todo: support aggregate" << endl;
-      string* output = new string();
-      google::protobuf::TextFormat::PrintToString(*func_msg, output);
-      return *output;
+      return SerializeResult(*func_msg, binary_result, result);
     } else if (func_msg->return_type().type() == TYPE_SCALAR) {
       // TODO handle when the size > 1.
       if (!strcmp(func_msg->return_type().scalar_type().c_str(), "int32_t")) {
         func_msg->mutable_return_type()->mutable_scalar_value()->set_int32_t(
-            *((int*)(&result)));
+            *((int*)(&return_value)));
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       } else if (!strcmp(func_msg->return_type().scalar_type().c_str(), "uint32_t")) {
         func_msg->mutable_return_type()->mutable_scalar_value()->set_uint32_t(
-            *((int*)(&result)));
+            *((int*)(&return_value)));
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       } else if (!strcmp(func_msg->return_type().scalar_type().c_str(), "int16_t")) {
         func_msg->mutable_return_type()->mutable_scalar_value()->set_int16_t(
-            *((int*)(&result)));
+            *((int*)(&return_value)));
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       } else if (!strcmp(func_msg->return_type().scalar_type().c_str(), "uint16_t")) {
         func_msg->mutable_return_type()->mutable_scalar_value()->set_uint16_t(
-            *((int*)(&result)));
+            *((int*)(&return_value)));
         cout << "result " << endl;
         // todo handle more types;
-        string* output = new string();
-        google::protobuf::TextFormat::PrintToString(*func_msg, output);
-        return *output;
+        return SerializeResult(*func_msg, binary_result, result);
       }
     } else if (func_msg->return_type().type() == TYPE_SUBMODULE) {
-      cerr << __func__ << "[driver:hal] return type TYPE_SUBMODULE" << endl;
-      if (result != NULL) {
-        // loads that interface spec and enqueues all functions.
-        cout << __func__ << " return type: " << func_msg->return_type().type()
-             << endl;
-      } else {
-        cout << __func__ << " return value = NULL" << endl;
-      }
-      // find a VTS spec for that module
-      string submodule_name = func_msg->return_type().predefined_type().substr(
-          0, func_msg->return_type().predefined_type().size() - 1);
-      vts::ComponentSpecificationMessage* submodule_iface_spec_msg;
-      if (submodule_if_spec_map_.find(submodule_name)
-          != submodule_if_spec_map_.end()) {
-        cout << __func__ << " submodule InterfaceSpecification already loaded"
-             << endl;
-        submodule_iface_spec_msg = submodule_if_spec_map_[submodule_name];
-        func_msg->set_allocated_return_type_submodule_spec(
-            submodule_iface_spec_msg);
-      } else {
-        submodule_iface_spec_msg =
-            FindComponentSpecification(
-                if_spec_msg_->component_class(), if_spec_msg_->component_type(),
-                if_spec_msg_->component_type_version(), submodule_name,
-                if_spec_msg_->package(), if_spec_msg_->component_name());
-        if (!submodule_iface_spec_msg) {
-          cerr << __func__ << " submodule InterfaceSpecification not found" << endl;
-        } else {
-          cout << __func__ << " submodule InterfaceSpecification found" << endl;
-          func_msg->set_allocated_return_type_submodule_spec(
-              submodule_iface_spec_msg);
-          FuzzerBase* func_fuzzer = GetFuzzerBaseSubModule(
-              *submodule_iface_spec_msg, result);
-          submodule_if_spec_map_[submodule_name] = submodule_iface_spec_msg;
-          submodule_fuzzerbase_map_[submodule_name] = func_fuzzer;
-        }
-      }
-      string* output = new string();
-      google::protobuf::TextFormat::PrintToString(*func_msg, output);
-      return *output;
+      return LoadSubModule(component, func_msg, return_value, binary_result,
+                           result);
     }
   }
-  return *(new string("void"));
+  return result->assign("void");
 }
 
 bool SpecificationBuilder::Process(const char* dll_file_name,
@@ -634,11 +681,14 @@ bool SpecificationBuilder::Process(const char* dll_file_name,
                                    int target_class, int target_type,
                                    float target_version,
                                    const char* target_package,
-                                   const char* target_component_name) {
-  vts::ComponentSpecificationMessage* interface_specification_message =
-      FindComponentSpecification(target_class, target_type, target_version,
-                                 "", target_package, target_component_name);
-  cout << "ifspec addr " << interface_specification_message << endl;
+                                   const char* target_component_name,
+                                   int jobs, bool coverage_guided,
+                                   int fork_server_calls) {
+  shared_ptr<const ComponentSpecificationMessage>
+      interface_specification_message = FindSharedComponentSpecification(
+          target_class, target_type, target_version, "", target_package,
+          target_component_name);
+  cout << "ifspec addr " << interface_specification_message.get() << endl;
 
   if (!interface_specification_message) {
     cerr << __func__ << ": no interface specification file found for class "
@@ -651,6 +701,26 @@ bool SpecificationBuilder::Process(const char* dll_file_name,
     return false;
   }
 
+  if (coverage_guided) {
+    return ProcessCoverageGuided(*interface_specification_message,
+                                 dll_file_name, target_class, target_type,
+                                 target_version);
+  }
+  if (fork_server_calls > 0) {
+    if (interface_specification_message->component_class() !=
+        HAL_CONVENTIONAL) {
+      cerr << __func__ << ": the fork server is only for conventional HALs"
+           << endl;
+      return false;
+    }
+    return ProcessInForkServer(*interface_specification_message,
+                               dll_file_name, fork_server_calls);
+  }
+  if (jobs > 1) {
+    return ProcessInWorkers(*interface_specification_message, dll_file_name,
+                            target_class, target_type, target_version, jobs);
+  }
+
   if (!GetFuzzerBaseAndAddAllFunctionsToQueue(*interface_specification_message,
                                               dll_file_name))
     return false;
@@ -691,9 +761,9 @@ bool SpecificationBuilder::Process(const char* dll_file_name,
                 submodule_name.back() == '*')) {
           submodule_name.pop_back();
         }
-        vts::ComponentSpecificationMessage* iface_spec_msg =
-            FindComponentSpecification(target_class, target_type,
-                                       target_version, submodule_name);
+        shared_ptr<const ComponentSpecificationMessage> iface_spec_msg =
+            FindSharedComponentSpecification(target_class, target_type,
+                                             target_version, submodule_name);
         if (iface_spec_msg) {
           cout << __FUNCTION__ << " submodule found - " << submodule_name
                << endl;
@@ -714,10 +784,412 @@ bool SpecificationBuilder::Process(const char* dll_file_name,
   return true;
 }
 
+// Prints the coverage a coverage-guided fuzz run has reached so far.
+static void PrintCoverageStats(const FuzzCoverageScheduler& scheduler,
+                               double start) {
+  cout << "[coverage] " << fixed << setprecision(1) << (NowSeconds() - start)
+       << "s " << scheduler.GetExecCount() << " execs "
+       << scheduler.GetCoveredCounterCount() << " counters "
+       << scheduler.GetCoveredUnitCount() << " units "
+       << scheduler.GetCorpusSize() << " inputs" << endl;
+}
+
+bool SpecificationBuilder::ProcessCoverageGuided(
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name, int target_class, int target_type,
+    float target_version) {
+  // drawn from the seeded generators, so the run can be replayed.
+  FuzzCoverageScheduler scheduler(GetRandomEngine()());
+  // the scheduler reads the coverage_delta of each call.
+  FuzzerBase::SetCoverageDeltaOnly(true);
+  // the FuzzerBase of each function added to scheduler.
+  vector<FuzzerBase*> function_fuzzers;
+  // the specifications of the component ("") and the found submodules.
+  map<string, shared_ptr<const ComponentSpecificationMessage>> spec_msgs;
+  spec_msgs[""].reset(new ComponentSpecificationMessage(iface_spec_msg));
+  vector<string> pending_specs = {""};
+
+  double start = NowSeconds();
+  double last_report = start;
+  FunctionSpecificationMessage func_msg;
+  for (int i = 0; i < epoch_count_; i++) {
+    while (!pending_specs.empty()) {
+      const ComponentSpecificationMessage& spec_msg =
+          *spec_msgs[pending_specs.back()];
+      pending_specs.pop_back();
+      FuzzerBase* fuzzer = wrapper_.GetFuzzer(spec_msg);
+      if (!fuzzer || !LoadFuzzTarget(fuzzer, spec_msg, dll_file_name)) {
+        cerr << __func__ << ": couldn't get a fuzzer base class" << endl;
+        if (function_fuzzers.empty()) return false;
+        continue;
+      }
+      for (const FunctionSpecificationMessage& api :
+           spec_msg.interface().api()) {
+        scheduler.AddFunction(api, spec_msg);
+        function_fuzzers.push_back(fuzzer);
+      }
+    }
+
+    int function = scheduler.NextInput(&func_msg);
+    if (function < 0) {
+      cout << "no function to fuzz; stopping after epoch " << i << endl;
+      break;
+    }
+    FuzzerBase* func_fuzzer = function_fuzzers[function];
+    void* result = NULL;
+    FunctionSpecificationMessage result_msg;
+    cout << "Iteration " << (i + 1) << " Function " << func_msg.name() << endl;
+    func_fuzzer->FunctionCallBegin();
+    // For Hidl HAL, use CallFunction method.
+    if (iface_spec_msg.component_class() == HAL_HIDL) {
+      func_fuzzer->CallFunction(func_msg, callback_socket_name_, &result_msg);
+    } else {
+      func_fuzzer->Fuzz(&func_msg, &result, callback_socket_name_);
+    }
+    FunctionSpecificationMessage coverage_msg;
+    func_fuzzer->FunctionCallEnd(&coverage_msg);
+    int new_units = scheduler.RecordCoverage(coverage_msg);
+    if (new_units > 0) {
+      cout << "[coverage] " << func_msg.name() << " reached " << new_units
+           << " new units" << endl;
+    }
+
+    if (func_msg.return_type().type() == TYPE_PREDEFINED && result != NULL) {
+      // TODO: handle the case when size > 1
+      string submodule_name = func_msg.return_type().predefined_type();
+      while (!submodule_name.empty() &&
+             (std::isspace(submodule_name.back()) ||
+              submodule_name.back() == '*')) {
+        submodule_name.pop_back();
+      }
+      // unlike in Process, the functions of a submodule are added once.
+      if (spec_msgs.find(submodule_name) == spec_msgs.end()) {
+        shared_ptr<const ComponentSpecificationMessage> submodule_spec_msg =
+            FindSharedComponentSpecification(target_class, target_type,
+                                             target_version, submodule_name);
+        spec_msgs[submodule_name] = submodule_spec_msg;
+        if (submodule_spec_msg) {
+          cout << __FUNCTION__ << " submodule found - " << submodule_name
+               << endl;
+          pending_specs.push_back(submodule_name);
+        }
+      }
+    }
+
+    if (NowSeconds() - last_report >= kFuzzStatsIntervalSeconds) {
+      PrintCoverageStats(scheduler, start);
+      last_report = NowSeconds();
+    }
+  }
+  PrintCoverageStats(scheduler, start);
+  scheduler.PrintFunctionStats();
+  return true;
+}
+
+// Prints the execs/sec of a fork server run since the last report (at
+// last_report, when last_execs functions had been called) and how its children
+// ended.
+static void PrintForkServerStats(uint64_t execs, uint64_t children,
+                                 uint64_t crashes, uint64_t timeouts,
+                                 double start, double* last_report,
+                                 uint64_t* last_execs) {
+  double now = NowSeconds();
+  double interval = now - *last_report;
+  cout << "[fork server] " << fixed << setprecision(1) << (now - start)
+       << "s " << execs << " execs "
+       << (interval > 0 ? (execs - *last_execs) / interval : 0)
+       << " execs/s " << children << " children " << crashes << " crashes "
+       << timeouts << " timeouts" << endl;
+  *last_report = now;
+  *last_execs = execs;
+}
+
+bool SpecificationBuilder::ProcessInForkServer(
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name, int calls_per_child) {
+  FuzzerBase* fuzzer =
+      GetFuzzerBaseAndAddAllFunctionsToQueue(iface_spec_msg, dll_file_name);
+  if (!fuzzer) return false;
+  // so the children call an opened device. If it can't be opened, the calls
+  // fall back on the module as they do without the fork server.
+  if (fuzzer->OpenConventionalHal() < 0) {
+    cerr << __func__ << ": couldn't open the HAL" << endl;
+  }
+
+  deque<pair<FunctionSpecificationMessage*, FuzzerBase*>> jobs;
+  while (!job_queue_.empty()) {
+    jobs.push_back(job_queue_.front());
+    job_queue_.pop();
+  }
+
+  double start = NowSeconds();
+  double last_report = start;
+  uint64_t last_execs = 0;
+  uint64_t execs = 0;
+  uint64_t children = 0;
+  uint64_t crashes = 0;
+  uint64_t timeouts = 0;
+  int epoch = 0;
+  while (epoch < epoch_count_ && !jobs.empty()) {
+    int num_calls =
+        min({calls_per_child, epoch_count_ - epoch, (int)jobs.size()});
+    ForkRunResult result;
+    bool started = fuzzer->ForkAndRun(
+        num_calls,
+        [this, &jobs, epoch](int index) {
+          FunctionSpecificationMessage* func_msg = jobs[index].first;
+          void* return_value = NULL;
+          cout << "Iteration " << (epoch + index + 1) << " Function "
+               << func_msg->name() << endl;
+          jobs[index].second->Fuzz(func_msg, &return_value,
+                                   callback_socket_name_);
+        },
+        kForkServerCallTimeoutMs, &result);
+    if (!started) return false;
+    children++;
+    execs += result.completed_calls;
+
+    int finished = result.completed_calls;
+    if (finished < num_calls) {
+      // the call which took the child down isn't run again.
+      const string& name = jobs[finished].first->name();
+      if (result.timed_out) {
+        timeouts++;
+        cerr << "[fork server] " << name << " timed out" << endl;
+      } else if (result.crashed) {
+        crashes++;
+        cerr << "[fork server] " << name << " crashed by signal "
+             << result.signal << endl;
+      } else {
+        cerr << "[fork server] " << name << " exited the child" << endl;
+      }
+      finished++;
+    } else if (result.crashed || result.timed_out) {
+      cerr << "[fork server] a child died after its calls" << endl;
+    }
+    for (int index = 0; index < finished; index++) {
+      delete jobs.front().first;
+      jobs.pop_front();
+    }
+    epoch += finished;
+
+    if (NowSeconds() - last_report >= kFuzzStatsIntervalSeconds) {
+      PrintForkServerStats(execs, children, crashes, timeouts, start,
+                           &last_report, &last_execs);
+    }
+  }
+  if (jobs.empty()) {
+    cout << "no more job to process; stopping after epoch " << epoch << endl;
+  }
+  PrintForkServerStats(execs, children, crashes, timeouts, start,
+                       &last_report, &last_execs);
+  for (auto& job : jobs) delete job.first;
+  return true;
+}
+
+// Prints the execs/sec of a parallel fuzz run since the last report (at
+// last_report, when last_execs functions had been called) and the stats of
+// each worker.
+static void PrintFuzzStats(const FuzzJobFrontier& frontier, int num_workers,
+                           double start, double* last_report,
+                           uint64_t* last_execs) {
+  double now = NowSeconds();
+  uint64_t execs = 0;
+  for (int worker = 0; worker < num_workers; worker++) {
+    execs += frontier.GetWorkerStats(worker).execs;
+  }
+  double interval = now - *last_report;
+  cout << "[fuzz] " << fixed << setprecision(1) << (now - start) << "s "
+       << execs << " execs "
+       << (interval > 0 ? (execs - *last_execs) / interval : 0)
+       << " execs/s" << endl;
+  for (int worker = 0; worker < num_workers; worker++) {
+    FuzzWorkerStats stats = frontier.GetWorkerStats(worker);
+    cout << "[fuzz]   worker " << worker << " pid " << stats.pid << " execs "
+         << stats.execs << " crashes " << stats.crashes
+         << (stats.retired ? " (retired)" : "") << endl;
+  }
+  *last_report = now;
+  *last_execs = execs;
+}
+
+bool SpecificationBuilder::ProcessInWorkers(
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name, int target_class, int target_type,
+    float target_version, int jobs) {
+  FuzzJobFrontier* frontier = FuzzJobFrontier::Create(jobs, epoch_count_);
+  if (!frontier) return false;
+  bool added;
+  int submodule_index = frontier->AddSubmodule("", &added);
+  for (int index = 0; index < iface_spec_msg.interface().api_size(); index++) {
+    frontier->AddJob({(uint32_t)submodule_index, (uint32_t)index});
+  }
+
+  // the running workers, keyed by their pids, and how often each has been
+  // replaced.
+  map<pid_t, int> workers;
+  vector<int> restart_counts(jobs, 0);
+  for (int worker = 0; worker < jobs; worker++) {
+    pid_t pid = StartFuzzWorker(frontier, worker, 0, iface_spec_msg,
+                                dll_file_name, target_class, target_type,
+                                target_version);
+    if (pid > 0) workers[pid] = worker;
+  }
+
+  double start = NowSeconds();
+  double last_report = start;
+  uint64_t last_execs = 0;
+  while (!workers.empty()) {
+    int status;
+    pid_t pid = waitpid(-1, &status, WNOHANG);
+    if (pid > 0 && workers.find(pid) != workers.end()) {
+      int worker = workers[pid];
+      workers.erase(pid);
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        // the other workers go on, and so does this one unless the jobs are
+        // done or it keeps dying.
+        cerr << "[fuzz] worker " << worker << " pid " << pid << " died"
+             << (WIFSIGNALED(status) ? " by signal " : " with status ")
+             << (WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status))
+             << endl;
+        if (!frontier->AbandonWorker(worker)) {
+          cerr << "[fuzz] worker " << worker << " is retired after "
+               << FuzzJobFrontier::kMaxConsecutiveCrashes
+               << " crashes in a row" << endl;
+        } else if (!frontier->IsDone()) {
+          pid = StartFuzzWorker(frontier, worker, ++restart_counts[worker],
+                                iface_spec_msg, dll_file_name, target_class,
+                                target_type, target_version);
+          if (pid > 0) workers[pid] = worker;
+        }
+      }
+      continue;
+    }
+    if (NowSeconds() - last_report >= kFuzzStatsIntervalSeconds) {
+      PrintFuzzStats(*frontier, jobs, start, &last_report, &last_execs);
+    }
+    usleep(kFuzzMonitorPollUsec);
+  }
+  PrintFuzzStats(*frontier, jobs, start, &last_report, &last_execs);
+  frontier->Destroy();
+  return true;
+}
+
+pid_t SpecificationBuilder::StartFuzzWorker(
+    FuzzJobFrontier* frontier, int worker, int restart_count,
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name, int target_class, int target_type,
+    float target_version) {
+  // each worker, and each replacement of one, draws its own values, so a
+  // replaced worker doesn't replay the calls which killed it.
+  uint64_t worker_seed = DeriveRandomSeed(
+      DeriveRandomSeed(GetRandomNumberGeneratorSeed(), worker), restart_count);
+  cout << "[fuzz] worker " << worker << " restart " << restart_count
+       << " seed " << worker_seed << endl;
+  pid_t pid = fork();
+  if (pid == 0) {
+    frontier->SetWorkerPid(worker, getpid());
+    RandomNumberGeneratorSeed(worker_seed);
+    RunFuzzWorker(frontier, worker, iface_spec_msg, dll_file_name,
+                  target_class, target_type, target_version);
+    _exit(0);
+  }
+  if (pid < 0) {
+    cerr << __func__ << " ERROR can't fork worker " << worker << endl;
+  }
+  return pid;
+}
+
+void SpecificationBuilder::RunFuzzWorker(
+    FuzzJobFrontier* frontier, int worker,
+    const ComponentSpecificationMessage& iface_spec_msg,
+    const char* dll_file_name, int target_class, int target_type,
+    float target_version) {
+  // the specification and the FuzzerBase of each submodule this worker has
+  // had a job of, keyed by the submodule index.
+  map<uint32_t, pair<shared_ptr<const ComponentSpecificationMessage>,
+                     FuzzerBase*>> fuzzers;
+  FuzzJob job;
+  while (true) {
+    FuzzJobClaim claim = frontier->ClaimJob(worker, &job);
+    if (claim == FUZZ_JOB_DONE) break;
+    if (claim == FUZZ_JOB_PENDING) {
+      usleep(kFuzzWorkerWaitUsec);
+      continue;
+    }
+
+    auto& fuzzer = fuzzers[job.submodule_index];
+    if (!fuzzer.first) {
+      if (job.submodule_index == 0) {
+        fuzzer.first.reset(new ComponentSpecificationMessage(iface_spec_msg));
+      } else {
+        fuzzer.first = FindSharedComponentSpecification(
+            target_class, target_type, target_version,
+            frontier->GetSubmoduleName(job.submodule_index));
+      }
+      if (fuzzer.first) {
+        fuzzer.second = wrapper_.CreateFuzzer(*fuzzer.first);
+        if (fuzzer.second &&
+            !LoadFuzzTarget(fuzzer.second, *fuzzer.first, dll_file_name)) {
+          delete fuzzer.second;
+          fuzzer.second = NULL;
+        }
+      }
+    }
+    if (!fuzzer.second ||
+        (int)job.function_index >= fuzzer.first->interface().api_size()) {
+      frontier->FinishJob(worker);
+      continue;
+    }
+
+    FunctionSpecificationMessage func_msg(
+        fuzzer.first->interface().api(job.function_index));
+    void* result = NULL;
+    cout << "Worker " << worker << " Function " << func_msg.name() << endl;
+    // For Hidl HAL, use CallFunction method.
+    if (fuzzer.first->component_class() == HAL_HIDL) {
+      FunctionSpecificationMessage result_msg;
+      fuzzer.second->CallFunction(func_msg, callback_socket_name_,
+                                  &result_msg);
+    } else {
+      fuzzer.second->Fuzz(&func_msg, &result, callback_socket_name_);
+    }
+    if (func_msg.return_type().type() == TYPE_PREDEFINED && result != NULL) {
+      // TODO: handle the case when size > 1
+      string submodule_name = func_msg.return_type().predefined_type();
+      while (!submodule_name.empty() &&
+             (std::isspace(submodule_name.back()) ||
+              submodule_name.back() == '*')) {
+        submodule_name.pop_back();
+      }
+      shared_ptr<const ComponentSpecificationMessage> submodule_spec_msg =
+          FindSharedComponentSpecification(target_class, target_type,
+                                           target_version, submodule_name);
+      bool added;
+      int submodule_index =
+          submodule_spec_msg ? frontier->AddSubmodule(submodule_name, &added)
+                             : -1;
+      if (submodule_index >= 0) {
+        // as in Process, all the functions are queued each time it's found.
+        for (int index = 0;
+             index < submodule_spec_msg->interface().api_size(); index++) {
+          if (!frontier->AddJob({(uint32_t)submodule_index, (uint32_t)index})) {
+            cerr << __func__ << " the job frontier is full" << endl;
+            break;
+          }
+        }
+      }
+    }
+    frontier->FinishJob(worker);
+  }
+}
+
 vts::ComponentSpecificationMessage*
-SpecificationBuilder::GetComponentSpecification() const {
-  cout << "ifspec addr get " << if_spec_msg_ << endl;
-  return if_spec_msg_;
+SpecificationBuilder::GetComponentSpecification(int component_handle) const {
+  LoadedComponent* component = GetLoadedComponent(component_handle);
+  if (!component) return NULL;
+  cout << "ifspec addr get " << component->if_spec_msg << endl;
+  return component->if_spec_msg;
 }
 
 }  // namespace vts
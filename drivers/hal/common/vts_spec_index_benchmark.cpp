@@ -0,0 +1,253 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "specification_parser/ComponentSpecificationBundle.h"
+#include "specification_parser/ComponentSpecificationIndex.h"
+#include "specification_parser/InterfaceSpecificationParser.h"
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+/*
+ * Measures the lookup of every component specification under a spec dir
+ * (e.g., test/vts/specification), as done on each LoadHal, ReadSpecification
+ * and submodule return: by scanning and parsing the files of the
+ * package/version dir until one matches, as FindComponentSpecification used
+ * to, and by the first and the repeated lookups of ComponentSpecificationIndex
+ * and of a ComponentSpecificationBundle compiled from the dir (into a temporary
+ * file).
+ *
+ * Usage: vts_spec_index_benchmark <spec dir> [<iterations>]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultIterations = 100;
+
+struct Lookup {
+  string dir_path;
+  // dir_path relative to the spec dir.
+  string package_dir;
+  int target_class;
+  int target_type;
+  float target_version;
+  string submodule_name;
+  string package;
+  string component_name;
+};
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Adds a lookup for each specification file under dir_path, whose package is
+// made of the path components between the spec dir and the version dir.
+static void CollectLookups(const string& dir_path, const string& package,
+                           vector<Lookup>* lookups) {
+  DIR* dir = opendir(dir_path.c_str());
+  if (!dir) return;
+  struct dirent* ent;
+  while ((ent = readdir(dir))) {
+    string name(ent->d_name);
+    if (ent->d_type == DT_DIR && name != "." && name != "..") {
+      CollectLookups(dir_path + "/" + name,
+                     package.empty() ? name : package + "/" + name, lookups);
+    } else if (ent->d_type == DT_REG && name.find(".vts") != string::npos) {
+      ComponentSpecificationMessage message;
+      size_t version_begin = package.rfind('/');
+      if (version_begin == string::npos ||
+          !InterfaceSpecificationParser::parse(
+              (dir_path + "/" + name).c_str(), &message)) {
+        continue;
+      }
+      Lookup lookup;
+      lookup.dir_path = dir_path;
+      lookup.package_dir = package;
+      lookup.target_class = message.component_class();
+      lookup.target_type = message.component_type();
+      lookup.target_version = message.component_type_version();
+      if (message.component_class() == HAL_CONVENTIONAL_SUBMODULE) {
+        lookup.submodule_name = message.original_data_structure_name();
+      }
+      lookup.package = package.substr(0, version_begin);
+      for (char& c : lookup.package) {
+        if (c == '/') c = '.';
+      }
+      if (message.component_class() == HAL_HIDL) {
+        lookup.package = message.package();
+        lookup.component_name = message.component_name();
+      }
+      lookups->push_back(lookup);
+    }
+  }
+  closedir(dir);
+}
+
+// Finds lookup as FindComponentSpecification did before the index.
+static ComponentSpecificationMessage* ScanDir(const Lookup& lookup) {
+  DIR* dir = opendir(lookup.dir_path.c_str());
+  if (!dir) return NULL;
+  struct dirent* ent;
+  while ((ent = readdir(dir))) {
+    if (ent->d_type != DT_REG ||
+        string(ent->d_name).find(".vts") == string::npos) {
+      continue;
+    }
+    ComponentSpecificationMessage* message =
+        new ComponentSpecificationMessage();
+    if (InterfaceSpecificationParser::parse(
+            (lookup.dir_path + "/" + ent->d_name).c_str(), message) &&
+        message->component_class() == lookup.target_class &&
+        message->component_type_version() == lookup.target_version) {
+      bool found;
+      if (message->component_class() != HAL_HIDL) {
+        found = message->component_type() == lookup.target_type &&
+                (lookup.submodule_name.empty() ||
+                 (message->component_class() == HAL_CONVENTIONAL_SUBMODULE &&
+                  message->original_data_structure_name() ==
+                      lookup.submodule_name));
+      } else {
+        found = message->package() == lookup.package &&
+                (lookup.component_name.empty() ||
+                 message->component_name() == lookup.component_name);
+      }
+      if (found) {
+        closedir(dir);
+        return message;
+      }
+    }
+    delete message;
+  }
+  closedir(dir);
+  return NULL;
+}
+
+static bool FindInIndex(ComponentSpecificationIndex* index,
+                        const Lookup& lookup) {
+  return index->Find(lookup.dir_path, lookup.target_class, lookup.target_type,
+                     lookup.target_version, lookup.submodule_name,
+                     lookup.package, lookup.component_name) != NULL;
+}
+
+static bool FindInBundle(ComponentSpecificationBundle* bundle,
+                         const Lookup& lookup) {
+  return bundle->Find(lookup.package_dir, lookup.target_class,
+                      lookup.target_type, lookup.target_version,
+                      lookup.submodule_name, lookup.package,
+                      lookup.component_name) != NULL;
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 2 ? atoi(argv[2]) : kDefaultIterations;
+  if (argc < 2 || iterations <= 0) {
+    fprintf(stderr, "usage: %s <spec dir> [<iterations>]\n", argv[0]);
+    return 2;
+  }
+  vector<Lookup> lookups;
+  CollectLookups(argv[1], "", &lookups);
+  if (lookups.empty()) {
+    fprintf(stderr, "no specification under %s\n", argv[1]);
+    return 1;
+  }
+  // the parser logs the files it can't parse; keep that out of the
+  // measurement.
+  cerr.rdbuf(NULL);
+
+  double start = NowSeconds();
+  int found = 0;
+  for (int i = 0; i < iterations; i++) {
+    for (const Lookup& lookup : lookups) {
+      ComponentSpecificationMessage* message = ScanDir(lookup);
+      if (message) found++;
+      delete message;
+    }
+  }
+  double scan_us = (NowSeconds() - start) * 1e6 / iterations / lookups.size();
+  if (found != iterations * (int)lookups.size()) {
+    fprintf(stderr, "the scan missed a specification\n");
+    return 1;
+  }
+
+  ComponentSpecificationIndex index;
+  start = NowSeconds();
+  for (const Lookup& lookup : lookups) {
+    if (!FindInIndex(&index, lookup)) {
+      fprintf(stderr, "the index missed a specification\n");
+      return 1;
+    }
+  }
+  double first_us = (NowSeconds() - start) * 1e6 / lookups.size();
+  int parsed_files = index.GetNumParsedFiles();
+
+  start = NowSeconds();
+  for (int i = 0; i < iterations; i++) {
+    for (const Lookup& lookup : lookups) FindInIndex(&index, lookup);
+  }
+  double repeated_us =
+      (NowSeconds() - start) * 1e6 / iterations / lookups.size();
+
+  char bundle_path[] = "/tmp/vts_spec_index_benchmark_XXXXXX";
+  int bundle_fd = mkstemp(bundle_path);
+  if (bundle_fd < 0) {
+    fprintf(stderr, "can't create a temporary file\n");
+    return 1;
+  }
+  close(bundle_fd);
+  ComponentSpecificationBundle bundle;
+  bool bundled =
+      ComponentSpecificationBundle::Write(argv[1], bundle_path) >= 0 &&
+      bundle.Open(bundle_path, argv[1]);
+  unlink(bundle_path);
+  if (!bundled) {
+    fprintf(stderr, "can't compile a bundle\n");
+    return 1;
+  }
+  start = NowSeconds();
+  for (const Lookup& lookup : lookups) {
+    if (!FindInBundle(&bundle, lookup)) {
+      fprintf(stderr, "the bundle missed a specification\n");
+      return 1;
+    }
+  }
+  double bundle_first_us = (NowSeconds() - start) * 1e6 / lookups.size();
+  start = NowSeconds();
+  for (int i = 0; i < iterations; i++) {
+    for (const Lookup& lookup : lookups) FindInBundle(&bundle, lookup);
+  }
+  double bundle_repeated_us =
+      (NowSeconds() - start) * 1e6 / iterations / lookups.size();
+
+  printf("%zu lookups, %d iterations\n", lookups.size(), iterations);
+  printf("%-18s %12.2f us/lookup\n", "scan and parse", scan_us);
+  printf("%-18s %12.2f us/lookup\n", "index, first", first_us);
+  printf("%-18s %12.2f us/lookup (%d files parsed again)\n",
+         "index, repeated", repeated_us,
+         index.GetNumParsedFiles() - parsed_files);
+  printf("%-18s %12.2f us/lookup\n", "bundle, first", bundle_first_us);
+  printf("%-18s %12.2f us/lookup\n", "bundle, repeated", bundle_repeated_us);
+  return 0;
+}
@@ -28,6 +28,7 @@ LOCAL_SRC_FILES := \
   VtsFuzzerMain.cpp \
   BinderServer.cpp \
   SocketServer.cpp \
+  CallExecutor.cpp \
 
 LOCAL_C_INCLUDES := \
   bionic \
@@ -39,6 +40,7 @@ LOCAL_C_INCLUDES := \
   system/extras \
   test/vts/drivers/hal/common \
   test/vts/drivers/hal/framework \
+  test/vts/drivers/hal/libdatatype/include \
   test/vts/drivers/libdrivercomm \
 
 LOCAL_SHARED_LIBRARIES := \
@@ -49,6 +51,7 @@ LOCAL_SHARED_LIBRARIES := \
   libdl \
   libandroid_runtime \
   libvts_common \
+  libvts_datatype \
   libvts_drivercomm \
   libvts_multidevice_proto \
   libprotobuf-cpp-full \
@@ -56,3 +59,41 @@ LOCAL_SHARED_LIBRARIES := \
 LOCAL_MULTILIB := both
 
 include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_payload_codec_benchmark
+LOCAL_MODULE_TAGS := optional
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  vts_payload_codec_benchmark.cpp \
+
+LOCAL_C_INCLUDES := \
+  external/protobuf/src \
+
+LOCAL_SHARED_LIBRARIES := \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE := vts_driver_soak_benchmark
+LOCAL_MODULE_TAGS := optional
+LOCAL_CFLAGS += -Wall -Werror
+
+LOCAL_SRC_FILES := \
+  vts_driver_soak_benchmark.cpp \
+
+LOCAL_C_INCLUDES := \
+  external/protobuf/src \
+  test/vts/drivers/libdrivercomm \
+
+LOCAL_SHARED_LIBRARIES := \
+  libvts_drivercomm \
+  libvts_multidevice_proto \
+  libprotobuf-cpp-full \
+
+include $(BUILD_EXECUTABLE)
@@ -39,6 +39,8 @@
 #include "binder/VtsFuzzerBinderService.h"
 #include "specification_parser/SpecificationBuilder.h"
 
+#include <VtsDriverCommUtil.h>
+
 #include <google/protobuf/text_format.h>
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
 
@@ -144,15 +146,11 @@ class VtsFuzzerServer : public BnVtsFuzzer {
   int32_t LoadHal(const string& path, int target_class, int target_type,
                   float target_version, const string& module_name) {
     printf("VtsFuzzerServer::LoadHal(%s)\n", path.c_str());
-    bool success = spec_builder_.LoadTargetComponent(
+    int component_handle = spec_builder_.LoadTargetComponent(
         path.c_str(), lib_path_, target_class, target_type, target_version,
         module_name.c_str());
-    cout << "Result: " << success << std::endl;
-    if (success) {
-      return 0;
-    } else {
-      return -1;
-    }
+    cout << "Result: " << component_handle << std::endl;
+    return component_handle;
   }
 
   int32_t Status(int32_t type) {
@@ -162,10 +160,9 @@ class VtsFuzzerServer : public BnVtsFuzzer {
 
   const char* Call(const string& arg) {
     printf("VtsFuzzerServer::Call(%s)\n", arg.c_str());
-    FunctionSpecificationMessage* func_msg = new FunctionSpecificationMessage();
-    google::protobuf::TextFormat::MergeFromString(arg, func_msg);
-    const string& result = spec_builder_.CallFunction(func_msg);
-    return result.c_str();
+    FunctionSpecificationMessage func_msg;
+    google::protobuf::TextFormat::MergeFromString(arg, &func_msg);
+    return spec_builder_.CallFunction(&func_msg, &call_result_).c_str();
   }
 
   const char* GetFunctions() {
@@ -189,14 +186,17 @@ class VtsFuzzerServer : public BnVtsFuzzer {
  private:
   android::vts::SpecificationBuilder& spec_builder_;
   const char* lib_path_;
+  // the result of the last Call, valid until the next one.
+  string call_result_;
 };
 
 void StartBinderServer(const string& service_name,
                        android::vts::SpecificationBuilder& spec_builder,
-                       const char* lib_path) {
+                       const char* lib_path, int ready_fd) {
   defaultServiceManager()->addService(
       String16(service_name.c_str()),
       new VtsFuzzerServer(spec_builder, lib_path));
+  NotifyDriverReady(ready_fd);
   android::ProcessState::self()->startThreadPool();
   IPCThreadState::self()->joinThreadPool();
 }
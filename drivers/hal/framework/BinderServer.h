@@ -24,9 +24,11 @@
 namespace android {
 namespace vts {
 
+// Registers the driver as service_name and serves binder calls. Once it is
+// registered, the driver notifies ready_fd (see NotifyDriverReady).
 extern void StartBinderServer(const string& service_name,
                               android::vts::SpecificationBuilder& spec_builder,
-                              const char* lib_path);
+                              const char* lib_path, int ready_fd = -1);
 
 }  // namespace vts
 }  // namespace android
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CallExecutor.h"
+
+#include <iostream>
+
+namespace android {
+namespace vts {
+
+VtsDriverCallExecutor::VtsDriverCallExecutor(int num_threads)
+    : num_pending_calls_(0), stopping_(false) {
+  if (num_threads < 1) num_threads = 1;
+  for (int i = 0; i < num_threads; i++) {
+    threads_.push_back(thread(&VtsDriverCallExecutor::WorkerLoop, this));
+  }
+  cout << __func__ << " " << num_threads << " threads" << endl;
+}
+
+VtsDriverCallExecutor::~VtsDriverCallExecutor() {
+  WaitUntilIdle();
+  {
+    lock_guard<mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_cv_.notify_all();
+  for (thread& worker : threads_) worker.join();
+}
+
+void VtsDriverCallExecutor::Submit(int queue_id, function<void()> call) {
+  lock_guard<mutex> lock(mutex_);
+  CallQueue& queue = queues_[queue_id];
+  PendingCall pending_call;
+  pending_call.call = move(call);
+  pending_call.submit_time = chrono::steady_clock::now();
+  queue.calls.push_back(move(pending_call));
+  uint64_t depth = queue.calls.size() + (queue.running ? 1 : 0);
+  if (depth > queue.stats.max_depth) queue.stats.max_depth = depth;
+  num_pending_calls_++;
+  // a queue with a running call is made ready again once the call finishes.
+  if (!queue.running && queue.calls.size() == 1) {
+    ready_queue_ids_.push_back(queue_id);
+    ready_cv_.notify_one();
+  }
+}
+
+void VtsDriverCallExecutor::WaitUntilIdle() {
+  unique_lock<mutex> lock(mutex_);
+  idle_cv_.wait(lock, [this] { return num_pending_calls_ == 0; });
+}
+
+map<int, CallQueueStats> VtsDriverCallExecutor::GetStats() const {
+  lock_guard<mutex> lock(mutex_);
+  map<int, CallQueueStats> stats;
+  for (const auto& queue : queues_) stats[queue.first] = queue.second.stats;
+  return stats;
+}
+
+void VtsDriverCallExecutor::WorkerLoop() {
+  unique_lock<mutex> lock(mutex_);
+  while (true) {
+    ready_cv_.wait(lock,
+                   [this] { return stopping_ || !ready_queue_ids_.empty(); });
+    if (ready_queue_ids_.empty()) return;
+    int queue_id = ready_queue_ids_.front();
+    ready_queue_ids_.pop_front();
+    // the elements of a map stay where they are as others are added.
+    CallQueue& queue = queues_[queue_id];
+    PendingCall pending_call = move(queue.calls.front());
+    queue.calls.pop_front();
+    queue.running = true;
+
+    uint64_t wait_usec = chrono::duration_cast<chrono::microseconds>(
+        chrono::steady_clock::now() - pending_call.submit_time).count();
+    queue.stats.num_calls++;
+    queue.stats.total_wait_usec += wait_usec;
+    if (wait_usec > queue.stats.max_wait_usec) {
+      queue.stats.max_wait_usec = wait_usec;
+    }
+
+    lock.unlock();
+    pending_call.call();
+    lock.lock();
+
+    queue.running = false;
+    if (!queue.calls.empty()) {
+      // goes behind the other ready queues, so a busy queue doesn't keep
+      // this thread to itself.
+      ready_queue_ids_.push_back(queue_id);
+      ready_cv_.notify_one();
+    }
+    if (--num_pending_calls_ == 0) idle_cv_.notify_all();
+  }
+}
+
+}  // namespace vts
+}  // namespace android
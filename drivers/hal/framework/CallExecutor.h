@@ -0,0 +1,106 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_DRIVER_HAL_CALL_EXECUTOR_
+#define __VTS_DRIVER_HAL_CALL_EXECUTOR_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// Contention metrics of a call queue.
+struct CallQueueStats {
+  CallQueueStats()
+      : num_calls(0), max_depth(0), total_wait_usec(0), max_wait_usec(0) {}
+
+  // number of calls run.
+  uint64_t num_calls;
+  // max number of calls in the queue at once, including a running one.
+  uint64_t max_depth;
+  // time the calls waited in the queue before they ran.
+  uint64_t total_wait_usec;
+  uint64_t max_wait_usec;
+};
+
+// Runs the calls of a driver session on a bounded pool of threads. The calls
+// submitted to the same queue (e.g., those to a component) run one at a time
+// in the order submitted, while those in different queues may run at the
+// same time.
+class VtsDriverCallExecutor {
+ public:
+  explicit VtsDriverCallExecutor(int num_threads);
+
+  // Waits for all the submitted calls to finish.
+  ~VtsDriverCallExecutor();
+
+  // Adds call to the queue queue_id.
+  void Submit(int queue_id, function<void()> call);
+
+  // Waits until all the submitted calls have finished.
+  void WaitUntilIdle();
+
+  // Returns the metrics of each queue, keyed by its id.
+  map<int, CallQueueStats> GetStats() const;
+
+ private:
+  struct PendingCall {
+    function<void()> call;
+    chrono::steady_clock::time_point submit_time;
+  };
+
+  struct CallQueue {
+    CallQueue() : running(false) {}
+
+    // the calls which haven't started yet, in order.
+    deque<PendingCall> calls;
+    // whether a call of the queue is running.
+    bool running;
+    CallQueueStats stats;
+  };
+
+  // Runs the calls of the ready queues until the executor is destroyed.
+  void WorkerLoop();
+
+  mutable mutex mutex_;
+  // notified when a queue gets ready or the executor stops.
+  condition_variable ready_cv_;
+  // notified when the last pending call finishes.
+  condition_variable idle_cv_;
+  map<int, CallQueue> queues_;
+  // the ids of the queues which have calls and no running call.
+  deque<int> ready_queue_ids_;
+  // number of calls submitted which haven't finished.
+  size_t num_pending_calls_;
+  bool stopping_;
+  vector<thread> threads_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_DRIVER_HAL_CALL_EXECUTOR_
@@ -30,6 +30,7 @@
 #include <unistd.h>
 
 #include <dirent.h>
+#include <dlfcn.h>
 
 #include <netdb.h>
 #include <netinet/in.h>
@@ -37,6 +38,7 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
+#include <sys/wait.h>
 
 #include <utils/RefBase.h>
 
@@ -44,6 +46,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <VtsDriverCommUtil.h>
 
@@ -51,6 +54,7 @@
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
 #include "binder/VtsFuzzerBinderService.h"
+#include "fuzz_tester/FuzzerCallbackBase.h"
 #include "specification_parser/SpecificationBuilder.h"
 
 #include "test/vts/proto/ComponentSpecificationMessage.pb.h"
@@ -69,61 +73,157 @@ int32_t VtsDriverHalSocketServer::LoadHal(const string& path, int target_class,
                                           const string& hw_binder_service_name,
                                           const string& module_name) {
   printf("VtsFuzzerServer::LoadHal(%s)\n", path.c_str());
-  bool success = spec_builder_.LoadTargetComponent(
+  int component_handle = spec_builder_.LoadTargetComponent(
       path.c_str(), lib_path_, target_class, target_type, target_version,
       target_package.c_str(), target_component_name.c_str(),
       hw_binder_service_name.c_str(),
       module_name.c_str());
-  cout << "Result: " << success << std::endl;
-  if (success) {
-    return 0;
-  } else {
-    return -1;
-  }
+  cout << "Result: " << component_handle << std::endl;
+  return component_handle;
 }
 
 int32_t VtsDriverHalSocketServer::Status(int32_t type) {
   printf("VtsFuzzerServer::Status(%i)\n", type);
-  return 0;
+  FuzzerCallbackStats stats = FuzzerCallbackBase::GetStats();
+  uint64_t value;
+  switch (type) {
+    case VTS_DRIVER_STATUS_CALLBACKS_QUEUED:
+      value = stats.num_queued;
+      break;
+    case VTS_DRIVER_STATUS_CALLBACKS_SENT:
+      value = stats.num_sent;
+      break;
+    case VTS_DRIVER_STATUS_CALLBACKS_DROPPED:
+      value = stats.num_dropped;
+      break;
+    case VTS_DRIVER_STATUS_CALLBACK_MAX_QUEUE_DEPTH:
+      value = stats.max_queue_depth;
+      break;
+    case VTS_DRIVER_STATUS_FUZZER_CACHE_HITS:
+      value = spec_builder_.GetFuzzerCacheHits();
+      break;
+    case VTS_DRIVER_STATUS_FUZZER_CACHE_MISSES:
+      value = spec_builder_.GetFuzzerCacheMisses();
+      break;
+    case VTS_DRIVER_STATUS_CALL_QUEUE_MAX_DEPTH:
+    case VTS_DRIVER_STATUS_CALL_QUEUE_MAX_WAIT_USEC:
+      value = 0;
+      if (!call_executor_) break;
+      for (const auto& queue : call_executor_->GetStats()) {
+        uint64_t queue_value =
+            type == VTS_DRIVER_STATUS_CALL_QUEUE_MAX_DEPTH
+                ? queue.second.max_depth
+                : queue.second.max_wait_usec;
+        if (queue_value > value) value = queue_value;
+      }
+      break;
+    default:
+      return 0;
+  }
+  return value > INT32_MAX ? INT32_MAX : (int32_t)value;
+}
+
+string VtsDriverHalSocketServer::GetCallQueueStats() const {
+  stringstream output;
+  if (!call_executor_) return output.str();
+  for (const auto& queue : call_executor_->GetStats()) {
+    output << "component " << queue.first
+           << " calls " << queue.second.num_calls
+           << " max_depth " << queue.second.max_depth
+           << " total_wait_usec " << queue.second.total_wait_usec
+           << " max_wait_usec " << queue.second.max_wait_usec << endl;
+  }
+  return output.str();
 }
 
-const char* VtsDriverHalSocketServer::ReadSpecification(
+string VtsDriverHalSocketServer::ReadSpecification(
     const string& name, int target_class, int target_type, float target_version,
     const string& target_package) {
   printf("VtsFuzzerServer::ReadSpecification(%s)\n", name.c_str());
-  ComponentSpecificationMessage* msg =
-      spec_builder_.FindComponentSpecification(
-          target_class, target_type, target_version,
-          "", target_package, name);
-  string* result = new string();
-  google::protobuf::TextFormat::PrintToString(*msg, result);
-  return result->c_str();
+  shared_ptr<const ComponentSpecificationMessage> msg =
+      spec_builder_.FindSharedComponentSpecification(
+          target_class, target_type, target_version, "", target_package, name);
+  string result;
+  if (msg) google::protobuf::TextFormat::PrintToString(*msg, &result);
+  return result;
 }
 
-const char* VtsDriverHalSocketServer::Call(const string& arg) {
-  cout << "VtsFuzzerServer::Call(" << arg << ")" << endl;
-  FunctionSpecificationMessage* func_msg = new FunctionSpecificationMessage();
+// Parses a FunctionSpecificationMessage encoded in the given payload format.
+static bool ParseFunctionSpecification(const string& arg,
+                                       VtsDriverPayloadFormat payload_format,
+                                       FunctionSpecificationMessage* func_msg) {
+  if (payload_format == VTS_DRIVER_PAYLOAD_FORMAT_BINARY) {
+    return func_msg->ParseFromString(arg);
+  }
+  return google::protobuf::TextFormat::MergeFromString(arg, func_msg);
+}
+
+const string& VtsDriverHalSocketServer::Call(
+    const string& arg, VtsDriverPayloadFormat payload_format,
+    int component_handle, google::protobuf::Arena* arena, string* result) {
+  if (payload_format == VTS_DRIVER_PAYLOAD_FORMAT_TEXT) {
+    cout << "VtsFuzzerServer::Call(" << arg << ")" << endl;
+  } else {
+    cout << "VtsFuzzerServer::Call(" << arg.size() << " bytes)" << endl;
+  }
+  FunctionSpecificationMessage* func_msg =
+      google::protobuf::Arena::CreateMessage<FunctionSpecificationMessage>(
+          arena);
   cout << __func__ << ":" << __LINE__ << endl;
-  google::protobuf::TextFormat::MergeFromString(arg, func_msg);
+  if (!ParseFunctionSpecification(arg, payload_format, func_msg)) {
+    cerr << __func__ << " can't parse the arg." << endl;
+  }
   cout << __func__ << ":" << __LINE__ << endl;
-  const string& result = spec_builder_.CallFunction(func_msg);
+  spec_builder_.CallFunction(
+      func_msg, result, payload_format == VTS_DRIVER_PAYLOAD_FORMAT_BINARY,
+      component_handle);
   cout << __func__ << ":" << __LINE__ << endl;
-  return result.c_str();
+  return *result;
 }
 
-const char* VtsDriverHalSocketServer::GetAttribute(const string& arg) {
-  printf("%s(%s)\n", __func__, arg.c_str());
-  FunctionSpecificationMessage* func_msg = new FunctionSpecificationMessage();
-  google::protobuf::TextFormat::MergeFromString(arg, func_msg);
-  const string& result = spec_builder_.GetAttribute(func_msg);
+bool VtsDriverHalSocketServer::CallBatch(
+    const VtsDriverControlCommandMessage& command_message,
+    VtsDriverControlResponseMessage* response_message) {
+  cout << __func__ << " " << command_message.batch_arg_size() << " calls"
+       << endl;
+  bool success = true;
+  for (const auto& arg : command_message.batch_arg()) {
+    const string& result =
+        Call(arg, command_message.payload_format(),
+             command_message.component_handle(), command_message.GetArena(),
+             response_message->add_batch_return_message());
+    bool call_success = !result.empty() && result != "error";
+    response_message->add_batch_response_code(
+        call_success ? VTS_DRIVER_RESPONSE_SUCCESS : VTS_DRIVER_RESPONSE_FAIL);
+    if (!call_success) {
+      success = false;
+      if (!command_message.continue_on_error()) break;
+    }
+  }
+  return success;
+}
+
+const string& VtsDriverHalSocketServer::GetAttribute(
+    const string& arg, VtsDriverPayloadFormat payload_format,
+    int component_handle, google::protobuf::Arena* arena, string* result) {
+  printf("%s(%zu bytes)\n", __func__, arg.size());
+  FunctionSpecificationMessage* func_msg =
+      google::protobuf::Arena::CreateMessage<FunctionSpecificationMessage>(
+          arena);
+  if (!ParseFunctionSpecification(arg, payload_format, func_msg)) {
+    cerr << __func__ << " can't parse the arg." << endl;
+  }
+  spec_builder_.GetAttribute(
+      func_msg, result, payload_format == VTS_DRIVER_PAYLOAD_FORMAT_BINARY,
+      component_handle);
   printf("%s: done\n", __func__);
-  return result.c_str();
+  return *result;
 }
 
-string VtsDriverHalSocketServer::ListFunctions() const {
+string VtsDriverHalSocketServer::ListFunctions(int component_handle) const {
   cout << "VtsFuzzerServer::" << __func__ << endl;
   vts::ComponentSpecificationMessage* spec =
-      spec_builder_.GetComponentSpecification();
+      spec_builder_.GetComponentSpecification(component_handle);
   string output;
   if (!spec) {
     return output;
@@ -139,18 +239,77 @@ string VtsDriverHalSocketServer::ListFunctions() const {
   }
 }
 
+bool VtsDriverHalSocketServer::SendResponse(
+    const VtsDriverControlCommandMessage& command_message,
+    VtsDriverControlResponseMessage* response_message) {
+  if (command_message.has_request_id()) {
+    response_message->set_request_id(command_message.request_id());
+  }
+  // the calls run by the executor respond from its threads.
+  lock_guard<mutex> lock(send_mutex_);
+  return VtsSocketSendMessage(*response_message);
+}
+
 bool VtsDriverHalSocketServer::ProcessOneCommand() {
   cout << __func__ << ":" << __LINE__ << " entry" << endl;
-  VtsDriverControlCommandMessage command_message;
-  if (!VtsSocketRecvMessage(&command_message)) return false;
+  if (call_executor_) return ProcessOneCommandConcurrently();
+  // the command is parsed into an arena which starts out on a per-session
+  // block, so a typical request doesn't touch the heap.
+  google::protobuf::ArenaOptions arena_options;
+  arena_options.initial_block = arena_block_;
+  arena_options.initial_block_size = sizeof(arena_block_);
+  google::protobuf::Arena arena(arena_options);
+  VtsDriverControlCommandMessage* command_message =
+      VtsSocketRecvMessage<VtsDriverControlCommandMessage>(&arena);
+  if (!command_message) return false;
+  return ProcessCommand(command_message, &arena);
+}
+
+bool VtsDriverHalSocketServer::ProcessOneCommandConcurrently() {
+  // each command has its own arena, which a call run by the executor keeps
+  // until it has responded.
+  google::protobuf::Arena* arena = new google::protobuf::Arena();
+  VtsDriverControlCommandMessage* command_message =
+      VtsSocketRecvMessage<VtsDriverControlCommandMessage>(arena);
+  if (!command_message) {
+    delete arena;
+    return false;
+  }
+  switch (command_message->command_type()) {
+    case CALL_FUNCTION:
+    case CALL_FUNCTION_BATCH:
+    case GET_ATTRIBUTE: {
+      // the calls to a component are run in order; responses go out as the
+      // calls finish, matched to the requests by their request ids.
+      int queue_id = spec_builder_.ResolveComponentHandle(
+          command_message->component_handle());
+      call_executor_->Submit(queue_id, [this, command_message, arena]() {
+        ProcessCommand(command_message, arena);
+        delete arena;
+      });
+      return true;
+    }
+    default: {
+      // the other commands (e.g., LOAD_HAL) don't run along with any call.
+      call_executor_->WaitUntilIdle();
+      bool result = ProcessCommand(command_message, arena);
+      delete arena;
+      return result;
+    }
+  }
+}
+
+bool VtsDriverHalSocketServer::ProcessCommand(
+    VtsDriverControlCommandMessage* command_message,
+    google::protobuf::Arena* arena) {
   cout << __func__ << ":" << __LINE__ << " command_type "
-       << command_message.command_type() << endl;
-  switch (command_message.command_type()) {
+       << command_message->command_type() << endl;
+  switch (command_message->command_type()) {
     case EXIT: {
       Exit();
       VtsDriverControlResponseMessage response_message;
       response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
-      if (VtsSocketSendMessage(response_message)) {
+      if (SendResponse(*command_message, &response_message)) {
         cout << getpid() << " " << __func__ << " exiting" << endl;
         return false;
       }
@@ -158,60 +317,89 @@ bool VtsDriverHalSocketServer::ProcessOneCommand() {
     }
     case LOAD_HAL: {
       int32_t result = LoadHal(
-          command_message.file_path(), command_message.target_class(),
-          command_message.target_type(), command_message.target_version(),
-          command_message.target_package(),
-          command_message.target_component_name(),
-          command_message.hw_binder_service_name(),
-          command_message.module_name());
+          command_message->file_path(), command_message->target_class(),
+          command_message->target_type(), command_message->target_version(),
+          command_message->target_package(),
+          command_message->target_component_name(),
+          command_message->hw_binder_service_name(),
+          command_message->module_name());
       VtsDriverControlResponseMessage response_message;
       response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
       response_message.set_return_value(result);
-      if (VtsSocketSendMessage(response_message)) return true;
+      if (SendResponse(*command_message, &response_message)) return true;
       break;
     }
     case GET_STATUS: {
-      int32_t result = Status(command_message.status_type());
+      int32_t result = Status(command_message->status_type());
       VtsDriverControlResponseMessage response_message;
       response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
       response_message.set_return_value(result);
-      if (VtsSocketSendMessage(response_message)) return true;
+      if (command_message->status_type() ==
+              VTS_DRIVER_STATUS_CALL_QUEUE_MAX_DEPTH ||
+          command_message->status_type() ==
+              VTS_DRIVER_STATUS_CALL_QUEUE_MAX_WAIT_USEC) {
+        response_message.set_return_message(GetCallQueueStats());
+      }
+      if (SendResponse(*command_message, &response_message)) return true;
       break;
     }
     case CALL_FUNCTION: {
-      if (command_message.has_driver_caller_uid()) {
-        setuid(atoi(command_message.driver_caller_uid().c_str()));
+      if (command_message->has_driver_caller_uid()) {
+        setuid(atoi(command_message->driver_caller_uid().c_str()));
       }
-      const char* result = Call(command_message.arg());
-      VtsDriverControlResponseMessage response_message;
-      response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
-      response_message.set_return_message(result);
-      if (VtsSocketSendMessage(response_message)) return true;
+      // the call, its result and the response all live on the arena.
+      VtsDriverControlResponseMessage* response_message =
+          google::protobuf::Arena::CreateMessage<
+              VtsDriverControlResponseMessage>(arena);
+      Call(command_message->arg(), command_message->payload_format(),
+           command_message->component_handle(), arena,
+           response_message->mutable_return_message());
+      response_message->set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+      response_message->set_payload_format(command_message->payload_format());
+      if (SendResponse(*command_message, response_message)) return true;
+      break;
+    }
+    case CALL_FUNCTION_BATCH: {
+      if (command_message->has_driver_caller_uid()) {
+        setuid(atoi(command_message->driver_caller_uid().c_str()));
+      }
+      VtsDriverControlResponseMessage* response_message =
+          google::protobuf::Arena::CreateMessage<
+              VtsDriverControlResponseMessage>(arena);
+      bool success = CallBatch(*command_message, response_message);
+      response_message->set_response_code(
+          success ? VTS_DRIVER_RESPONSE_SUCCESS : VTS_DRIVER_RESPONSE_FAIL);
+      response_message->set_payload_format(command_message->payload_format());
+      if (SendResponse(*command_message, response_message)) return true;
       break;
     }
     case VTS_DRIVER_COMMAND_READ_SPECIFICATION: {
-      const char* result = ReadSpecification(
-          command_message.module_name(),
-          command_message.target_class(),
-          command_message.target_type(),
-          command_message.target_version(),
-          command_message.target_package());
+      string result = ReadSpecification(
+          command_message->module_name(),
+          command_message->target_class(),
+          command_message->target_type(),
+          command_message->target_version(),
+          command_message->target_package());
       VtsDriverControlResponseMessage response_message;
       response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
       response_message.set_return_message(result);
-      if (VtsSocketSendMessage(response_message)) return true;
+      if (SendResponse(*command_message, &response_message)) return true;
       break;
     }
     case GET_ATTRIBUTE: {
-      const char* result = GetAttribute(command_message.arg());
-      VtsDriverControlResponseMessage response_message;
-      response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
-      response_message.set_return_message(result);
-      if (VtsSocketSendMessage(response_message)) return true;
+      VtsDriverControlResponseMessage* response_message =
+          google::protobuf::Arena::CreateMessage<
+              VtsDriverControlResponseMessage>(arena);
+      GetAttribute(command_message->arg(), command_message->payload_format(),
+                   command_message->component_handle(), arena,
+                   response_message->mutable_return_message());
+      response_message->set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+      response_message->set_payload_format(command_message->payload_format());
+      if (SendResponse(*command_message, response_message)) return true;
       break;
     }
     case LIST_FUNCTIONS: {
-      string result = ListFunctions();
+      string result = ListFunctions(command_message->component_handle());
       VtsDriverControlResponseMessage response_message;
       if (result.size() > 0) {
         response_message.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
@@ -219,7 +407,7 @@ bool VtsDriverHalSocketServer::ProcessOneCommand() {
       } else {
         response_message.set_response_code(VTS_DRIVER_RESPONSE_FAIL);
       }
-      if (VtsSocketSendMessage(response_message)) return true;
+      if (SendResponse(*command_message, &response_message)) return true;
       break;
     }
     default:
@@ -229,16 +417,11 @@ bool VtsDriverHalSocketServer::ProcessOneCommand() {
   return false;
 }
 
-// Starts to run a UNIX socket server (foreground).
-int StartSocketServer(const string& socket_port_file,
-                      android::vts::SpecificationBuilder& spec_builder,
-                      const char* lib_path) {
-  int sockfd;
-  socklen_t clilen;
-  struct sockaddr_in cli_addr;
+// Binds a UNIX socket to socket_port_file and listens on it. Returns the
+// socket, or -1 on error.
+static int ListenOnUnixSocket(const string& socket_port_file) {
   struct sockaddr_un serv_addr;
-
-  sockfd = socket(PF_UNIX, SOCK_STREAM, 0);
+  int sockfd = socket(PF_UNIX, SOCK_STREAM, 0);
   if (sockfd < 0) {
     cerr << "Can't open the socket." << endl;
     return -1;
@@ -257,10 +440,21 @@ int StartSocketServer(const string& socket_port_file,
     cerr << getpid() << " " << __func__
          << " ERROR binding failed. errno = " << error_save << " "
          << strerror(error_save) << endl;
+    close(sockfd);
     return -1;
   }
 
   listen(sockfd, 5);
+  return sockfd;
+}
+
+// Serves each agent session accepted on sockfd in a forked process
+// (foreground).
+static int ServeAgentSessions(int sockfd,
+                              android::vts::SpecificationBuilder& spec_builder,
+                              const char* lib_path, int call_threads) {
+  socklen_t clilen;
+  struct sockaddr_in cli_addr;
   clilen = sizeof(cli_addr);
 
   while (true) {
@@ -277,7 +471,7 @@ int StartSocketServer(const string& socket_port_file,
       close(sockfd);
       cout << "[driver:hal] process for an agent - pid = " << getpid() << endl;
       VtsDriverHalSocketServer* server =
-          new VtsDriverHalSocketServer(spec_builder, lib_path);
+          new VtsDriverHalSocketServer(spec_builder, lib_path, call_threads);
       server->SetSockfd(newsockfd);
       while (server->ProcessOneCommand())
         ;
@@ -293,6 +487,113 @@ int StartSocketServer(const string& socket_port_file,
   return 0;
 }
 
+// Starts to run a UNIX socket server (foreground).
+int StartSocketServer(const string& socket_port_file,
+                      android::vts::SpecificationBuilder& spec_builder,
+                      const char* lib_path, int ready_fd, int call_threads) {
+  int sockfd = ListenOnUnixSocket(socket_port_file);
+  if (sockfd < 0) return -1;
+  NotifyDriverReady(ready_fd);
+  return ServeAgentSessions(sockfd, spec_builder, lib_path, call_threads);
+}
+
+// Handles a FORK_DRIVER command of a zygote connection. The socket of the new
+// driver is listening before the response is sent, so the agent can connect
+// to the driver as soon as it has the response.
+// zygote_sockfd and connection_sockfd are the sockets of the zygote, which the
+// new driver closes. *driver_pid is set to the pid of the new driver.
+static bool ForkDriver(const VtsDriverControlCommandMessage& command_message,
+                       int zygote_sockfd, int connection_sockfd,
+                       android::vts::SpecificationBuilder& spec_builder,
+                       const char* lib_path, int call_threads,
+                       pid_t* driver_pid) {
+  int sockfd = ListenOnUnixSocket(command_message.server_socket_path());
+  if (sockfd < 0) return false;
+  pid_t pid = fork();
+  if (pid == 0) {  // child
+    close(zygote_sockfd);
+    close(connection_sockfd);
+    cout << "[driver:hal] forked a driver for "
+         << command_message.server_socket_path() << " - pid = " << getpid()
+         << endl;
+    spec_builder.SetCallbackSocketName(command_message.callback_socket_name());
+    exit(ServeAgentSessions(sockfd, spec_builder, lib_path, call_threads));
+  }
+  close(sockfd);
+  if (pid < 0) {
+    cerr << __func__ << " ERROR can't fork a driver." << endl;
+    return false;
+  }
+  *driver_pid = pid;
+  return true;
+}
+
+int StartZygoteServer(const string& zygote_socket_path,
+                      android::vts::SpecificationBuilder& spec_builder,
+                      const char* lib_path, const vector<string>& preload_paths,
+                      int ready_fd, int call_threads) {
+  // the handles are kept open, so the libraries stay loaded in the forked
+  // drivers, where DllLoader gets the same handles without loading again.
+  if (!dlopen(lib_path, RTLD_NOW)) {
+    cerr << __func__ << " can't preload " << lib_path << ": " << dlerror()
+         << endl;
+  }
+  for (const string& path : preload_paths) {
+    if (!dlopen(path.c_str(), RTLD_NOW)) {
+      cerr << __func__ << " can't preload " << path << ": " << dlerror()
+           << endl;
+    }
+  }
+  int num_specs = spec_builder.PreloadComponentSpecifications();
+  cout << "[driver:hal] zygote preloaded " << num_specs
+       << " specification files" << endl;
+  // initializes the descriptors of the messages the drivers receive.
+  VtsDriverControlCommandMessage::descriptor();
+  FunctionSpecificationMessage::descriptor();
+
+  int sockfd = ListenOnUnixSocket(zygote_socket_path);
+  if (sockfd < 0) return -1;
+  NotifyDriverReady(ready_fd);
+
+  while (true) {
+    // reaps the exited drivers.
+    while (waitpid(-1, NULL, WNOHANG) > 0) {
+    }
+    int newsockfd = ::accept(sockfd, NULL, NULL);
+    if (newsockfd < 0) {
+      if (errno == EINTR) continue;
+      cerr << __func__ << " ERROR accept failed." << endl;
+      return -1;
+    }
+
+    VtsDriverCommUtil util(newsockfd);
+    VtsDriverControlCommandMessage command_message;
+    while (util.VtsSocketRecvMessage(&command_message)) {
+      VtsDriverControlResponseMessage response_message;
+      if (command_message.has_request_id()) {
+        response_message.set_request_id(command_message.request_id());
+      }
+      pid_t driver_pid = 0;
+      bool success = command_message.command_type() == EXIT ||
+                     (command_message.command_type() == FORK_DRIVER &&
+                      ForkDriver(command_message, sockfd, newsockfd,
+                                 spec_builder, lib_path, call_threads,
+                                 &driver_pid));
+      response_message.set_response_code(success ? VTS_DRIVER_RESPONSE_SUCCESS
+                                                 : VTS_DRIVER_RESPONSE_FAIL);
+      // the agent tracks a forked driver by its pid.
+      if (driver_pid > 0) response_message.set_return_value(driver_pid);
+      if (!util.VtsSocketSendMessage(response_message)) break;
+      if (command_message.command_type() == EXIT) {
+        cout << "[driver:hal] zygote exiting" << endl;
+        return 0;
+      }
+    }
+    util.Close();
+  }
+  return 0;
+}
+
 }  // namespace vts
 }  // namespace android
 
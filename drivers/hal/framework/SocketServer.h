@@ -19,8 +19,12 @@
 #ifndef __VTS_DRIVER_HAL_SOCKET_SERVER_
 #define __VTS_DRIVER_HAL_SOCKET_SERVER_
 
+#include <mutex>
+#include <vector>
+
 #include <VtsDriverCommUtil.h>
 
+#include "CallExecutor.h"
 #include "specification_parser/SpecificationBuilder.h"
 
 namespace android {
@@ -28,9 +32,19 @@ namespace vts {
 
 class VtsDriverHalSocketServer : public VtsDriverCommUtil {
  public:
+  // If call_threads is positive, the calls of the session are run on that
+  // many threads (see ProcessOneCommandConcurrently).
   VtsDriverHalSocketServer(android::vts::SpecificationBuilder& spec_builder,
-                           const char* lib_path)
-      : VtsDriverCommUtil(), spec_builder_(spec_builder), lib_path_(lib_path) {}
+                           const char* lib_path, int call_threads = 0)
+      : VtsDriverCommUtil(),
+        spec_builder_(spec_builder),
+        lib_path_(lib_path),
+        call_executor_(call_threads > 0
+                           ? new VtsDriverCallExecutor(call_threads)
+                           : NULL) {}
+
+  // Waits for the calls which are still running.
+  ~VtsDriverHalSocketServer() { delete call_executor_; }
 
   // Start a session to handle a new request.
   bool ProcessOneCommand();
@@ -38,27 +52,84 @@ class VtsDriverHalSocketServer : public VtsDriverCommUtil {
  protected:
   void Exit();
 
+  // Loads a HAL in addition to those already loaded. Returns its component
+  // handle, or -1.
   int32_t LoadHal(const string& path, int target_class, int target_type,
                   float target_version, const string& target_package,
                   const string& target_component_name,
                   const string& hw_binder_service_name,
                   const string& module_name);
   int32_t Status(int32_t type);
-  const char* ReadSpecification(
-      const string& name, int target_class, int target_type,
-      float target_version, const string& target_package);
-  const char* Call(const string& arg);
-  const char* GetAttribute(const string& arg);
-  string ListFunctions() const;
+  string ReadSpecification(const string& name, int target_class,
+                           int target_type, float target_version,
+                           const string& target_package);
+  // Calls a function whose FunctionSpecificationMessage is encoded in arg,
+  // of the component whose handle is component_handle, and puts the result in
+  // result in the same payload format. The parsed call is allocated on arena,
+  // which is that of the request. Returns *result.
+  const string& Call(const string& arg, VtsDriverPayloadFormat payload_format,
+                     int component_handle, google::protobuf::Arena* arena,
+                     string* result);
+  // Makes the calls of a CALL_FUNCTION_BATCH command in order and adds their
+  // results to response_message. Returns false if any of the calls failed.
+  bool CallBatch(const VtsDriverControlCommandMessage& command_message,
+                 VtsDriverControlResponseMessage* response_message);
+  // Gets an attribute as Call calls a function.
+  const string& GetAttribute(const string& arg,
+                             VtsDriverPayloadFormat payload_format,
+                             int component_handle,
+                             google::protobuf::Arena* arena, string* result);
+  string ListFunctions(int component_handle) const;
+  // Returns the metrics of each call queue, one line per queue.
+  string GetCallQueueStats() const;
+
+  // Handles a command parsed into arena, on which its response is made.
+  // Returns false if the session is over.
+  bool ProcessCommand(VtsDriverControlCommandMessage* command_message,
+                      google::protobuf::Arena* arena);
+
+  // Receives a command and hands it to call_executor_ if it is a call, so
+  // that calls to different components run at the same time while those to
+  // the same component run in order. Any other command is handled once all
+  // the calls before it have finished.
+  bool ProcessOneCommandConcurrently();
+
+  // Sends a response to the given command, tagged with its request id.
+  bool SendResponse(const VtsDriverControlCommandMessage& command_message,
+                    VtsDriverControlResponseMessage* response_message);
 
  private:
+  // size of the block which backs the per-request arena.
+  static const size_t kArenaBlockSize = 16 * 1024;
+
   android::vts::SpecificationBuilder& spec_builder_;
   const char* lib_path_;
+  // initial block of the arena each command message is parsed into.
+  char arena_block_[kArenaBlockSize];
+  // runs the calls if they may run concurrently, or NULL.
+  VtsDriverCallExecutor* call_executor_;
+  // serializes the responses sent by the threads of call_executor_.
+  mutex send_mutex_;
 };
 
+// Serves the agent at socket_port_file. Once it listens, the driver notifies
+// ready_fd (see NotifyDriverReady). If call_threads is positive, each session
+// runs calls to different components on up to that many threads.
 extern int StartSocketServer(const string& socket_port_file,
                              android::vts::SpecificationBuilder& spec_builder,
-                             const char* lib_path);
+                             const char* lib_path, int ready_fd = -1,
+                             int call_threads = 0);
+
+// Runs a zygote driver at zygote_socket_path (foreground). It preloads
+// lib_path, the libraries in preload_paths, and the specification files once,
+// and then forks a driver which shares them for each FORK_DRIVER command. Once
+// it listens, the zygote notifies ready_fd (see NotifyDriverReady). The forked
+// drivers use call_threads as StartSocketServer does.
+extern int StartZygoteServer(const string& zygote_socket_path,
+                             android::vts::SpecificationBuilder& spec_builder,
+                             const char* lib_path,
+                             const vector<string>& preload_paths,
+                             int ready_fd = -1, int call_threads = 0);
 
 }  // namespace vts
 }  // namespace android
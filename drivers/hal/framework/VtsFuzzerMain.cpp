@@ -40,12 +40,16 @@
 
 #include <algorithm>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "binder/VtsFuzzerBinderService.h"
+#include "fuzz_tester/FuzzerBase.h"
 #include "specification_parser/InterfaceSpecificationParser.h"
 #include "specification_parser/SpecificationBuilder.h"
 #include "replayer/VtsHidlHalReplayer.h"
+#include "vts_random.h"
 
 #include "BinderServer.h"
 #include "SocketServer.h"
@@ -101,6 +105,44 @@ int main(int argc, char* const argv[]) {
       {"trace_path", optional_argument, NULL, 'r'},
       {"spec_path", optional_argument, NULL, 'a'},
       {"hal_service_name", optional_argument, NULL, 'j'},
+      // a pipe on which the agent which launched this driver waits until the
+      // driver accepts connections.
+      {"ready_fd", optional_argument, NULL, 'y'},
+      // a spec bundle (see ComponentSpecificationBundle) to use instead of
+      // that of spec_dir.
+      {"spec_bundle", optional_argument, NULL, 'b'},
+      // the number of worker processes which fuzz the target (not with
+      // --server).
+      {"jobs", required_argument, NULL, 'g'},
+      // picks the inputs from the coverage of the earlier calls (not with
+      // --server or --jobs).
+      {"coverage_guided", no_argument, NULL, 'u'},
+      // the seed of the random values, with which a run can be replayed
+      // (by default, one from the clock which is printed).
+      {"seed", required_argument, NULL, 'x'},
+      // loads a conventional HAL once and makes the calls in children forked
+      // from it, that many calls per child (not with --server, --jobs or
+      // --coverage_guided).
+      {"fork_server", required_argument, NULL, 'l'},
+      // makes the target dump its code coverage counters in memory instead of
+      // in gcda files (for a target built with clang --coverage). The dumps
+      // aren't told apart by call, so not with call_threads > 1.
+      {"gcov_in_memory", no_argument, NULL, 'q'},
+      // sends only the code coverage counters which changed since the last
+      // call, which the host adds up, instead of the whole gcda files.
+      {"coverage_delta_only", no_argument, NULL, 'i'},
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+      // runs as a zygote at server_socket_path which forks a driver for each
+      // FORK_DRIVER command.
+      {"zygote", no_argument, NULL, 'z'},
+      // comma-separated paths of the shared libraries (e.g., the target HAL)
+      // which the zygote loads before forking drivers.
+      {"preload", optional_argument, NULL, 'o'},
+      // runs the calls of each session on up to that many threads, where the
+      // calls to one component run in order. In a coverage build, the calls
+      // still run one at a time (the gcda files are shared by the process).
+      {"call_threads", optional_argument, NULL, 'w'},
+#endif
       {NULL, 0, NULL, 0}};
   int target_class;
   int target_type;
@@ -120,6 +162,21 @@ int main(int argc, char* const argv[]) {
   string trace_path;
   string spec_path;
   string hal_service_name = "default";
+  bool has_hal_service_name = false;
+  int ready_fd = -1;
+  string spec_bundle_path;
+  int jobs = 1;
+  bool coverage_guided = false;
+  int fork_server_calls = 0;
+  bool gcov_in_memory = false;
+  bool coverage_delta_only = false;
+  bool has_seed = false;
+  uint64_t seed = 0;
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+  bool zygote = false;
+  vector<string> preload_paths;
+  int call_threads = 0;
+#endif
 
   while (true) {
     int optionIndex = 0;
@@ -207,7 +264,57 @@ int main(int argc, char* const argv[]) {
         break;
       case 'j':
         hal_service_name = string(optarg);
+        has_hal_service_name = true;
+        break;
+      case 'y':
+        ready_fd = atoi(optarg);
+        break;
+      case 'b':
+        spec_bundle_path = string(optarg);
+        break;
+      case 'g':
+        jobs = atoi(optarg);
+        if (jobs <= 0) {
+          fprintf(stderr, "jobs must be > 0");
+          return 2;
+        }
+        break;
+      case 'u':
+        coverage_guided = true;
+        break;
+      case 'x':
+        seed = strtoull(optarg, NULL, 0);
+        has_seed = true;
+        break;
+      case 'l':
+        fork_server_calls = atoi(optarg);
+        if (fork_server_calls <= 0) {
+          fprintf(stderr, "fork_server must be > 0");
+          return 2;
+        }
+        break;
+      case 'q':
+        gcov_in_memory = true;
+        break;
+      case 'i':
+        coverage_delta_only = true;
+        break;
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+      case 'z':
+        zygote = true;
+        break;
+      case 'o': {
+        stringstream paths(optarg);
+        string path;
+        while (getline(paths, path, ',')) {
+          if (!path.empty()) preload_paths.push_back(path);
+        }
+        break;
+      }
+      case 'w':
+        call_threads = atoi(optarg);
         break;
+#endif
       default:
         if (ic != '?') {
           fprintf(stderr, "getopt_long returned unexpected value 0x%x\n", ic);
@@ -216,13 +323,51 @@ int main(int argc, char* const argv[]) {
     }
   }
 
+  if (has_seed) {
+    android::vts::RandomNumberGeneratorSeed(seed);
+  } else {
+    android::vts::RandomNumberGeneratorReset();
+  }
+  cout << "random seed " << android::vts::GetRandomNumberGeneratorSeed()
+       << endl;
+#ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
+  if (gcov_in_memory && call_threads > 1) {
+    fprintf(stderr, "gcov_in_memory can't be used with call_threads > 1\n");
+    return 2;
+  }
+#endif
+  // the hooks have to be loaded before the target (or a preloaded library).
+  if (gcov_in_memory && !android::vts::FuzzerBase::EnableInMemoryCoverage()) {
+    fprintf(stderr, "can't capture the code coverage in memory\n");
+    return 2;
+  }
+  android::vts::FuzzerBase::SetCoverageDeltaOnly(coverage_delta_only);
+
   android::vts::SpecificationBuilder spec_builder(spec_dir_path, epoch_count,
                                                   callback_socket_name);
+  if (!spec_bundle_path.empty() &&
+      !spec_builder.OpenSpecificationBundle(spec_bundle_path)) {
+    fprintf(stderr, "can't open the spec bundle %s\n",
+            spec_bundle_path.c_str());
+  }
+  // by default, the fuzzed HIDL service is named after its package.
+  if (has_hal_service_name) {
+    spec_builder.SetHwBinderServiceName(hal_service_name);
+  }
   if (!server) {
     if (optind != argc - 1) {
       fprintf(stderr, "Must specify output file (see --help).\n");
       return 2;
     }
+    if (coverage_guided && jobs > 1) {
+      fprintf(stderr, "coverage_guided can't be used with jobs > 1\n");
+      return 2;
+    }
+    if (fork_server_calls > 0 && (coverage_guided || jobs > 1)) {
+      fprintf(stderr,
+              "fork_server can't be used with coverage_guided or jobs > 1\n");
+      return 2;
+    }
     bool success;
     if (mode == "replay") {
       android::vts::VtsHidlHalReplayer replayer(spec_path,
@@ -233,7 +378,8 @@ int main(int argc, char* const argv[]) {
       success = spec_builder.Process(argv[optind],INTERFACE_SPEC_LIB_FILENAME,
                                      target_class, target_type, target_version,
                                      target_package.c_str(),
-                                     target_component_name.c_str());
+                                     target_component_name.c_str(), jobs,
+                                     coverage_guided, fork_server_calls);
     }
     cout << "Result: " << success << endl;
     if (success) {
@@ -241,11 +387,18 @@ int main(int argc, char* const argv[]) {
     }
   } else {
 #ifndef VTS_AGENT_DRIVER_COMM_BINDER  // socket
-    android::vts::StartSocketServer(server_socket_path, spec_builder,
-                                    INTERFACE_SPEC_LIB_FILENAME);
+    if (zygote) {
+      android::vts::StartZygoteServer(server_socket_path, spec_builder,
+                                      INTERFACE_SPEC_LIB_FILENAME,
+                                      preload_paths, ready_fd, call_threads);
+    } else {
+      android::vts::StartSocketServer(server_socket_path, spec_builder,
+                                      INTERFACE_SPEC_LIB_FILENAME, ready_fd,
+                                      call_threads);
+    }
 #else  // binder
     android::vts::StartBinderServer(service_name, spec_builder,
-                                    INTERFACE_SPEC_LIB_FILENAME);
+                                    INTERFACE_SPEC_LIB_FILENAME, ready_fd);
 #endif
   }
   return 0;
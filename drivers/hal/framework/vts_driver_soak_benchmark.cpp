@@ -0,0 +1,186 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <VtsDriverCommUtil.h>
+#include <google/protobuf/text_format.h>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+#include "test/vts/proto/VtsDriverControlMessage.pb.h"
+
+/*
+ * Soaks a HAL driver with CALL_FUNCTION requests and prints its RSS over
+ * time, which stays flat once the driver's caches are warm if no request
+ * leaks. The driver is launched on a temporary socket, loads a HAL with the
+ * LOAD_HAL command in <load_hal file>, and is then sent the call in <call
+ * file> (a FunctionSpecificationMessage) <calls> times in the wire format.
+ * Both files are in the protobuf text format.
+ *
+ * Usage: vts_driver_soak_benchmark <driver binary> <spec dir> <load_hal file>
+ *            <call file> [<calls>]
+ *   e.g., vts_driver_soak_benchmark /data/local/tmp/64/fuzzer64 \
+ *             /data/local/tmp/spec load_nfc.txt nfc_powercycle.txt 1000000
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultCalls = 1000000;
+// the number of RSS samples printed over the run.
+static const int kSamples = 20;
+static const int kReadyTimeoutMsec = 30 * 1000;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Returns the VmRSS of pid in kB, or -1.
+static long GetRssKb(pid_t pid) {
+  ifstream status("/proc/" + to_string(pid) + "/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) return atol(line.c_str() + 6);
+  }
+  return -1;
+}
+
+// Parses the text-format message in the file at path.
+static bool ReadTextMessage(const char* path,
+                            google::protobuf::Message* message) {
+  ifstream in(path);
+  stringstream text;
+  text << in.rdbuf();
+  return in && google::protobuf::TextFormat::ParseFromString(text.str(),
+                                                             message);
+}
+
+// Launches the driver at driver_path serving socket_path. Returns its pid once
+// it listens, or -1.
+static pid_t LaunchDriver(const string& driver_path, const string& spec_dir,
+                          const string& socket_path) {
+  int pipe_fds[2];
+  if (pipe2(pipe_fds, O_CLOEXEC) != 0) return -1;
+  vector<string> args;
+  args.push_back(driver_path);
+  args.push_back("--server");
+  args.push_back("--server_socket_path=" + socket_path);
+  args.push_back("--spec_dir=" + spec_dir);
+  args.push_back("--ready_fd=" + to_string(pipe_fds[1]));
+  vector<char*> argv;
+  for (const string& arg : args) argv.push_back((char*)arg.c_str());
+  argv.push_back(NULL);
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    // the driver logs every call; keep that out of the measurement.
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    dup2(null_fd, STDERR_FILENO);
+    fcntl(pipe_fds[1], F_SETFD, 0);
+    execv(argv[0], argv.data());
+    _exit(1);
+  }
+  close(pipe_fds[1]);
+  if (pid < 0) {
+    close(pipe_fds[0]);
+    return -1;
+  }
+  if (!WaitForDriverReady(pipe_fds[0], kReadyTimeoutMsec)) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    return -1;
+  }
+  return pid;
+}
+
+int main(int argc, char** argv) {
+  int calls = argc > 5 ? atoi(argv[5]) : kDefaultCalls;
+  if (argc < 5 || calls < kSamples) {
+    fprintf(stderr,
+            "usage: %s <driver binary> <spec dir> <load_hal file> <call file>"
+            " [<calls>]\n",
+            argv[0]);
+    return 2;
+  }
+  VtsDriverControlCommandMessage load_hal;
+  FunctionSpecificationMessage call;
+  if (!ReadTextMessage(argv[3], &load_hal) ||
+      !ReadTextMessage(argv[4], &call)) {
+    fprintf(stderr, "can't parse %s or %s\n", argv[3], argv[4]);
+    return 1;
+  }
+  load_hal.set_command_type(LOAD_HAL);
+
+  const string socket_path =
+      "/data/local/tmp/vts_driver_soak_benchmark_" + to_string(getpid());
+  pid_t driver_pid = LaunchDriver(argv[1], argv[2], socket_path);
+  if (driver_pid < 0) {
+    fprintf(stderr, "can't launch %s\n", argv[1]);
+    return 1;
+  }
+
+  VtsDriverCommUtil session;
+  VtsDriverControlResponseMessage response;
+  bool success = session.Connect(socket_path) &&
+                 session.VtsSocketSendMessage(load_hal) &&
+                 session.VtsSocketRecvMessage(&response) &&
+                 response.return_value() >= 0;
+  if (!success) fprintf(stderr, "LOAD_HAL failed\n");
+
+  VtsDriverControlCommandMessage command;
+  command.set_command_type(CALL_FUNCTION);
+  command.set_payload_format(VTS_DRIVER_PAYLOAD_FORMAT_BINARY);
+  command.set_component_handle(response.return_value());
+  call.SerializeToString(command.mutable_arg());
+  double start = NowSeconds();
+  if (success) printf("%12s %10s %12s\n", "calls", "seconds", "rss (kB)");
+  for (int i = 0; success && i < calls; i++) {
+    if (i % (calls / kSamples) == 0) {
+      printf("%12d %10.1f %12ld\n", i, NowSeconds() - start,
+             GetRssKb(driver_pid));
+      fflush(stdout);
+    }
+    success = session.VtsSocketSendMessage(command) &&
+              session.VtsSocketRecvMessage(&response) &&
+              response.response_code() == VTS_DRIVER_RESPONSE_SUCCESS;
+    if (!success) fprintf(stderr, "call %d failed\n", i);
+  }
+  if (success) {
+    printf("%12d %10.1f %12ld\n", calls, NowSeconds() - start,
+           GetRssKb(driver_pid));
+  }
+
+  session.Close();
+  kill(driver_pid, SIGKILL);
+  waitpid(driver_pid, NULL, 0);
+  unlink(socket_path.c_str());
+  return success ? 0 : 1;
+}
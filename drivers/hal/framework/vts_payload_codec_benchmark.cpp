@@ -0,0 +1,123 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <google/protobuf/text_format.h>
+
+#include "test/vts/proto/ComponentSpecificationMessage.pb.h"
+
+/*
+ * Measures the encode + decode cost of the CALL_FUNCTION payloads of the
+ * given specifications in the protobuf text format and in the wire format.
+ * Each API of a specification is used as a FunctionSpecificationMessage
+ * payload, and the whole specification as a LIST_FUNCTIONS payload.
+ *
+ * Usage: vts_payload_codec_benchmark <iterations> <spec file>...
+ *   e.g., vts_payload_codec_benchmark 1000 /data/local/tmp/spec/Nfc.vts \
+ *             /data/local/tmp/spec/Context.vts
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Encodes and decodes message iterations times in the given format, and
+// returns the average nanoseconds per encode + decode. The encoded size is
+// stored in encoded_size.
+template <typename T>
+static double MeasureRoundTrip(const T& message, bool binary, int iterations,
+                               size_t* encoded_size) {
+  string encoded;
+  T decoded;
+  double start = NowSeconds();
+  for (int i = 0; i < iterations; i++) {
+    encoded.clear();
+    decoded.Clear();
+    if (binary) {
+      message.SerializeToString(&encoded);
+      decoded.ParseFromString(encoded);
+    } else {
+      google::protobuf::TextFormat::PrintToString(message, &encoded);
+      google::protobuf::TextFormat::MergeFromString(encoded, &decoded);
+    }
+  }
+  double elapsed = NowSeconds() - start;
+  *encoded_size = encoded.size();
+  return elapsed * 1e9 / iterations;
+}
+
+template <typename T>
+static void PrintRow(const char* spec_name, const char* payload_name,
+                     const T& message, int iterations) {
+  size_t text_size, binary_size;
+  double text_ns = MeasureRoundTrip(message, false, iterations, &text_size);
+  double binary_ns = MeasureRoundTrip(message, true, iterations, &binary_size);
+  printf("%-32s %-32s %8zu %10.0f %8zu %10.0f %6.1fx\n", spec_name,
+         payload_name, text_size, text_ns, binary_size, binary_ns,
+         text_ns / binary_ns);
+}
+
+static bool RunBenchmark(const char* spec_path, int iterations) {
+  ifstream in_file(spec_path);
+  if (!in_file) {
+    fprintf(stderr, "can't open %s\n", spec_path);
+    return false;
+  }
+  stringstream str_stream;
+  str_stream << in_file.rdbuf();
+  ComponentSpecificationMessage spec;
+  if (!google::protobuf::TextFormat::MergeFromString(str_stream.str(),
+                                                     &spec)) {
+    fprintf(stderr, "can't parse %s\n", spec_path);
+    return false;
+  }
+
+  const char* spec_name = strrchr(spec_path, '/');
+  spec_name = spec_name ? spec_name + 1 : spec_path;
+  for (const FunctionSpecificationMessage& api : spec.interface().api()) {
+    PrintRow(spec_name, api.name().c_str(), api, iterations);
+  }
+  PrintRow(spec_name, "(whole spec)", spec, iterations);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int iterations = argc > 2 ? atoi(argv[1]) : 0;
+  if (iterations <= 0) {
+    fprintf(stderr, "usage: %s <iterations> <spec file>...\n", argv[0]);
+    return 2;
+  }
+
+  printf("%-32s %-32s %8s %10s %8s %10s %7s\n", "spec", "payload",
+         "text B", "text ns", "bin B", "bin ns", "speedup");
+  for (int i = 2; i < argc; i++) {
+    if (!RunBenchmark(argv[i], iterations)) return 1;
+  }
+  return 0;
+}
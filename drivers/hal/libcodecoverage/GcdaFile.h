@@ -26,21 +26,23 @@ using namespace std;
 namespace android {
 namespace vts {
 
-// Basic I/O methods for a GCOV file.
+// Basic I/O methods for a GCOV file, which is read through an unbuffered
+// FILE. A subclass can read it from elsewhere (see MappedGcdaFile) by
+// overriding Open, Close, Sync, ReadWords and IsError.
 class GcdaFile {
  public:
   GcdaFile(const string& filename) :
-    filename_(filename) {}
+    gcov_var_(), filename_(filename) {}
   virtual ~GcdaFile() {};
 
   // Opens a file.
-  bool Open();
+  virtual bool Open();
 
   // Closes a file and returns any existing error code.
-  int Close();
+  virtual int Close();
 
   // Synchronizes to the given base and length.
-  void Sync(unsigned base, unsigned length);
+  virtual void Sync(unsigned base, unsigned length);
 
   // Reads a string array where the maximum number of strings is also specified.
   unsigned ReadStringArray(char** string_array, unsigned num_strings);
@@ -52,7 +54,7 @@ class GcdaFile {
   unsigned ReadUnsigned();
 
   // Reads 'words' number of words.
-  const unsigned* ReadWords(unsigned words);
+  virtual const unsigned* ReadWords(unsigned words);
 
   // Reads a counter.
   gcov_type ReadCounter();
@@ -72,7 +74,7 @@ class GcdaFile {
   }
 
   // Returns non-zero error code if there's an error.
-  inline int IsError() const {
+  virtual int IsError() const {
     return gcov_var_.file ? gcov_var_.error : 1;
   }
 
@@ -85,7 +87,6 @@ class GcdaFile {
     return value;
   }
 
- private:
   // The GCOV var data structure for an opened file.
   struct gcov_var_t gcov_var_;
   const string& filename_;
@@ -95,6 +95,9 @@ void GcdaRawCoverageParser::ParseBody() {
       case GCOV_TAG_FUNCTION:
         TagFunction(tag, length);
         break;
+      case GCOV_TAG_FOR_COUNTER(GCOV_COUNTER_ARCS):
+        TagArcCounters(tag, length);
+        break;
       case GCOV_TAG_BLOCKS:
         TagBlocks(tag, length);
         break;
@@ -117,6 +120,8 @@ void GcdaRawCoverageParser::ParseBody() {
 
 vector<unsigned> GcdaRawCoverageParser::Parse() {
   result.clear();
+  functions_.clear();
+  in_function_ = false;
   if (!gcda_file_->Open()) {
     cerr << __func__ << " Cannot open a file, " << filename_ << endl;
     return result;
@@ -22,25 +22,44 @@
 #include <vector>
 
 #include "GcdaFile.h"
+#include "MappedGcdaFile.h"
 
 using namespace std;
 
 namespace android {
 namespace vts {
 
+// The arc counters of a function in a GCDA file.
+struct GcdaFunctionCounters {
+  unsigned ident;
+  unsigned lineno_checksum;
+  unsigned cfg_checksum;
+  // the execution counts of the instrumented arcs, in the file's order.
+  vector<gcov_type> counters;
+};
+
 // Parses a GCDA file and extracts raw coverage info.
 class GcdaRawCoverageParser {
  public:
-  GcdaRawCoverageParser(const char* filename)
+  // The file is held in memory as a whole (see MappedGcdaFile) unless mapped
+  // is false, in which case it's read through a FILE.
+  GcdaRawCoverageParser(const char* filename, bool mapped = true)
     : filename_(filename),
-      gcda_file_(new GcdaFile(filename_)) {}
+      gcda_file_(mapped ? new MappedGcdaFile(filename_)
+                        : new GcdaFile(filename_)),
+      in_function_(false) {}
 
-  virtual ~GcdaRawCoverageParser() {}
+  virtual ~GcdaRawCoverageParser() { delete gcda_file_; }
 
   // Parses a given file and returns a vector which contains IDs of raw
   // coverage measurement units (e.g., basic blocks).
   vector<unsigned> Parse();
 
+  // Returns the arc counters of the functions found by the last Parse.
+  const vector<GcdaFunctionCounters>& GetFunctionCounters() const {
+    return functions_;
+  }
+
  protected:
   // Parses the GCOV magic number.
   bool ParseMagic();
@@ -52,11 +71,26 @@ class GcdaRawCoverageParser {
   void TagFunction(unsigned /*tag*/, unsigned length) {
     /* unsigned long pos = */ gcda_file_->Position();
 
+    // a function without a body has no counters.
+    in_function_ = length != 0;
     if (length) {
-      gcda_file_->ReadUnsigned();  // ident %u
-      unsigned lineno_checksum = gcda_file_->ReadUnsigned();
-      result.push_back(lineno_checksum);
-      gcda_file_->ReadUnsigned();  // cfg_checksum 0x%08x
+      GcdaFunctionCounters function;
+      function.ident = gcda_file_->ReadUnsigned();
+      function.lineno_checksum = gcda_file_->ReadUnsigned();
+      result.push_back(function.lineno_checksum);
+      function.cfg_checksum = gcda_file_->ReadUnsigned();
+      functions_.push_back(function);
+    }
+  }
+
+  // Processes tag for the arc counters of the last function.
+  void TagArcCounters(unsigned /*tag*/, unsigned length) {
+    if (!in_function_) return;
+    unsigned n_counts = GCOV_TAG_COUNTER_NUM(length);
+    vector<gcov_type>& counters = functions_.back().counters;
+    counters.reserve(counters.size() + n_counts);
+    for (unsigned index = 0; index < n_counts; index++) {
+      counters.push_back(gcda_file_->ReadCounter());
     }
   }
 
@@ -86,6 +120,12 @@ class GcdaRawCoverageParser {
 
   // vector containing the parsed, raw coverage data.
   vector<unsigned> result;
+
+  // the arc counters of each function.
+  vector<GcdaFunctionCounters> functions_;
+
+  // whether the last function tag had a body to count.
+  bool in_function_;
 };
 
 }  // namespace vts
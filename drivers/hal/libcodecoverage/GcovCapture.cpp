@@ -0,0 +1,138 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "GcovCapture.h"
+
+#include <dlfcn.h>
+
+#include <iostream>
+#include <map>
+#include <mutex>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+static const char kGcovCaptureLibrary[] = "libvts_gcov_capture.so";
+
+// the dumps are made by whichever thread flushes (or exits), so the state
+// below is guarded by a lock.
+static mutex capture_lock;
+static bool capture_enabled = false;
+
+// the files of the dump in progress; the last one is being written.
+static vector<GcovCapturedFile> pending_files;
+static bool in_file = false;
+
+// the files of the finished dumps by filename.
+static map<string, GcovCapturedFile> finished_files;
+
+bool GcovCaptureEnable() {
+  lock_guard<mutex> lock(capture_lock);
+  if (capture_enabled) return true;
+  // RTLD_GLOBAL puts the hooks ahead of the profile runtime of the code
+  // loaded later.
+  if (!dlopen(kGcovCaptureLibrary, RTLD_NOW | RTLD_GLOBAL)) {
+    cerr << __func__ << ": can't load " << kGcovCaptureLibrary << ": "
+         << dlerror() << endl;
+    return false;
+  }
+  capture_enabled = true;
+  return true;
+}
+
+bool GcovCaptureIsEnabled() {
+  lock_guard<mutex> lock(capture_lock);
+  return capture_enabled;
+}
+
+void GcovCaptureStartFile(const char* filename) {
+  lock_guard<mutex> lock(capture_lock);
+  pending_files.push_back(GcovCapturedFile());
+  pending_files.back().filename = filename ? filename : "";
+  in_file = true;
+}
+
+void GcovCaptureEmitFunction(unsigned ident, unsigned lineno_checksum,
+                             unsigned cfg_checksum) {
+  lock_guard<mutex> lock(capture_lock);
+  if (!in_file) return;
+  GcdaFunctionCounters function;
+  function.ident = ident;
+  function.lineno_checksum = lineno_checksum;
+  function.cfg_checksum = cfg_checksum;
+  pending_files.back().functions.push_back(function);
+}
+
+void GcovCaptureEmitArcs(unsigned num_counters, const uint64_t* counters) {
+  lock_guard<mutex> lock(capture_lock);
+  if (!in_file || pending_files.back().functions.empty()) return;
+  vector<gcov_type>& function_counters =
+      pending_files.back().functions.back().counters;
+  function_counters.insert(function_counters.end(), counters,
+                           counters + num_counters);
+}
+
+void GcovCaptureEndFile() {
+  lock_guard<mutex> lock(capture_lock);
+  in_file = false;
+}
+
+void GcovCaptureFinishDump() {
+  lock_guard<mutex> lock(capture_lock);
+  // a file still being written belongs to the next dump.
+  size_t finished = pending_files.size() - (in_file ? 1 : 0);
+  for (size_t index = 0; index < finished; index++) {
+    GcovCapturedFile& file = pending_files[index];
+    auto it = finished_files.find(file.filename);
+    if (it == finished_files.end()) {
+      finished_files[file.filename].functions.swap(file.functions);
+      continue;
+    }
+    // each dump starts from 0 (the flush resets the counters), so the dumps
+    // of the same file add up unless the file changed shape.
+    vector<GcdaFunctionCounters>& functions = it->second.functions;
+    bool same_shape = functions.size() == file.functions.size();
+    for (size_t i = 0; same_shape && i < functions.size(); i++) {
+      same_shape = functions[i].counters.size() ==
+                   file.functions[i].counters.size();
+    }
+    if (!same_shape) {
+      functions.swap(file.functions);
+      continue;
+    }
+    for (size_t i = 0; i < functions.size(); i++) {
+      for (size_t j = 0; j < functions[i].counters.size(); j++) {
+        functions[i].counters[j] += file.functions[i].counters[j];
+      }
+    }
+  }
+  pending_files.erase(pending_files.begin(), pending_files.begin() + finished);
+}
+
+void GcovCaptureTakeFiles(vector<GcovCapturedFile>* files) {
+  lock_guard<mutex> lock(capture_lock);
+  for (auto& it : finished_files) {
+    files->push_back(GcovCapturedFile());
+    files->back().filename = it.first;
+    files->back().functions.swap(it.second.functions);
+  }
+  finished_files.clear();
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_LIBMEASUREMENT_GCOV_CAPTURE_H__
+#define __VTS_SYSFUZZER_LIBMEASUREMENT_GCOV_CAPTURE_H__
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "GcdaParser.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// The counters of a gcda file which were dumped in memory.
+struct GcovCapturedFile {
+  // the path of the gcda file the counters were meant for.
+  string filename;
+  vector<GcdaFunctionCounters> functions;
+};
+
+// Makes the code built with clang --coverage which is loaded from now on
+// (e.g., a target HAL) dump its counters in memory instead of in gcda files,
+// by loading libvts_gcov_capture.so (see GcovCaptureHooks.cpp) ahead of it.
+// Returns true if successful or already done.
+extern bool GcovCaptureEnable();
+
+// Returns true if the counter dumps are captured in memory.
+extern bool GcovCaptureIsEnabled();
+
+// Called by libvts_gcov_capture.so for each part of a dump.
+extern void GcovCaptureStartFile(const char* filename);
+extern void GcovCaptureEmitFunction(unsigned ident, unsigned lineno_checksum,
+                                    unsigned cfg_checksum);
+extern void GcovCaptureEmitArcs(unsigned num_counters,
+                                const uint64_t* counters);
+extern void GcovCaptureEndFile();
+
+// Marks the end of a dump (e.g., of a __gcov_flush), so its files can be
+// taken.
+extern void GcovCaptureFinishDump();
+
+// Moves the files of the dumps finished since the last call to files. The
+// counters of a file dumped more than once are added up. The dumps aren't
+// tagged by thread or call, so the files are only those of one call if no
+// other call runs at the same time (i.e., a driver with --gcov_in_memory
+// can't have --call_threads > 1).
+extern void GcovCaptureTakeFiles(vector<GcovCapturedFile>* files);
+
+}  // namespace vts
+}  // namespace android
+
+#endif
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+
+#include "GcovCapture.h"
+
+/*
+ * The functions of the clang profile runtime (GCDAProfiling.c in
+ * compiler-rt) which the writeout function of each module built with
+ * --coverage calls to write its gcda file. This library is loaded with
+ * RTLD_GLOBAL (see GcovCaptureEnable) before the target, so the target's
+ * calls bind to these and its counters go to memory instead of to files.
+ */
+
+#define GCOV_CAPTURE_EXPORT extern "C" __attribute__((visibility("default")))
+
+GCOV_CAPTURE_EXPORT void llvm_gcda_start_file(const char* orig_filename,
+                                              const char /*version*/[4],
+                                              uint32_t /*checksum*/) {
+  android::vts::GcovCaptureStartFile(orig_filename);
+}
+
+GCOV_CAPTURE_EXPORT void llvm_gcda_emit_function(
+    uint32_t ident, const char* /*function_name*/, uint32_t func_checksum,
+    uint8_t /*use_extra_checksum*/, uint32_t cfg_checksum) {
+  android::vts::GcovCaptureEmitFunction(ident, func_checksum, cfg_checksum);
+}
+
+GCOV_CAPTURE_EXPORT void llvm_gcda_emit_arcs(uint32_t num_counters,
+                                             uint64_t* counters) {
+  android::vts::GcovCaptureEmitArcs(num_counters, counters);
+}
+
+GCOV_CAPTURE_EXPORT void llvm_gcda_summary_info() {}
+
+GCOV_CAPTURE_EXPORT void llvm_gcda_end_file() {
+  android::vts::GcovCaptureEndFile();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MappedGcdaFile.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace android {
+namespace vts {
+
+// Reads size bytes of fd into buffer. Returns false on a read error or if
+// the file is shorter.
+static bool ReadFully(int fd, void* buffer, size_t size) {
+  char* next = static_cast<char*>(buffer);
+  while (size > 0) {
+    ssize_t count = read(fd, next, size);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    next += count;
+    size -= count;
+  }
+  return true;
+}
+
+bool MappedGcdaFile::Open() {
+  if (filename_.length() < 1) return false;
+  if (words_) return false;
+
+  int fd = open(filename_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat st;
+  if (fstat(fd, &st) < 0 || st.st_size <= 0) {
+    close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  void* words = NULL;
+  size_t map_size = 0;
+  if (size >= kMinMappedFileSize) {
+    words = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (words == MAP_FAILED) {
+      words = NULL;
+    } else {
+      map_size = size;
+    }
+  } else {
+    words = malloc(size);
+    if (words && !ReadFully(fd, words, size)) {
+      free(words);
+      words = NULL;
+    }
+  }
+  // a mapping stays valid once the file is closed.
+  close(fd);
+  if (!words) return false;
+
+  memset(&gcov_var_, 0, sizeof(gcov_var_));
+  gcov_var_.overread = -1u;
+  gcov_var_.length = size / sizeof(unsigned);
+  words_ = static_cast<const unsigned*>(words);
+  map_size_ = map_size;
+  return true;
+}
+
+int MappedGcdaFile::Close() {
+  if (words_) {
+    if (map_size_) {
+      munmap(const_cast<unsigned*>(words_), map_size_);
+    } else {
+      free(const_cast<unsigned*>(words_));
+    }
+    words_ = NULL;
+    map_size_ = 0;
+    gcov_var_.length = 0;
+    gcov_var_.offset = 0;
+  }
+  return gcov_var_.error;
+}
+
+void MappedGcdaFile::Sync(unsigned base, unsigned length) {
+  if (!words_) return;
+
+  // past the end, the reads fail as they do at the end.
+  base += length;
+  gcov_var_.offset = base < gcov_var_.length ? base : gcov_var_.length;
+}
+
+const unsigned* MappedGcdaFile::ReadWords(unsigned words) {
+  if (!words_) return 0;
+
+  unsigned excess = gcov_var_.length - gcov_var_.offset;
+  if (excess < words) {
+    gcov_var_.overread += words - excess;
+    gcov_var_.offset = gcov_var_.length;
+    return 0;
+  }
+  const unsigned* result = words_ + gcov_var_.offset;
+  gcov_var_.offset += words;
+  return result;
+}
+
+}  // namespace vts
+}  // namespace android
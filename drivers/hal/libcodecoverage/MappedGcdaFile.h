@@ -0,0 +1,70 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_SYSFUZZER_LIBMEASUREMENT_MAPPED_GCDA_FILE_H__
+#define __VTS_SYSFUZZER_LIBMEASUREMENT_MAPPED_GCDA_FILE_H__
+
+#include <stddef.h>
+
+#include <string>
+
+#include "GcdaFile.h"
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// A GCOV file which is held in memory as a whole, so ReadWords hands out
+// pointers into its contents instead of reading the file into a growing
+// buffer, and Sync only moves the offset. A large file is mapped; a small one
+// (most are a few KB) is read at once, since mapping and unmapping it costs
+// more than copying it. The words are swapped as they are read if the file is
+// of the other endianness, as in GcdaFile.
+class MappedGcdaFile : public GcdaFile {
+ public:
+  // The size from which a file is mapped instead of read.
+  static const size_t kMinMappedFileSize = 256 * 1024;
+
+  MappedGcdaFile(const string& filename) :
+    GcdaFile(filename), words_(NULL), map_size_(0) {}
+  virtual ~MappedGcdaFile() { Close(); }
+
+  // Maps or reads a file. Returns false if it can't (e.g., it's empty).
+  bool Open() override;
+
+  // Releases the file and returns any existing error code.
+  int Close() override;
+
+  void Sync(unsigned base, unsigned length) override;
+
+  const unsigned* ReadWords(unsigned words) override;
+
+  int IsError() const override {
+    return words_ ? gcov_var_.error : 1;
+  }
+
+ private:
+  // the contents of the file, which are gcov_var_.length words long.
+  const unsigned* words_;
+  // the size of the mapping of words_, or 0 if words_ is a copy of the file.
+  size_t map_size_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "GcdaParser.h"
+
+/*
+ * Measures GcdaRawCoverageParser over a corpus of gcda files (e.g., those the
+ * drivers parse after each call), reading them through a FILE (GcdaFile) and
+ * holding them in memory (MappedGcdaFile, which maps the large ones), and
+ * checks that both parse the same units.
+ *
+ * Usage: gcda_parser_benchmark <rounds> <gcda file or dir>...
+ * where the .gcda files under a dir are found recursively.
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Appends path to files if it's a gcda file, or the gcda files under it if
+// it's a dir, and adds their sizes to *bytes.
+static void FindGcdaFiles(const string& path, vector<string>* files,
+                          uint64_t* bytes) {
+  struct stat st;
+  if (stat(path.c_str(), &st) < 0) {
+    fprintf(stderr, "can't stat %s\n", path.c_str());
+    return;
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    if (path.size() > 5 && path.compare(path.size() - 5, 5, ".gcda") == 0) {
+      files->push_back(path);
+      *bytes += st.st_size;
+    }
+    return;
+  }
+  DIR* dir = opendir(path.c_str());
+  if (!dir) return;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    if (!strcmp(entry->d_name, ".") || !strcmp(entry->d_name, "..")) {
+      continue;
+    }
+    FindGcdaFiles(path + "/" + entry->d_name, files, bytes);
+  }
+  closedir(dir);
+}
+
+// Returns the seconds it takes to parse each of files rounds times, and puts
+// the parsed units of the last round in units.
+static double MeasureParse(const vector<string>& files, int rounds,
+                           bool mapped, vector<vector<unsigned>>* units) {
+  units->assign(files.size(), vector<unsigned>());
+  double start = NowSeconds();
+  for (int round = 0; round < rounds; round++) {
+    for (size_t index = 0; index < files.size(); index++) {
+      (*units)[index] =
+          GcdaRawCoverageParser(files[index].c_str(), mapped).Parse();
+    }
+  }
+  return NowSeconds() - start;
+}
+
+int main(int argc, char** argv) {
+  int rounds = argc > 2 ? atoi(argv[1]) : 0;
+  if (rounds <= 0) {
+    fprintf(stderr, "usage: %s <rounds> <gcda file or dir>...\n", argv[0]);
+    return 1;
+  }
+  vector<string> files;
+  uint64_t bytes = 0;
+  for (int index = 2; index < argc; index++) {
+    FindGcdaFiles(argv[index], &files, &bytes);
+  }
+  if (files.empty()) {
+    fprintf(stderr, "no gcda files found\n");
+    return 1;
+  }
+
+  // the parser prints a line for each blocks and arcs tag, which would be
+  // measured instead.
+  streambuf* cout_buf = cout.rdbuf(NULL);
+  vector<vector<unsigned>> file_units;
+  vector<vector<unsigned>> mapped_units;
+  double file_seconds = MeasureParse(files, rounds, false, &file_units);
+  double mapped_seconds = MeasureParse(files, rounds, true, &mapped_units);
+  cout.clear();
+  cout.rdbuf(cout_buf);
+
+  uint64_t units = 0;
+  for (const auto& parsed : mapped_units) units += parsed.size();
+  uint64_t parses = (uint64_t)files.size() * rounds;
+  printf("%zu files, %llu bytes, %llu units, %d rounds\n", files.size(),
+         (unsigned long long)bytes, (unsigned long long)units, rounds);
+  printf("%-10s %12s %12s\n", "", "us/file", "MB/s");
+  printf("%-10s %12.2f %12.1f\n", "FILE", file_seconds * 1e6 / parses,
+         bytes * rounds / file_seconds / 1e6);
+  printf("%-10s %12.2f %12.1f\n", "memory", mapped_seconds * 1e6 / parses,
+         bytes * rounds / mapped_seconds / 1e6);
+  if (file_units != mapped_units) {
+    fprintf(stderr, "the parsed units differ\n");
+    return 1;
+  }
+  return 0;
+}
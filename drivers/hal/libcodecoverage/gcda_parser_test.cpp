@@ -22,16 +22,22 @@
 
 /*
  * To test locally:
- * $ rm a.out; gcc GcdaParser.cpp gcda_parser_test.cpp GcdaFile.cpp -lstdc++; ./a.out
+ * $ rm a.out; gcc GcdaParser.cpp gcda_parser_test.cpp GcdaFile.cpp \
+ *   MappedGcdaFile.cpp -lstdc++; ./a.out
  */
 
 using namespace std;
 
 int main() {
-  std::vector<unsigned> result =
-      android::vts::GcdaRawCoverageParser("testdata/lights.gcda").Parse();
+  android::vts::GcdaRawCoverageParser parser("testdata/lights.gcda");
+  std::vector<unsigned> result = parser.Parse();
   for (unsigned int index = 0; index < result.size(); index++) {
     cout << result.at(index) << endl;
   }
+  for (const auto& function : parser.GetFunctionCounters()) {
+    cout << function.ident << ":";
+    for (auto counter : function.counters) cout << " " << counter;
+    cout << endl;
+  }
   return 0;
 }
@@ -20,17 +20,23 @@
 #include "hal_camera.h"
 #include "hal_gps.h"
 #include "hal_light.h"
+#include "vts_random.h"
 
 #define MAX_CHAR_POINTER_LENGTH 100
 
 namespace android {
 namespace vts {
 
-extern void RandomNumberGeneratorReset();
+// The values are drawn from the generator of the calling thread (see
+// vts_random.h).
 extern uint32_t RandomUint32();
 extern int32_t RandomInt32();
 extern uint64_t RandomUint64();
 extern int64_t RandomInt64();
+extern uint16_t RandomUint16();
+extern int16_t RandomInt16();
+extern uint8_t RandomUint8();
+extern int8_t RandomInt8();
 extern float RandomFloat();
 extern double RandomDouble();
 extern bool RandomBool();
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __vts_libdatatype_vts_random_h__
+#define __vts_libdatatype_vts_random_h__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace android {
+namespace vts {
+
+// A xoshiro256** pseudo random number generator. It has no lock and its
+// whole state is four words, so each thread has its own (see
+// GetRandomEngine). It can be used with the distributions of <random>.
+class VtsRandomEngine {
+ public:
+  typedef uint64_t result_type;
+
+  explicit VtsRandomEngine(uint64_t seed = 0) { Seed(seed); }
+
+  // Restarts the sequence of seed.
+  void Seed(uint64_t seed);
+
+  // Returns the next 64 random bits.
+  uint64_t operator()() {
+    uint64_t result = Rotate(state_[1] * 5, 7) * 9;
+    uint64_t t = state_[1] << 17;
+    state_[2] ^= state_[0];
+    state_[3] ^= state_[1];
+    state_[1] ^= state_[2];
+    state_[0] ^= state_[3];
+    state_[2] ^= t;
+    state_[3] = Rotate(state_[3], 45);
+    return result;
+  }
+
+  uint32_t NextUint32() { return (*this)() >> 32; }
+
+  // Returns a number in [0, bound), or 0 if bound is 0, by a multiply and a
+  // shift instead of a division.
+  uint32_t Below(uint32_t bound) {
+    return (uint32_t)(((uint64_t)NextUint32() * bound) >> 32);
+  }
+
+  // Returns a number in [min_value, max_value].
+  int64_t InRange(int64_t min_value, int64_t max_value);
+
+  // Returns a number in [0, 1).
+  double NextDouble() { return ((*this)() >> 11) / 9007199254740992.0; }
+
+  // Fills size bytes at buffer with random bits.
+  void Fill(void* buffer, size_t size);
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() { return UINT64_MAX; }
+
+ private:
+  static uint64_t Rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+  }
+
+  uint64_t state_[4];
+};
+
+// Seeds the generators of all the threads, so a run can be replayed from
+// seed: the calling thread gets the first sequence of seed, and each other
+// thread the next one when it next draws a number.
+extern void RandomNumberGeneratorSeed(uint64_t seed);
+
+// Seeds the generators from the clock and the pid.
+extern void RandomNumberGeneratorReset();
+
+// Returns the seed of the generators.
+extern uint64_t GetRandomNumberGeneratorSeed();
+
+// Returns a seed derived from seed and stream (e.g., a worker number) with
+// splitmix64. Unlike seed + stream, nearby seeds and streams give unrelated
+// seeds.
+extern uint64_t DeriveRandomSeed(uint64_t seed, uint64_t stream);
+
+// Returns the generator of the calling thread.
+extern VtsRandomEngine& GetRandomEngine();
+
+// Fills size bytes at buffer with random bits.
+extern void RandomFill(void* buffer, size_t size);
+
+// Fills count values at values with random values.
+extern void RandomFillUint32(uint32_t* values, size_t count);
+extern void RandomFillUint64(uint64_t* values, size_t count);
+
+// Returns a number in [0, bound), or 0 if bound is 0.
+extern uint32_t RandomUint32Below(uint32_t bound);
+
+// Returns a number in [min_value, max_value].
+extern int64_t RandomInt64InRange(int64_t min_value, int64_t max_value);
+
+// Returns one of the count values at values (e.g., the values of an enum).
+template <typename T>
+const T& RandomChoice(const T* values, size_t count) {
+  return values[RandomUint32Below(count)];
+}
+
+}  // namespace vts
+}  // namespace android
+
+#endif
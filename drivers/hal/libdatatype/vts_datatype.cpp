@@ -17,44 +17,44 @@
 #include "vts_datatype.h"
 
 #include <stdlib.h>
-#include <time.h>
 
 namespace android {
 namespace vts {
 
-void RandomNumberGeneratorReset() { srand(time(NULL)); }
+uint32_t RandomUint32() { return GetRandomEngine().NextUint32(); }
 
-uint32_t RandomUint32() { return (unsigned int)rand(); }
+int32_t RandomInt32() { return (int32_t)GetRandomEngine().NextUint32(); }
 
-int32_t RandomInt32() { return rand(); }
+uint64_t RandomUint64() { return GetRandomEngine()(); }
 
-uint64_t RandomUint64() {
-  uint64_t num = (unsigned int)rand();
-  return (num << 32) | (unsigned int)rand();
-}
+int64_t RandomInt64() { return (int64_t)GetRandomEngine()(); }
 
-int64_t RandomInt64() {
-  int64_t num = rand();
-  return (num << 32) | rand();
-}
+uint16_t RandomUint16() { return GetRandomEngine()() >> 48; }
+
+int16_t RandomInt16() { return (int16_t)(GetRandomEngine()() >> 48); }
 
-float RandomFloat() { return (float)rand() / (float)(RAND_MAX / 1000000000.0); }
+uint8_t RandomUint8() { return GetRandomEngine()() >> 56; }
 
-double RandomDouble() {
-  return (double)rand() / (double)(RAND_MAX / 1000000000.0);
+int8_t RandomInt8() { return (int8_t)(GetRandomEngine()() >> 56); }
+
+float RandomFloat() {
+  return (float)(GetRandomEngine().NextDouble() * 1000000000.0);
 }
 
-bool RandomBool() { return (abs(rand()) % 2) == 1; }
+double RandomDouble() { return GetRandomEngine().NextDouble() * 1000000000.0; }
+
+bool RandomBool() { return (int64_t)GetRandomEngine()() < 0; }
 
 char* RandomCharPointer() {
-  int len = RandomUint32() % MAX_CHAR_POINTER_LENGTH;
+  int len = 1 + RandomUint32Below(MAX_CHAR_POINTER_LENGTH - 1);
   char* buf = (char*)malloc(len);
+  RandomFill(buf, len - 1);
   buf[len - 1] = '\0';
   return buf;
 }
 
 void* RandomVoidPointer() {
-  int len = RandomUint32() % MAX_CHAR_POINTER_LENGTH;
+  int len = RandomUint32Below(MAX_CHAR_POINTER_LENGTH);
   void* buf = malloc(len);
   return buf;
 }
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "vts_random.h"
+
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// the seed of the generators, a count of the seedings (so a thread can tell
+// its generator is stale), and the sequence the next thread to be seeded gets.
+static atomic<uint64_t> random_seed(0);
+static atomic<uint32_t> random_seed_generation(1);
+static atomic<uint64_t> random_next_sequence(0);
+
+// Returns the next number of the splitmix64 sequence at *state, which spreads
+// a seed over the state of a generator.
+static uint64_t SplitMix64(uint64_t* state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+void VtsRandomEngine::Seed(uint64_t seed) {
+  for (uint64_t& word : state_) word = SplitMix64(&seed);
+}
+
+int64_t VtsRandomEngine::InRange(int64_t min_value, int64_t max_value) {
+  if (max_value <= min_value) return min_value;
+  uint64_t span = (uint64_t)max_value - (uint64_t)min_value;
+  uint64_t offset;
+  if (span == UINT64_MAX) {
+    offset = (*this)();
+  } else if (span < UINT32_MAX) {
+    offset = Below(span + 1);
+  } else {
+    // rejects the draws past the last whole multiple of span + 1.
+    uint64_t limit = UINT64_MAX - UINT64_MAX % (span + 1);
+    do {
+      offset = (*this)();
+    } while (offset >= limit);
+    offset %= span + 1;
+  }
+  return (int64_t)((uint64_t)min_value + offset);
+}
+
+void VtsRandomEngine::Fill(void* buffer, size_t size) {
+  uint8_t* bytes = (uint8_t*)buffer;
+  while (size >= sizeof(uint64_t)) {
+    uint64_t value = (*this)();
+    memcpy(bytes, &value, sizeof(value));
+    bytes += sizeof(value);
+    size -= sizeof(value);
+  }
+  if (size > 0) {
+    uint64_t value = (*this)();
+    memcpy(bytes, &value, size);
+  }
+}
+
+// The generator of a thread and the seeding it's from.
+struct ThreadRandomEngine {
+  ThreadRandomEngine() : generation(0) {}
+
+  VtsRandomEngine engine;
+  uint32_t generation;
+};
+
+static thread_local ThreadRandomEngine thread_random_engine;
+
+// Seeds the generator of the calling thread with the next sequence of seed.
+static void SeedThreadRandomEngine(uint32_t generation) {
+  uint64_t sequence = random_next_sequence++;
+  // the sequences of seed are far apart in the space of seeds.
+  uint64_t mixer = random_seed + sequence * 0x9e3779b97f4a7c15ULL;
+  thread_random_engine.engine.Seed(SplitMix64(&mixer));
+  thread_random_engine.generation = generation;
+}
+
+void RandomNumberGeneratorSeed(uint64_t seed) {
+  random_seed = seed;
+  random_next_sequence = 0;
+  SeedThreadRandomEngine(++random_seed_generation);
+}
+
+void RandomNumberGeneratorReset() {
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  RandomNumberGeneratorSeed(((uint64_t)ts.tv_sec << 32) ^ ts.tv_nsec ^
+                            getpid());
+}
+
+uint64_t GetRandomNumberGeneratorSeed() { return random_seed; }
+
+uint64_t DeriveRandomSeed(uint64_t seed, uint64_t stream) {
+  uint64_t mixed = SplitMix64(&seed) ^ stream;
+  return SplitMix64(&mixed);
+}
+
+VtsRandomEngine& GetRandomEngine() {
+  uint32_t generation = random_seed_generation.load(memory_order_relaxed);
+  if (thread_random_engine.generation != generation) {
+    SeedThreadRandomEngine(generation);
+  }
+  return thread_random_engine.engine;
+}
+
+void RandomFill(void* buffer, size_t size) {
+  GetRandomEngine().Fill(buffer, size);
+}
+
+void RandomFillUint32(uint32_t* values, size_t count) {
+  GetRandomEngine().Fill(values, count * sizeof(uint32_t));
+}
+
+void RandomFillUint64(uint64_t* values, size_t count) {
+  VtsRandomEngine& engine = GetRandomEngine();
+  for (size_t index = 0; index < count; index++) values[index] = engine();
+}
+
+uint32_t RandomUint32Below(uint32_t bound) {
+  return GetRandomEngine().Below(bound);
+}
+
+int64_t RandomInt64InRange(int64_t min_value, int64_t max_value) {
+  return GetRandomEngine().InRange(min_value, max_value);
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <thread>
+#include <vector>
+
+#include "vts_random.h"
+
+/*
+ * Measures the random values which the drivers draw, as RandomUint32,
+ * RandomUint64 and RandomCharPointer used to make them with rand() and as
+ * they are made by the generator of the calling thread (vts_random.h): one
+ * at a time, as a buffer fill, and from several threads at once, where
+ * rand() takes a lock.
+ *
+ * Usage: vts_random_benchmark [<values> [<threads>]]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const uint64_t kDefaultValues = 10 * 1000 * 1000;
+static const int kDefaultThreads = 4;
+static const size_t kBufferSize = 4096;
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// RandomUint32 and RandomUint64 as they were made with rand().
+static uint32_t RandUint32() { return (unsigned int)rand(); }
+
+static uint64_t RandUint64() {
+  uint64_t num = (unsigned int)rand();
+  return (num << 32) | (unsigned int)rand();
+}
+
+// Fills a buffer a byte at a time with rand(), as RandomCharPointer would
+// have to.
+static void RandFill(uint8_t* buffer, size_t size) {
+  for (size_t index = 0; index < size; index++) buffer[index] = rand();
+}
+
+// Returns the ns per value of draw called values times, of which the results
+// are summed into *sink so they aren't optimized away.
+template <typename Draw>
+static double MeasureDraws(uint64_t values, Draw draw, uint64_t* sink) {
+  double start = NowSeconds();
+  uint64_t sum = 0;
+  for (uint64_t i = 0; i < values; i++) sum += draw();
+  double elapsed = NowSeconds() - start;
+  *sink += sum;
+  return elapsed * 1e9 / values;
+}
+
+// Returns the ns per byte of fill filling a buffer until values bytes are
+// filled.
+template <typename Fill>
+static double MeasureFills(uint64_t values, Fill fill, uint64_t* sink) {
+  vector<uint8_t> buffer(kBufferSize);
+  uint64_t rounds = values / kBufferSize + 1;
+  double start = NowSeconds();
+  for (uint64_t i = 0; i < rounds; i++) {
+    fill(buffer.data(), buffer.size());
+    *sink += buffer[i % kBufferSize];
+  }
+  double elapsed = NowSeconds() - start;
+  return elapsed * 1e9 / (rounds * kBufferSize);
+}
+
+// Returns the ns per value of draw called values times by each of threads
+// threads, counting the values of all the threads.
+template <typename Draw>
+static double MeasureThreads(uint64_t values, int threads, Draw draw,
+                             uint64_t* sink) {
+  vector<uint64_t> sums(threads);
+  vector<thread> workers;
+  double start = NowSeconds();
+  for (int index = 0; index < threads; index++) {
+    workers.push_back(thread([values, draw, &sums, index] {
+      uint64_t sum = 0;
+      for (uint64_t i = 0; i < values; i++) sum += draw();
+      sums[index] = sum;
+    }));
+  }
+  for (thread& worker : workers) worker.join();
+  double elapsed = NowSeconds() - start;
+  for (uint64_t sum : sums) *sink += sum;
+  return elapsed * 1e9 / (values * threads);
+}
+
+int main(int argc, char** argv) {
+  uint64_t values = argc > 1 ? strtoull(argv[1], NULL, 0) : kDefaultValues;
+  int threads = argc > 2 ? atoi(argv[2]) : kDefaultThreads;
+  if (values == 0 || threads <= 0) {
+    fprintf(stderr, "usage: %s [<values> [<threads>]]\n", argv[0]);
+    return 1;
+  }
+  srand(1);
+  RandomNumberGeneratorSeed(1);
+  uint64_t sink = 0;
+
+  double rand_uint32 = MeasureDraws(values, RandUint32, &sink);
+  double engine_uint32 = MeasureDraws(
+      values, [] { return GetRandomEngine().NextUint32(); }, &sink);
+  double rand_uint64 = MeasureDraws(values, RandUint64, &sink);
+  double engine_uint64 =
+      MeasureDraws(values, [] { return GetRandomEngine()(); }, &sink);
+  double rand_below = MeasureDraws(
+      values, [] { return (uint32_t)rand() % 1000; }, &sink);
+  double engine_below =
+      MeasureDraws(values, [] { return RandomUint32Below(1000); }, &sink);
+  double rand_fill = MeasureFills(values, RandFill, &sink);
+  double engine_fill = MeasureFills(values, RandomFill, &sink);
+  double rand_threads = MeasureThreads(values / threads, threads, RandUint32,
+                                       &sink);
+  double engine_threads = MeasureThreads(
+      values / threads, threads,
+      [] { return GetRandomEngine().NextUint32(); }, &sink);
+
+  printf("%llu values, %d threads (checksum %llx)\n",
+         (unsigned long long)values, threads, (unsigned long long)sink);
+  printf("%-22s %10s %10s\n", "", "rand()", "engine");
+  printf("%-22s %10.2f %10.2f ns/value\n", "uint32", rand_uint32,
+         engine_uint32);
+  printf("%-22s %10.2f %10.2f ns/value\n", "uint64", rand_uint64,
+         engine_uint64);
+  printf("%-22s %10.2f %10.2f ns/value\n", "below 1000", rand_below,
+         engine_below);
+  printf("%-22s %10.2f %10.2f ns/byte\n", "buffer fill", rand_fill,
+         engine_fill);
+  printf("%-22s %10.2f %10.2f ns/value\n", "uint32, all threads",
+         rand_threads, engine_threads);
+  return 0;
+}
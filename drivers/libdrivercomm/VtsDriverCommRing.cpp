@@ -0,0 +1,232 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "VtsDriverCommRing.h"
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <new>
+
+using namespace std;
+
+namespace android {
+namespace vts {
+
+// the atomics below are shared by two processes, so they must not fall back
+// to a lock which lives in one process.
+static_assert(ATOMIC_INT_LOCK_FREE == 2 && ATOMIC_LLONG_LOCK_FREE == 2,
+              "lock-free atomics are needed in shared memory");
+
+static const uint32_t kRingMagic = 0x76727231;  // "vrr1"
+// times to poll the ring before going to sleep on the futex.
+static const int kSpinCount = 2000;
+// how long a blocked side sleeps before it checks the control socket.
+static const long kWaitTimeoutNsec = 100 * 1000 * 1000;
+
+// Fields written by the producer and the consumer are on separate cache
+// lines.
+struct VtsDriverCommRing::Control {
+  uint32_t magic;
+  uint32_t capacity;
+  std::atomic<uint32_t> closed;
+
+  // total bytes written, and the futex the consumer sleeps on.
+  alignas(64) std::atomic<uint64_t> write_pos;
+  std::atomic<uint32_t> data_futex;
+  std::atomic<uint32_t> consumer_waiting;
+
+  // total bytes read, and the futex the producer sleeps on.
+  alignas(64) std::atomic<uint64_t> read_pos;
+  std::atomic<uint32_t> space_futex;
+  std::atomic<uint32_t> producer_waiting;
+};
+
+size_t VtsDriverCommRing::GetControlSize() {
+  return (sizeof(VtsDriverCommRing::Control) + 63) & ~(size_t)63;
+}
+
+size_t VtsDriverCommRing::GetRegionSize(size_t capacity) {
+  return GetControlSize() + capacity;
+}
+
+VtsDriverCommRing* VtsDriverCommRing::Create(void* addr, size_t capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+      capacity > UINT32_MAX) {
+    cerr << __func__ << " ERROR invalid ring capacity " << capacity << endl;
+    return NULL;
+  }
+  Control* control = new (addr) Control();
+  control->capacity = capacity;
+  control->closed.store(0);
+  control->write_pos.store(0);
+  control->data_futex.store(0);
+  control->consumer_waiting.store(0);
+  control->read_pos.store(0);
+  control->space_futex.store(0);
+  control->producer_waiting.store(0);
+  control->magic = kRingMagic;
+  return new VtsDriverCommRing(control, (char*)addr + GetControlSize(),
+                               capacity);
+}
+
+VtsDriverCommRing* VtsDriverCommRing::Attach(void* addr, size_t region_size) {
+  if (region_size < GetControlSize()) return NULL;
+  Control* control = (Control*)addr;
+  size_t capacity = control->capacity;
+  if (control->magic != kRingMagic || capacity == 0 ||
+      (capacity & (capacity - 1)) != 0 ||
+      GetRegionSize(capacity) > region_size) {
+    cerr << __func__ << " ERROR no valid ring in the shared memory" << endl;
+    return NULL;
+  }
+  return new VtsDriverCommRing(control, (char*)addr + GetControlSize(),
+                               capacity);
+}
+
+bool VtsDriverCommRing::Wait(std::atomic<uint32_t>* futex,
+                             std::atomic<uint32_t>* waiting, uint32_t value,
+                             int control_sockfd) {
+  waiting->store(1);
+  // the caller re-checks the ring after this returns, so a wake-up which
+  // came in between is not lost: the futex value has changed by then and the
+  // wait below returns at once.
+  struct timespec timeout = {0, kWaitTimeoutNsec};
+  long ret = syscall(__NR_futex, futex, FUTEX_WAIT, value, &timeout, NULL, 0);
+  num_syscalls_++;
+  waiting->store(0);
+  if (control_->closed.load()) return false;
+  if (ret != 0 && errno == ETIMEDOUT && control_sockfd >= 0) {
+    struct pollfd pfd;
+    pfd.fd = control_sockfd;
+    pfd.events = 0;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR))) {
+      cerr << getpid() << " " << __func__ << " ERROR the peer hung up" << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+void VtsDriverCommRing::Wake(std::atomic<uint32_t>* futex,
+                             std::atomic<uint32_t>* waiting) {
+  futex->fetch_add(1);
+  if (waiting->load()) {
+    syscall(__NR_futex, futex, FUTEX_WAKE, 1, NULL, NULL, 0);
+    num_syscalls_++;
+  }
+}
+
+bool VtsDriverCommRing::Write(const struct iovec* iov, int iov_count,
+                              int control_sockfd) {
+  size_t iov_offset = 0;
+  while (iov_count > 0) {
+    if (control_->closed.load()) return false;
+    uint64_t write_pos = control_->write_pos.load(std::memory_order_relaxed);
+    size_t space = capacity_ - (write_pos - control_->read_pos.load());
+    if (space == 0) {
+      int spin;
+      for (spin = 0; spin < kSpinCount; spin++) {
+        if (write_pos - control_->read_pos.load() < capacity_) break;
+      }
+      if (spin == kSpinCount) {
+        uint32_t value = control_->space_futex.load();
+        if (write_pos - control_->read_pos.load() == capacity_ &&
+            !Wait(&control_->space_futex, &control_->producer_waiting, value,
+                  control_sockfd)) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    // copies as much as fits, wrapping around the end of the data area.
+    uint64_t pos = write_pos;
+    while (space > 0 && iov_count > 0) {
+      size_t len = iov->iov_len - iov_offset;
+      if (len > space) len = space;
+      size_t index = pos & (capacity_ - 1);
+      size_t first = capacity_ - index;
+      if (first > len) first = len;
+      const char* src = (const char*)iov->iov_base + iov_offset;
+      memcpy(&data_[index], src, first);
+      memcpy(&data_[0], src + first, len - first);
+      pos += len;
+      space -= len;
+      iov_offset += len;
+      if (iov_offset == iov->iov_len) {
+        iov++;
+        iov_count--;
+        iov_offset = 0;
+      }
+    }
+    control_->write_pos.store(pos);
+    Wake(&control_->data_futex, &control_->consumer_waiting);
+  }
+  return true;
+}
+
+bool VtsDriverCommRing::Read(char* buf, size_t len, int control_sockfd) {
+  size_t bytes_read = 0;
+  while (bytes_read < len) {
+    uint64_t read_pos = control_->read_pos.load(std::memory_order_relaxed);
+    size_t available = control_->write_pos.load() - read_pos;
+    if (available == 0) {
+      if (control_->closed.load()) return false;
+      int spin;
+      for (spin = 0; spin < kSpinCount; spin++) {
+        if (control_->write_pos.load() != read_pos) break;
+      }
+      if (spin == kSpinCount) {
+        uint32_t value = control_->data_futex.load();
+        if (control_->write_pos.load() == read_pos &&
+            !Wait(&control_->data_futex, &control_->consumer_waiting, value,
+                  control_sockfd)) {
+          return false;
+        }
+      }
+      continue;
+    }
+
+    size_t chunk = len - bytes_read;
+    if (chunk > available) chunk = available;
+    size_t index = read_pos & (capacity_ - 1);
+    size_t first = capacity_ - index;
+    if (first > chunk) first = chunk;
+    memcpy(&buf[bytes_read], &data_[index], first);
+    memcpy(&buf[bytes_read + first], &data_[0], chunk - first);
+    bytes_read += chunk;
+    control_->read_pos.store(read_pos + chunk);
+    Wake(&control_->space_futex, &control_->producer_waiting);
+  }
+  return true;
+}
+
+void VtsDriverCommRing::Close() {
+  control_->closed.store(1);
+  Wake(&control_->data_futex, &control_->consumer_waiting);
+  Wake(&control_->space_futex, &control_->producer_waiting);
+}
+
+}  // namespace vts
+}  // namespace android
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __VTS_DRIVER_COMM_RING_H_
+#define __VTS_DRIVER_COMM_RING_H_
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <atomic>
+
+namespace android {
+namespace vts {
+
+// A single-producer/single-consumer byte ring in memory shared by two
+// processes. The producer blocks while the ring is full and the consumer
+// while it is empty, and each wakes the other with a futex. A blocked side
+// also watches the control socket of the connection so that it notices when
+// the peer goes away.
+class VtsDriverCommRing {
+ public:
+  // Returns the bytes of shared memory used by a ring of the given capacity.
+  static size_t GetRegionSize(size_t capacity);
+
+  // Initializes a new ring of capacity bytes (a power of 2) at addr.
+  static VtsDriverCommRing* Create(void* addr, size_t capacity);
+
+  // Attaches to a ring which the peer initialized at addr. region_size is the
+  // number of mapped bytes from addr. Returns NULL if there is no valid ring.
+  static VtsDriverCommRing* Attach(void* addr, size_t region_size);
+
+  // Writes all the bytes in iov, blocking while the ring is full. Returns
+  // false if the ring is closed or control_sockfd is hung up.
+  bool Write(const struct iovec* iov, int iov_count, int control_sockfd);
+
+  // Reads exactly len bytes, blocking while the ring is empty. Returns false
+  // if the ring is closed or control_sockfd is hung up.
+  bool Read(char* buf, size_t len, int control_sockfd);
+
+  // Marks the ring closed and wakes up the peer.
+  void Close();
+
+  // Returns the number of data bytes the ring holds.
+  size_t GetCapacity() const { return capacity_; }
+
+  // Returns the number of futex system calls made so far.
+  uint64_t GetNumSyscalls() const { return num_syscalls_; }
+
+ private:
+  // the part of the ring which lives in the shared memory.
+  struct Control;
+
+  // Returns the bytes at the start of a ring's memory used by its Control.
+  static size_t GetControlSize();
+
+  VtsDriverCommRing(Control* control, char* data, size_t capacity)
+      : control_(control), data_(data), capacity_(capacity),
+        num_syscalls_(0) {}
+
+  // Waits until *futex changes from value, the ring is closed, or the wait
+  // times out. Returns false if the ring is closed or control_sockfd is hung
+  // up.
+  bool Wait(std::atomic<uint32_t>* futex, std::atomic<uint32_t>* waiting,
+            uint32_t value, int control_sockfd);
+
+  // Bumps *futex and wakes up the peer if it waits on it.
+  void Wake(std::atomic<uint32_t>* futex, std::atomic<uint32_t>* waiting);
+
+  Control* control_;
+  char* data_;
+  size_t capacity_;
+  uint64_t num_syscalls_;
+};
+
+}  // namespace vts
+}  // namespace android
+
+#endif  // __VTS_DRIVER_COMM_RING_H_
@@ -19,26 +19,56 @@
 #include <errno.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <linux/memfd.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <iostream>
 #include <sstream>
 
+#include <google/protobuf/io/coded_stream.h>
+
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
 using namespace std;
 
 #define MAX_HEADER_BUFFER_SIZE 128
 
+// The binary framing header is 8 bytes:
+//   byte 0:    kBinaryFramingMagic (never an ASCII digit, so a receiver can
+//              tell the two framings apart from the first byte)
+//   byte 1:    kBinaryFramingVersion
+//   bytes 2-3: flags (big endian, see below; zero for a message)
+//   bytes 4-7: payload length (big endian)
+#define BINARY_HEADER_SIZE 8
+
+// Flags of a binary header without payload which negotiates the shared
+// memory transport. The offer carries the memfd holding both rings (the one
+// written by the offering side first) as SCM_RIGHTS ancillary data. Once the
+// offer is accepted, each message is a 4-byte big endian length and the
+// payload in the ring of its direction.
+#define BINARY_FLAG_SHARED_MEMORY_OFFER 0x1
+#define BINARY_FLAG_SHARED_MEMORY_ACCEPT 0x2
+#define BINARY_FLAG_SHARED_MEMORY_REJECT 0x4
+
 namespace android {
 namespace vts {
 
+static const unsigned char kBinaryFramingMagic = 0xf5;
+static const unsigned char kBinaryFramingVersion = 1;
+static const size_t kMaxMessageLength = 1 << 30;
+
 bool VtsDriverCommUtil::Connect(const string& socket_name) {
   struct sockaddr_un serv_addr;
   struct hostent* server;
@@ -65,6 +95,7 @@ bool VtsDriverCommUtil::Connect(const string& socket_name) {
     sockfd_ = -1;
     return false;
   }
+  recv_buffer_begin_ = recv_buffer_end_ = 0;
   return true;
 }
 
@@ -80,87 +111,463 @@ int VtsDriverCommUtil::Close() {
 
     sockfd_ = -1;
   }
+  recv_buffer_begin_ = recv_buffer_end_ = 0;
+  pending_recv_bytes_.clear();
+  ReleaseSharedMemory();
 
   return result;
 }
 
-bool VtsDriverCommUtil::VtsSocketSendBytes(const string& message) {
-  cout << getpid() << " " << __func__ << endl;
-  if (sockfd_ == -1) {
-    cerr << __func__ << " ERROR sockfd not set" << endl;
+void VtsDriverCommUtil::ReleaseSharedMemory() {
+  if (pending_fd_ != -1) {
+    close(pending_fd_);
+    pending_fd_ = -1;
+  }
+  if (send_ring_) {
+    send_ring_->Close();
+    delete send_ring_;
+    send_ring_ = NULL;
+  }
+  if (recv_ring_) {
+    recv_ring_->Close();
+    delete recv_ring_;
+    recv_ring_ = NULL;
+  }
+  if (shared_memory_) {
+    munmap(shared_memory_, shared_memory_size_);
+    shared_memory_ = NULL;
+    shared_memory_size_ = 0;
+  }
+}
+
+bool VtsDriverCommUtil::SendControlHeader(uint16_t flags, int fd) {
+  unsigned char header[BINARY_HEADER_SIZE] = {
+      kBinaryFramingMagic, kBinaryFramingVersion,
+      (unsigned char)(flags >> 8), (unsigned char)(flags & 0xff), 0, 0, 0, 0};
+  struct iovec iov;
+  iov.iov_base = header;
+  iov.iov_len = BINARY_HEADER_SIZE;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  char control[CMSG_SPACE(sizeof(int))];
+  if (fd != -1) {
+    memset(control, 0, sizeof(control));
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+  }
+  while (true) {
+    ssize_t n = sendmsg(sockfd_, &msg, 0);
+    num_write_calls_++;
+    if (n < 0 && errno == EINTR) continue;
+    // an 8-byte write to a stream socket is not split.
+    if (n != BINARY_HEADER_SIZE) {
+      cerr << getpid() << " " << __func__ << " ERROR sendmsg failed errno = "
+           << errno << endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+bool VtsDriverCommUtil::StartSharedMemoryTransport(size_t ring_capacity) {
+  cout << getpid() << " " << __func__ << " " << ring_capacity << endl;
+  if (sockfd_ == -1 || send_ring_) {
+    cerr << getpid() << " " << __func__
+         << " ERROR no socket or the transport is already started" << endl;
     return false;
   }
-  std::stringstream header;
-  header << message.length() << "\n";
-  cout << getpid() << " [agent->driver] len = " << message.length() << endl;
-  int n = write(sockfd_, header.str().c_str(), header.str().length());
-  if (n < 0) {
-    cerr << getpid() << " " << __func__ << ":" << __LINE__
-         << " ERROR writing to socket" << endl;
+  if (ring_capacity < 4096 || (ring_capacity & (ring_capacity - 1)) != 0) {
+    cerr << getpid() << " " << __func__ << " ERROR invalid ring capacity "
+         << ring_capacity << endl;
+    return false;
+  }
+
+  size_t ring_region_size = VtsDriverCommRing::GetRegionSize(ring_capacity);
+  size_t region_size = ring_region_size * 2;
+  int fd = syscall(__NR_memfd_create, "vts_drivercomm", MFD_CLOEXEC);
+  if (fd < 0) {
+    cerr << getpid() << " " << __func__ << " ERROR memfd_create failed errno = "
+         << errno << endl;
+    return false;
+  }
+  void* addr = MAP_FAILED;
+  if (ftruncate(fd, region_size) == 0) {
+    addr = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (addr == MAP_FAILED) {
+    cerr << getpid() << " " << __func__ << " ERROR can't map the rings errno = "
+         << errno << endl;
+    close(fd);
+    return false;
+  }
+  shared_memory_ = addr;
+  shared_memory_size_ = region_size;
+  send_ring_ = VtsDriverCommRing::Create(addr, ring_capacity);
+  recv_ring_ =
+      VtsDriverCommRing::Create((char*)addr + ring_region_size, ring_capacity);
+
+  bool sent = SendControlHeader(BINARY_FLAG_SHARED_MEMORY_OFFER, fd);
+  close(fd);
+  unsigned char reply[BINARY_HEADER_SIZE];
+  // RecvExactly reads the socket as the rings are not in use until the reply
+  // says so.
+  VtsDriverCommRing* send_ring = send_ring_;
+  VtsDriverCommRing* recv_ring = recv_ring_;
+  send_ring_ = recv_ring_ = NULL;
+  if (!sent || !RecvExactly((char*)reply, BINARY_HEADER_SIZE) ||
+      reply[0] != kBinaryFramingMagic ||
+      reply[3] != BINARY_FLAG_SHARED_MEMORY_ACCEPT) {
+    cerr << getpid() << " " << __func__
+         << " the peer declined the shared memory transport" << endl;
+    send_ring_ = send_ring;
+    recv_ring_ = recv_ring;
+    ReleaseSharedMemory();
+    return false;
+  }
+  send_ring_ = send_ring;
+  recv_ring_ = recv_ring;
+  send_framing_ = VTS_SOCKET_FRAMING_BINARY;
+  return true;
+}
+
+bool VtsDriverCommUtil::AcceptSharedMemoryTransport() {
+  int fd = pending_fd_;
+  pending_fd_ = -1;
+  struct stat st;
+  void* addr = MAP_FAILED;
+  if (fd != -1 && !send_ring_ && fstat(fd, &st) == 0 && st.st_size > 0) {
+    addr = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (fd != -1) close(fd);
+
+  VtsDriverCommRing* recv_ring = NULL;
+  VtsDriverCommRing* send_ring = NULL;
+  if (addr != MAP_FAILED) {
+    // the offering side writes the first ring.
+    recv_ring = VtsDriverCommRing::Attach(addr, st.st_size);
+    if (recv_ring) {
+      size_t offset = VtsDriverCommRing::GetRegionSize(
+          recv_ring->GetCapacity());
+      send_ring = VtsDriverCommRing::Attach((char*)addr + offset,
+                                            st.st_size - offset);
+    }
+  }
+  if (!send_ring) {
+    cerr << getpid() << " " << __func__
+         << " ERROR can't use the offered shared memory" << endl;
+    delete recv_ring;
+    if (addr != MAP_FAILED) munmap(addr, st.st_size);
+    return SendControlHeader(BINARY_FLAG_SHARED_MEMORY_REJECT, -1);
+  }
+  if (!SendControlHeader(BINARY_FLAG_SHARED_MEMORY_ACCEPT, -1)) {
+    delete recv_ring;
+    delete send_ring;
+    munmap(addr, st.st_size);
     return false;
   }
+  shared_memory_ = addr;
+  shared_memory_size_ = st.st_size;
+  send_ring_ = send_ring;
+  recv_ring_ = recv_ring;
+  cout << getpid() << " " << __func__ << " using the shared memory transport"
+       << endl;
+  return true;
+}
+
+size_t VtsDriverCommUtil::BuildHeader(size_t msg_len, char* header) {
+  if (send_ring_) {
+    header[0] = (msg_len >> 24) & 0xff;
+    header[1] = (msg_len >> 16) & 0xff;
+    header[2] = (msg_len >> 8) & 0xff;
+    header[3] = msg_len & 0xff;
+    return 4;
+  } else if (send_framing_ == VTS_SOCKET_FRAMING_BINARY) {
+    header[0] = kBinaryFramingMagic;
+    header[1] = kBinaryFramingVersion;
+    header[2] = 0;
+    header[3] = 0;
+    header[4] = (msg_len >> 24) & 0xff;
+    header[5] = (msg_len >> 16) & 0xff;
+    header[6] = (msg_len >> 8) & 0xff;
+    header[7] = msg_len & 0xff;
+    return BINARY_HEADER_SIZE;
+  }
+  return snprintf(header, MAX_HEADER_BUFFER_SIZE, "%zu\n", msg_len);
+}
 
-  int bytes_sent = 0;
-  int msg_len = message.length();
-  while (bytes_sent < msg_len) {
-    n = write(sockfd_, &message.c_str()[bytes_sent], msg_len - bytes_sent);
+bool VtsDriverCommUtil::WriteAll(struct iovec* iov, int iov_count) {
+  if (send_ring_) {
+    if (!send_ring_->Write(iov, iov_count, sockfd_)) {
+      cerr << getpid() << " " << __func__ << " ERROR writing to the ring"
+           << endl;
+      return false;
+    }
+    return true;
+  }
+
+  struct iovec* iov_next = iov;
+  while (iov_count > 0) {
+    ssize_t n = writev(sockfd_, iov_next, iov_count);
+    num_write_calls_++;
+    if (n < 0 && errno == EINTR) continue;
     if (n <= 0) {
       cerr << getpid() << " " << __func__ << ":" << __LINE__
            << " ERROR writing to socket" << endl;
       return false;
     }
-    bytes_sent += n;
+    while (iov_count > 0 && (size_t)n >= iov_next->iov_len) {
+      n -= iov_next->iov_len;
+      iov_next++;
+      iov_count--;
+    }
+    if (iov_count > 0) {
+      iov_next->iov_base = (char*)iov_next->iov_base + n;
+      iov_next->iov_len -= n;
+    }
   }
   return true;
 }
 
-string VtsDriverCommUtil::VtsSocketRecvBytes() {
+bool VtsDriverCommUtil::VtsSocketSendBytes(const string& message) {
   cout << getpid() << " " << __func__ << endl;
+  if (sockfd_ == -1) {
+    cerr << __func__ << " ERROR sockfd not set" << endl;
+    return false;
+  }
+  size_t msg_len = message.length();
+  if (msg_len > kMaxMessageLength) {
+    cerr << getpid() << " " << __func__ << " ERROR message too long "
+         << msg_len << endl;
+    return false;
+  }
+
+  char header[MAX_HEADER_BUFFER_SIZE];
+  size_t header_len = BuildHeader(msg_len, header);
+  cout << getpid() << " [agent->driver] len = " << msg_len << endl;
+
+  // the header and the payload go out in one system call in the common case.
+  struct iovec iov[2];
+  iov[0].iov_base = header;
+  iov[0].iov_len = header_len;
+  iov[1].iov_base = const_cast<char*>(message.data());
+  iov[1].iov_len = msg_len;
+  return WriteAll(iov, msg_len > 0 ? 2 : 1);
+}
+
+bool VtsDriverCommUtil::AppendFramedMessage(
+    const google::protobuf::Message& message, string* buffer) {
+  if (!message.SerializeToString(&send_message_buffer_)) {
+    cerr << getpid() << " " << __func__
+         << " ERROR can't serialize the message to a string." << endl;
+    return false;
+  }
+  return AppendFramedBytes(send_message_buffer_, buffer);
+}
+
+bool VtsDriverCommUtil::AppendFramedBytes(const string& message,
+                                          string* buffer) {
+  size_t msg_len = message.length();
+  if (msg_len == 0 || msg_len > kMaxMessageLength) {
+    cerr << getpid() << " " << __func__ << " ERROR invalid message length "
+         << msg_len << endl;
+    return false;
+  }
+  char header[MAX_HEADER_BUFFER_SIZE];
+  buffer->append(header, BuildHeader(msg_len, header));
+  buffer->append(message);
+  return true;
+}
+
+bool VtsDriverCommUtil::VtsSocketSendFramedBytes(const string& bytes) {
+  cout << getpid() << " " << __func__ << " " << bytes.length() << endl;
   if (sockfd_ == -1) {
     cerr << getpid() << " " << __func__ << " ERROR sockfd not set" << endl;
-    return string();
+    return false;
   }
+  if (bytes.empty()) return true;
+  struct iovec iov;
+  iov.iov_base = const_cast<char*>(bytes.data());
+  iov.iov_len = bytes.length();
+  return WriteAll(&iov, 1);
+}
 
-  int header_index = 0;
-  char header_buffer[MAX_HEADER_BUFFER_SIZE];
+ssize_t VtsDriverCommUtil::ReadSocket(char* buf, size_t len) {
+  struct iovec iov;
+  iov.iov_base = buf;
+  iov.iov_len = len;
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  char control[CMSG_SPACE(sizeof(int))];
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  ssize_t ret = recvmsg(sockfd_, &msg, MSG_CMSG_CLOEXEC);
+  num_read_calls_++;
+  if (ret > 0) {
+    for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+         cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+      if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+          cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+        if (pending_fd_ != -1) close(pending_fd_);
+        memcpy(&pending_fd_, CMSG_DATA(cmsg), sizeof(int));
+      }
+    }
+  }
+  return ret;
+}
 
-  for (header_index = 0; header_index < MAX_HEADER_BUFFER_SIZE;
-       header_index++) {
-    int ret = read(sockfd_, &header_buffer[header_index], 1);
-    if (ret != 1) {
+bool VtsDriverCommUtil::FillRecvBuffer() {
+  while (true) {
+    ssize_t ret = ReadSocket(recv_buffer_, kRecvBufferSize);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
       int errno_save = errno;
-      cerr << getpid() << " " << __func__
-           << " ERROR reading the length ret = " << ret
-           << " sockfd = " << sockfd_ << " "
-           << " errno = " << errno_save << " " << strerror(errno_save) << endl;
-      return string();
-    }
-    if (header_buffer[header_index] == '\n' ||
-        header_buffer[header_index] == '\r') {
-      header_buffer[header_index] = '\0';
-      break;
+      cerr << getpid() << " " << __func__ << " ERROR read failed ret = " << ret
+           << " sockfd = " << sockfd_ << " errno = " << errno_save << " "
+           << strerror(errno_save) << endl;
+      return false;
     }
+    recv_buffer_begin_ = 0;
+    recv_buffer_end_ = ret;
+    return true;
   }
+}
 
-  int msg_len = atoi(header_buffer);
-  char* msg = (char*)malloc(msg_len + 1);
-  if (!msg) {
-    cerr << getpid() << " " << __func__ << " ERROR malloc failed" << endl;
-    return string();
+bool VtsDriverCommUtil::RecvExactly(char* buf, size_t len) {
+  if (recv_ring_) return recv_ring_->Read(buf, len, sockfd_);
+
+  size_t buffered = recv_buffer_end_ - recv_buffer_begin_;
+  if (buffered >= len) {
+    memcpy(buf, &recv_buffer_[recv_buffer_begin_], len);
+    recv_buffer_begin_ += len;
+    return true;
   }
+  memcpy(buf, &recv_buffer_[recv_buffer_begin_], buffered);
+  recv_buffer_begin_ = recv_buffer_end_ = 0;
+  size_t bytes_read = buffered;
 
-  int bytes_read = 0;
-  while (bytes_read < msg_len) {
-    int result = read(sockfd_, &msg[bytes_read], msg_len - bytes_read);
-    if (result <= 0) {
+  // a large remainder is read straight into the destination; a small one goes
+  // through the buffer so that the following header is picked up by the
+  // same system call.
+  while (len - bytes_read >= kRecvBufferSize) {
+    ssize_t ret = ReadSocket(&buf[bytes_read], len - bytes_read);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret <= 0) {
       cerr << getpid() << " " << __func__ << " ERROR read failed" << endl;
-      return string();
+      return false;
     }
-    bytes_read += result;
+    bytes_read += ret;
+  }
+  while (bytes_read < len) {
+    if (!FillRecvBuffer()) return false;
+    size_t chunk = recv_buffer_end_;
+    if (chunk > len - bytes_read) chunk = len - bytes_read;
+    memcpy(&buf[bytes_read], recv_buffer_, chunk);
+    recv_buffer_begin_ = chunk;
+    bytes_read += chunk;
+  }
+  return true;
+}
+
+bool VtsDriverCommUtil::RecvHeader(size_t* msg_len) {
+  if (recv_ring_) {
+    unsigned char header[4];
+    if (!recv_ring_->Read((char*)header, sizeof(header), sockfd_)) {
+      cerr << getpid() << " " << __func__ << " ERROR reading the ring" << endl;
+      return false;
+    }
+    *msg_len = ((size_t)header[0] << 24) | ((size_t)header[1] << 16) |
+               ((size_t)header[2] << 8) | (size_t)header[3];
+    if (*msg_len > kMaxMessageLength) {
+      cerr << getpid() << " " << __func__ << " ERROR message too long "
+           << *msg_len << endl;
+      return false;
+    }
+    return true;
+  }
+
+  if (recv_buffer_begin_ == recv_buffer_end_ && !FillRecvBuffer()) {
+    cerr << getpid() << " " << __func__ << " ERROR reading the length"
+         << " sockfd = " << sockfd_ << endl;
+    return false;
+  }
+
+  if ((unsigned char)recv_buffer_[recv_buffer_begin_] == kBinaryFramingMagic) {
+    unsigned char header[BINARY_HEADER_SIZE];
+    if (!RecvExactly((char*)header, BINARY_HEADER_SIZE)) return false;
+    if (header[1] != kBinaryFramingVersion) {
+      cerr << getpid() << " " << __func__
+           << " ERROR unsupported binary framing version " << (int)header[1]
+           << endl;
+      return false;
+    }
+    *msg_len = ((size_t)header[4] << 24) | ((size_t)header[5] << 16) |
+               ((size_t)header[6] << 8) | (size_t)header[7];
+    // the peer speaks the binary framing, so it is used from now on.
+    send_framing_ = VTS_SOCKET_FRAMING_BINARY;
+    if (header[3] & BINARY_FLAG_SHARED_MEMORY_OFFER) {
+      // the offer is not a message; the next message comes in the rings if
+      // the offer is accepted or on the socket otherwise.
+      if (!AcceptSharedMemoryTransport()) return false;
+      return RecvHeader(msg_len);
+    }
+  } else {
+    char header_buffer[MAX_HEADER_BUFFER_SIZE];
+    int header_index;
+    for (header_index = 0; header_index < MAX_HEADER_BUFFER_SIZE;
+         header_index++) {
+      if (recv_buffer_begin_ == recv_buffer_end_ && !FillRecvBuffer()) {
+        cerr << getpid() << " " << __func__ << " ERROR reading the length"
+             << " sockfd = " << sockfd_ << endl;
+        return false;
+      }
+      header_buffer[header_index] = recv_buffer_[recv_buffer_begin_++];
+      if (header_buffer[header_index] == '\n' ||
+          header_buffer[header_index] == '\r') {
+        header_buffer[header_index] = '\0';
+        break;
+      }
+    }
+    if (header_index == MAX_HEADER_BUFFER_SIZE) {
+      cerr << getpid() << " " << __func__ << " ERROR header too long" << endl;
+      return false;
+    }
+    *msg_len = atoi(header_buffer);
+  }
+
+  if (*msg_len > kMaxMessageLength) {
+    cerr << getpid() << " " << __func__ << " ERROR message too long "
+         << *msg_len << endl;
+    return false;
+  }
+  return true;
+}
+
+string VtsDriverCommUtil::VtsSocketRecvBytes() {
+  cout << getpid() << " " << __func__ << endl;
+  if (sockfd_ == -1) {
+    cerr << getpid() << " " << __func__ << " ERROR sockfd not set" << endl;
+    return string();
+  }
+
+  size_t msg_len;
+  if (!RecvHeader(&msg_len)) return string();
+
+  string msg(msg_len, '\0');
+  if (msg_len > 0 && !RecvExactly(&msg[0], msg_len)) {
+    cerr << getpid() << " " << __func__ << " ERROR read failed" << endl;
+    return string();
   }
-  msg[msg_len] = '\0';
   cout << getpid() << " " << __func__ << " recv" << endl;
-  return string(msg, msg_len);
+  return msg;
 }
 
 bool VtsDriverCommUtil::VtsSocketSendMessage(
@@ -171,13 +578,12 @@ bool VtsDriverCommUtil::VtsSocketSendMessage(
     return false;
   }
 
-  string message_string;
-  if (!message.SerializeToString(&message_string)) {
+  if (!message.SerializeToString(&send_message_buffer_)) {
     cerr << getpid() << " " << __func__
          << " ERROR can't serialize the message to a string." << endl;
     return false;
   }
-  return VtsSocketSendBytes(message_string);
+  return VtsSocketSendBytes(send_message_buffer_);
 }
 
 bool VtsDriverCommUtil::VtsSocketRecvMessage(
@@ -188,14 +594,168 @@ bool VtsDriverCommUtil::VtsSocketRecvMessage(
     return false;
   }
 
-  string message_string = VtsSocketRecvBytes();
-  if (message_string.length() == 0) {
+  size_t msg_len;
+  if (!RecvHeader(&msg_len)) return false;
+  if (msg_len == 0) {
     cerr << getpid() << " " << __func__ << " ERROR message string zero length"
          << endl;
     return false;
   }
 
-  return message->ParseFromString(message_string);
+  // resize() keeps the capacity, so a connection stops allocating once its
+  // buffer has grown to the largest message seen.
+  recv_message_buffer_.resize(msg_len);
+  if (!RecvExactly(&recv_message_buffer_[0], msg_len)) {
+    cerr << getpid() << " " << __func__ << " ERROR read failed" << endl;
+    return false;
+  }
+
+  // parses straight out of the receive buffer without an intermediate copy.
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(recv_message_buffer_.data()), msg_len);
+  if (!message->ParseFromCodedStream(&input) ||
+      !input.ConsumedEntireMessage()) {
+    cerr << getpid() << " " << __func__ << " ERROR can't parse the message"
+         << endl;
+    return false;
+  }
+  return true;
+}
+
+int VtsDriverCommUtil::ParsePendingHeader(size_t* header_len,
+                                          size_t* msg_len) {
+  const string& bytes = pending_recv_bytes_;
+  if (bytes.empty()) return 0;
+  if ((unsigned char)bytes[0] == kBinaryFramingMagic) {
+    if (bytes.size() < BINARY_HEADER_SIZE) return 0;
+    const unsigned char* header = (const unsigned char*)bytes.data();
+    if (header[1] != kBinaryFramingVersion || header[2] != 0 ||
+        header[3] != 0) {
+      cerr << getpid() << " " << __func__
+           << " ERROR unsupported binary header version " << (int)header[1]
+           << " flags " << (int)header[3] << endl;
+      return -1;
+    }
+    *header_len = BINARY_HEADER_SIZE;
+    *msg_len = ((size_t)header[4] << 24) | ((size_t)header[5] << 16) |
+               ((size_t)header[6] << 8) | (size_t)header[7];
+    // the peer speaks the binary framing, so it is used from now on.
+    send_framing_ = VTS_SOCKET_FRAMING_BINARY;
+  } else {
+    size_t end = bytes.find_first_of("\n\r");
+    if (end == string::npos) {
+      if (bytes.size() < MAX_HEADER_BUFFER_SIZE) return 0;
+      cerr << getpid() << " " << __func__ << " ERROR header too long" << endl;
+      return -1;
+    }
+    *header_len = end + 1;
+    *msg_len = atoi(bytes.substr(0, end).c_str());
+  }
+  if (*msg_len == 0 || *msg_len > kMaxMessageLength) {
+    cerr << getpid() << " " << __func__ << " ERROR bad message length "
+         << *msg_len << endl;
+    return -1;
+  }
+  return 1;
+}
+
+int VtsDriverCommUtil::VtsSocketRecvMessageNonBlocking(
+    google::protobuf::Message* message) {
+  if (sockfd_ == -1 || recv_ring_) {
+    cerr << getpid() << " " << __func__ << " ERROR no socket to read" << endl;
+    return -1;
+  }
+  // bytes buffered by an earlier blocking receive come first.
+  if (recv_buffer_begin_ < recv_buffer_end_) {
+    pending_recv_bytes_.append(&recv_buffer_[recv_buffer_begin_],
+                               recv_buffer_end_ - recv_buffer_begin_);
+    recv_buffer_begin_ = recv_buffer_end_ = 0;
+  }
+
+  while (true) {
+    size_t header_len, msg_len;
+    int parsed = ParsePendingHeader(&header_len, &msg_len);
+    if (parsed < 0) return -1;
+    if (parsed > 0 && pending_recv_bytes_.size() >= header_len + msg_len) {
+      google::protobuf::io::CodedInputStream input(
+          reinterpret_cast<const uint8_t*>(pending_recv_bytes_.data()) +
+              header_len,
+          msg_len);
+      bool success =
+          message->ParseFromCodedStream(&input) && input.ConsumedEntireMessage();
+      pending_recv_bytes_.erase(0, header_len + msg_len);
+      if (!success) {
+        cerr << getpid() << " " << __func__ << " ERROR can't parse the message"
+             << endl;
+        return -1;
+      }
+      return 1;
+    }
+
+    ssize_t ret = recv(sockfd_, recv_buffer_, kRecvBufferSize, MSG_DONTWAIT);
+    num_read_calls_++;
+    if (ret > 0) {
+      pending_recv_bytes_.append(recv_buffer_, ret);
+      continue;
+    }
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return 0;
+    if (ret < 0) {
+      int errno_save = errno;
+      cerr << getpid() << " " << __func__ << " ERROR read failed sockfd = "
+           << sockfd_ << " errno = " << errno_save << " "
+           << strerror(errno_save) << endl;
+    }
+    return -1;
+  }
+}
+
+void NotifyDriverReady(int ready_fd) {
+  if (ready_fd < 0) return;
+  char ready = 'r';
+  while (write(ready_fd, &ready, 1) < 0 && errno == EINTR) {
+  }
+  close(ready_fd);
+}
+
+bool WaitForDriverReady(int ready_fd, int timeout_msec) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool ready = false;
+  while (true) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int elapsed_msec = (now.tv_sec - start.tv_sec) * 1000 +
+                       (now.tv_nsec - start.tv_nsec) / 1000000;
+    if (elapsed_msec > timeout_msec) {
+      cerr << __func__ << " ERROR the driver is not ready after "
+           << timeout_msec << " ms" << endl;
+      break;
+    }
+    struct pollfd pfd;
+    pfd.fd = ready_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    int ret = poll(&pfd, 1, timeout_msec - elapsed_msec);
+    if (ret < 0 && errno == EINTR) continue;
+    if (ret < 0) {
+      cerr << __func__ << " ERROR poll failed. errno = " << errno << endl;
+      break;
+    }
+    if (ret == 0) continue;
+    char buf;
+    ssize_t len = read(ready_fd, &buf, 1);
+    if (len < 0 && errno == EINTR) continue;
+    // EOF: every copy of the write end is closed without a notification.
+    if (len != 1) {
+      cerr << __func__ << " ERROR the driver exited before it was ready"
+           << endl;
+    }
+    ready = (len == 1);
+    break;
+  }
+  close(ready_fd);
+  return ready;
 }
 
 }  // namespace vts
@@ -17,9 +17,16 @@
 #ifndef __VTS_DRIVER_COMM_UTIL_H_
 #define __VTS_DRIVER_COMM_UTIL_H_
 
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
 #include <iostream>
 #include <string>
 
+#include <google/protobuf/arena.h>
+
+#include "VtsDriverCommRing.h"
 #include "test/vts/proto/VtsDriverControlMessage.pb.h"
 
 using namespace std;
@@ -27,15 +34,46 @@ using namespace std;
 namespace android {
 namespace vts {
 
+// Framing of the length header which precedes every message on a socket.
+enum VtsSocketFraming {
+  // "<decimal length>\n" header (the original VTS protocol).
+  VTS_SOCKET_FRAMING_ASCII = 0,
+  // fixed-width binary header with magic, version, flags, and length.
+  VTS_SOCKET_FRAMING_BINARY = 1,
+};
+
 class VtsDriverCommUtil {
  public:
-  VtsDriverCommUtil() : sockfd_(-1) {}
+  VtsDriverCommUtil()
+      : sockfd_(-1),
+        send_framing_(VTS_SOCKET_FRAMING_ASCII),
+        recv_buffer_begin_(0),
+        recv_buffer_end_(0),
+        pending_fd_(-1),
+        shared_memory_(NULL),
+        shared_memory_size_(0),
+        send_ring_(NULL),
+        recv_ring_(NULL),
+        num_read_calls_(0),
+        num_write_calls_(0) {}
 
-  explicit VtsDriverCommUtil(int sockfd) : sockfd_(sockfd) {}
+  explicit VtsDriverCommUtil(int sockfd)
+      : sockfd_(sockfd),
+        send_framing_(VTS_SOCKET_FRAMING_ASCII),
+        recv_buffer_begin_(0),
+        recv_buffer_end_(0),
+        pending_fd_(-1),
+        shared_memory_(NULL),
+        shared_memory_size_(0),
+        send_ring_(NULL),
+        recv_ring_(NULL),
+        num_read_calls_(0),
+        num_write_calls_(0) {}
 
   ~VtsDriverCommUtil() {
     cout << __func__ << endl;
     //    if (sockfd_ != -1) Close();
+    ReleaseSharedMemory();
   }
 
   // returns true if connection to the server is successful, false otherwise.
@@ -45,6 +83,43 @@ class VtsDriverCommUtil {
   void SetSockfd(int sockfd) {
     cout << __func__ << endl;
     sockfd_ = sockfd;
+    recv_buffer_begin_ = recv_buffer_end_ = 0;
+    pending_recv_bytes_.clear();
+  }
+
+  // Sets the framing used to send messages. A received message is accepted in
+  // either framing; receiving a binary-framed message switches the send
+  // framing to binary as the peer evidently supports it. Thus only a client
+  // which knows its peer supports binary framing needs to call this.
+  void SetSendFraming(VtsSocketFraming framing) { send_framing_ = framing; }
+
+  // Returns the framing currently used to send messages.
+  VtsSocketFraming GetSendFraming() const { return send_framing_; }
+
+  // Returns the number of received bytes which are buffered but not consumed
+  // yet (e.g., the start of a pipelined message).
+  size_t GetNumBufferedBytes() const {
+    return recv_buffer_end_ - recv_buffer_begin_;
+  }
+
+  // Moves the message traffic of this connection from the socket to a pair
+  // of shared memory rings of ring_capacity bytes (a power of 2) each, which
+  // the peer maps when it receives the offer. The socket stays open for
+  // detecting a peer which goes away. Returns false if the peer declines or
+  // the memory can't be set up, in which case the socket is still used.
+  // Must be called when no message is in flight.
+  bool StartSharedMemoryTransport(size_t ring_capacity = kDefaultRingCapacity);
+
+  // Returns true if messages go through shared memory rings.
+  bool IsSharedMemoryTransport() const { return send_ring_ != NULL; }
+
+  // Returns the number of read and write system calls made so far. Futex
+  // calls made by the shared memory rings are included.
+  uint64_t GetNumReadCalls() const {
+    return num_read_calls_ + (recv_ring_ ? recv_ring_->GetNumSyscalls() : 0);
+  }
+  uint64_t GetNumWriteCalls() const {
+    return num_write_calls_ + (send_ring_ ? send_ring_->GetNumSyscalls() : 0);
   }
 
   // closes the channel. returns 0 if success or socket already closed
@@ -62,11 +137,125 @@ class VtsDriverCommUtil {
   // Receives a protobuf message.
   bool VtsSocketRecvMessage(google::protobuf::Message* message);
 
+  // Reads the bytes available on the socket without blocking and parses the
+  // next message once it is complete. Returns 1 if *message is parsed, 0 if
+  // more bytes are needed, or -1 if the peer is gone or sent a bad message.
+  // Bytes of the following messages are kept for the next call, which must
+  // be made before waiting for the socket to become readable again. The
+  // shared memory transport is not supported.
+  int VtsSocketRecvMessageNonBlocking(google::protobuf::Message* message);
+
+  // Appends message to buffer with the header which VtsSocketSendMessage
+  // would send, so that several messages can go out in one write by
+  // VtsSocketSendFramedBytes. The framing in use when appending must still be
+  // in use when sending.
+  bool AppendFramedMessage(const google::protobuf::Message& message,
+                           string* buffer);
+
+  // Same as AppendFramedMessage for a message which is already serialized.
+  bool AppendFramedBytes(const string& message, string* buffer);
+
+  // Sends bytes which hold one or more messages built by AppendFramedMessage.
+  bool VtsSocketSendFramedBytes(const string& bytes);
+
+  // Receives a protobuf message which is allocated on the given arena (so it
+  // is owned and freed by the arena). Returns NULL on error.
+  template <typename T>
+  T* VtsSocketRecvMessage(google::protobuf::Arena* arena) {
+    T* message = google::protobuf::Arena::CreateMessage<T>(arena);
+    if (!VtsSocketRecvMessage(message)) return NULL;
+    return message;
+  }
+
  private:
+  // Writes the header of a msg_len-byte message for the current transport and
+  // framing into header (MAX_HEADER_BUFFER_SIZE bytes) and returns its length.
+  size_t BuildHeader(size_t msg_len, char* header);
+
+  // Writes all the bytes in iov to the socket or the send ring.
+  bool WriteAll(struct iovec* iov, int iov_count);
+
+  // Reads the length header of the next message in either framing.
+  bool RecvHeader(size_t* msg_len);
+
+  // Parses the header at the start of pending_recv_bytes_. Returns 1 and sets
+  // *header_len and *msg_len if it is complete, 0 if it is not, or -1 if it
+  // is malformed.
+  int ParsePendingHeader(size_t* header_len, size_t* msg_len);
+
+  // Reads exactly len bytes, using the bytes buffered by earlier reads first.
+  bool RecvExactly(char* buf, size_t len);
+
+  // Reads as many bytes as available (up to the buffer size) into the empty
+  // receive buffer. Returns false on EOF or error.
+  bool FillRecvBuffer();
+
+  // Reads up to len bytes from sockfd_. A file descriptor passed along with
+  // the bytes is kept in pending_fd_.
+  ssize_t ReadSocket(char* buf, size_t len);
+
+  // Sends a binary header with the given flags and no payload, passing fd
+  // along if it is not -1.
+  bool SendControlHeader(uint16_t flags, int fd);
+
+  // Maps the shared memory offered by the peer (pending_fd_) and replies
+  // whether it is accepted.
+  bool AcceptSharedMemoryTransport();
+
+  // Closes the rings (waking up the peer) and unmaps the shared memory.
+  void ReleaseSharedMemory();
+
+  // size of the per-connection receive buffer.
+  static const size_t kRecvBufferSize = 4096;
+
+  // default capacity of each shared memory ring.
+  static const size_t kDefaultRingCapacity = 256 * 1024;
+
   // sockfd
   int sockfd_;
+
+  // framing used by VtsSocketSendBytes.
+  VtsSocketFraming send_framing_;
+
+  // bytes read from sockfd_ but not consumed yet are in
+  // recv_buffer_[recv_buffer_begin_, recv_buffer_end_).
+  char recv_buffer_[kRecvBufferSize];
+  size_t recv_buffer_begin_;
+  size_t recv_buffer_end_;
+
+  // bytes read by VtsSocketRecvMessageNonBlocking but not consumed yet.
+  string pending_recv_bytes_;
+
+  // serialized messages are received into and sent from these buffers which
+  // are reused across messages so that their capacity is kept.
+  string recv_message_buffer_;
+  string send_message_buffer_;
+
+  // a file descriptor received from the peer and not consumed yet, or -1.
+  int pending_fd_;
+
+  // shared memory holding both rings when the shared memory transport is
+  // used (both NULL otherwise).
+  void* shared_memory_;
+  size_t shared_memory_size_;
+  VtsDriverCommRing* send_ring_;
+  VtsDriverCommRing* recv_ring_;
+
+  // system call counters.
+  uint64_t num_read_calls_;
+  uint64_t num_write_calls_;
 };
 
+// Tells the agent which launched this driver that the driver accepts
+// connections, by writing a byte to ready_fd and closing it. Does nothing if
+// ready_fd is -1 (the driver was not launched by the agent).
+extern void NotifyDriverReady(int ready_fd);
+
+// Waits up to timeout_msec until the driver holding the write end of the
+// pipe ready_fd calls NotifyDriverReady, and closes ready_fd. Returns false on
+// timeout or if the driver exits before it is ready.
+extern bool WaitForDriverReady(int ready_fd, int timeout_msec);
+
 }  // namespace vts
 }  // namespace android
 
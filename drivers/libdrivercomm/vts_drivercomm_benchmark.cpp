@@ -0,0 +1,115 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "VtsDriverCommUtil.h"
+
+/*
+ * Measures round trips of VtsSocketSendBytes / VtsSocketRecvBytes over a
+ * socketpair for both the ASCII and the binary framing.
+ *
+ * Usage: vts_drivercomm_benchmark [<round trip count>]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultRoundTrips = 100000;
+static const size_t kPayloadSizes[] = {16, 256, 4096, 65536};
+
+static double NowSeconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Echoes every received message back to the sender until EOF.
+static void EchoServer(VtsDriverCommUtil* server) {
+  while (true) {
+    string message = server->VtsSocketRecvBytes();
+    if (message.empty()) break;
+    if (!server->VtsSocketSendBytes(message)) break;
+  }
+}
+
+static bool RunBenchmark(VtsSocketFraming framing, size_t payload_size,
+                         int round_trips) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    fprintf(stderr, "socketpair failed\n");
+    return false;
+  }
+  VtsDriverCommUtil client(fds[0]);
+  VtsDriverCommUtil server(fds[1]);
+  client.SetSendFraming(framing);
+  thread server_thread(EchoServer, &server);
+
+  string payload(payload_size, 'x');
+  double start = NowSeconds();
+  for (int i = 0; i < round_trips; i++) {
+    if (!client.VtsSocketSendBytes(payload) ||
+        client.VtsSocketRecvBytes().size() != payload_size) {
+      fprintf(stderr, "round trip %d failed\n", i);
+      client.Close();
+      server_thread.join();
+      server.Close();
+      return false;
+    }
+  }
+  double elapsed = NowSeconds() - start;
+  uint64_t syscalls = client.GetNumReadCalls() + client.GetNumWriteCalls() +
+                      server.GetNumReadCalls() + server.GetNumWriteCalls();
+
+  client.Close();
+  server_thread.join();
+  server.Close();
+
+  // each round trip carries two messages.
+  double messages = 2.0 * round_trips;
+  printf("%-6s %8zu bytes %12.0f msgs/sec %8.2f syscalls/msg\n",
+         framing == VTS_SOCKET_FRAMING_BINARY ? "binary" : "ascii",
+         payload_size, messages / elapsed, syscalls / messages);
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int round_trips = argc > 1 ? atoi(argv[1]) : kDefaultRoundTrips;
+  if (round_trips <= 0) {
+    fprintf(stderr, "usage: %s [<round trip count>]\n", argv[0]);
+    return 2;
+  }
+  // the library logs every call (and the EOF at the end of each run); keep
+  // that out of the measurement.
+  cout.rdbuf(NULL);
+  cerr.rdbuf(NULL);
+
+  for (size_t payload_size : kPayloadSizes) {
+    if (!RunBenchmark(VTS_SOCKET_FRAMING_ASCII, payload_size, round_trips) ||
+        !RunBenchmark(VTS_SOCKET_FRAMING_BINARY, payload_size, round_trips)) {
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2016 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "VtsDriverCommUtil.h"
+
+/*
+ * Measures the round trip latency (p50 / p99 / p99.9) between two processes
+ * over the binary-framed socket and over the shared memory rings. A forked
+ * child plays the driver and echoes every message back.
+ *
+ * Usage: vts_drivercomm_latency_benchmark [<round trip count>]
+ */
+
+using namespace std;
+using namespace android::vts;
+
+static const int kDefaultRoundTrips = 100000;
+static const size_t kPayloadSizes[] = {16, 256, 4096, 65536, 1 << 20};
+
+static double NowNanoseconds() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Echoes every received message back to the sender until EOF.
+static void EchoServer(int sockfd) {
+  VtsDriverCommUtil server(sockfd);
+  while (true) {
+    string message = server.VtsSocketRecvBytes();
+    if (message.empty()) break;
+    if (!server.VtsSocketSendBytes(message)) break;
+  }
+  server.Close();
+}
+
+static double Percentile(const vector<double>& sorted, double percentile) {
+  size_t index = sorted.size() * percentile / 100;
+  if (index >= sorted.size()) index = sorted.size() - 1;
+  return sorted[index];
+}
+
+static bool RunBenchmark(bool shared_memory, size_t payload_size,
+                         int round_trips) {
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+    fprintf(stderr, "socketpair failed\n");
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid < 0) {
+    fprintf(stderr, "fork failed\n");
+    return false;
+  }
+  if (pid == 0) {
+    close(fds[0]);
+    EchoServer(fds[1]);
+    _exit(0);
+  }
+  close(fds[1]);
+
+  VtsDriverCommUtil client(fds[0]);
+  client.SetSendFraming(VTS_SOCKET_FRAMING_BINARY);
+  bool success = !shared_memory || client.StartSharedMemoryTransport();
+  if (!success) fprintf(stderr, "can't start the shared memory transport\n");
+
+  string payload(payload_size, 'x');
+  vector<double> latencies;
+  latencies.reserve(round_trips);
+  // the first round trips warm up the caches and the rings.
+  int warm_up = round_trips / 100;
+  for (int i = 0; success && i < warm_up + round_trips; i++) {
+    double start = NowNanoseconds();
+    if (!client.VtsSocketSendBytes(payload) ||
+        client.VtsSocketRecvBytes().size() != payload_size) {
+      fprintf(stderr, "round trip %d failed\n", i);
+      success = false;
+      break;
+    }
+    if (i >= warm_up) latencies.push_back(NowNanoseconds() - start);
+  }
+  uint64_t syscalls = client.GetNumReadCalls() + client.GetNumWriteCalls();
+  client.Close();
+  waitpid(pid, NULL, 0);
+  if (!success) return false;
+
+  sort(latencies.begin(), latencies.end());
+  printf("%-6s %8zu bytes %10.2f us p50 %10.2f us p99 %10.2f us p99.9 "
+         "%8.2f syscalls/rt\n",
+         shared_memory ? "shmem" : "socket", payload_size,
+         Percentile(latencies, 50) / 1e3, Percentile(latencies, 99) / 1e3,
+         Percentile(latencies, 99.9) / 1e3,
+         (double)syscalls / (warm_up + round_trips));
+  return true;
+}
+
+int main(int argc, char** argv) {
+  int round_trips = argc > 1 ? atoi(argv[1]) : kDefaultRoundTrips;
+  if (round_trips <= 0) {
+    fprintf(stderr, "usage: %s [<round trip count>]\n", argv[0]);
+    return 2;
+  }
+  // the library logs every call (and the EOF at the end of each run); keep
+  // that out of the measurement.
+  cout.rdbuf(NULL);
+  cerr.rdbuf(NULL);
+
+  for (size_t payload_size : kPayloadSizes) {
+    if (!RunBenchmark(false, payload_size, round_trips) ||
+        !RunBenchmark(true, payload_size, round_trips)) {
+      return 1;
+    }
+  }
+  return 0;
+}
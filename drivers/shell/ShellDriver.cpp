@@ -175,6 +175,9 @@ int VtsShellDriver::HandleShellCommandConnection(int connection_fd) {
 
     // TODO: other response code conditions
     responseMessage.set_response_code(VTS_DRIVER_RESPONSE_SUCCESS);
+    if (cmd_msg.has_request_id()) {
+      responseMessage.set_request_id(cmd_msg.request_id());
+    }
     if (!driverUtil.VtsSocketSendMessage(responseMessage)) {
       fprintf(stderr, "Driver: write output to socket error.\n");
       --numberOfFailure;
@@ -190,7 +193,7 @@ int VtsShellDriver::HandleShellCommandConnection(int connection_fd) {
   return numberOfFailure;
 }
 
-int VtsShellDriver::StartListen() {
+int VtsShellDriver::StartListen(int ready_fd) {
   if (this->socket_address_.empty()) {
     cerr << "[Driver] NULL socket address." << endl;
     return -1;
@@ -225,6 +228,7 @@ int VtsShellDriver::StartListen() {
     cerr << "Driver: listen() failed: " << strerror(errno) << endl;
     return errno;
   }
+  NotifyDriverReady(ready_fd);
 
   while (1) {
     address_length = sizeof(address);
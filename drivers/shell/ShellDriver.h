@@ -51,8 +51,9 @@ class VtsShellDriver {
   // closes the sockets.
   int Close();
 
-  // start shell driver server on unix socket
-  int StartListen();
+  // start shell driver server on unix socket. Once it listens, the driver
+  // notifies ready_fd (see NotifyDriverReady).
+  int StartListen(int ready_fd = -1);
 
  private:
   // socket address
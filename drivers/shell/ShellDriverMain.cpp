@@ -18,6 +18,7 @@
 
 #include <getopt.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string>
 
 #include "ShellDriver.h"
@@ -37,6 +38,8 @@ static void usage() {
       "    Show this message.\n"
       "--socket_path=<Unix_socket_path>\n"
       "    Show this message.\n"
+      "--ready_fd=<fd>\n"
+      "    Pipe to notify once the driver accepts connections.\n"
       "\n"
       "Recording continues until Ctrl-C is hit or the time limit is reached.\n"
       "\n");
@@ -47,9 +50,11 @@ int main(int argc, char* const argv[]) {
   static const struct option longOptions[] = {
       {"help", no_argument, NULL, 'h'},
       {"server_socket_path", required_argument, NULL, 's'},
+      {"ready_fd", required_argument, NULL, 'r'},
       {NULL, 0, NULL, 0}};
 
   string socket_path = DEFAULT_SOCKET_PATH;
+  int ready_fd = -1;
 
   while (true) {
     int optionIndex = 0;
@@ -65,6 +70,9 @@ int main(int argc, char* const argv[]) {
       case 's':
         socket_path = string(optarg);
         break;
+      case 'r':
+        ready_fd = atoi(optarg);
+        break;
       default:
         if (ic != '?') {
           fprintf(stderr, "getopt_long returned unexpected value 0x%x\n", ic);
@@ -74,5 +82,5 @@ int main(int argc, char* const argv[]) {
   }
 
   android::vts::VtsShellDriver shellDriver(socket_path.c_str());
-  return shellDriver.StartListen();
+  return shellDriver.StartListen(ready_fd);
 }
@@ -15,7 +15,7 @@ import ComponentSpecificationMessage_pb2
 DESCRIPTOR = _descriptor.FileDescriptor(
   name='AndroidSystemControlMessage.proto',
   package='android.vts',
-  serialized_pb='\n!AndroidSystemControlMessage.proto\x12\x0b\x61ndroid.vts\x1a#ComponentSpecificationMessage.proto\"\xe0\x03\n\"AndroidSystemControlCommandMessage\x12.\n\x0c\x63ommand_type\x18\x01 \x01(\x0e\x32\x18.android.vts.CommandType\x12\x0e\n\x05paths\x18\xe9\x07 \x03(\x0c\x12\x16\n\rcallback_port\x18\xcd\x08 \x01(\x05\x12\x15\n\x0cservice_name\x18\xd1\x0f \x01(\x0c\x12\x30\n\x0b\x64river_type\x18\xb9\x17 \x01(\x0e\x32\x1a.android.vts.VtsDriverType\x12\x12\n\tfile_path\x18\xba\x17 \x01(\x0c\x12\r\n\x04\x62its\x18\xbb\x17 \x01(\x05\x12\x15\n\x0ctarget_class\x18\xbc\x17 \x01(\x05\x12\x14\n\x0btarget_type\x18\xbd\x17 \x01(\x05\x12\x17\n\x0etarget_version\x18\xbe\x17 \x01(\x05\x12\x14\n\x0bmodule_name\x18\xbf\x17 \x01(\x0c\x12\x17\n\x0etarget_package\x18\xc0\x17 \x01(\x0c\x12\x1e\n\x15target_component_name\x18\xc1\x17 \x01(\x0c\x12\x1f\n\x16hw_binder_service_name\x18\xcd\x17 \x01(\x0c\x12\x0c\n\x03\x61rg\x18\xa1\x1f \x01(\x0c\x12\x1a\n\x11\x64river_caller_uid\x18\x85  \x01(\x0c\x12\x16\n\rshell_command\x18\x89\' \x03(\x0c\"\xd3\x01\n#AndroidSystemControlResponseMessage\x12\x30\n\rresponse_code\x18\x01 \x01(\x0e\x32\x19.android.vts.ResponseCode\x12\x0f\n\x06reason\x18\xe9\x07 \x01(\x0c\x12\x13\n\nfile_names\x18\xea\x07 \x03(\x0c\x12\r\n\x04spec\x18\xeb\x07 \x01(\x0c\x12\x0f\n\x06result\x18\xec\x07 \x01(\x0c\x12\x0f\n\x06stdout\x18\xd1\x0f \x03(\x0c\x12\x0f\n\x06stderr\x18\xd2\x0f \x03(\x0c\x12\x12\n\texit_code\x18\xd3\x0f \x03(\x05\"w\n#AndroidSystemCallbackRequestMessage\x12\n\n\x02id\x18\x01 \x01(\x0c\x12\x0c\n\x04name\x18\x02 \x01(\x0c\x12\x36\n\x03\x61rg\x18\x0b \x03(\x0b\x32).android.vts.VariableSpecificationMessage\"X\n$AndroidSystemCallbackResponseMessage\x12\x30\n\rresponse_code\x18\x01 \x01(\x0e\x32\x19.android.vts.ResponseCode*\xa5\x02\n\x0b\x43ommandType\x12\x18\n\x14UNKNOWN_COMMAND_TYPE\x10\x00\x12\r\n\tLIST_HALS\x10\x01\x12\x11\n\rSET_HOST_INFO\x10\x02\x12\x08\n\x04PING\x10\x03\x12\x18\n\x14\x43HECK_DRIVER_SERVICE\x10\x65\x12\x19\n\x15LAUNCH_DRIVER_SERVICE\x10\x66\x12(\n$VTS_AGENT_COMMAND_READ_SPECIFICATION\x10g\x12\x0e\n\tLIST_APIS\x10\xc9\x01\x12\r\n\x08\x43\x41LL_API\x10\xca\x01\x12$\n\x1fVTS_AGENT_COMMAND_GET_ATTRIBUTE\x10\xcb\x01\x12,\n\'VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND\x10\xad\x02*@\n\x0cResponseCode\x12\x19\n\x15UNKNOWN_RESPONSE_CODE\x10\x00\x12\x0b\n\x07SUCCESS\x10\x01\x12\x08\n\x04\x46\x41IL\x10\x02*\xfd\x01\n\rVtsDriverType\x12\x1a\n\x16UKNOWN_VTS_DRIVER_TYPE\x10\x00\x12$\n VTS_DRIVER_TYPE_HAL_CONVENTIONAL\x10\x01\x12\x1e\n\x1aVTS_DRIVER_TYPE_HAL_LEGACY\x10\x02\x12\x1c\n\x18VTS_DRIVER_TYPE_HAL_HIDL\x10\x03\x12\x31\n-VTS_DRIVER_TYPE_HAL_HIDL_WRAPPED_CONVENTIONAL\x10\x04\x12\x1e\n\x1aVTS_DRIVER_TYPE_LIB_SHARED\x10\x0b\x12\x19\n\x15VTS_DRIVER_TYPE_SHELL\x10\x15')
+  serialized_pb='\n!AndroidSystemControlMessage.proto\x12\x0b\x61ndroid.vts\x1a#ComponentSpecificationMessage.proto\"\x94\x05\n\"AndroidSystemControlCommandMessage\x12.\n\x0c\x63ommand_type\x18\x01 \x01(\x0e\x32\x18.android.vts.CommandType\x12\x0e\n\x05paths\x18\xe9\x07 \x03(\x0c\x12\x16\n\rcallback_port\x18\xcd\x08 \x01(\x05\x12\x15\n\x0cservice_name\x18\xd1\x0f \x01(\x0c\x12\x30\n\x0b\x64river_type\x18\xb9\x17 \x01(\x0e\x32\x1a.android.vts.VtsDriverType\x12\x12\n\tfile_path\x18\xba\x17 \x01(\x0c\x12\r\n\x04\x62its\x18\xbb\x17 \x01(\x05\x12\x15\n\x0ctarget_class\x18\xbc\x17 \x01(\x05\x12\x14\n\x0btarget_type\x18\xbd\x17 \x01(\x05\x12\x17\n\x0etarget_version\x18\xbe\x17 \x01(\x05\x12\x14\n\x0bmodule_name\x18\xbf\x17 \x01(\x0c\x12\x17\n\x0etarget_package\x18\xc0\x17 \x01(\x0c\x12\x1e\n\x15target_component_name\x18\xc1\x17 \x01(\x0c\x12\x1f\n\x16hw_binder_service_name\x18\xcd\x17 \x01(\x0c\x12\x37\n\x10\x64river_transport\x18\xce\x17 \x01(\x0e\x32\x1c.android.vts.DriverTransport\x12\x0c\n\x03\x61rg\x18\xa1\x1f \x01(\x0c\x12\x12\n\tbatch_arg\x18\xa2\x1f \x03(\x0c\x12\x1a\n\x11\x63ontinue_on_error\x18\xa3\x1f \x01(\x08\x12\x33\n\x0epayload_format\x18\xa4\x1f \x01(\x0e\x32\x1a.android.vts.PayloadFormat\x12\x14\n\x0bstatus_type\x18\xa5\x1f \x01(\x05\x12\x1a\n\x11\x64river_caller_uid\x18\x85  \x01(\x0c\x12\x16\n\rshell_command\x18\x89\' \x03(\x0c\"\xef\x02\n#AndroidSystemControlResponseMessage\x12\x30\n\rresponse_code\x18\x01 \x01(\x0e\x32\x19.android.vts.ResponseCode\x12\x0f\n\x06reason\x18\xe9\x07 \x01(\x0c\x12\x13\n\nfile_names\x18\xea\x07 \x03(\x0c\x12\r\n\x04spec\x18\xeb\x07 \x01(\x0c\x12\x0f\n\x06result\x18\xec\x07 \x01(\x0c\x12\x15\n\x0c\x62\x61tch_result\x18\xed\x07 \x03(\x0c\x12\x37\n\x13\x62\x61tch_response_code\x18\xee\x07 \x03(\x0e\x32\x19.android.vts.ResponseCode\x12\x33\n\x0epayload_format\x18\xef\x07 \x01(\x0e\x32\x1a.android.vts.PayloadFormat\x12\x15\n\x0cstatus_value\x18\xf0\x07 \x01(\x05\x12\x0f\n\x06stdout\x18\xd1\x0f \x03(\x0c\x12\x0f\n\x06stderr\x18\xd2\x0f \x03(\x0c\x12\x12\n\texit_code\x18\xd3\x0f \x03(\x05\"w\n#AndroidSystemCallbackRequestMessage\x12\n\n\x02id\x18\x01 \x01(\x0c\x12\x0c\n\x04name\x18\x02 \x01(\x0c\x12\x36\n\x03\x61rg\x18\x0b \x03(\x0b\x32).android.vts.VariableSpecificationMessage\"X\n$AndroidSystemCallbackResponseMessage\x12\x30\n\rresponse_code\x18\x01 \x01(\x0e\x32\x19.android.vts.ResponseCode*\xdd\x02\n\x0b\x43ommandType\x12\x18\n\x14UNKNOWN_COMMAND_TYPE\x10\x00\x12\r\n\tLIST_HALS\x10\x01\x12\x11\n\rSET_HOST_INFO\x10\x02\x12\x08\n\x04PING\x10\x03\x12\x18\n\x14\x43HECK_DRIVER_SERVICE\x10\x65\x12\x19\n\x15LAUNCH_DRIVER_SERVICE\x10\x66\x12(\n$VTS_AGENT_COMMAND_READ_SPECIFICATION\x10g\x12\x0e\n\tLIST_APIS\x10\xc9\x01\x12\r\n\x08\x43\x41LL_API\x10\xca\x01\x12$\n\x1fVTS_AGENT_COMMAND_GET_ATTRIBUTE\x10\xcb\x01\x12\x13\n\x0e\x43\x41LL_API_BATCH\x10\xcc\x01\x12!\n\x1cVTS_AGENT_COMMAND_GET_STATUS\x10\xcd\x01\x12,\n\'VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND\x10\xad\x02*@\n\x0cResponseCode\x12\x19\n\x15UNKNOWN_RESPONSE_CODE\x10\x00\x12\x0b\n\x07SUCCESS\x10\x01\x12\x08\n\x04\x46\x41IL\x10\x02*C\n\rPayloadFormat\x12\x17\n\x13PAYLOAD_FORMAT_TEXT\x10\x00\x12\x19\n\x15PAYLOAD_FORMAT_BINARY\x10\x01*R\n\x0f\x44riverTransport\x12\x1b\n\x17\x44RIVER_TRANSPORT_SOCKET\x10\x00\x12\"\n\x1e\x44RIVER_TRANSPORT_SHARED_MEMORY\x10\x01*\xfd\x01\n\rVtsDriverType\x12\x1a\n\x16UKNOWN_VTS_DRIVER_TYPE\x10\x00\x12$\n VTS_DRIVER_TYPE_HAL_CONVENTIONAL\x10\x01\x12\x1e\n\x1aVTS_DRIVER_TYPE_HAL_LEGACY\x10\x02\x12\x1c\n\x18VTS_DRIVER_TYPE_HAL_HIDL\x10\x03\x12\x31\n-VTS_DRIVER_TYPE_HAL_HIDL_WRAPPED_CONVENTIONAL\x10\x04\x12\x1e\n\x1aVTS_DRIVER_TYPE_LIB_SHARED\x10\x0b\x12\x19\n\x15VTS_DRIVER_TYPE_SHELL\x10\x15')
 
 _COMMANDTYPE = _descriptor.EnumDescriptor(
   name='CommandType',
@@ -64,14 +64,22 @@ _COMMANDTYPE = _descriptor.EnumDescriptor(
       options=None,
       type=None),
     _descriptor.EnumValueDescriptor(
-      name='VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND', index=10, number=301,
+      name='CALL_API_BATCH', index=10, number=204,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='VTS_AGENT_COMMAND_GET_STATUS', index=11, number=205,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND', index=12, number=301,
       options=None,
       type=None),
   ],
   containing_type=None,
   options=None,
-  serialized_start=996,
-  serialized_end=1289,
+  serialized_start=1332,
+  serialized_end=1681,
 )
 
 CommandType = enum_type_wrapper.EnumTypeWrapper(_COMMANDTYPE)
@@ -96,11 +104,55 @@ _RESPONSECODE = _descriptor.EnumDescriptor(
   ],
   containing_type=None,
   options=None,
-  serialized_start=1291,
-  serialized_end=1355,
+  serialized_start=1683,
+  serialized_end=1747,
 )
 
 ResponseCode = enum_type_wrapper.EnumTypeWrapper(_RESPONSECODE)
+_PAYLOADFORMAT = _descriptor.EnumDescriptor(
+  name='PayloadFormat',
+  full_name='android.vts.PayloadFormat',
+  filename=None,
+  file=DESCRIPTOR,
+  values=[
+    _descriptor.EnumValueDescriptor(
+      name='PAYLOAD_FORMAT_TEXT', index=0, number=0,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='PAYLOAD_FORMAT_BINARY', index=1, number=1,
+      options=None,
+      type=None),
+  ],
+  containing_type=None,
+  options=None,
+  serialized_start=1749,
+  serialized_end=1816,
+)
+
+PayloadFormat = enum_type_wrapper.EnumTypeWrapper(_PAYLOADFORMAT)
+_DRIVERTRANSPORT = _descriptor.EnumDescriptor(
+  name='DriverTransport',
+  full_name='android.vts.DriverTransport',
+  filename=None,
+  file=DESCRIPTOR,
+  values=[
+    _descriptor.EnumValueDescriptor(
+      name='DRIVER_TRANSPORT_SOCKET', index=0, number=0,
+      options=None,
+      type=None),
+    _descriptor.EnumValueDescriptor(
+      name='DRIVER_TRANSPORT_SHARED_MEMORY', index=1, number=1,
+      options=None,
+      type=None),
+  ],
+  containing_type=None,
+  options=None,
+  serialized_start=1818,
+  serialized_end=1900,
+)
+
+DriverTransport = enum_type_wrapper.EnumTypeWrapper(_DRIVERTRANSPORT)
 _VTSDRIVERTYPE = _descriptor.EnumDescriptor(
   name='VtsDriverType',
   full_name='android.vts.VtsDriverType',
@@ -138,8 +190,8 @@ _VTSDRIVERTYPE = _descriptor.EnumDescriptor(
   ],
   containing_type=None,
   options=None,
-  serialized_start=1358,
-  serialized_end=1611,
+  serialized_start=1903,
+  serialized_end=2156,
 )
 
 VtsDriverType = enum_type_wrapper.EnumTypeWrapper(_VTSDRIVERTYPE)
@@ -153,10 +205,16 @@ VTS_AGENT_COMMAND_READ_SPECIFICATION = 103
 LIST_APIS = 201
 CALL_API = 202
 VTS_AGENT_COMMAND_GET_ATTRIBUTE = 203
+CALL_API_BATCH = 204
+VTS_AGENT_COMMAND_GET_STATUS = 205
 VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND = 301
 UNKNOWN_RESPONSE_CODE = 0
 SUCCESS = 1
 FAIL = 2
+PAYLOAD_FORMAT_TEXT = 0
+PAYLOAD_FORMAT_BINARY = 1
+DRIVER_TRANSPORT_SOCKET = 0
+DRIVER_TRANSPORT_SHARED_MEMORY = 1
 UKNOWN_VTS_DRIVER_TYPE = 0
 VTS_DRIVER_TYPE_HAL_CONVENTIONAL = 1
 VTS_DRIVER_TYPE_HAL_LEGACY = 2
@@ -273,21 +331,56 @@ _ANDROIDSYSTEMCONTROLCOMMANDMESSAGE = _descriptor.Descriptor(
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='arg', full_name='android.vts.AndroidSystemControlCommandMessage.arg', index=14,
+      name='driver_transport', full_name='android.vts.AndroidSystemControlCommandMessage.driver_transport', index=14,
+      number=3022, type=14, cpp_type=8, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='arg', full_name='android.vts.AndroidSystemControlCommandMessage.arg', index=15,
       number=4001, type=12, cpp_type=9, label=1,
       has_default_value=False, default_value="",
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='driver_caller_uid', full_name='android.vts.AndroidSystemControlCommandMessage.driver_caller_uid', index=15,
+      name='batch_arg', full_name='android.vts.AndroidSystemControlCommandMessage.batch_arg', index=16,
+      number=4002, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='continue_on_error', full_name='android.vts.AndroidSystemControlCommandMessage.continue_on_error', index=17,
+      number=4003, type=8, cpp_type=7, label=1,
+      has_default_value=False, default_value=False,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='payload_format', full_name='android.vts.AndroidSystemControlCommandMessage.payload_format', index=18,
+      number=4004, type=14, cpp_type=8, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='status_type', full_name='android.vts.AndroidSystemControlCommandMessage.status_type', index=19,
+      number=4005, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='driver_caller_uid', full_name='android.vts.AndroidSystemControlCommandMessage.driver_caller_uid', index=20,
       number=4101, type=12, cpp_type=9, label=1,
       has_default_value=False, default_value="",
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='shell_command', full_name='android.vts.AndroidSystemControlCommandMessage.shell_command', index=16,
+      name='shell_command', full_name='android.vts.AndroidSystemControlCommandMessage.shell_command', index=21,
       number=5001, type=12, cpp_type=9, label=3,
       has_default_value=False, default_value=[],
       message_type=None, enum_type=None, containing_type=None,
@@ -303,7 +396,7 @@ _ANDROIDSYSTEMCONTROLCOMMANDMESSAGE = _descriptor.Descriptor(
   is_extendable=False,
   extension_ranges=[],
   serialized_start=88,
-  serialized_end=568,
+  serialized_end=748,
 )
 
 
@@ -350,21 +443,49 @@ _ANDROIDSYSTEMCONTROLRESPONSEMESSAGE = _descriptor.Descriptor(
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='stdout', full_name='android.vts.AndroidSystemControlResponseMessage.stdout', index=5,
+      name='batch_result', full_name='android.vts.AndroidSystemControlResponseMessage.batch_result', index=5,
+      number=1005, type=12, cpp_type=9, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='batch_response_code', full_name='android.vts.AndroidSystemControlResponseMessage.batch_response_code', index=6,
+      number=1006, type=14, cpp_type=8, label=3,
+      has_default_value=False, default_value=[],
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='payload_format', full_name='android.vts.AndroidSystemControlResponseMessage.payload_format', index=7,
+      number=1007, type=14, cpp_type=8, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='status_value', full_name='android.vts.AndroidSystemControlResponseMessage.status_value', index=8,
+      number=1008, type=5, cpp_type=1, label=1,
+      has_default_value=False, default_value=0,
+      message_type=None, enum_type=None, containing_type=None,
+      is_extension=False, extension_scope=None,
+      options=None),
+    _descriptor.FieldDescriptor(
+      name='stdout', full_name='android.vts.AndroidSystemControlResponseMessage.stdout', index=9,
       number=2001, type=12, cpp_type=9, label=3,
       has_default_value=False, default_value=[],
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='stderr', full_name='android.vts.AndroidSystemControlResponseMessage.stderr', index=6,
+      name='stderr', full_name='android.vts.AndroidSystemControlResponseMessage.stderr', index=10,
       number=2002, type=12, cpp_type=9, label=3,
       has_default_value=False, default_value=[],
       message_type=None, enum_type=None, containing_type=None,
       is_extension=False, extension_scope=None,
       options=None),
     _descriptor.FieldDescriptor(
-      name='exit_code', full_name='android.vts.AndroidSystemControlResponseMessage.exit_code', index=7,
+      name='exit_code', full_name='android.vts.AndroidSystemControlResponseMessage.exit_code', index=11,
       number=2003, type=5, cpp_type=1, label=3,
       has_default_value=False, default_value=[],
       message_type=None, enum_type=None, containing_type=None,
@@ -379,8 +500,8 @@ _ANDROIDSYSTEMCONTROLRESPONSEMESSAGE = _descriptor.Descriptor(
   options=None,
   is_extendable=False,
   extension_ranges=[],
-  serialized_start=571,
-  serialized_end=782,
+  serialized_start=751,
+  serialized_end=1118,
 )
 
 
@@ -421,8 +542,8 @@ _ANDROIDSYSTEMCALLBACKREQUESTMESSAGE = _descriptor.Descriptor(
   options=None,
   is_extendable=False,
   extension_ranges=[],
-  serialized_start=784,
-  serialized_end=903,
+  serialized_start=1120,
+  serialized_end=1239,
 )
 
 
@@ -449,13 +570,17 @@ _ANDROIDSYSTEMCALLBACKRESPONSEMESSAGE = _descriptor.Descriptor(
   options=None,
   is_extendable=False,
   extension_ranges=[],
-  serialized_start=905,
-  serialized_end=993,
+  serialized_start=1241,
+  serialized_end=1329,
 )
 
 _ANDROIDSYSTEMCONTROLCOMMANDMESSAGE.fields_by_name['command_type'].enum_type = _COMMANDTYPE
 _ANDROIDSYSTEMCONTROLCOMMANDMESSAGE.fields_by_name['driver_type'].enum_type = _VTSDRIVERTYPE
+_ANDROIDSYSTEMCONTROLCOMMANDMESSAGE.fields_by_name['driver_transport'].enum_type = _DRIVERTRANSPORT
+_ANDROIDSYSTEMCONTROLCOMMANDMESSAGE.fields_by_name['payload_format'].enum_type = _PAYLOADFORMAT
 _ANDROIDSYSTEMCONTROLRESPONSEMESSAGE.fields_by_name['response_code'].enum_type = _RESPONSECODE
+_ANDROIDSYSTEMCONTROLRESPONSEMESSAGE.fields_by_name['batch_response_code'].enum_type = _RESPONSECODE
+_ANDROIDSYSTEMCONTROLRESPONSEMESSAGE.fields_by_name['payload_format'].enum_type = _PAYLOADFORMAT
 _ANDROIDSYSTEMCALLBACKREQUESTMESSAGE.fields_by_name['arg'].message_type = ComponentSpecificationMessage_pb2._VARIABLESPECIFICATIONMESSAGE
 _ANDROIDSYSTEMCALLBACKRESPONSEMESSAGE.fields_by_name['response_code'].enum_type = _RESPONSECODE
 DESCRIPTOR.message_types_by_name['AndroidSystemControlCommandMessage'] = _ANDROIDSYSTEMCONTROLCOMMANDMESSAGE
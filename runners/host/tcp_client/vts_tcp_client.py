@@ -27,6 +27,7 @@ from vts.runners.host import const
 from vts.runners.host import errors
 from vts.utils.python.mirror import mirror_object
 
+from google.protobuf import message as protobuf_message
 from google.protobuf import text_format
 
 TARGET_IP = os.environ.get("TARGET_IP", None)
@@ -42,6 +43,8 @@ COMMAND_TYPE_NAME = {1: "LIST_HALS",
                      201: "LIST_APIS",
                      202: "CALL_API",
                      203: "VTS_AGENT_COMMAND_GET_ATTRIBUTE",
+                     204: "CALL_API_BATCH",
+                     205: "VTS_AGENT_COMMAND_GET_STATUS",
                      301: "VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND"}
 
 
@@ -52,12 +55,21 @@ class VtsTcpClient(object):
         connection: a TCP socket instance.
         channel: a file to write and read data.
         _mode: the connection mode (adb_forwarding or ssh_tunnel)
+        _payload_format: SysMsg_pb2.PayloadFormat, the encoding of the
+                         FunctionSpecificationMessage payloads of API calls.
+                         Text until the agent advertises the binary format
+                         for the launched or checked driver.
+        _preferred_payload_format: SysMsg_pb2.PayloadFormat, the encoding
+                                   used once the agent advertises it.
     """
 
-    def __init__(self, mode="adb_forwarding"):
+    def __init__(self, mode="adb_forwarding",
+                 payload_format=SysMsg_pb2.PAYLOAD_FORMAT_BINARY):
         self.connection = None
         self.channel = None
         self._mode = mode
+        self._payload_format = SysMsg_pb2.PAYLOAD_FORMAT_TEXT
+        self._preferred_payload_format = payload_format
 
     def Connect(self, ip=TARGET_IP, command_port=TARGET_PORT,
                 callback_port=None, retry=_SOCKET_CONN_RETRY_NUMBER):
@@ -129,14 +141,43 @@ class VtsTcpClient(object):
         self.SendCommand(SysMsg_pb2.CHECK_DRIVER_SERVICE,
                          service_name=service_name)
         resp = self.RecvResponse()
-        return (resp.response_code == SysMsg_pb2.SUCCESS)
+        if resp.response_code != SysMsg_pb2.SUCCESS:
+            return False
+        self._NegotiatePayloadFormat(resp)
+        return True
+
+    def _NegotiatePayloadFormat(self, resp):
+        """Picks the payload format for the driver of a session.
+
+        The binary format is used only if it is preferred and the agent
+        advertises it in the LAUNCH_DRIVER_SERVICE or CHECK_DRIVER_SERVICE
+        response. An older agent leaves payload_format unset and only takes
+        text payloads.
+
+        Args:
+            resp: AndroidSystemControlResponseMessage, a successful response.
+        """
+        if (self._preferred_payload_format == SysMsg_pb2.PAYLOAD_FORMAT_BINARY
+                and resp.HasField("payload_format")
+                and resp.payload_format == SysMsg_pb2.PAYLOAD_FORMAT_BINARY):
+            self._payload_format = SysMsg_pb2.PAYLOAD_FORMAT_BINARY
+        else:
+            self._payload_format = SysMsg_pb2.PAYLOAD_FORMAT_TEXT
+        logging.info("payload format: %s", self._payload_format)
 
     def LaunchDriverService(self, driver_type, service_name, bits,
                             file_path=None, target_class=None, target_type=None,
                             target_version=None, target_package=None,
                             target_component_name=None,
-                            hw_binder_service_name=None):
-        """RPC to LAUNCH_DRIVER_SERVICE."""
+                            hw_binder_service_name=None,
+                            driver_transport=None):
+        """RPC to LAUNCH_DRIVER_SERVICE.
+
+        driver_transport is a DriverTransport value. With
+        DRIVER_TRANSPORT_SHARED_MEMORY, the agent and the driver exchange
+        calls through shared memory rings instead of a socket if both sides
+        support it.
+        """
         logging.info("service_name: %s", service_name)
         logging.info("file_path: %s", file_path)
         logging.info("bits: %s", bits)
@@ -151,10 +192,14 @@ class VtsTcpClient(object):
                          target_version=target_version,
                          target_package=target_package,
                          target_component_name=target_component_name,
-                         hw_binder_service_name=hw_binder_service_name)
+                         hw_binder_service_name=hw_binder_service_name,
+                         driver_transport=driver_transport)
         resp = self.RecvResponse()
         logging.info("resp for LAUNCH_DRIVER_SERVICE: %s", resp)
-        return (resp.response_code == SysMsg_pb2.SUCCESS)
+        if resp.response_code != SysMsg_pb2.SUCCESS:
+            return False
+        self._NegotiatePayloadFormat(resp)
+        return True
 
     def ListApis(self):
         """RPC to LIST_APIS."""
@@ -230,67 +275,177 @@ class VtsTcpClient(object):
         raise errors.VtsUnsupportedTypeError(
             "unsupported type %s" % var_spec_msg.type)
 
+    def _EncodePayloads(self, args):
+        """Encodes the FunctionSpecificationMessage args of an API call.
+
+        Messages are encoded in self._payload_format. Strings are taken as
+        messages already in the text format, in which case all args are sent
+        in the text format.
+
+        Args:
+            args: list of FunctionSpecificationMessages or strings.
+
+        Returns:
+            a tuple of the list of encoded args and their
+            SysMsg_pb2.PayloadFormat.
+        """
+        payload_format = self._payload_format
+        if any(isinstance(arg, basestring) for arg in args):
+            payload_format = SysMsg_pb2.PAYLOAD_FORMAT_TEXT
+        encoded_args = []
+        for arg in args:
+            if isinstance(arg, basestring):
+                encoded_args.append(arg)
+            elif payload_format == SysMsg_pb2.PAYLOAD_FORMAT_BINARY:
+                encoded_args.append(arg.SerializeToString())
+            else:
+                encoded_args.append(text_format.MessageToString(arg))
+        return encoded_args, payload_format
+
     def CallApi(self, arg, caller_uid=None):
-        """RPC to CALL_API."""
-        self.SendCommand(SysMsg_pb2.CALL_API, arg=arg, caller_uid=caller_uid)
+        """RPC to CALL_API.
+
+        Args:
+            arg: FunctionSpecificationMessage of the call, or the message in
+                 the text format.
+            caller_uid: string, UID of a caller on the driver-side.
+        """
+        encoded_args, payload_format = self._EncodePayloads([arg])
+        self.SendCommand(SysMsg_pb2.CALL_API, arg=encoded_args[0],
+                         caller_uid=caller_uid, payload_format=payload_format)
         resp = self.RecvResponse()
         resp_code = resp.response_code
         if (resp_code == SysMsg_pb2.SUCCESS):
-            result = CompSpecMsg_pb2.FunctionSpecificationMessage()
-            if resp.result == "error":
-                raise errors.VtsTcpCommunicationError(
-                    "API call error by the VTS driver.")
-            try:
-                text_format.Merge(resp.result, result)
-            except text_format.ParseError as e:
-                logging.exception(e)
-                logging.error("Paring error\n%s", resp.result)
-            if result.return_type.type == CompSpecMsg_pb2.TYPE_SUBMODULE:
-                logging.info("returned a submodule spec")
-                logging.info("spec: %s", result.return_type_submodule_spec)
-                return mirror_object.MirrorObject(
-                     self, result.return_type_submodule_spec, None)
-
-            logging.info("result: %s", result.return_type_hidl)
-            if len(result.return_type_hidl) == 1:
-                result_value = self.GetPythonDataOfVariableSpecMsg(
-                    result.return_type_hidl[0])
-            elif len(result.return_type_hidl) > 1:
-                result_value = []
-                for return_type_hidl in result.return_type_hidl:
-                    result_value.append(self.GetPythonDataOfVariableSpecMsg(
-                        return_type_hidl))
-            else:  # For non-HIDL return value
-                if hasattr(result, "return_type"):
-                    result_value = result
-                else:
-                    result_value = None
-
-            if hasattr(result, "raw_coverage_data"):
-                return result_value, {"coverage": result.raw_coverage_data}
-            else:
-                return result_value
+            return self._GetCallApiResult(resp.result, resp.payload_format)
 
         logging.error("NOTICE - Likely a crash discovery!")
         logging.error("SysMsg_pb2.SUCCESS is %s", SysMsg_pb2.SUCCESS)
         raise errors.VtsTcpCommunicationError(
             "RPC Error, response code for %s is %s" % (arg, resp_code))
 
+    def CallApiBatch(self, args, caller_uid=None, continue_on_error=False):
+        """RPC to CALL_API_BATCH.
+
+        The calls are made back-to-back by the driver and answered with one
+        response.
+
+        Args:
+            args: list, each the arg of a CALL_API (see CallApi).
+            caller_uid: string, UID of a caller on the driver-side.
+            continue_on_error: boolean, whether to make the rest of the calls
+                               after a failed one.
+
+        Returns:
+            a list with the result of each call made (see CallApi), in the
+            order of args. The result of a failed call is None.
+
+        Raises:
+            VtsTcpCommunicationError if the batch is not answered, or a call
+            fails and continue_on_error is False.
+        """
+        encoded_args, payload_format = self._EncodePayloads(args)
+        self.SendCommand(SysMsg_pb2.CALL_API_BATCH, batch_arg=encoded_args,
+                         caller_uid=caller_uid,
+                         continue_on_error=continue_on_error,
+                         payload_format=payload_format)
+        resp = self.RecvResponse()
+        if resp is None or (resp.response_code != SysMsg_pb2.SUCCESS and
+                            not continue_on_error):
+            logging.error("NOTICE - Likely a crash discovery!")
+            raise errors.VtsTcpCommunicationError(
+                "RPC Error, response code for the batch is %s" %
+                (resp.response_code if resp else None))
+
+        results = []
+        for result, resp_code in zip(resp.batch_result,
+                                     resp.batch_response_code):
+            if resp_code == SysMsg_pb2.SUCCESS:
+                results.append(self._GetCallApiResult(
+                    result, resp.payload_format))
+            else:
+                results.append(None)
+        return results
+
+    def _DecodePayload(self, payload, payload_format):
+        """Decodes a FunctionSpecificationMessage returned by the agent.
+
+        Args:
+            payload: string, the encoded message.
+            payload_format: SysMsg_pb2.PayloadFormat of payload.
+
+        Returns:
+            FunctionSpecificationMessage
+        """
+        result = CompSpecMsg_pb2.FunctionSpecificationMessage()
+        if payload == "error":
+            raise errors.VtsTcpCommunicationError(
+                "API call error by the VTS driver.")
+        try:
+            if payload_format == SysMsg_pb2.PAYLOAD_FORMAT_BINARY:
+                result.ParseFromString(payload)
+            else:
+                text_format.Merge(payload, result)
+        except (text_format.ParseError, protobuf_message.DecodeError) as e:
+            logging.exception(e)
+            logging.error("Paring error\n%s", payload)
+        return result
+
+    def _GetCallApiResult(self, payload, payload_format):
+        """Converts the result of a CALL_API to its python value.
+
+        Args:
+            payload: string, the encoded FunctionSpecificationMessage.
+            payload_format: SysMsg_pb2.PayloadFormat of payload.
+
+        Returns:
+            the return value of the call, and the coverage data if the result
+            has it.
+        """
+        result = self._DecodePayload(payload, payload_format)
+        if result.return_type.type == CompSpecMsg_pb2.TYPE_SUBMODULE:
+            logging.info("returned a submodule spec")
+            logging.info("spec: %s", result.return_type_submodule_spec)
+            return mirror_object.MirrorObject(
+                 self, result.return_type_submodule_spec, None)
+
+        logging.info("result: %s", result.return_type_hidl)
+        if len(result.return_type_hidl) == 1:
+            result_value = self.GetPythonDataOfVariableSpecMsg(
+                result.return_type_hidl[0])
+        elif len(result.return_type_hidl) > 1:
+            result_value = []
+            for return_type_hidl in result.return_type_hidl:
+                result_value.append(self.GetPythonDataOfVariableSpecMsg(
+                    return_type_hidl))
+        else:  # For non-HIDL return value
+            if hasattr(result, "return_type"):
+                result_value = result
+            else:
+                result_value = None
+
+        if hasattr(result, "raw_coverage_data"):
+            return result_value, {"coverage": result.raw_coverage_data,
+                                  "coverage_delta": result.coverage_delta}
+        else:
+            return result_value
+
     def GetAttribute(self, arg):
-        """RPC to VTS_AGENT_COMMAND_GET_ATTRIBUTE."""
-        self.SendCommand(SysMsg_pb2.VTS_AGENT_COMMAND_GET_ATTRIBUTE, arg=arg)
+        """RPC to VTS_AGENT_COMMAND_GET_ATTRIBUTE.
+
+        Args:
+            arg: FunctionSpecificationMessage of the attribute, or the message
+                 in the text format.
+        """
+        encoded_args, payload_format = self._EncodePayloads([arg])
+        self.SendCommand(SysMsg_pb2.VTS_AGENT_COMMAND_GET_ATTRIBUTE,
+                         arg=encoded_args[0], payload_format=payload_format)
         resp = self.RecvResponse()
         resp_code = resp.response_code
         if (resp_code == SysMsg_pb2.SUCCESS):
-            result = CompSpecMsg_pb2.FunctionSpecificationMessage()
             if resp.result == "error":
                 raise errors.VtsTcpCommunicationError(
                     "Get attribute request failed on target.")
-            try:
-                text_format.Merge(resp.result, result)
-            except text_format.ParseError as e:
-                logging.exception(e)
-                logging.error("Paring error\n%s", resp.result)
+            result = self._DecodePayload(resp.result, resp.payload_format)
             if result.return_type.type == CompSpecMsg_pb2.TYPE_SUBMODULE:
                 logging.info("returned a submodule spec")
                 logging.info("spec: %s", result.return_type_submodule_spec)
@@ -306,6 +461,26 @@ class VtsTcpClient(object):
         raise errors.VtsTcpCommunicationError(
             "RPC Error, response code for %s is %s" % (arg, resp_code))
 
+    def GetStatus(self, status_type):
+        """RPC to VTS_AGENT_COMMAND_GET_STATUS.
+
+        Args:
+            status_type: integer, the VtsDriverStatusType of the counter to
+                         read (e.g., 5 for the FuzzerBase cache hits).
+
+        Returns:
+            the value of the counter, and the metrics which come with it
+            (e.g., of each call queue) or an empty string.
+        """
+        self.SendCommand(SysMsg_pb2.VTS_AGENT_COMMAND_GET_STATUS,
+                         status_type=status_type)
+        resp = self.RecvResponse()
+        if not resp or resp.response_code != SysMsg_pb2.SUCCESS:
+            raise errors.VtsTcpCommunicationError(
+                "RPC Error, response for status type %s is %s" %
+                (status_type, resp))
+        return resp.status_value, resp.result
+
     def ExecuteShellCommand(self, command):
         """RPC to VTS_AGENT_COMMAND_EXECUTE_SHELL_COMMAND."""
         self.SendCommand(
@@ -402,13 +577,18 @@ class VtsTcpClient(object):
                     target_package=None,
                     target_component_name=None,
                     hw_binder_service_name=None,
+                    driver_transport=None,
                     module_name=None,
                     service_name=None,
                     callback_port=None,
                     driver_type=None,
                     shell_command=None,
                     caller_uid=None,
-                    arg=None):
+                    arg=None,
+                    batch_arg=None,
+                    continue_on_error=None,
+                    payload_format=None,
+                    status_type=None):
         """Sends a command.
 
         Args:
@@ -424,7 +604,7 @@ class VtsTcpClient(object):
         command_msg.command_type = command_type
         logging.info("sending a command (type %s)",
                      COMMAND_TYPE_NAME[command_type])
-        if command_type == 202:
+        if command_type == 202 and payload_format != SysMsg_pb2.PAYLOAD_FORMAT_BINARY:
             logging.info("target API: %s", arg)
 
         if target_class is not None:
@@ -445,6 +625,9 @@ class VtsTcpClient(object):
         if hw_binder_service_name is not None:
             command_msg.hw_binder_service_name = hw_binder_service_name
 
+        if driver_transport is not None:
+            command_msg.driver_transport = driver_transport
+
         if module_name is not None:
             command_msg.module_name = module_name
 
@@ -472,6 +655,18 @@ class VtsTcpClient(object):
         if arg is not None:
             command_msg.arg = arg
 
+        if batch_arg is not None:
+            command_msg.batch_arg.extend(batch_arg)
+
+        if continue_on_error is not None:
+            command_msg.continue_on_error = continue_on_error
+
+        if payload_format is not None:
+            command_msg.payload_format = payload_format
+
+        if status_type is not None:
+            command_msg.status_type = status_type
+
         if shell_command is not None:
             if isinstance(shell_command, types.ListType):
                 command_msg.shell_command.extend(shell_command)
@@ -40,19 +40,31 @@ class CallbackRequestHandler(socketserver.StreamRequestHandler):
         When a callback happens on the target side, a request message is posted
         to the host side and is handled here. The message is parsed and the
         appropriate callback function on the host side is called.
+
+        The agent keeps one connection open and sends all callback requests
+        through it, often several in one write, so requests are handled until
+        the connection is closed.
+        """
+        while self.HandleOneRequest():
+            pass
+
+    def HandleOneRequest(self):
+        """Handles one request.
+
+        Returns:
+            False if the connection is closed, True otherwise.
         """
         header = self.rfile.readline().strip()
+        if not header:
+            # the agent closed the connection.
+            return False
         try:
             len = int(header)
         except ValueError:
-            if header:
-                logging.exception("Unable to convert '%s' into an integer, which "
-                                  "is required for reading the next message." %
-                                  header)
-                raise
-            else:
-                logging.error('CallbackRequestHandler received empty message header. Skipping...')
-                return
+            logging.exception("Unable to convert '%s' into an integer, which "
+                              "is required for reading the next message." %
+                              header)
+            raise
         # Read the request message.
         received_data = self.rfile.read(len)
         logging.debug("Received callback message: %s", received_data)
@@ -78,6 +90,7 @@ class CallbackRequestHandler(socketserver.StreamRequestHandler):
         message = response_message.SerializeToString()
         # self.request is the TCP socket connected to the client
         self.request.sendall(message)
+        return True
 
 
 class CallbackServer(object):
@@ -142,8 +155,11 @@ class CallbackServer(object):
             CallbackServerError is raised if the server fails to start.
         """
         try:
-            self._server = socketserver.TCPServer(
+            # a connection stays open for as long as the agent runs, so each
+            # one needs its own thread.
+            self._server = socketserver.ThreadingTCPServer(
                 (self._hostname, port), CallbackRequestHandler)
+            self._server.daemon_threads = True
             self._ip, self._port = self._server.server_address
 
             # Start a thread with the server.
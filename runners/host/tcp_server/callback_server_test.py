@@ -223,5 +223,47 @@ class TestMethods(unittest.TestCase):
         # also confirm the error message
         self.assertEqual(response_message.response_code, SysMsg_pb2.FAIL)
 
+    def testBatchedRequests(self):
+        """Tests several requests sent in one write on one connection.
+
+        The agent keeps its connection to the callback server open and
+        coalesces requests, so all of them must be handled.
+        """
+        func_id = "21"
+        request_count = 3
+
+        def callback_func():
+            self._counter += 1
+
+        self._callback_server.RegisterCallback(func_id, callback_func)
+        prev_value = self._counter
+
+        request_message = SysMsg_pb2.AndroidSystemCallbackRequestMessage()
+        request_message.id = func_id
+        message = request_message.SerializeToString()
+        response_message = SysMsg_pb2.AndroidSystemCallbackResponseMessage()
+        response_message.response_code = SysMsg_pb2.SUCCESS
+        expected_responses = (response_message.SerializeToString() *
+                              request_count)
+
+        sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+        try:
+            sock.connect((self._callback_server.ip,
+                          self._callback_server.port))
+            sock.sendall((str(len(message)) + "\n" + message) * request_count)
+
+            # a response is sent after its callback is called.
+            received_responses = ""
+            while len(received_responses) < len(expected_responses):
+                data = sock.recv(1024)
+                if not data:
+                    break
+                received_responses += data
+        finally:
+            sock.close()
+
+        self.assertEqual(received_responses, expected_responses)
+        self.assertEqual(self._counter, prev_value + request_count)
+
 if __name__ == '__main__':
     unittest.main()
@@ -18,6 +18,7 @@ vts_lib_packages := \
   libvts_common \
   libvts_datatype \
   libvts_drivercomm \
+  libvts_gcov_capture \
   libvts_interfacespecification \
   libvts_measurement \
   libvts_multidevice_proto \
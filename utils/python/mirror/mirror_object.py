@@ -22,7 +22,6 @@ import sys
 from vts.utils.python.fuzzer import FuzzerUtils
 from vts.utils.python.mirror import mirror_object_for_types
 from vts.proto import ComponentSpecificationMessage_pb2 as CompSpecMsg
-from google.protobuf import text_format
 
 # a dict containing the IDs of the registered function pointers.
 _function_pointer_id_dict = {}
@@ -94,8 +93,7 @@ class MirrorObject(object):
             func_msg.return_type.scalar_type = "int32_t"
         logging.debug("final msg %s", func_msg)
 
-        result = self._client.CallApi(text_format.MessageToString(func_msg),
-                                      self.__caller_uid)
+        result = self._client.CallApi(func_msg, self.__caller_uid)
         logging.debug(result)
         return result
 
@@ -146,8 +144,7 @@ class MirrorObject(object):
             except AttributeError as e:
                 logging.exception("%s" % e)
                 pass
-            result = self._client.GetAttribute(
-                text_format.MessageToString(func_msg))
+            result = self._client.GetAttribute(func_msg)
             logging.debug(result)
             return result
 
@@ -473,8 +470,7 @@ class MirrorObject(object):
                         if submodule_name.endswith("*"):
                             submodule_name = submodule_name[:-1]
                         func_msg.submodule_name = submodule_name
-            result = self._client.CallApi(text_format.MessageToString(func_msg),
-                                          self.__caller_uid)
+            result = self._client.CallApi(func_msg, self.__caller_uid)
             logging.debug(result)
             if (isinstance(result, tuple) and len(result) == 2 and
                 isinstance(result[1], dict) and "coverage" in result[1]):